@@ -81,6 +81,35 @@ RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool
 	return ret;
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_priority);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path) {
+
+	return (ThreadLoadStatus)ResourceLoader::load_threaded_get_status(p_path);
+}
+
+float _ResourceLoader::load_threaded_get_progress(const String &p_path) {
+
+	float progress = 0;
+	ResourceLoader::load_threaded_get_status(p_path, &progress);
+	return progress;
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+
+	Error err = OK;
+	RES ret = ResourceLoader::load_threaded_get(p_path, &err);
+
+	if (err != OK) {
+		ERR_EXPLAIN("Error loading resource: '" + p_path + "'");
+		ERR_FAIL_COND_V(err != OK, ret);
+	}
+	return ret;
+}
+
 PoolVector<String> _ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 
 	List<String> exts;
@@ -133,6 +162,10 @@ void _ResourceLoader::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("load_interactive", "path", "type_hint"), &_ResourceLoader::load_interactive, DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("load", "path", "type_hint", "no_cache"), &_ResourceLoader::load, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "priority"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path"), &_ResourceLoader::load_threaded_get_status);
+	ClassDB::bind_method(D_METHOD("load_threaded_get_progress", "path"), &_ResourceLoader::load_threaded_get_progress);
+	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
 	ClassDB::bind_method(D_METHOD("get_recognized_extensions_for_type", "type"), &_ResourceLoader::get_recognized_extensions_for_type);
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
@@ -141,6 +174,11 @@ void _ResourceLoader::_bind_methods() {
 #ifndef DISABLE_DEPRECATED
 	ClassDB::bind_method(D_METHOD("has", "path"), &_ResourceLoader::has);
 #endif // DISABLE_DEPRECATED
+
+	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_FAILED);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_LOADED);
 }
 
 _ResourceLoader::_ResourceLoader() {
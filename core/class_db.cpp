@@ -1154,6 +1154,33 @@ StringName ClassDB::get_property_getter(StringName p_class, const StringName p_p
 	return StringName();
 }
 
+// Resolves the method get_property() ends up calling for p_property, so callers can cache it per class.
+// Returns NULL for anything that isn't a plain getter (constants, properties without one).
+MethodBind *ClassDB::get_property_getter_method(const StringName &p_class, const StringName &p_property, int *r_index) {
+
+	ClassInfo *type = classes.getptr(p_class);
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (!psg->getter)
+				return NULL;
+
+			*r_index = psg->index;
+			if (psg->index < 0 && psg->_getptr)
+				return psg->_getptr;
+			return get_method(p_class, psg->getter);
+		}
+
+		if (check->constant_map.has(p_property))
+			return NULL;
+
+		check = check->inherits_ptr;
+	}
+
+	return NULL;
+}
+
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -336,6 +336,7 @@ public:
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = NULL);
 	static StringName get_property_setter(StringName p_class, const StringName p_property);
 	static StringName get_property_getter(StringName p_class, const StringName p_property);
+	static MethodBind *get_property_getter_method(const StringName &p_class, const StringName &p_property, int *r_index);
 
 	static bool has_method(StringName p_class, StringName p_method, bool p_no_inheritance = false);
 	static void set_method_flags(StringName p_class, StringName p_method, int p_flags);
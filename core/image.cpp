@@ -2186,6 +2186,8 @@ PoolVector<uint8_t> (*Image::lossy_packer)(const Ref<Image> &, float) = NULL;
 Ref<Image> (*Image::lossy_unpacker)(const PoolVector<uint8_t> &) = NULL;
 PoolVector<uint8_t> (*Image::lossless_packer)(const Ref<Image> &) = NULL;
 Ref<Image> (*Image::lossless_unpacker)(const PoolVector<uint8_t> &) = NULL;
+Ref<Image> (*Image::lossy_memory_unpacker)(const uint8_t *, int) = NULL;
+Ref<Image> (*Image::lossless_memory_unpacker)(const uint8_t *, int) = NULL;
 
 void Image::_set_data(const Dictionary &p_data) {
 
@@ -2938,6 +2940,26 @@ Error Image::load_webp_from_buffer(const PoolVector<uint8_t> &p_array) {
 	return _load_from_buffer(p_array, _webp_mem_loader_func);
 }
 
+Ref<Image> Image::unpack_from_memory(const uint8_t *p_buffer, int p_size, bool p_lossy) {
+
+	// Data written by lossy_packer/lossless_packer, decoded without a copy when the unpacker supports it.
+	Ref<Image> (*memory_unpacker)(const uint8_t *, int) = p_lossy ? lossy_memory_unpacker : lossless_memory_unpacker;
+	if (memory_unpacker) {
+		return memory_unpacker(p_buffer, p_size);
+	}
+
+	Ref<Image> (*unpacker)(const PoolVector<uint8_t> &) = p_lossy ? lossy_unpacker : lossless_unpacker;
+	ERR_FAIL_COND_V(!unpacker, Ref<Image>());
+
+	PoolVector<uint8_t> data;
+	data.resize(p_size);
+	{
+		PoolVector<uint8_t>::Write w = data.write();
+		copymem(w.ptr(), p_buffer, p_size);
+	}
+	return unpacker(data);
+}
+
 Error Image::_load_from_buffer(const PoolVector<uint8_t> &p_array, ImageMemLoadFunc p_loader) {
 	int buffer_size = p_array.size();
 
@@ -143,6 +143,11 @@ public:
 	static Ref<Image> (*lossy_unpacker)(const PoolVector<uint8_t> &p_buffer);
 	static PoolVector<uint8_t> (*lossless_packer)(const Ref<Image> &p_image);
 	static Ref<Image> (*lossless_unpacker)(const PoolVector<uint8_t> &p_buffer);
+	// Optional variants of the unpackers that decode in place. Whoever replaces an unpacker must also set or clear its variant.
+	static Ref<Image> (*lossy_memory_unpacker)(const uint8_t *p_buffer, int p_size);
+	static Ref<Image> (*lossless_memory_unpacker)(const uint8_t *p_buffer, int p_size);
+
+	static Ref<Image> unpack_from_memory(const uint8_t *p_buffer, int p_size, bool p_lossy);
 
 	PoolVector<uint8_t>::Write write_lock;
 
@@ -97,10 +97,14 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	}
 }
 
-void PackedData::add_pack_source(PackSource *p_source) {
+void PackedData::add_pack_source(PackSource *p_source, bool p_at_front) {
 
 	if (p_source != NULL) {
-		sources.push_back(p_source);
+		if (p_at_front) {
+			sources.insert(0, p_source); // tried before the sources already added
+		} else {
+			sources.push_back(p_source);
+		}
 	}
 };
 
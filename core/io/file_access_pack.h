@@ -101,7 +101,7 @@ private:
 	void _free_packed_dirs(PackedDir *p_dir);
 
 public:
-	void add_pack_source(PackSource *p_source);
+	void add_pack_source(PackSource *p_source, bool p_at_front = false);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
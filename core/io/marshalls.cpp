@@ -1391,3 +1391,802 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 	return OK;
 }
+
+/* Compact encoding */
+
+#define COMPACT_TYPE_MASK 0x1F
+#define COMPACT_FLAG_64 0x20 // REAL stored as double
+#define COMPACT_FLAG_TRUE 0x20 // BOOL value
+#define COMPACT_FLAG_QUANTIZED 0x40 // normalized floats stored as halves, QUAT as smallest three
+#define COMPACT_FLAG_FALLBACK 0x80 // stored with encode_variant()
+
+#define COMPACT_QUAT_SCALE 722.6631f // 511 * sqrt(2), the smallest three are within +-1 / sqrt(2), 10 bits each
+
+int variant_get_floats(const Variant &p_value, float *r_floats) {
+
+	switch (p_value.get_type()) {
+
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			r_floats[0] = v.x;
+			r_floats[1] = v.y;
+			return 2;
+		}
+		case Variant::RECT2: {
+			Rect2 r = p_value;
+			r_floats[0] = r.position.x;
+			r_floats[1] = r.position.y;
+			r_floats[2] = r.size.x;
+			r_floats[3] = r.size.y;
+			return 4;
+		}
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			r_floats[0] = v.x;
+			r_floats[1] = v.y;
+			r_floats[2] = v.z;
+			return 3;
+		}
+		case Variant::TRANSFORM2D: {
+			Transform2D t = p_value;
+			for (int i = 0; i < 3; i++) {
+				r_floats[i * 2 + 0] = t.elements[i].x;
+				r_floats[i * 2 + 1] = t.elements[i].y;
+			}
+			return 6;
+		}
+		case Variant::PLANE: {
+			Plane p = p_value;
+			r_floats[0] = p.normal.x;
+			r_floats[1] = p.normal.y;
+			r_floats[2] = p.normal.z;
+			r_floats[3] = p.d;
+			return 4;
+		}
+		case Variant::QUAT: {
+			Quat q = p_value;
+			r_floats[0] = q.x;
+			r_floats[1] = q.y;
+			r_floats[2] = q.z;
+			r_floats[3] = q.w;
+			return 4;
+		}
+		case Variant::AABB: {
+			AABB aabb = p_value;
+			for (int i = 0; i < 3; i++) {
+				r_floats[i] = aabb.position[i];
+				r_floats[i + 3] = aabb.size[i];
+			}
+			return 6;
+		}
+		case Variant::BASIS: {
+			Basis b = p_value;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					r_floats[i * 3 + j] = b.elements[i][j];
+				}
+			}
+			return 9;
+		}
+		case Variant::TRANSFORM: {
+			Transform t = p_value;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					r_floats[i * 3 + j] = t.basis.elements[i][j];
+				}
+				r_floats[9 + i] = t.origin[i];
+			}
+			return 12;
+		}
+		case Variant::COLOR: {
+			Color c = p_value;
+			r_floats[0] = c.r;
+			r_floats[1] = c.g;
+			r_floats[2] = c.b;
+			r_floats[3] = c.a;
+			return 4;
+		}
+		default: {
+		}
+	}
+
+	return 0;
+}
+
+int variant_get_float_count(Variant::Type p_type) {
+
+	switch (p_type) {
+		case Variant::VECTOR2: return 2;
+		case Variant::RECT2: return 4;
+		case Variant::VECTOR3: return 3;
+		case Variant::TRANSFORM2D: return 6;
+		case Variant::PLANE: return 4;
+		case Variant::QUAT: return 4;
+		case Variant::AABB: return 6;
+		case Variant::BASIS: return 9;
+		case Variant::TRANSFORM: return 12;
+		case Variant::COLOR: return 4;
+		default: {
+		}
+	}
+
+	return 0;
+}
+
+Variant variant_from_floats(Variant::Type p_type, const float *p_floats) {
+
+	switch (p_type) {
+
+		case Variant::VECTOR2: {
+			return Vector2(p_floats[0], p_floats[1]);
+		}
+		case Variant::RECT2: {
+			return Rect2(p_floats[0], p_floats[1], p_floats[2], p_floats[3]);
+		}
+		case Variant::VECTOR3: {
+			return Vector3(p_floats[0], p_floats[1], p_floats[2]);
+		}
+		case Variant::TRANSFORM2D: {
+			Transform2D t;
+			for (int i = 0; i < 3; i++) {
+				t.elements[i] = Vector2(p_floats[i * 2 + 0], p_floats[i * 2 + 1]);
+			}
+			return t;
+		}
+		case Variant::PLANE: {
+			return Plane(p_floats[0], p_floats[1], p_floats[2], p_floats[3]);
+		}
+		case Variant::QUAT: {
+			return Quat(p_floats[0], p_floats[1], p_floats[2], p_floats[3]);
+		}
+		case Variant::AABB: {
+			return AABB(Vector3(p_floats[0], p_floats[1], p_floats[2]), Vector3(p_floats[3], p_floats[4], p_floats[5]));
+		}
+		case Variant::BASIS: {
+			Basis b;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					b.elements[i][j] = p_floats[i * 3 + j];
+				}
+			}
+			return b;
+		}
+		case Variant::TRANSFORM: {
+			Transform t;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					t.basis.elements[i][j] = p_floats[i * 3 + j];
+				}
+				t.origin[i] = p_floats[9 + i];
+			}
+			return t;
+		}
+		case Variant::COLOR: {
+			return Color(p_floats[0], p_floats[1], p_floats[2], p_floats[3]);
+		}
+		default: {
+		}
+	}
+
+	return Variant();
+}
+
+static void _compact_put_u8(uint8_t p_value, uint8_t *&buf, int &r_len) {
+
+	if (buf) {
+		*(buf++) = p_value;
+	}
+	r_len++;
+}
+
+static void _compact_put_varuint(uint64_t p_value, uint8_t *&buf, int &r_len) {
+
+	int len = encode_varuint(p_value, buf);
+	if (buf) {
+		buf += len;
+	}
+	r_len += len;
+}
+
+static _FORCE_INLINE_ void _compact_put_varint(int64_t p_value, uint8_t *&buf, int &r_len) {
+
+	_compact_put_varuint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63), buf, r_len);
+}
+
+static void _compact_put_float(float p_value, bool p_half, uint8_t *&buf, int &r_len) {
+
+	if (p_half) {
+		if (buf) {
+			encode_uint16(Math::make_half_float(p_value), buf);
+			buf += 2;
+		}
+		r_len += 2;
+	} else {
+		if (buf) {
+			encode_float(p_value, buf);
+			buf += 4;
+		}
+		r_len += 4;
+	}
+}
+
+static void _compact_put_string(const String &p_string, uint8_t *&buf, int &r_len) {
+
+	CharString utf8 = p_string.utf8();
+
+	_compact_put_varuint(utf8.length(), buf, r_len);
+	if (buf) {
+		copymem(buf, utf8.get_data(), utf8.length());
+		buf += utf8.length();
+	}
+	r_len += utf8.length();
+}
+
+static void _compact_put_quat(const Quat &p_quat, uint8_t *&buf, int &r_len) {
+
+	// smallest three: drop the largest component, rebuilt from the others since the quaternion is unit
+	float q[4] = { p_quat.x, p_quat.y, p_quat.z, p_quat.w };
+
+	int largest = 0;
+	for (int i = 1; i < 4; i++) {
+		if (Math::abs(q[i]) > Math::abs(q[largest])) {
+			largest = i;
+		}
+	}
+
+	float sign = q[largest] < 0 ? -1 : 1;
+	uint32_t packed = largest;
+	int shift = 2;
+
+	for (int i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		int value = CLAMP(int(Math::round(q[i] * sign * COMPACT_QUAT_SCALE)), -511, 511);
+		packed |= uint32_t(value + 511) << shift;
+		shift += 10;
+	}
+
+	if (buf) {
+		encode_uint32(packed, buf);
+		buf += 4;
+	}
+	r_len += 4;
+}
+
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_quantize) {
+
+	uint8_t *buf = r_buffer;
+	r_len = 0;
+
+	Variant::Type type = p_variant.get_type();
+
+	switch (type) {
+
+		case Variant::NIL: {
+			_compact_put_u8(type, buf, r_len);
+		} break;
+		case Variant::BOOL: {
+			_compact_put_u8(type | (bool(p_variant) ? COMPACT_FLAG_TRUE : 0), buf, r_len);
+		} break;
+		case Variant::INT: {
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varint(p_variant, buf, r_len);
+		} break;
+		case Variant::REAL: {
+
+			double d = p_variant;
+
+			if (double(float(d)) != d) {
+				_compact_put_u8(type | COMPACT_FLAG_64, buf, r_len);
+				if (buf) {
+					encode_double(d, buf);
+					buf += 8;
+				}
+				r_len += 8;
+			} else {
+				_compact_put_u8(type, buf, r_len);
+				_compact_put_float(d, false, buf, r_len);
+			}
+		} break;
+		case Variant::STRING:
+		case Variant::NODE_PATH: {
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_string(p_variant, buf, r_len);
+		} break;
+		case Variant::QUAT: {
+
+			if (p_quantize) {
+				_compact_put_u8(type | COMPACT_FLAG_QUANTIZED, buf, r_len);
+				_compact_put_quat(p_variant, buf, r_len);
+				break;
+			}
+
+			_compact_put_u8(type, buf, r_len);
+			float floats[4];
+			variant_get_floats(p_variant, floats);
+			for (int i = 0; i < 4; i++) {
+				_compact_put_float(floats[i], false, buf, r_len);
+			}
+		} break;
+		case Variant::VECTOR2:
+		case Variant::RECT2:
+		case Variant::VECTOR3:
+		case Variant::TRANSFORM2D:
+		case Variant::PLANE:
+		case Variant::AABB:
+		case Variant::BASIS:
+		case Variant::TRANSFORM:
+		case Variant::COLOR: {
+
+			// half floats only keep about three significant digits, so only normalized data (colors
+			// and unit vectors, like normals and directions) is quantized; positions keep full precision
+			bool half = false;
+			if (p_quantize) {
+				if (type == Variant::COLOR) {
+					half = true;
+				} else if (type == Variant::VECTOR2) {
+					half = Vector2(p_variant).is_normalized();
+				} else if (type == Variant::VECTOR3) {
+					half = Vector3(p_variant).is_normalized();
+				}
+			}
+
+			_compact_put_u8(type | (half ? COMPACT_FLAG_QUANTIZED : 0), buf, r_len);
+
+			float floats[12];
+			int count = variant_get_floats(p_variant, floats);
+			for (int i = 0; i < count; i++) {
+				_compact_put_float(floats[i], half, buf, r_len);
+			}
+		} break;
+		case Variant::ARRAY: {
+
+			Array array = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(array.size(), buf, r_len);
+
+			for (int i = 0; i < array.size(); i++) {
+				int len;
+				Error err = encode_variant_compact(array.get(i), buf, len, p_quantize);
+				ERR_FAIL_COND_V(err, err);
+				if (buf) {
+					buf += len;
+				}
+				r_len += len;
+			}
+		} break;
+		case Variant::DICTIONARY: {
+
+			Dictionary dict = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(dict.size(), buf, r_len);
+
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				for (int i = 0; i < 2; i++) {
+					int len;
+					Error err = encode_variant_compact(i == 0 ? E->get() : dict[E->get()], buf, len, p_quantize);
+					ERR_FAIL_COND_V(err, err);
+					if (buf) {
+						buf += len;
+					}
+					r_len += len;
+				}
+			}
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+
+			PoolVector<uint8_t> data = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(data.size(), buf, r_len);
+
+			if (buf && data.size()) {
+				PoolVector<uint8_t>::Read r = data.read();
+				copymem(buf, &r[0], data.size());
+				buf += data.size();
+			}
+			r_len += data.size();
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+
+			PoolVector<int> data = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(data.size(), buf, r_len);
+
+			PoolVector<int>::Read r = data.read();
+			for (int i = 0; i < data.size(); i++) {
+				_compact_put_varint(r[i], buf, r_len);
+			}
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+
+			PoolVector<real_t> data = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(data.size(), buf, r_len);
+
+			PoolVector<real_t>::Read r = data.read();
+			for (int i = 0; i < data.size(); i++) {
+				_compact_put_float(r[i], false, buf, r_len);
+			}
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+
+			PoolVector<String> data = p_variant;
+			_compact_put_u8(type, buf, r_len);
+			_compact_put_varuint(data.size(), buf, r_len);
+
+			PoolVector<String>::Read r = data.read();
+			for (int i = 0; i < data.size(); i++) {
+				_compact_put_string(r[i], buf, r_len);
+			}
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY:
+		case Variant::POOL_VECTOR3_ARRAY:
+		case Variant::POOL_COLOR_ARRAY: {
+
+			Array data = p_variant; // converted, to treat the three the same way
+			bool half = p_quantize && type == Variant::POOL_COLOR_ARRAY; // like single values, only colors
+			_compact_put_u8(type | (half ? COMPACT_FLAG_QUANTIZED : 0), buf, r_len);
+			_compact_put_varuint(data.size(), buf, r_len);
+
+			for (int i = 0; i < data.size(); i++) {
+				float floats[4];
+				int count = variant_get_floats(data[i], floats);
+				for (int j = 0; j < count; j++) {
+					_compact_put_float(floats[j], half, buf, r_len);
+				}
+			}
+		} break;
+		default: {
+
+			// objects and RIDs are rare in messages, keep the regular encoding for them
+			int len;
+			Error err = encode_variant(p_variant, NULL, len);
+			ERR_FAIL_COND_V(err, err);
+
+			_compact_put_u8(type | COMPACT_FLAG_FALLBACK, buf, r_len);
+			_compact_put_varuint(len, buf, r_len);
+
+			if (buf) {
+				encode_variant(p_variant, buf, len);
+				buf += len;
+			}
+			r_len += len;
+		}
+	}
+
+	return OK;
+}
+
+#define COMPACT_NEED(m_bytes) ERR_FAIL_COND_V(len < (int)(m_bytes), ERR_INVALID_DATA)
+
+static Error _compact_get_varuint(const uint8_t *&buf, int &len, uint64_t &r_value) {
+
+	int read = decode_varuint(buf, len, r_value);
+	ERR_FAIL_COND_V(!read, ERR_INVALID_DATA);
+	buf += read;
+	len -= read;
+	return OK;
+}
+
+static Error _compact_get_count(const uint8_t *&buf, int &len, int p_min_item_size, int &r_count) {
+
+	uint64_t count;
+	Error err = _compact_get_varuint(buf, len, count);
+	ERR_FAIL_COND_V(err, err);
+	// every item takes at least p_min_item_size bytes, this also rejects absurd counts before allocating
+	ERR_FAIL_COND_V(count * MAX(p_min_item_size, 1) > uint64_t(len), ERR_INVALID_DATA);
+	r_count = count;
+	return OK;
+}
+
+static Error _compact_get_float(const uint8_t *&buf, int &len, bool p_half, float &r_value) {
+
+	if (p_half) {
+		COMPACT_NEED(2);
+		r_value = Math::half_to_float(decode_uint16(buf));
+		buf += 2;
+		len -= 2;
+	} else {
+		COMPACT_NEED(4);
+		r_value = decode_float(buf);
+		buf += 4;
+		len -= 4;
+	}
+	return OK;
+}
+
+static Error _compact_get_string(const uint8_t *&buf, int &len, String &r_string) {
+
+	int size;
+	Error err = _compact_get_count(buf, len, 1, size);
+	ERR_FAIL_COND_V(err, err);
+
+	r_string = String();
+	if (size) {
+		ERR_FAIL_COND_V(r_string.parse_utf8((const char *)buf, size), ERR_INVALID_DATA);
+	}
+	buf += size;
+	len -= size;
+	return OK;
+}
+
+static Error _compact_get_quat(const uint8_t *&buf, int &len, Quat &r_quat) {
+
+	COMPACT_NEED(4);
+	uint32_t packed = decode_uint32(buf);
+	buf += 4;
+	len -= 4;
+
+	int largest = packed & 3;
+	float q[4];
+	float sum = 0;
+	int shift = 2;
+
+	for (int i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		q[i] = (int((packed >> shift) & 0x3FF) - 511) / COMPACT_QUAT_SCALE;
+		sum += q[i] * q[i];
+		shift += 10;
+	}
+
+	q[largest] = Math::sqrt(MAX(0.0f, 1.0f - sum));
+	r_quat = Quat(q[0], q[1], q[2], q[3]);
+	return OK;
+}
+
+static Error _decode_variant_compact(Variant &r_variant, const uint8_t *&buf, int &len, bool p_allow_objects, int p_depth) {
+
+	ERR_EXPLAIN("Variant is too deeply nested.");
+	ERR_FAIL_COND_V(p_depth > 512, ERR_INVALID_DATA);
+	COMPACT_NEED(1);
+
+	uint8_t tag = *buf;
+	buf++;
+	len--;
+
+	Variant::Type type = Variant::Type(tag & COMPACT_TYPE_MASK);
+	ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+
+	bool quantized = tag & COMPACT_FLAG_QUANTIZED;
+	Error err = OK;
+
+	if (tag & COMPACT_FLAG_FALLBACK) {
+
+		int size;
+		err = _compact_get_count(buf, len, 1, size);
+		ERR_FAIL_COND_V(err, err);
+
+		int used;
+		err = decode_variant(r_variant, buf, size, &used, p_allow_objects);
+		ERR_FAIL_COND_V(err, err);
+		ERR_FAIL_COND_V(r_variant.get_type() != type, ERR_INVALID_DATA);
+
+		buf += size;
+		len -= size;
+		return OK;
+	}
+
+	switch (type) {
+
+		case Variant::NIL: {
+			r_variant = Variant();
+		} break;
+		case Variant::BOOL: {
+			r_variant = bool(tag & COMPACT_FLAG_TRUE);
+		} break;
+		case Variant::INT: {
+			uint64_t value;
+			err = _compact_get_varuint(buf, len, value);
+			ERR_FAIL_COND_V(err, err);
+			r_variant = int64_t(value >> 1) ^ -int64_t(value & 1);
+		} break;
+		case Variant::REAL: {
+			if (tag & COMPACT_FLAG_64) {
+				COMPACT_NEED(8);
+				r_variant = decode_double(buf);
+				buf += 8;
+				len -= 8;
+			} else {
+				float value;
+				err = _compact_get_float(buf, len, quantized, value);
+				ERR_FAIL_COND_V(err, err);
+				r_variant = value;
+			}
+		} break;
+		case Variant::STRING:
+		case Variant::NODE_PATH: {
+			String string;
+			err = _compact_get_string(buf, len, string);
+			ERR_FAIL_COND_V(err, err);
+			if (type == Variant::NODE_PATH) {
+				r_variant = NodePath(string);
+			} else {
+				r_variant = string;
+			}
+		} break;
+		case Variant::QUAT: {
+			if (quantized) {
+				Quat quat;
+				err = _compact_get_quat(buf, len, quat);
+				ERR_FAIL_COND_V(err, err);
+				r_variant = quat;
+				break;
+			}
+		} // fall through, full precision quaternions are read like the other float types
+		case Variant::VECTOR2:
+		case Variant::RECT2:
+		case Variant::VECTOR3:
+		case Variant::TRANSFORM2D:
+		case Variant::PLANE:
+		case Variant::AABB:
+		case Variant::BASIS:
+		case Variant::TRANSFORM:
+		case Variant::COLOR: {
+
+			float floats[12];
+			int count = variant_get_float_count(type);
+			for (int i = 0; i < count; i++) {
+				err = _compact_get_float(buf, len, quantized, floats[i]);
+				ERR_FAIL_COND_V(err, err);
+			}
+			r_variant = variant_from_floats(type, floats);
+		} break;
+		case Variant::ARRAY: {
+
+			int count;
+			err = _compact_get_count(buf, len, 1, count);
+			ERR_FAIL_COND_V(err, err);
+
+			Array array;
+			array.resize(count);
+			for (int i = 0; i < count; i++) {
+				Variant value;
+				err = _decode_variant_compact(value, buf, len, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+				array.set(i, value);
+			}
+			r_variant = array;
+		} break;
+		case Variant::DICTIONARY: {
+
+			int count;
+			err = _compact_get_count(buf, len, 2, count);
+			ERR_FAIL_COND_V(err, err);
+
+			Dictionary dict;
+			for (int i = 0; i < count; i++) {
+				Variant key, value;
+				err = _decode_variant_compact(key, buf, len, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+				err = _decode_variant_compact(value, buf, len, p_allow_objects, p_depth + 1);
+				ERR_FAIL_COND_V(err, err);
+				dict[key] = value;
+			}
+			r_variant = dict;
+		} break;
+		case Variant::POOL_BYTE_ARRAY: {
+
+			int count;
+			err = _compact_get_count(buf, len, 1, count);
+			ERR_FAIL_COND_V(err, err);
+
+			PoolVector<uint8_t> data;
+			if (count) {
+				data.resize(count);
+				PoolVector<uint8_t>::Write w = data.write();
+				copymem(&w[0], buf, count);
+			}
+			buf += count;
+			len -= count;
+			r_variant = data;
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+
+			int count;
+			err = _compact_get_count(buf, len, 1, count);
+			ERR_FAIL_COND_V(err, err);
+
+			PoolVector<int> data;
+			data.resize(count);
+			{
+				PoolVector<int>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					uint64_t value;
+					err = _compact_get_varuint(buf, len, value);
+					ERR_FAIL_COND_V(err, err);
+					w[i] = int64_t(value >> 1) ^ -int64_t(value & 1);
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+
+			int count;
+			err = _compact_get_count(buf, len, quantized ? 2 : 4, count);
+			ERR_FAIL_COND_V(err, err);
+
+			PoolVector<real_t> data;
+			data.resize(count);
+			{
+				PoolVector<real_t>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					float value;
+					_compact_get_float(buf, len, quantized, value);
+					w[i] = value;
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_STRING_ARRAY: {
+
+			int count;
+			err = _compact_get_count(buf, len, 1, count);
+			ERR_FAIL_COND_V(err, err);
+
+			PoolVector<String> data;
+			data.resize(count);
+			{
+				PoolVector<String>::Write w = data.write();
+				for (int i = 0; i < count; i++) {
+					err = _compact_get_string(buf, len, w[i]);
+					ERR_FAIL_COND_V(err, err);
+				}
+			}
+			r_variant = data;
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY:
+		case Variant::POOL_VECTOR3_ARRAY:
+		case Variant::POOL_COLOR_ARRAY: {
+
+			Variant::Type element_type = type == Variant::POOL_VECTOR2_ARRAY ? Variant::VECTOR2 : (type == Variant::POOL_VECTOR3_ARRAY ? Variant::VECTOR3 : Variant::COLOR);
+			int element_floats = variant_get_float_count(element_type);
+
+			int count;
+			err = _compact_get_count(buf, len, element_floats * (quantized ? 2 : 4), count);
+			ERR_FAIL_COND_V(err, err);
+
+			Array data;
+			data.resize(count);
+			for (int i = 0; i < count; i++) {
+				float floats[4];
+				for (int j = 0; j < element_floats; j++) {
+					_compact_get_float(buf, len, quantized, floats[j]);
+				}
+				data[i] = variant_from_floats(element_type, floats);
+			}
+
+			Variant array = data;
+			if (type == Variant::POOL_VECTOR2_ARRAY) {
+				r_variant = PoolVector<Vector2>(array);
+			} else if (type == Variant::POOL_VECTOR3_ARRAY) {
+				r_variant = PoolVector<Vector3>(array);
+			} else {
+				r_variant = PoolVector<Color>(array);
+			}
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_INVALID_DATA);
+		}
+	}
+
+	return OK;
+}
+
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+
+	const uint8_t *buf = p_buffer;
+	int len = p_len;
+
+	Error err = _decode_variant_compact(r_variant, buf, len, p_allow_objects, 0);
+	ERR_FAIL_COND_V(err, err);
+
+	if (r_len) {
+		*r_len = p_len - len;
+	}
+
+	return OK;
+}
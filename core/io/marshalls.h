@@ -125,6 +125,25 @@ static inline int encode_cstring(const char *p_string, uint8_t *p_data) {
 	return len + 1;
 }
 
+// Variable length unsigned integer, 7 bits per byte. p_arr can be NULL to get the length.
+static inline int encode_varuint(uint64_t p_uint, uint8_t *p_arr) {
+
+	int len = 0;
+
+	while (p_uint >= 0x80) {
+
+		if (p_arr) {
+			*p_arr = (p_uint & 0x7F) | 0x80;
+			p_arr++;
+		}
+		p_uint >>= 7;
+		len++;
+	}
+
+	if (p_arr) *p_arr = p_uint;
+	return len + 1;
+}
+
 static inline uint16_t decode_uint16(const uint8_t *p_arr) {
 
 	uint16_t u = 0;
@@ -184,6 +203,22 @@ static inline double decode_double(const uint8_t *p_arr) {
 	return md.d;
 }
 
+// Returns the bytes read, or 0 if the buffer ends before the integer does.
+static inline int decode_varuint(const uint8_t *p_arr, int p_len, uint64_t &r_uint) {
+
+	r_uint = 0;
+
+	for (int i = 0; i < p_len && i < 10; i++) {
+
+		r_uint |= uint64_t(p_arr[i] & 0x7F) << (i * 7);
+		if (!(p_arr[i] & 0x80)) {
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
 class EncodedObjectAsID : public Reference {
 	GDCLASS(EncodedObjectAsID, Reference);
 
@@ -202,4 +237,15 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id = false);
 
+// Compact encoding for network messages: one byte type tags, variable length integers, no padding.
+// With p_quantize, colors and unit vectors are sent as half floats and quaternions (which must be normalized)
+// in 32 bits; other floats, like positions, keep full precision.
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_quantize = false);
+
+// Access to the components of variant types made only of floats (vectors, transforms, colors...).
+int variant_get_float_count(Variant::Type p_type);
+int variant_get_floats(const Variant &p_variant, float *r_floats); // up to 12, returns the count or 0
+Variant variant_from_floats(Variant::Type p_type, const float *p_floats);
+
 #endif
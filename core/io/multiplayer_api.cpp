@@ -87,6 +87,17 @@ _FORCE_INLINE_ bool _can_call_mode(Node *p_node, MultiplayerAPI::RPCMode mode, i
 	return false;
 }
 
+_FORCE_INLINE_ MultiplayerAPI::RPCMode _get_rset_mode(Node *p_node, const StringName &p_name) {
+
+	const Map<StringName, MultiplayerAPI::RPCMode>::Element *E = p_node->get_node_rset_mode(p_name);
+	if (E)
+		return E->get();
+	if (p_node->get_script_instance())
+		return p_node->get_script_instance()->get_rset_mode(p_name);
+
+	return MultiplayerAPI::RPC_MODE_DISABLED;
+}
+
 void MultiplayerAPI::poll() {
 
 	if (!network_peer.is_valid() || network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_DISCONNECTED)
@@ -97,25 +108,26 @@ void MultiplayerAPI::poll() {
 	if (!network_peer.is_valid()) // It's possible that polling might have resulted in a disconnection, so check here.
 		return;
 
-	while (network_peer->get_available_packet_count()) {
+	NetworkedMultiplayerPeer::PacketInfo packets[PACKET_BATCH_SIZE];
+	int count;
 
-		int sender = network_peer->get_packet_peer();
-		const uint8_t *packet;
-		int len;
+	while (network_peer.is_valid() && (count = network_peer->get_packet_batch(packets, PACKET_BATCH_SIZE))) {
 
-		Error err = network_peer->get_packet(&packet, len);
-		if (err != OK) {
-			ERR_PRINT("Error getting packet!");
-		}
+		for (int i = 0; i < count; i++) {
 
-		rpc_sender_id = sender;
-		_process_packet(sender, packet, len);
-		rpc_sender_id = 0;
+			rpc_sender_id = packets[i].from;
+			_process_packet(packets[i].from, packets[i].buffer, packets[i].size);
+			rpc_sender_id = 0;
 
-		if (!network_peer.is_valid()) {
-			break; // It's also possible that a packet or RPC caused a disconnection, so also check here.
+			if (!network_peer.is_valid() || network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_DISCONNECTED) {
+				break; // It's also possible that a packet or RPC caused a disconnection, so also check here. The rest of the batch is gone.
+			}
 		}
 	}
+
+	if (network_peer.is_valid()) {
+		replicator->poll();
+	}
 }
 
 void MultiplayerAPI::clear() {
@@ -123,7 +135,9 @@ void MultiplayerAPI::clear() {
 	path_get_cache.clear();
 	path_send_cache.clear();
 	packet_cache.clear();
+	compact_args_cache.clear();
 	last_send_cache_id = 1;
+	replicator->clear();
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -168,7 +182,7 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
 	ERR_FAIL_COND(p_packet_len < 1);
 
-	uint8_t packet_type = p_packet[0];
+	uint8_t packet_type = p_packet[0] & NETWORK_COMMAND_MASK;
 
 	switch (packet_type) {
 
@@ -182,9 +196,25 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 			_process_confirm_path(p_from, p_packet, p_packet_len);
 		} break;
 
+		case NETWORK_COMMAND_SIMPLIFY_NAME: {
+
+			_process_simplify_name(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_CONFIRM_NAME: {
+
+			_process_confirm_name(p_from, p_packet, p_packet_len);
+		} break;
+
 		case NETWORK_COMMAND_REMOTE_CALL:
 		case NETWORK_COMMAND_REMOTE_SET: {
 
+			if (p_packet[0] & NETWORK_COMMAND_FLAG_COMPACT) {
+
+				_process_compact_rpc(p_from, p_packet, p_packet_len);
+				break;
+			}
+
 			ERR_EXPLAIN("Invalid packet received. Size too small.");
 			ERR_FAIL_COND(p_packet_len < 6);
 
@@ -221,6 +251,16 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT: {
+
+			replicator->process_snapshot(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT_ACK: {
+
+			replicator->process_ack(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -268,7 +308,95 @@ Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int
 	return node;
 }
 
-void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset) {
+void MultiplayerAPI::_process_compact_rpc(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	// [command and flags][path cstring or path id varuint][name cstring or name id varuint][arguments]
+
+	uint8_t flags = p_packet[0];
+	int ofs = 1;
+	NodePath path;
+	const PathGetCache::NodeInfo *ni = NULL;
+
+	if (flags & NETWORK_COMMAND_FLAG_PATH_INLINE) {
+
+		int end = ofs;
+		while (end < p_packet_len && p_packet[end] != 0)
+			end++;
+
+		ERR_EXPLAIN("Invalid packet received. Size too small.");
+		ERR_FAIL_COND(end >= p_packet_len);
+
+		String paths;
+		paths.parse_utf8((const char *)&p_packet[ofs], end - ofs);
+		path = paths;
+		ofs = end + 1;
+	} else {
+
+		uint64_t id;
+		int len = decode_varuint(&p_packet[ofs], p_packet_len - ofs, id);
+		ERR_EXPLAIN("Invalid packet received. Size too small.");
+		ERR_FAIL_COND(len == 0);
+		ofs += len;
+
+		Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
+		ERR_EXPLAIN("Invalid packet received. Requests invalid peer cache.");
+		ERR_FAIL_COND(!E);
+
+		Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(id);
+		ERR_EXPLAIN("Invalid packet received. Unabled to find requested cached node.");
+		ERR_FAIL_COND(!F);
+
+		ni = &F->get();
+		path = ni->path;
+	}
+
+	StringName name;
+
+	if (flags & NETWORK_COMMAND_FLAG_NAME_ID) {
+
+		uint64_t id;
+		int len = decode_varuint(&p_packet[ofs], p_packet_len - ofs, id);
+		ERR_EXPLAIN("Invalid packet received. Size too small.");
+		ERR_FAIL_COND(len == 0);
+		ofs += len;
+
+		// Names are only simplified once the path is confirmed, so the id always refers to a cached path.
+		ERR_EXPLAIN("Invalid packet received. Name id sent without a cached path.");
+		ERR_FAIL_COND(!ni);
+
+		const Map<int, StringName>::Element *E = ni->names.find(id);
+		ERR_EXPLAIN("Invalid packet received. Unabled to find requested cached name.");
+		ERR_FAIL_COND(!E);
+		name = E->get();
+	} else {
+
+		int end = ofs;
+		while (end < p_packet_len && p_packet[end] != 0)
+			end++;
+
+		ERR_EXPLAIN("Invalid packet received. Size too small.");
+		ERR_FAIL_COND(end >= p_packet_len);
+
+		name = String::utf8((const char *)&p_packet[ofs], end - ofs);
+		ofs = end + 1;
+	}
+
+	Node *node = root_node->get_node(path);
+	if (!node) {
+		ERR_PRINTS("Failed to get path from RPC: " + String(path));
+		return;
+	}
+
+	if ((flags & NETWORK_COMMAND_MASK) == NETWORK_COMMAND_REMOTE_CALL) {
+
+		_process_rpc(node, name, p_from, p_packet, p_packet_len, ofs, true);
+	} else {
+
+		_process_rset(node, name, p_from, p_packet, p_packet_len, ofs, true);
+	}
+}
+
+void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, bool p_compact) {
 
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
 	ERR_FAIL_COND(p_offset >= p_packet_len);
@@ -299,7 +427,12 @@ void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_
 		ERR_FAIL_COND(p_offset >= p_packet_len);
 
 		int vlen;
-		Error err = decode_variant(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
+		Error err;
+		if (p_compact) {
+			err = decode_variant_compact(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
+		} else {
+			err = decode_variant(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
+		}
 		ERR_EXPLAIN("Invalid packet received. Unable to decode RPC argument.");
 		ERR_FAIL_COND(err != OK);
 
@@ -317,25 +450,24 @@ void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_
 	}
 }
 
-void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset) {
+void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, bool p_compact) {
 
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
 	ERR_FAIL_COND(p_offset >= p_packet_len);
 
 	// Check that remote can call the RSET on this node.
-	RPCMode rset_mode = RPC_MODE_DISABLED;
-	const Map<StringName, RPCMode>::Element *E = p_node->get_node_rset_mode(p_name);
-	if (E) {
-		rset_mode = E->get();
-	} else if (p_node->get_script_instance()) {
-		rset_mode = p_node->get_script_instance()->get_rset_mode(p_name);
-	}
+	RPCMode rset_mode = _get_rset_mode(p_node, p_name);
 
 	ERR_EXPLAIN("RSET '" + String(p_name) + "' is not allowed from: " + itos(p_from) + ". Mode is " + itos((int)rset_mode) + ", master is " + itos(p_node->get_network_master()) + ".");
 	ERR_FAIL_COND(!_can_call_mode(p_node, rset_mode, p_from));
 
 	Variant value;
-	Error err = decode_variant(value, &p_packet[p_offset], p_packet_len - p_offset);
+	Error err;
+	if (p_compact) {
+		err = decode_variant_compact(value, &p_packet[p_offset], p_packet_len - p_offset);
+	} else {
+		err = decode_variant(value, &p_packet[p_offset], p_packet_len - p_offset);
+	}
 
 	ERR_EXPLAIN("Invalid packet received. Unable to decode RSET value.");
 	ERR_FAIL_COND(err != OK);
@@ -349,6 +481,13 @@ void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p
 	}
 }
 
+bool MultiplayerAPI::can_remote_set(Node *p_node, const StringName &p_property, int p_from) const {
+
+	ERR_FAIL_NULL_V(p_node, false);
+
+	return _can_call_mode(p_node, _get_rset_mode(p_node, p_property), p_from);
+}
+
 void MultiplayerAPI::_process_simplify_path(int p_from, const uint8_t *p_packet, int p_packet_len) {
 
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
@@ -405,6 +544,75 @@ void MultiplayerAPI::_process_confirm_path(int p_from, const uint8_t *p_packet,
 	E->get() = true;
 }
 
+void MultiplayerAPI::_process_simplify_name(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 10);
+	int path_id = decode_uint32(&p_packet[1]);
+	int name_id = decode_uint32(&p_packet[5]);
+
+	String name;
+	name.parse_utf8((const char *)&p_packet[9], p_packet_len - 9);
+
+	Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
+	ERR_EXPLAIN("Invalid packet received. Requests invalid peer cache.");
+	ERR_FAIL_COND(!E);
+
+	Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(path_id);
+	ERR_EXPLAIN("Invalid packet received. Tries to simplify a name for a path which was not found in cache.");
+	ERR_FAIL_COND(!F);
+
+	F->get().names[name_id] = name;
+
+	// Encode name id and path to send ack.
+	CharString pname = String(F->get().path).utf8();
+	int len = encode_cstring(pname.get_data(), NULL);
+
+	Vector<uint8_t> packet;
+
+	packet.resize(1 + 4 + len);
+	packet.write[0] = NETWORK_COMMAND_CONFIRM_NAME;
+	encode_uint32(name_id, &packet.write[1]);
+	encode_cstring(pname.get_data(), &packet.write[5]);
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	network_peer->set_target_peer(p_from);
+	network_peer->put_packet(packet.ptr(), packet.size());
+}
+
+void MultiplayerAPI::_process_confirm_name(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 6);
+	int name_id = decode_uint32(&p_packet[1]);
+
+	String paths;
+	paths.parse_utf8((const char *)&p_packet[5], p_packet_len - 5);
+
+	NodePath path = paths;
+
+	PathSentCache *psc = path_send_cache.getptr(path);
+	ERR_EXPLAIN("Invalid packet received. Tries to confirm a name for a path which was not found in cache.");
+	ERR_FAIL_COND(!psc);
+
+	const StringName *K = NULL;
+	while ((K = psc->names.next(K))) {
+
+		NameSentCache &nsc = psc->names[*K];
+		if (nsc.id != name_id)
+			continue;
+
+		Map<int, bool>::Element *E = nsc.confirmed_peers.find(p_from);
+		ERR_EXPLAIN("Invalid packet received. Source peer was not found in cache for the given name.");
+		ERR_FAIL_COND(!E);
+		E->get() = true;
+		return;
+	}
+
+	ERR_EXPLAIN("Invalid packet received. Tries to confirm a name which was not found in cache.");
+	ERR_FAIL();
+}
+
 bool MultiplayerAPI::_send_confirm_path(NodePath p_path, PathSentCache *psc, int p_target) {
 	bool has_all_peers = true;
 	List<int> peers_to_add; // If one is missing, take note to add it.
@@ -455,6 +663,56 @@ bool MultiplayerAPI::_send_confirm_path(NodePath p_path, PathSentCache *psc, int
 	return has_all_peers;
 }
 
+bool MultiplayerAPI::_send_confirm_name(const StringName &p_name, NameSentCache *nsc, PathSentCache *psc, int p_target) {
+	bool has_all_peers = true;
+	List<int> peers_to_add; // If one is missing, take note to add it.
+
+	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+
+		if (p_target < 0 && E->get() == -p_target)
+			continue; // Continue, excluded.
+
+		if (p_target > 0 && E->get() != p_target)
+			continue; // Continue, not for this peer.
+
+		Map<int, bool>::Element *F = nsc->confirmed_peers.find(E->get());
+
+		if (!F || !F->get()) {
+
+			// The peer refers to names through their path, wait until it has it.
+			Map<int, bool>::Element *P = psc->confirmed_peers.find(E->get());
+			if (!F && P && P->get()) {
+				peers_to_add.push_back(E->get());
+			}
+
+			has_all_peers = false;
+		}
+	}
+
+	for (List<int>::Element *E = peers_to_add.front(); E; E = E->next()) {
+
+		// Encode method or property name.
+		CharString pname = String(p_name).utf8();
+		int len = encode_cstring(pname.get_data(), NULL);
+
+		Vector<uint8_t> packet;
+
+		packet.resize(1 + 4 + 4 + len);
+		packet.write[0] = NETWORK_COMMAND_SIMPLIFY_NAME;
+		encode_uint32(psc->id, &packet.write[1]);
+		encode_uint32(nsc->id, &packet.write[5]);
+		encode_cstring(pname.get_data(), &packet.write[9]);
+
+		network_peer->set_target_peer(E->get());
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->put_packet(packet.ptr(), packet.size());
+
+		nsc->confirmed_peers.insert(E->get(), false);
+	}
+
+	return has_all_peers;
+}
+
 void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount) {
 
 	if (network_peer.is_null()) {
@@ -500,6 +758,11 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 		psc->id = last_send_cache_id++;
 	}
 
+	if (compact_encoding) {
+		_send_compact_rpc(from_path, psc, p_to, p_unreliable, p_set, p_name, p_arg, p_argcount);
+		return;
+	}
+
 	// Create base packet, lots of hardcode because it must be tight.
 
 	int ofs = 0;
@@ -594,15 +857,119 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	}
 }
 
+int MultiplayerAPI::_make_compact_rpc_packet(bool p_set, const NodePath &p_path, int p_path_id, bool p_path_confirmed, const StringName &p_name, int p_name_id, bool p_name_confirmed) {
+
+	int ofs = 0;
+	int len;
+
+	MAKE_ROOM(1);
+	packet_cache.write[0] = (p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL) | NETWORK_COMMAND_FLAG_COMPACT;
+	ofs += 1;
+
+	if (p_path_confirmed) {
+		len = encode_varuint(p_path_id, NULL);
+		MAKE_ROOM(ofs + len);
+		encode_varuint(p_path_id, &(packet_cache.write[ofs]));
+	} else {
+		packet_cache.write[0] |= NETWORK_COMMAND_FLAG_PATH_INLINE;
+		CharString pname = String(p_path).utf8();
+		len = encode_cstring(pname.get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(pname.get_data(), &(packet_cache.write[ofs]));
+	}
+	ofs += len;
+
+	if (p_name_confirmed) {
+		packet_cache.write[0] |= NETWORK_COMMAND_FLAG_NAME_ID;
+		len = encode_varuint(p_name_id, NULL);
+		MAKE_ROOM(ofs + len);
+		encode_varuint(p_name_id, &(packet_cache.write[ofs]));
+	} else {
+		CharString name = String(p_name).utf8();
+		len = encode_cstring(name.get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(name.get_data(), &(packet_cache.write[ofs]));
+	}
+	ofs += len;
+
+	MAKE_ROOM(ofs + compact_args_cache.size());
+	copymem(&(packet_cache.write[ofs]), compact_args_cache.ptr(), compact_args_cache.size());
+	ofs += compact_args_cache.size();
+
+	return ofs;
+}
+
+void MultiplayerAPI::_send_compact_rpc(const NodePath &p_path, PathSentCache *psc, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount) {
+
+	// Arguments are encoded once, only the header changes depending on what each peer confirmed.
+	int ofs = 0;
+	int len;
+
+	if (!p_set) {
+		compact_args_cache.resize(1);
+		compact_args_cache.write[0] = p_argcount;
+		ofs += 1;
+	}
+
+	for (int i = 0; i < (p_set ? 1 : p_argcount); i++) {
+		Error err = encode_variant_compact(*p_arg[i], NULL, len, float_quantization);
+		ERR_EXPLAIN("Unable to encode RPC argument. THIS IS LIKELY A BUG IN THE ENGINE!");
+		ERR_FAIL_COND(err != OK);
+		compact_args_cache.resize(ofs + len);
+		encode_variant_compact(*p_arg[i], &(compact_args_cache.write[ofs]), len, float_quantization);
+		ofs += len;
+	}
+	compact_args_cache.resize(ofs);
+
+	NameSentCache *nsc = psc->names.getptr(p_name);
+	if (!nsc) {
+		psc->names[p_name] = NameSentCache();
+		nsc = psc->names.getptr(p_name);
+		nsc->id = psc->last_name_id++;
+	}
+
+	bool has_all_paths = _send_confirm_path(p_path, psc, p_to);
+	bool has_all_names = _send_confirm_name(p_name, nsc, psc, p_to);
+
+	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+
+	if (has_all_paths && has_all_names) {
+
+		ofs = _make_compact_rpc_packet(p_set, p_path, psc->id, true, p_name, nsc->id, true);
+		network_peer->set_target_peer(p_to);
+		network_peer->put_packet(packet_cache.ptr(), ofs);
+		return;
+	}
+
+	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+
+		if (p_to < 0 && E->get() == -p_to)
+			continue; // Continue, excluded.
+
+		if (p_to > 0 && E->get() != p_to)
+			continue; // Continue, not for this peer.
+
+		Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
+		ERR_CONTINUE(!F); // Should never happen.
+		Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+
+		ofs = _make_compact_rpc_packet(p_set, p_path, psc->id, F->get(), p_name, nsc->id, G && G->get());
+		network_peer->set_target_peer(E->get());
+		network_peer->put_packet(packet_cache.ptr(), ofs);
+	}
+}
+
 void MultiplayerAPI::_add_peer(int p_id) {
 	connected_peers.insert(p_id);
 	path_get_cache.insert(p_id, PathGetCache());
+	replicator->add_peer(p_id);
 	emit_signal("network_peer_connected", p_id);
 }
 
 void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
 	path_get_cache.erase(p_id); // I no longer need your cache, sorry.
+	replicator->del_peer(p_id);
 	emit_signal("network_peer_disconnected", p_id);
 }
 
@@ -805,6 +1172,26 @@ bool MultiplayerAPI::is_refusing_new_network_connections() const {
 	return network_peer->is_refusing_new_connections();
 }
 
+void MultiplayerAPI::set_compact_encoding(bool p_enabled) {
+
+	compact_encoding = p_enabled;
+}
+
+bool MultiplayerAPI::is_compact_encoding_enabled() const {
+
+	return compact_encoding;
+}
+
+void MultiplayerAPI::set_float_quantization(bool p_enabled) {
+
+	float_quantization = p_enabled;
+}
+
+bool MultiplayerAPI::is_float_quantization_enabled() const {
+
+	return float_quantization;
+}
+
 Vector<int> MultiplayerAPI::get_network_connected_peers() const {
 
 	ERR_EXPLAIN("No network peer is assigned. Assume no peers are connected.");
@@ -838,7 +1225,14 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_network_connected_peers"), &MultiplayerAPI::get_network_connected_peers);
 	ClassDB::bind_method(D_METHOD("set_refuse_new_network_connections", "refuse"), &MultiplayerAPI::set_refuse_new_network_connections);
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
+	ClassDB::bind_method(D_METHOD("set_compact_encoding", "enabled"), &MultiplayerAPI::set_compact_encoding);
+	ClassDB::bind_method(D_METHOD("is_compact_encoding_enabled"), &MultiplayerAPI::is_compact_encoding_enabled);
+	ClassDB::bind_method(D_METHOD("set_float_quantization", "enabled"), &MultiplayerAPI::set_float_quantization);
+	ClassDB::bind_method(D_METHOD("is_float_quantization_enabled"), &MultiplayerAPI::is_float_quantization_enabled);
+	ClassDB::bind_method(D_METHOD("get_replicator"), &MultiplayerAPI::get_replicator);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_encoding"), "set_compact_encoding", "is_compact_encoding_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "float_quantization"), "set_float_quantization", "is_float_quantization_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
 
 	ADD_SIGNAL(MethodInfo("network_peer_connected", PropertyInfo(Variant::INT, "id")));
@@ -862,9 +1256,13 @@ void MultiplayerAPI::_bind_methods() {
 MultiplayerAPI::MultiplayerAPI() {
 	rpc_sender_id = 0;
 	root_node = NULL;
+	compact_encoding = false;
+	float_quantization = false;
+	replicator = memnew(MultiplayerReplicator(this));
 	clear();
 }
 
 MultiplayerAPI::~MultiplayerAPI() {
 	clear();
+	memdelete(replicator);
 }
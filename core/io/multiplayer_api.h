@@ -31,6 +31,7 @@
 #ifndef MULTIPLAYER_PROTOCOL_H
 #define MULTIPLAYER_PROTOCOL_H
 
+#include "core/io/multiplayer_replicator.h"
 #include "core/io/networked_multiplayer_peer.h"
 #include "core/reference.h"
 
@@ -39,10 +40,27 @@ class MultiplayerAPI : public Reference {
 	GDCLASS(MultiplayerAPI, Reference);
 
 private:
+	enum {
+		PACKET_BATCH_SIZE = 64
+	};
+
+	//name sent caches, only used by the compact encoding
+	struct NameSentCache {
+		Map<int, bool> confirmed_peers;
+		int id;
+	};
+
 	//path sent caches
 	struct PathSentCache {
 		Map<int, bool> confirmed_peers;
 		int id;
+		HashMap<StringName, NameSentCache> names;
+		int last_name_id;
+
+		PathSentCache() {
+			id = 0;
+			last_name_id = 0;
+		}
 	};
 
 	//path get caches
@@ -50,6 +68,7 @@ private:
 		struct NodeInfo {
 			NodePath path;
 			ObjectID instance;
+			Map<int, StringName> names;
 		};
 
 		Map<int, NodeInfo> nodes;
@@ -62,7 +81,11 @@ private:
 	Map<int, PathGetCache> path_get_cache;
 	int last_send_cache_id;
 	Vector<uint8_t> packet_cache;
+	Vector<uint8_t> compact_args_cache;
+	bool compact_encoding;
+	bool float_quantization;
 	Node *root_node;
+	MultiplayerReplicator *replicator;
 
 protected:
 	static void _bind_methods();
@@ -70,13 +93,19 @@ protected:
 	void _process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_simplify_path(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_confirm_path(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_simplify_name(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_confirm_name(int p_from, const uint8_t *p_packet, int p_packet_len);
 	Node *_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len);
-	void _process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
-	void _process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
+	void _process_compact_rpc(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, bool p_compact = false);
+	void _process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, bool p_compact = false);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(NodePath p_path, PathSentCache *psc, int p_from);
+	bool _send_confirm_name(const StringName &p_name, NameSentCache *nsc, PathSentCache *psc, int p_target);
+	void _send_compact_rpc(const NodePath &p_path, PathSentCache *psc, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
+	int _make_compact_rpc_packet(bool p_set, const NodePath &p_path, int p_path_id, bool p_path_confirmed, const StringName &p_name, int p_name_id, bool p_name_confirmed);
 
 public:
 	enum NetworkCommands {
@@ -85,6 +114,18 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_SNAPSHOT,
+		NETWORK_COMMAND_SNAPSHOT_ACK,
+		NETWORK_COMMAND_SIMPLIFY_NAME,
+		NETWORK_COMMAND_CONFIRM_NAME,
+	};
+
+	// Stored in the command byte of compact RPCs.
+	enum NetworkCommandFlags {
+		NETWORK_COMMAND_MASK = 0x1F,
+		NETWORK_COMMAND_FLAG_NAME_ID = 0x20, // Method or property sent as negotiated id instead of name.
+		NETWORK_COMMAND_FLAG_PATH_INLINE = 0x40, // Node path sent in full, not confirmed yet.
+		NETWORK_COMMAND_FLAG_COMPACT = 0x80,
 	};
 
 	enum RPCMode {
@@ -103,6 +144,7 @@ public:
 	void poll();
 	void clear();
 	void set_root_node(Node *p_node);
+	Node *get_root_node() const { return root_node; }
 	void set_network_peer(const Ref<NetworkedMultiplayerPeer> &p_peer);
 	Ref<NetworkedMultiplayerPeer> get_network_peer() const;
 	Error send_bytes(PoolVector<uint8_t> p_data, int p_to = NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST, NetworkedMultiplayerPeer::TransferMode p_mode = NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
@@ -111,6 +153,8 @@ public:
 	void rpcp(Node *p_node, int p_peer_id, bool p_unreliable, const StringName &p_method, const Variant **p_arg, int p_argcount);
 	// Called by Node.rset
 	void rsetp(Node *p_node, int p_peer_id, bool p_unreliable, const StringName &p_property, const Variant &p_value);
+	// Called by MultiplayerReplicator
+	bool can_remote_set(Node *p_node, const StringName &p_property, int p_from) const;
 
 	void _add_peer(int p_id);
 	void _del_peer(int p_id);
@@ -126,6 +170,13 @@ public:
 	void set_refuse_new_network_connections(bool p_refuse);
 	bool is_refusing_new_network_connections() const;
 
+	void set_compact_encoding(bool p_enabled);
+	bool is_compact_encoding_enabled() const;
+	void set_float_quantization(bool p_enabled);
+	bool is_float_quantization_enabled() const;
+
+	MultiplayerReplicator *get_replicator() const { return replicator; }
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
@@ -0,0 +1,1138 @@
+/*************************************************************************/
+/*  multiplayer_replicator.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "multiplayer_replicator.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/multiplayer_api.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/spatial.h"
+
+#define MAX_REPLICATED_PROPERTIES 64
+
+// Bit-level packet writer; values are stored LSB first.
+class SnapshotWriter {
+
+	Vector<uint8_t> &data;
+	uint8_t *ptr;
+	int bit;
+
+public:
+	void put_bits(uint64_t p_value, int p_bits) {
+
+		while (p_bits > 0) {
+
+			int byte = bit >> 3;
+			int used = bit & 7;
+			int count = MIN(8 - used, p_bits);
+
+			if (byte >= data.size()) {
+				data.resize(MAX(byte + 1, data.size() * 2));
+				ptr = data.ptrw();
+			}
+
+			uint8_t chunk = (p_value & ((1 << count) - 1)) << used;
+			if (used == 0) {
+				ptr[byte] = chunk;
+			} else {
+				ptr[byte] |= chunk;
+			}
+
+			p_value >>= count;
+			p_bits -= count;
+			bit += count;
+		}
+	}
+
+	_FORCE_INLINE_ void put_bool(bool p_value) { put_bits(p_value ? 1 : 0, 1); }
+
+	void put_varuint(uint64_t p_value) {
+
+		while (p_value >= 0x80) {
+			put_bits((p_value & 0x7F) | 0x80, 8);
+			p_value >>= 7;
+		}
+		put_bits(p_value, 8);
+	}
+
+	_FORCE_INLINE_ void put_varint(int64_t p_value) { put_varuint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63)); }
+
+	void put_float(float p_value) {
+
+		MarshallFloat mf;
+		mf.f = p_value;
+		put_bits(mf.i, 32);
+	}
+
+	void put_double(double p_value) {
+
+		MarshallDouble md;
+		md.d = p_value;
+		put_bits(md.l, 64);
+	}
+
+	void put_bytes(const uint8_t *p_data, int p_len) {
+
+		for (int i = 0; i < p_len; i++) {
+			put_bits(p_data[i], 8);
+		}
+	}
+
+	void put_string(const String &p_string) {
+
+		CharString cs = p_string.utf8();
+		put_varuint(cs.length());
+		put_bytes((const uint8_t *)cs.get_data(), cs.length());
+	}
+
+	int get_size() const { return (bit + 7) >> 3; }
+
+	SnapshotWriter(Vector<uint8_t> &r_data, int p_byte_offset) :
+			data(r_data) {
+
+		if (data.size() < p_byte_offset + 1) {
+			data.resize(p_byte_offset + 1);
+		}
+		ptr = data.ptrw();
+		bit = p_byte_offset << 3;
+	}
+};
+
+// Bit-level packet reader; reading past the end returns zeros and flags an error.
+class SnapshotReader {
+
+	const uint8_t *data;
+	int bit_count;
+	int bit;
+	bool error;
+
+public:
+	uint64_t get_bits(int p_bits) {
+
+		if (bit + p_bits > bit_count) {
+			error = true;
+			bit = bit_count;
+			return 0;
+		}
+
+		uint64_t value = 0;
+		int shift = 0;
+
+		while (p_bits > 0) {
+
+			int used = bit & 7;
+			int count = MIN(8 - used, p_bits);
+
+			value |= uint64_t((data[bit >> 3] >> used) & ((1 << count) - 1)) << shift;
+
+			shift += count;
+			p_bits -= count;
+			bit += count;
+		}
+
+		return value;
+	}
+
+	_FORCE_INLINE_ bool get_bool() { return get_bits(1) != 0; }
+
+	uint64_t get_varuint() {
+
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint64_t byte = get_bits(8);
+			value |= (byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				return value;
+			}
+		}
+
+		error = true;
+		return 0;
+	}
+
+	_FORCE_INLINE_ int64_t get_varint() {
+
+		uint64_t value = get_varuint();
+		return int64_t(value >> 1) ^ -int64_t(value & 1);
+	}
+
+	float get_float() {
+
+		MarshallFloat mf;
+		mf.i = get_bits(32);
+		return mf.f;
+	}
+
+	double get_double() {
+
+		MarshallDouble md;
+		md.l = get_bits(64);
+		return md.d;
+	}
+
+	bool get_bytes(uint8_t *r_data, int p_len) {
+
+		if (p_len < 0 || bit + p_len * 8 > bit_count) {
+			error = true;
+			bit = bit_count;
+			return false;
+		}
+
+		for (int i = 0; i < p_len; i++) {
+			r_data[i] = get_bits(8);
+		}
+		return true;
+	}
+
+	String get_string() {
+
+		int64_t len = get_varuint();
+		if (len > get_remaining_bytes()) {
+			error = true;
+			return String();
+		}
+
+		CharString cs;
+		cs.resize(len + 1);
+		if (!get_bytes((uint8_t *)cs.ptrw(), len)) {
+			return String();
+		}
+		cs.ptrw()[len] = 0;
+
+		String s;
+		s.parse_utf8(cs.get_data(), len);
+		return s;
+	}
+
+	int get_remaining_bytes() const { return (bit_count - bit) >> 3; }
+
+	bool has_error() const { return error; }
+	void set_error() { error = true; }
+
+	SnapshotReader(const uint8_t *p_data, int p_len) {
+
+		data = p_data;
+		bit_count = p_len << 3;
+		bit = 0;
+		error = false;
+	}
+};
+
+// Types made of floats are sent component by component, so a delta only carries the components that changed.
+
+static _FORCE_INLINE_ bool _float_bits_equal(float p_a, float p_b) {
+
+	MarshallFloat a, b;
+	a.f = p_a;
+	b.f = p_b;
+	return a.i == b.i;
+}
+
+static _FORCE_INLINE_ bool _value_changed(const Variant &p_value, const Variant &p_base) {
+
+	// Variant comparison considers 1 and 1.0 equal, the type must be preserved too
+	return p_value.get_type() != p_base.get_type() || p_value != p_base;
+}
+
+// Snapshot ids are sorted.
+static bool _has_id(const Vector<uint32_t> &p_ids, uint32_t p_id) {
+
+	int low = 0;
+	int high = p_ids.size() - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		if (p_ids[middle] == p_id)
+			return true;
+		if (p_ids[middle] < p_id)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+	return false;
+}
+
+static void _put_value(SnapshotWriter &w, const Variant &p_value, const Variant *p_base) {
+
+	Variant::Type type = p_value.get_type();
+	bool same_type = p_base && p_base->get_type() == type;
+
+	w.put_bits(type, 5);
+
+	switch (type) {
+
+		case Variant::NIL: {
+		} break;
+		case Variant::BOOL: {
+			w.put_bool(p_value);
+		} break;
+		case Variant::INT: {
+			int64_t value = p_value;
+			w.put_varint(same_type ? value - int64_t(*p_base) : value);
+		} break;
+		case Variant::REAL: {
+			double value = p_value;
+			bool wide = double(float(value)) != value;
+			w.put_bool(wide);
+			if (wide) {
+				w.put_double(value);
+			} else {
+				w.put_float(value);
+			}
+		} break;
+		default: {
+
+			float floats[12];
+			int count = variant_get_floats(p_value, floats);
+
+			if (count) {
+
+				float base_floats[12];
+				if (same_type) {
+					variant_get_floats(*p_base, base_floats);
+				}
+
+				for (int i = 0; i < count; i++) {
+					if (same_type) {
+						bool changed = !_float_bits_equal(floats[i], base_floats[i]);
+						w.put_bool(changed);
+						if (!changed)
+							continue;
+					}
+					w.put_float(floats[i]);
+				}
+
+			} else {
+
+				int len;
+				Error err = encode_variant(p_value, NULL, len);
+				ERR_FAIL_COND(err != OK);
+
+				Vector<uint8_t> buf;
+				buf.resize(len);
+				encode_variant(p_value, buf.ptrw(), len);
+
+				w.put_varuint(len);
+				w.put_bytes(buf.ptr(), len);
+			}
+		}
+	}
+}
+
+static Variant _get_value(SnapshotReader &r, const Variant *p_base) {
+
+	Variant::Type type = Variant::Type(r.get_bits(5));
+	bool same_type = p_base && p_base->get_type() == type;
+
+	switch (type) {
+
+		case Variant::NIL: {
+			return Variant();
+		}
+		case Variant::BOOL: {
+			return r.get_bool();
+		}
+		case Variant::INT: {
+			int64_t value = r.get_varint();
+			return same_type ? value + int64_t(*p_base) : value;
+		}
+		case Variant::REAL: {
+			return r.get_bool() ? r.get_double() : double(r.get_float());
+		}
+		default: {
+		}
+	}
+
+	int count = variant_get_float_count(type);
+
+	if (count) {
+
+		float floats[12];
+		if (same_type) {
+			variant_get_floats(*p_base, floats);
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (!same_type || r.get_bool()) {
+				floats[i] = r.get_float();
+			}
+		}
+
+		return variant_from_floats(type, floats);
+	}
+
+	int64_t len = r.get_varuint();
+	if (len > r.get_remaining_bytes()) {
+		r.set_error();
+		return Variant();
+	}
+
+	Vector<uint8_t> buf;
+	buf.resize(len);
+	if (!len || !r.get_bytes(buf.ptrw(), len)) {
+		return Variant();
+	}
+
+	Variant value;
+	Error err = decode_variant(value, buf.ptr(), len, NULL, false);
+	if (err != OK) {
+		return Variant();
+	}
+
+	return value;
+}
+
+/* Server */
+
+void MultiplayerReplicator::add_node(Node *p_node, const PoolStringArray &p_properties, const StringName &p_group) {
+
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND(p_properties.size() == 0);
+	ERR_EXPLAIN("Too many replicated properties, the maximum per node is " + itos(MAX_REPLICATED_PROPERTIES) + ".");
+	ERR_FAIL_COND(p_properties.size() > MAX_REPLICATED_PROPERTIES);
+
+	// a node registered again gets a new id, so peers receive the new property list
+	remove_node(p_node);
+
+	Entity entity;
+	entity.instance = p_node->get_instance_id();
+	entity.group = p_group;
+	for (int i = 0; i < p_properties.size(); i++) {
+		entity.properties.push_back(p_properties[i]);
+	}
+
+	uint32_t id = ++last_entity_id;
+	entities[id] = entity;
+	entity_ids[entity.instance] = id;
+}
+
+void MultiplayerReplicator::remove_node(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	Map<ObjectID, uint32_t>::Element *E = entity_ids.find(p_node->get_instance_id());
+	if (!E)
+		return;
+
+	entities.erase(E->get());
+	entity_ids.erase(E);
+}
+
+bool MultiplayerReplicator::has_node(Node *p_node) const {
+
+	ERR_FAIL_NULL_V(p_node, false);
+
+	return entity_ids.has(p_node->get_instance_id());
+}
+
+void MultiplayerReplicator::set_tick_rate(int p_rate) {
+
+	ERR_FAIL_COND(p_rate < 0);
+	tick_rate = p_rate;
+	next_tick_usec = 0;
+}
+
+int MultiplayerReplicator::get_tick_rate() const {
+
+	return tick_rate;
+}
+
+void MultiplayerReplicator::set_interest_radius(float p_radius) {
+
+	ERR_FAIL_COND(p_radius < 0);
+	interest_radius = p_radius;
+}
+
+float MultiplayerReplicator::get_interest_radius() const {
+
+	return interest_radius;
+}
+
+void MultiplayerReplicator::set_peer_origin(int p_peer, const Vector3 &p_origin) {
+
+	Map<int, PeerState>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND(!E);
+
+	E->get().has_origin = true;
+	E->get().origin = p_origin;
+}
+
+void MultiplayerReplicator::set_peer_groups(int p_peer, const PoolStringArray &p_groups) {
+
+	Map<int, PeerState>::Element *E = peers.find(p_peer);
+	ERR_FAIL_COND(!E);
+
+	E->get().groups.clear();
+	for (int i = 0; i < p_groups.size(); i++) {
+		E->get().groups.insert(p_groups[i]);
+	}
+}
+
+void MultiplayerReplicator::_sample(Snapshot &r_snapshot, const Snapshot &p_previous, Vector<Interest> &r_interest) {
+
+	r_snapshot.tick = tick;
+	r_snapshot.ids.resize(entities.size());
+	r_snapshot.values.resize(entities.size());
+	r_interest.resize(entities.size());
+
+	uint32_t *ids = r_snapshot.ids.ptrw();
+	Vector<Variant> *values = r_snapshot.values.ptrw();
+	Interest *interest = r_interest.ptrw();
+
+	int count = 0;
+	int previous = 0;
+	List<uint32_t> freed;
+
+	for (Map<uint32_t, Entity>::Element *E = entities.front(); E; E = E->next()) {
+
+		const Entity &entity = E->get();
+
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(entity.instance));
+		if (!node) {
+			freed.push_back(E->key());
+			continue;
+		}
+
+		Vector<Variant> sampled;
+		sampled.resize(entity.properties.size());
+		for (int i = 0; i < entity.properties.size(); i++) {
+			sampled.write[i] = node->get(entity.properties[i]);
+		}
+
+		// unchanged entities share the previous tick's values, which also lets sending skip them cheaply
+		while (previous < p_previous.ids.size() && p_previous.ids[previous] < E->key()) {
+			previous++;
+		}
+
+		if (previous < p_previous.ids.size() && p_previous.ids[previous] == E->key()) {
+
+			const Vector<Variant> &old = p_previous.values[previous];
+			bool changed = old.size() != sampled.size();
+			for (int i = 0; i < sampled.size() && !changed; i++) {
+				changed = _value_changed(sampled[i], old[i]);
+			}
+
+			if (!changed) {
+				sampled = old;
+			}
+		}
+
+		ids[count] = E->key();
+		values[count] = sampled;
+
+		Interest &ei = interest[count];
+		ei.group = entity.group;
+		ei.positioned = false;
+
+		if (interest_radius > 0 && node->is_inside_tree()) {
+
+			Spatial *spatial = Object::cast_to<Spatial>(node);
+			Node2D *node_2d = Object::cast_to<Node2D>(node);
+
+			if (spatial) {
+				ei.position = spatial->get_global_transform().origin;
+				ei.positioned = true;
+			} else if (node_2d) {
+				Vector2 position = node_2d->get_global_position();
+				ei.position = Vector3(position.x, position.y, 0);
+				ei.positioned = true;
+			}
+		}
+
+		count++;
+	}
+
+	r_snapshot.ids.resize(count);
+	r_snapshot.values.resize(count);
+	r_interest.resize(count);
+
+	for (List<uint32_t>::Element *E = freed.front(); E; E = E->next()) {
+
+		Map<uint32_t, Entity>::Element *F = entities.find(E->get());
+		entity_ids.erase(F->get().instance);
+		entities.erase(F);
+	}
+}
+
+void MultiplayerReplicator::_send_to_peer(int p_peer, PeerState &r_peer, const Snapshot &p_snapshot, const Vector<Interest> &p_interest) {
+
+	Ref<NetworkedMultiplayerPeer> network_peer = multiplayer->get_network_peer();
+	Node *root_node = multiplayer->get_root_node();
+
+	// interest management
+
+	Vector<uint32_t> visible;
+	Vector<int> visible_index;
+	visible.resize(p_snapshot.ids.size());
+	visible_index.resize(p_snapshot.ids.size());
+
+	real_t radius_squared = interest_radius * interest_radius;
+	int visible_count = 0;
+
+	for (int i = 0; i < p_snapshot.ids.size(); i++) {
+
+		const Interest &ei = p_interest[i];
+
+		if (ei.group != StringName() && !r_peer.groups.has(ei.group))
+			continue;
+		if (interest_radius > 0 && r_peer.has_origin && ei.positioned && r_peer.origin.distance_squared_to(ei.position) > radius_squared)
+			continue;
+
+		visible.write[visible_count] = p_snapshot.ids[i];
+		visible_index.write[visible_count] = i;
+		visible_count++;
+	}
+
+	visible.resize(visible_count);
+
+	// the baseline is the newest snapshot the peer acknowledged, as long as it is still in the history
+
+	uint32_t base_tick = 0;
+	const Snapshot *base = NULL;
+	const Vector<uint32_t> *base_ids = NULL;
+
+	if (r_peer.acked_tick && tick - r_peer.acked_tick < SNAPSHOT_HISTORY) {
+
+		int slot = r_peer.acked_tick % SNAPSHOT_HISTORY;
+		if (history[slot].tick == r_peer.acked_tick && r_peer.sent_ticks[slot] == r_peer.acked_tick) {
+			base_tick = r_peer.acked_tick;
+			base = &history[slot];
+			base_ids = &r_peer.sent_ids[slot];
+		}
+	}
+
+	packet_cache.resize(MAX(packet_cache.size(), 1));
+	packet_cache.write[0] = MultiplayerAPI::NETWORK_COMMAND_SNAPSHOT;
+
+	SnapshotWriter w(packet_cache, 1);
+	w.put_bits(tick, 32);
+	w.put_bits(base_tick, 32);
+
+	// entities the peer no longer sees, gap coded
+
+	{
+		int removed_count = 0;
+		if (base_ids) {
+			for (int i = 0, j = 0; i < base_ids->size(); i++) {
+				while (j < visible_count && visible[j] < (*base_ids)[i]) {
+					j++;
+				}
+				if (j >= visible_count || visible[j] != (*base_ids)[i]) {
+					removed_count++;
+				}
+			}
+		}
+
+		w.put_varuint(removed_count);
+
+		if (removed_count) {
+			uint32_t prev_id = 0;
+			for (int i = 0, j = 0; i < base_ids->size(); i++) {
+				uint32_t id = (*base_ids)[i];
+				while (j < visible_count && visible[j] < id) {
+					j++;
+				}
+				if (j >= visible_count || visible[j] != id) {
+					w.put_varuint(id - prev_id);
+					prev_id = id;
+				}
+			}
+		}
+	}
+
+	// new and changed entities, gap coded and terminated by a zero gap
+
+	uint32_t prev_id = 0;
+	int base_index = 0;
+	int base_sent_index = 0;
+
+	for (int i = 0; i < visible_count; i++) {
+
+		uint32_t id = visible[i];
+		const Vector<Variant> &values = p_snapshot.values[visible_index[i]];
+		const Vector<Variant> *base_values = NULL;
+
+		if (base) {
+
+			while (base_sent_index < base_ids->size() && (*base_ids)[base_sent_index] < id) {
+				base_sent_index++;
+			}
+
+			if (base_sent_index < base_ids->size() && (*base_ids)[base_sent_index] == id) {
+
+				while (base_index < base->ids.size() && base->ids[base_index] < id) {
+					base_index++;
+				}
+
+				if (base_index < base->ids.size() && base->ids[base_index] == id) {
+					base_values = &base->values[base_index];
+				}
+			}
+		}
+
+		if (base_values) {
+
+			if (base_values->ptr() == values.ptr())
+				continue; // shared, so unchanged since the baseline
+
+			bool changed = false;
+			for (int j = 0; j < values.size() && !changed; j++) {
+				changed = _value_changed(values[j], (*base_values)[j]);
+			}
+
+			if (!changed)
+				continue;
+		}
+
+		w.put_varuint(id - prev_id);
+		prev_id = id;
+		w.put_bool(base_values == NULL);
+
+		if (base_values) {
+
+			for (int j = 0; j < values.size(); j++) {
+
+				bool changed = _value_changed(values[j], (*base_values)[j]);
+				w.put_bool(changed);
+				if (changed) {
+					_put_value(w, values[j], &(*base_values)[j]);
+				}
+			}
+
+		} else {
+
+			const Entity &entity = entities[id];
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(entity.instance));
+
+			w.put_string(root_node && node ? String(root_node->get_path_to(node)) : String());
+			w.put_varuint(entity.properties.size());
+			for (int j = 0; j < entity.properties.size(); j++) {
+				w.put_string(entity.properties[j]);
+			}
+
+			for (int j = 0; j < values.size(); j++) {
+				_put_value(w, values[j], NULL);
+			}
+		}
+	}
+
+	w.put_varuint(0);
+
+	int slot = tick % SNAPSHOT_HISTORY;
+	r_peer.sent_ticks[slot] = tick;
+	r_peer.sent_ids[slot] = visible;
+
+	int size = w.get_size();
+
+	network_peer->set_target_peer(p_peer);
+	network_peer->put_packet(packet_cache.ptr(), size);
+
+	last_tick_sent_bytes += size;
+}
+
+void MultiplayerReplicator::send_snapshot() {
+
+	ERR_FAIL_NULL(multiplayer);
+
+	Ref<NetworkedMultiplayerPeer> network_peer = multiplayer->get_network_peer();
+	if (network_peer.is_null() || network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED || !network_peer->is_server())
+		return;
+
+	tick++;
+
+	Snapshot &snapshot = history[tick % SNAPSHOT_HISTORY];
+	const Snapshot &previous = history[(tick - 1) % SNAPSHOT_HISTORY];
+
+	Vector<Interest> interest;
+	_sample(snapshot, previous, interest);
+
+	last_tick_sent_bytes = 0;
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+
+	for (Map<int, PeerState>::Element *E = peers.front(); E; E = E->next()) {
+		_send_to_peer(E->key(), E->get(), snapshot, interest);
+	}
+
+	sent_bytes += last_tick_sent_bytes;
+}
+
+void MultiplayerReplicator::process_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 5);
+
+	Map<int, PeerState>::Element *E = peers.find(p_from);
+	if (!E)
+		return;
+
+	PeerState &peer = E->get();
+	uint32_t acked = decode_uint32(&p_packet[1]);
+
+	if (acked > peer.acked_tick && peer.sent_ticks[acked % SNAPSHOT_HISTORY] == acked) {
+		peer.acked_tick = acked;
+	}
+}
+
+void MultiplayerReplicator::poll() {
+
+	if (tick_rate <= 0 || entities.empty())
+		return;
+
+	Ref<NetworkedMultiplayerPeer> network_peer = multiplayer->get_network_peer();
+	if (network_peer.is_null() || !network_peer->is_server())
+		return;
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+	uint64_t interval = 1000000 / tick_rate;
+
+	if (next_tick_usec == 0) {
+		next_tick_usec = now;
+	}
+
+	if (now < next_tick_usec)
+		return;
+
+	// stay on the tick grid, ticks missed during a long frame are skipped rather than sent in a burst
+	next_tick_usec += interval * ((now - next_tick_usec) / interval + 1);
+
+	send_snapshot();
+}
+
+/* Client */
+
+Node *MultiplayerReplicator::_get_remote_node(Entity &r_entity) {
+
+	Node *node = Object::cast_to<Node>(ObjectDB::get_instance(r_entity.instance));
+	if (node)
+		return node;
+
+	Node *root_node = multiplayer->get_root_node();
+	if (!root_node || r_entity.path.is_empty() || !root_node->has_node(r_entity.path))
+		return NULL;
+
+	node = root_node->get_node(r_entity.path);
+	r_entity.instance = node->get_instance_id();
+	return node;
+}
+
+void MultiplayerReplicator::_prune_remote_entities(const Snapshot &p_snapshot) {
+
+	// A removed entity can still be updated by a later snapshot that deltas against an older
+	// baseline containing it, so it is only forgotten once no received snapshot has it.
+	for (Set<uint32_t>::Element *E = removed_remote_entities.front(); E;) {
+
+		Set<uint32_t>::Element *N = E->next();
+		uint32_t id = E->get();
+
+		if (_has_id(p_snapshot.ids, id)) {
+			removed_remote_entities.erase(E); // visible again
+			E = N;
+			continue;
+		}
+
+		bool referenced = false;
+		for (int i = 0; i < SNAPSHOT_HISTORY; i++) {
+			if (received[i].tick && _has_id(received[i].ids, id)) {
+				referenced = true;
+				break;
+			}
+		}
+
+		if (!referenced) {
+			remote_entities.erase(id);
+			removed_remote_entities.erase(E);
+		}
+
+		E = N;
+	}
+}
+
+void MultiplayerReplicator::process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Snapshots are only accepted from the server.");
+	ERR_FAIL_COND(p_from != 1);
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 10);
+
+	SnapshotReader r(&p_packet[1], p_packet_len - 1);
+
+	uint32_t snapshot_tick = r.get_bits(32);
+	uint32_t base_tick = r.get_bits(32);
+
+	if (snapshot_tick <= last_received_tick)
+		return; // late or duplicated, a newer state was applied already
+
+	const Snapshot *base = NULL;
+	if (base_tick) {
+		base = &received[base_tick % SNAPSHOT_HISTORY];
+		ERR_EXPLAIN("Invalid packet received. Snapshot baseline " + itos(base_tick) + " is not known.");
+		ERR_FAIL_COND(base->tick != base_tick);
+	}
+
+	Vector<uint32_t> removed;
+	{
+		int removed_count = r.get_varuint();
+		ERR_EXPLAIN("Invalid packet received. Size smaller than declared.");
+		ERR_FAIL_COND(removed_count > r.get_remaining_bytes());
+
+		uint32_t id = 0;
+		for (int i = 0; i < removed_count; i++) {
+			id += r.get_varuint();
+			removed.push_back(id);
+		}
+	}
+
+	// rebuild the full state: baseline entities, minus the removed ones, with updates applied
+
+	Snapshot snapshot;
+	snapshot.tick = snapshot_tick;
+
+	struct Update {
+		int index;
+		uint64_t changed;
+	};
+
+	Vector<Update> updates;
+
+	int base_index = 0;
+	int removed_index = 0;
+	uint32_t id = 0;
+
+	while (!r.has_error()) {
+
+		uint32_t gap = r.get_varuint();
+		uint32_t next_id = gap ? id + gap : 0xFFFFFFFF;
+
+		// keep baseline entities up to this one
+		while (base && base_index < base->ids.size() && base->ids[base_index] < next_id) {
+
+			uint32_t base_id = base->ids[base_index];
+			while (removed_index < removed.size() && removed[removed_index] < base_id) {
+				removed_index++;
+			}
+
+			if (removed_index >= removed.size() || removed[removed_index] != base_id) {
+				snapshot.ids.push_back(base_id);
+				snapshot.values.push_back(base->values[base_index]);
+			}
+
+			base_index++;
+		}
+
+		if (!gap)
+			break;
+
+		id = next_id;
+
+		const Vector<Variant> *base_values = NULL;
+		if (base && base_index < base->ids.size() && base->ids[base_index] == id) {
+			base_values = &base->values[base_index];
+			base_index++;
+		}
+
+		bool is_new = r.get_bool();
+		Vector<Variant> values;
+		Update update;
+		update.changed = 0;
+
+		if (is_new) {
+
+			Entity entity;
+			entity.path = r.get_string();
+
+			int property_count = r.get_varuint();
+			ERR_EXPLAIN("Invalid packet received. Too many replicated properties.");
+			ERR_FAIL_COND(property_count > MAX_REPLICATED_PROPERTIES);
+
+			for (int i = 0; i < property_count; i++) {
+				entity.properties.push_back(r.get_string());
+			}
+
+			values.resize(property_count);
+			for (int i = 0; i < property_count; i++) {
+				values.write[i] = _get_value(r, NULL);
+				update.changed |= uint64_t(1) << i;
+			}
+
+			remote_entities[id] = entity;
+
+		} else {
+
+			ERR_EXPLAIN("Invalid packet received. Snapshot updates an entity missing from its baseline.");
+			ERR_FAIL_COND(!base_values);
+
+			values = *base_values;
+			for (int i = 0; i < values.size(); i++) {
+				if (r.get_bool()) {
+					values.write[i] = _get_value(r, &(*base_values)[i]);
+					update.changed |= uint64_t(1) << i;
+				}
+			}
+		}
+
+		update.index = snapshot.ids.size();
+		updates.push_back(update);
+
+		snapshot.ids.push_back(id);
+		snapshot.values.push_back(values);
+	}
+
+	ERR_EXPLAIN("Invalid packet received. Unable to decode snapshot.");
+	ERR_FAIL_COND(r.has_error());
+
+	received[snapshot_tick % SNAPSHOT_HISTORY] = snapshot;
+	last_received_tick = snapshot_tick;
+
+	if (base) {
+		for (int i = 0; i < removed.size(); i++) {
+			removed_remote_entities.insert(removed[i]);
+		}
+	} else {
+		// a snapshot without baseline replaces everything known before
+		for (Map<uint32_t, Entity>::Element *E = remote_entities.front(); E; E = E->next()) {
+			if (!_has_id(snapshot.ids, E->key())) {
+				removed_remote_entities.insert(E->key());
+			}
+		}
+	}
+	_prune_remote_entities(snapshot);
+
+	for (int i = 0; i < updates.size(); i++) {
+
+		const Update &update = updates[i];
+		Map<uint32_t, Entity>::Element *E = remote_entities.find(snapshot.ids[update.index]);
+		if (!E)
+			continue;
+
+		Node *node = _get_remote_node(E->get());
+		if (!node)
+			continue;
+
+		Entity &entity = E->get();
+		const Vector<Variant> &values = snapshot.values[update.index];
+		for (int j = 0; j < values.size(); j++) {
+
+			uint64_t bit = uint64_t(1) << j;
+			if (!(update.changed & bit))
+				continue;
+
+			// the server may only change what the client allows, same as with rset()
+			if (!multiplayer->can_remote_set(node, entity.properties[j], p_from)) {
+				if (!(entity.rejected & bit)) {
+					entity.rejected |= bit;
+					ERR_PRINTS("Replicated property '" + String(entity.properties[j]) + "' of node '" + String(entity.path) + "' is not allowed from: " + itos(p_from) + ", see rset_config().");
+				}
+				continue;
+			}
+
+			node->set(entity.properties[j], values[j]);
+		}
+	}
+
+	uint8_t ack[5];
+	ack[0] = MultiplayerAPI::NETWORK_COMMAND_SNAPSHOT_ACK;
+	encode_uint32(snapshot_tick, &ack[1]);
+
+	Ref<NetworkedMultiplayerPeer> network_peer = multiplayer->get_network_peer();
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_from);
+	network_peer->put_packet(ack, 5);
+
+	emit_signal("snapshot_received", snapshot_tick);
+}
+
+/* Shared */
+
+void MultiplayerReplicator::add_peer(int p_peer) {
+
+	peers[p_peer] = PeerState();
+}
+
+void MultiplayerReplicator::del_peer(int p_peer) {
+
+	peers.erase(p_peer);
+}
+
+void MultiplayerReplicator::clear() {
+
+	tick = 0;
+	next_tick_usec = 0;
+	for (int i = 0; i < SNAPSHOT_HISTORY; i++) {
+		history[i] = Snapshot();
+		received[i] = Snapshot();
+	}
+	peers.clear();
+	packet_cache.clear();
+	remote_entities.clear();
+	removed_remote_entities.clear();
+	last_received_tick = 0;
+	sent_bytes = 0;
+	last_tick_sent_bytes = 0;
+}
+
+void MultiplayerReplicator::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add_node", "node", "properties", "group"), &MultiplayerReplicator::add_node, DEFVAL(StringName()));
+	ClassDB::bind_method(D_METHOD("remove_node", "node"), &MultiplayerReplicator::remove_node);
+	ClassDB::bind_method(D_METHOD("has_node", "node"), &MultiplayerReplicator::has_node);
+
+	ClassDB::bind_method(D_METHOD("set_tick_rate", "rate"), &MultiplayerReplicator::set_tick_rate);
+	ClassDB::bind_method(D_METHOD("get_tick_rate"), &MultiplayerReplicator::get_tick_rate);
+	ClassDB::bind_method(D_METHOD("set_interest_radius", "radius"), &MultiplayerReplicator::set_interest_radius);
+	ClassDB::bind_method(D_METHOD("get_interest_radius"), &MultiplayerReplicator::get_interest_radius);
+
+	ClassDB::bind_method(D_METHOD("set_peer_origin", "peer", "origin"), &MultiplayerReplicator::set_peer_origin);
+	ClassDB::bind_method(D_METHOD("set_peer_groups", "peer", "groups"), &MultiplayerReplicator::set_peer_groups);
+
+	ClassDB::bind_method(D_METHOD("send_snapshot"), &MultiplayerReplicator::send_snapshot);
+	ClassDB::bind_method(D_METHOD("get_tick"), &MultiplayerReplicator::get_tick);
+	ClassDB::bind_method(D_METHOD("get_last_received_tick"), &MultiplayerReplicator::get_last_received_tick);
+	ClassDB::bind_method(D_METHOD("get_sent_bytes"), &MultiplayerReplicator::get_sent_bytes);
+	ClassDB::bind_method(D_METHOD("get_last_tick_sent_bytes"), &MultiplayerReplicator::get_last_tick_sent_bytes);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tick_rate", PROPERTY_HINT_RANGE, "0,120,1"), "set_tick_rate", "get_tick_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "interest_radius", PROPERTY_HINT_RANGE, "0,4096,0.1,or_greater"), "set_interest_radius", "get_interest_radius");
+
+	ADD_SIGNAL(MethodInfo("snapshot_received", PropertyInfo(Variant::INT, "tick")));
+}
+
+MultiplayerReplicator::MultiplayerReplicator(MultiplayerAPI *p_multiplayer) {
+
+	multiplayer = p_multiplayer;
+	tick_rate = 30;
+	interest_radius = 0;
+	next_tick_usec = 0;
+	tick = 0;
+	last_entity_id = 0;
+	sent_bytes = 0;
+	last_tick_sent_bytes = 0;
+	last_received_tick = 0;
+}
@@ -0,0 +1,159 @@
+/*************************************************************************/
+/*  multiplayer_replicator.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MULTIPLAYER_REPLICATOR_H
+#define MULTIPLAYER_REPLICATOR_H
+
+#include "core/object.h"
+
+class MultiplayerAPI;
+class Node;
+
+// Snapshot replication: the server samples the properties of registered nodes once per tick and
+// sends each peer a bit-packed delta against the last snapshot that peer acknowledged.
+class MultiplayerReplicator : public Object {
+
+	GDCLASS(MultiplayerReplicator, Object);
+
+public:
+	enum {
+		SNAPSHOT_HISTORY = 32, // snapshots kept to delta against, per side
+	};
+
+private:
+	struct Entity {
+		ObjectID instance;
+		NodePath path;
+		Vector<StringName> properties;
+		StringName group;
+		uint64_t rejected; // client side, properties already reported as not allowed by rset_config()
+
+		Entity() {
+			instance = 0;
+			rejected = 0;
+		}
+	};
+
+	// Values of every visible entity at one tick, sorted by entity id.
+	struct Snapshot {
+		uint32_t tick;
+		Vector<uint32_t> ids;
+		Vector<Vector<Variant> > values;
+
+		Snapshot() { tick = 0; }
+	};
+
+	struct Interest {
+		StringName group;
+		Vector3 position;
+		bool positioned;
+	};
+
+	struct PeerState {
+		uint32_t acked_tick;
+		bool has_origin;
+		Vector3 origin;
+		Set<StringName> groups;
+		uint32_t sent_ticks[SNAPSHOT_HISTORY];
+		Vector<uint32_t> sent_ids[SNAPSHOT_HISTORY]; // entities each sent snapshot contained
+
+		PeerState() {
+			acked_tick = 0;
+			has_origin = false;
+			for (int i = 0; i < SNAPSHOT_HISTORY; i++) {
+				sent_ticks[i] = 0;
+			}
+		}
+	};
+
+	MultiplayerAPI *multiplayer;
+
+	int tick_rate;
+	float interest_radius;
+	uint64_t next_tick_usec;
+
+	// server side
+	uint32_t tick;
+	uint32_t last_entity_id;
+	Map<uint32_t, Entity> entities;
+	Map<ObjectID, uint32_t> entity_ids;
+	Snapshot history[SNAPSHOT_HISTORY];
+	Map<int, PeerState> peers;
+	Vector<uint8_t> packet_cache;
+	uint64_t sent_bytes;
+	int last_tick_sent_bytes;
+
+	// client side
+	Map<uint32_t, Entity> remote_entities;
+	Set<uint32_t> removed_remote_entities; // still in remote_entities until no baseline refers to them
+	Snapshot received[SNAPSHOT_HISTORY];
+	uint32_t last_received_tick;
+
+	void _sample(Snapshot &r_snapshot, const Snapshot &p_previous, Vector<Interest> &r_interest);
+	void _send_to_peer(int p_peer, PeerState &r_peer, const Snapshot &p_snapshot, const Vector<Interest> &p_interest);
+	Node *_get_remote_node(Entity &r_entity);
+	void _prune_remote_entities(const Snapshot &p_snapshot);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void add_node(Node *p_node, const PoolStringArray &p_properties, const StringName &p_group = StringName());
+	void remove_node(Node *p_node);
+	bool has_node(Node *p_node) const;
+
+	void set_tick_rate(int p_rate);
+	int get_tick_rate() const;
+
+	void set_interest_radius(float p_radius);
+	float get_interest_radius() const;
+
+	void set_peer_origin(int p_peer, const Vector3 &p_origin);
+	void set_peer_groups(int p_peer, const PoolStringArray &p_groups);
+
+	void send_snapshot();
+	uint32_t get_tick() const { return tick; }
+	uint32_t get_last_received_tick() const { return last_received_tick; }
+
+	uint64_t get_sent_bytes() const { return sent_bytes; }
+	int get_last_tick_sent_bytes() const { return last_tick_sent_bytes; }
+
+	// Called by MultiplayerAPI
+	void poll();
+	void clear();
+	void add_peer(int p_peer);
+	void del_peer(int p_peer);
+	void process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void process_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+	MultiplayerReplicator(MultiplayerAPI *p_multiplayer = NULL);
+};
+
+#endif // MULTIPLAYER_REPLICATOR_H
@@ -67,5 +67,17 @@ void NetworkedMultiplayerPeer::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("connection_failed"));
 }
 
+int NetworkedMultiplayerPeer::get_packet_batch(PacketInfo *r_packets, int p_max) {
+
+	if (p_max < 1 || get_available_packet_count() == 0)
+		return 0;
+
+	r_packets[0].from = get_packet_peer();
+	Error err = get_packet(&r_packets[0].buffer, r_packets[0].size);
+	ERR_FAIL_COND_V(err != OK, 0);
+
+	return 1;
+}
+
 NetworkedMultiplayerPeer::NetworkedMultiplayerPeer() {
 }
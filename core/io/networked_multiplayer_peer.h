@@ -74,6 +74,16 @@ public:
 
 	virtual ConnectionStatus get_connection_status() const = 0;
 
+	struct PacketInfo {
+		const uint8_t *buffer;
+		int size;
+		int from;
+	};
+
+	// Returns up to p_max packets at once. Buffers stay valid until the next call to get_packet_batch, get_packet or poll.
+	// The default implementation hands out one packet per call.
+	virtual int get_packet_batch(PacketInfo *r_packets, int p_max);
+
 	NetworkedMultiplayerPeer();
 };
 
@@ -111,9 +111,14 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 		}
 		if (len == 0)
 			return StringName();
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
-		s.parse_utf8(&str_buf[0]);
+		const uint8_t *mapped = f->get_buffer_ptr(len);
+		if (mapped) {
+			s.parse_utf8((const char *)mapped, len);
+		} else {
+			f->get_buffer((uint8_t *)&str_buf[0], len);
+			s.parse_utf8(&str_buf[0]);
+		}
 		return s;
 	}
 
@@ -593,22 +598,30 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 
 			} else {
 				//compressed
-				PoolVector<uint8_t> data;
-				data.resize(f->get_32());
-				PoolVector<uint8_t>::Write w = data.write();
-				f->get_buffer(w.ptr(), data.size());
-				w = PoolVector<uint8_t>::Write();
+				uint32_t datalen = f->get_32();
 
 				Ref<Image> image;
 
-				if (encoding == IMAGE_ENCODING_LOSSY && Image::lossy_unpacker) {
+				const uint8_t *mapped = f->get_buffer_ptr(datalen);
+				if (mapped) {
+					// decode straight from the file data, e.g. a memory mapped pack
+					image = Image::unpack_from_memory(mapped, datalen, encoding == IMAGE_ENCODING_LOSSY);
+				} else {
+					PoolVector<uint8_t> data;
+					data.resize(datalen);
+					PoolVector<uint8_t>::Write w = data.write();
+					f->get_buffer(w.ptr(), data.size());
+					w = PoolVector<uint8_t>::Write();
+
+					if (encoding == IMAGE_ENCODING_LOSSY && Image::lossy_unpacker) {
 
-					image = Image::lossy_unpacker(data);
-				} else if (encoding == IMAGE_ENCODING_LOSSLESS && Image::lossless_unpacker) {
+						image = Image::lossy_unpacker(data);
+					} else if (encoding == IMAGE_ENCODING_LOSSLESS && Image::lossless_unpacker) {
 
-					image = Image::lossless_unpacker(data);
+						image = Image::lossless_unpacker(data);
+					}
 				}
-				_advance_padding(data.size());
+				_advance_padding(datalen);
 
 				r_v = image;
 			}
@@ -809,9 +822,14 @@ String ResourceInteractiveLoaderBinary::get_unicode_string() {
 	}
 	if (len == 0)
 		return String();
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
-	s.parse_utf8(&str_buf[0]);
+	const uint8_t *mapped = f->get_buffer_ptr(len);
+	if (mapped) {
+		s.parse_utf8((const char *)mapped, len);
+	} else {
+		f->get_buffer((uint8_t *)&str_buf[0], len);
+		s.parse_utf8(&str_buf[0]);
+	}
 	return s;
 }
 
@@ -33,6 +33,7 @@
 #include "core/io/resource_import.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/path_remap.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
@@ -319,38 +320,119 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 		}
 	}
 
+	if (!p_no_cache && thread_load_mutex) {
+
+		thread_load_mutex->lock();
+
+		ThreadLoadTask **taskp = thread_load_tasks.getptr(local_path);
+		if (!taskp) {
+
+			RES cached = _get_cached(local_path); //may have finished loading in another thread meanwhile
+			if (cached.is_valid()) {
+				thread_load_mutex->unlock();
+				if (r_error)
+					*r_error = OK;
+				return cached;
+			}
+
+			// Register the load, so threaded requests for the same path wait for it instead of loading it again.
+			ThreadLoadTask *task = memnew(ThreadLoadTask);
+			task->local_path = local_path;
+			task->type_hint = p_type_hint;
+			task->order = thread_load_order++;
+			task->dependencies_scanned = true;
+			task->refcount = 1;
+			thread_load_tasks.set(local_path, task);
+			ThreadLoadTask *previous = _thread_load_begin(task);
+			thread_load_mutex->unlock();
+
+			Error err = OK;
+			RES res = _load_local(local_path, p_path, p_type_hint, p_no_cache, &err);
+			if (r_error)
+				*r_error = err;
+
+			thread_load_mutex->lock();
+			_thread_load_end(task, previous, res, err);
+			_thread_load_release(task);
+			thread_load_mutex->unlock();
+
+			return res;
+		}
+
+		ThreadLoadTask *task = *taskp;
+		Thread::ID caller = Thread::get_caller_id();
+		ThreadLoadTask **currentp = thread_load_current.getptr(caller);
+		ThreadLoadTask *current = currentp ? *currentp : NULL;
+
+		// Waiting would deadlock if this thread is the one loading it, or if it waits
+		// on the resource being loaded here (a cycle); load it here like before then.
+		bool deadlock = (task->loading && task->loader_thread == caller) || (current && _thread_load_depends_on(task, current));
+		if (deadlock) {
+			thread_load_mutex->unlock();
+			return _load_local(local_path, p_path, p_type_hint, p_no_cache, r_error);
+		}
+
+		// Already being loaded, wait for it instead of loading it twice.
+		task->refcount++;
+		if (current)
+			current->waiting_for = task;
+		_thread_load_wait(task);
+		if (current)
+			current->waiting_for = NULL;
+
+		RES res = task->resource;
+		if (r_error)
+			*r_error = task->error;
+		_thread_load_release(task);
+		thread_load_mutex->unlock();
+
+		if (res.is_valid())
+			return res;
+		// Failed in another thread, try again here so errors are reported to this caller.
+	}
+
+	return _load_local(local_path, p_path, p_type_hint, p_no_cache, r_error);
+}
+
+RES ResourceLoader::_load_local(const String &p_local_path, const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
+
 	bool xl_remapped = false;
-	String path = _path_remap(local_path, &xl_remapped);
+	String path = _path_remap(p_local_path, &xl_remapped);
 
 	ERR_FAIL_COND_V(path == "", RES());
 
 	print_verbose("Loading resource: " + path);
-	RES res = _load(path, local_path, p_type_hint, p_no_cache, r_error);
+	RES res = _load(path, p_local_path, p_type_hint, p_no_cache, r_error);
 
 	if (res.is_null()) {
 		return RES();
 	}
 	if (!p_no_cache)
-		res->set_path(local_path);
+		res->set_path(p_local_path);
 
 	if (xl_remapped)
 		res->set_as_translation_remapped(true);
 
+	_resource_loaded(res, path, p_path);
+
+	return res;
+}
+
+void ResourceLoader::_resource_loaded(RES &p_resource, const String &p_remapped_path, const String &p_path) {
+
 #ifdef TOOLS_ENABLED
 
-	res->set_edited(false);
+	p_resource->set_edited(false);
 	if (timestamp_on_load) {
-		uint64_t mt = FileAccess::get_modified_time(path);
+		uint64_t mt = FileAccess::get_modified_time(p_remapped_path);
 		//printf("mt %s: %lli\n",remapped_path.utf8().get_data(),mt);
-		res->set_last_modified_time(mt);
+		p_resource->set_last_modified_time(mt);
 	}
 #endif
 
 	if (_loaded_callback) {
-		_loaded_callback(res, p_path);
+		_loaded_callback(p_resource, p_path);
 	}
-
-	return res;
 }
 
 bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
@@ -435,6 +517,452 @@ Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_
 	return Ref<ResourceInteractiveLoader>();
 }
 
+RES ResourceLoader::_get_cached(const String &p_local_path) {
+
+	if (ResourceCache::lock) {
+		ResourceCache::lock->read_lock();
+	}
+
+	RES res;
+	Resource **rptr = ResourceCache::resources.getptr(p_local_path);
+	if (rptr) {
+		//may have just been freed in a thread, then referencing fails and it is not considered cached
+		res = RES(*rptr);
+	}
+
+	if (ResourceCache::lock) {
+		ResourceCache::lock->read_unlock();
+	}
+
+	return res;
+}
+
+bool ResourceLoader::_thread_load_use_pool() {
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	return pool && pool->get_thread_count() > 0;
+}
+
+// All the _thread_load_*() helpers expect thread_load_mutex to be locked.
+
+ResourceLoader::ThreadLoadTask *ResourceLoader::_thread_load_get_task(const String &p_local_path, const String &p_type_hint, int p_priority) {
+
+	ThreadLoadTask **taskp = thread_load_tasks.getptr(p_local_path);
+	if (taskp) {
+		_thread_load_raise_priority(*taskp, p_priority);
+		return *taskp;
+	}
+
+	ThreadLoadTask *task = memnew(ThreadLoadTask);
+	task->local_path = p_local_path;
+	task->type_hint = p_type_hint;
+	task->priority = p_priority;
+	task->order = thread_load_order++;
+	thread_load_tasks.set(p_local_path, task);
+
+	RES cached = _get_cached(p_local_path);
+	if (cached.is_valid()) {
+		print_verbose("Loading resource: " + p_local_path + " (cached)");
+		task->resource = cached;
+		task->status = THREAD_LOAD_LOADED;
+		task->progress = 1.0;
+	} else {
+		_thread_load_queue(task);
+	}
+
+	return task;
+}
+
+void ResourceLoader::_thread_load_raise_priority(ThreadLoadTask *p_task, int p_priority) {
+
+	if (p_priority <= p_task->priority || p_task->status != THREAD_LOAD_IN_PROGRESS)
+		return;
+
+	p_task->priority = p_priority;
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		_thread_load_raise_priority(p_task->dependencies[i], p_priority);
+	}
+}
+
+bool ResourceLoader::_thread_load_depends_on(ThreadLoadTask *p_task, ThreadLoadTask *p_dependency) {
+
+	if (p_task == p_dependency)
+		return true;
+
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		if (_thread_load_depends_on(p_task->dependencies[i], p_dependency))
+			return true;
+	}
+
+	return p_task->waiting_for && _thread_load_depends_on(p_task->waiting_for, p_dependency);
+}
+
+void ResourceLoader::_thread_load_queue(ThreadLoadTask *p_task) {
+
+	thread_load_ready.push_back(p_task);
+
+	if (!_thread_load_use_pool())
+		return; //run by whoever waits for it
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	// Every group must be waited for once, free the ones already done.
+	for (int i = thread_load_groups.size() - 1; i >= 0; i--) {
+		if (pool->is_group_completed(thread_load_groups[i])) {
+			pool->wait_for_group(thread_load_groups[i]);
+			thread_load_groups.remove(i);
+		}
+	}
+
+	// One group per ready task, each picks whatever ready task has the highest priority when it runs.
+	thread_load_groups.push_back(pool->add_native_group_task(&ResourceLoader::_thread_load_function, NULL, 1));
+}
+
+ResourceLoader::ThreadLoadTask *ResourceLoader::_thread_load_begin(ThreadLoadTask *p_task) {
+
+	Thread::ID thread = Thread::get_caller_id();
+	ThreadLoadTask **previousp = thread_load_current.getptr(thread);
+	ThreadLoadTask *previous = previousp ? *previousp : NULL; //waiting threads help, so loads can nest
+	thread_load_current.set(thread, p_task);
+
+	p_task->loading = true;
+	p_task->loader_thread = thread;
+
+	return previous;
+}
+
+void ResourceLoader::_thread_load_end(ThreadLoadTask *p_task, ThreadLoadTask *p_previous, const RES &p_resource, Error p_error) {
+
+	if (p_previous) {
+		thread_load_current.set(p_task->loader_thread, p_previous);
+	} else {
+		thread_load_current.erase(p_task->loader_thread);
+	}
+
+	p_task->loading = false;
+	p_task->resource = p_resource;
+	p_task->error = p_error;
+	p_task->status = p_resource.is_valid() ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+	p_task->progress = 1.0;
+	_thread_load_finish(p_task);
+}
+
+void ResourceLoader::_thread_load_finish(ThreadLoadTask *p_task) {
+
+	for (int i = 0; i < p_task->waiters; i++) {
+		p_task->done->post();
+	}
+	p_task->waiters = 0;
+
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		_thread_load_release(p_task->dependencies[i]);
+	}
+	p_task->dependencies.clear();
+
+	for (int i = 0; i < p_task->dependents.size(); i++) {
+		ThreadLoadTask *dependent = p_task->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			_thread_load_queue(dependent);
+		}
+	}
+	p_task->dependents.clear();
+}
+
+void ResourceLoader::_thread_load_release(ThreadLoadTask *p_task) {
+
+	p_task->refcount--;
+	if (p_task->refcount > 0 || p_task->status == THREAD_LOAD_IN_PROGRESS)
+		return;
+
+	thread_load_tasks.erase(p_task->local_path);
+	if (p_task->done) {
+		memdelete(p_task->done);
+	}
+	memdelete(p_task);
+}
+
+void ResourceLoader::_thread_load_wait(ThreadLoadTask *p_task) {
+
+	while (p_task->status == THREAD_LOAD_IN_PROGRESS) {
+
+		if (thread_load_groups.size()) {
+			// Help with the queue instead of blocking, whatever runs has the highest priority.
+			int group = thread_load_groups[thread_load_groups.size() - 1];
+			thread_load_groups.resize(thread_load_groups.size() - 1);
+			thread_load_mutex->unlock();
+			WorkerThreadPool::get_singleton()->wait_for_group(group);
+			thread_load_mutex->lock();
+		} else if (thread_load_ready.size()) {
+			// No worker threads, load it right here.
+			thread_load_mutex->unlock();
+			_thread_load_function(NULL, 0);
+			thread_load_mutex->lock();
+		} else {
+			// Being loaded by another thread.
+			if (!p_task->done) {
+				p_task->done = Semaphore::create();
+			}
+			p_task->waiters++;
+			thread_load_mutex->unlock();
+			p_task->done->wait();
+			thread_load_mutex->lock();
+		}
+	}
+}
+
+float ResourceLoader::_thread_load_get_progress(ThreadLoadTask *p_task) {
+
+	if (p_task->status != THREAD_LOAD_IN_PROGRESS)
+		return 1.0;
+
+	// Every dependency weighs as much as the resource itself.
+	float progress = p_task->progress;
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		progress += _thread_load_get_progress(p_task->dependencies[i]);
+	}
+
+	return progress / (p_task->dependencies.size() + 1);
+}
+
+void ResourceLoader::_thread_load_function(void *p_userdata, uint32_t p_index) {
+
+	thread_load_mutex->lock();
+
+	if (thread_load_ready.empty()) {
+		thread_load_mutex->unlock();
+		return; //taken by a thread that was waiting for it
+	}
+
+	int best = 0;
+	for (int i = 1; i < thread_load_ready.size(); i++) {
+		const ThreadLoadTask *task = thread_load_ready[i];
+		const ThreadLoadTask *best_task = thread_load_ready[best];
+		if (task->priority > best_task->priority || (task->priority == best_task->priority && task->order < best_task->order)) {
+			best = i;
+		}
+	}
+
+	ThreadLoadTask *task = thread_load_ready[best];
+	thread_load_ready.remove(best);
+
+	if (!task->dependencies_scanned) {
+
+		task->dependencies_scanned = true;
+		String local_path = task->local_path;
+		thread_load_mutex->unlock();
+
+		List<String> dependencies;
+		get_dependencies(local_path, &dependencies);
+
+		thread_load_mutex->lock();
+
+		for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+
+			String dependency_path;
+			if (E->get().is_rel_path())
+				dependency_path = "res://" + E->get();
+			else
+				dependency_path = ProjectSettings::get_singleton()->localize_path(E->get());
+
+			ThreadLoadTask **existing = thread_load_tasks.getptr(dependency_path);
+			if (existing && (task->dependencies.find(*existing) != -1 || _thread_load_depends_on(*existing, task)))
+				continue; //listed twice, or a cycle that loading will report
+
+			ThreadLoadTask *dependency = _thread_load_get_task(dependency_path, String(), task->priority);
+			dependency->refcount++;
+			task->dependencies.push_back(dependency);
+
+			if (dependency->status == THREAD_LOAD_IN_PROGRESS) {
+				dependency->dependents.push_back(task);
+				task->pending_dependencies++;
+			}
+		}
+
+		if (task->pending_dependencies > 0) {
+			thread_load_mutex->unlock();
+			return; //queued again once the last dependency is done
+		}
+	}
+
+	ThreadLoadTask *previous = _thread_load_begin(task);
+	String local_path = task->local_path;
+	String type_hint = task->type_hint;
+	thread_load_mutex->unlock();
+
+	// Dependencies are cached by now, so this only loads the resource itself.
+	Error err = OK;
+	RES res;
+	Ref<ResourceInteractiveLoader> ril = load_interactive(local_path, type_hint, false, &err);
+	if (ril.is_valid()) {
+
+		int stage_count = MAX(ril->get_stage_count(), 1);
+		while (true) {
+
+			err = ril->poll();
+			if (err == ERR_FILE_EOF) {
+				err = OK;
+				res = ril->get_resource();
+				break;
+			}
+			if (err != OK)
+				break;
+
+			thread_load_mutex->lock();
+			task->progress = MIN(float(ril->get_stage()) / stage_count, 1.0f);
+			thread_load_mutex->unlock();
+		}
+	}
+
+	if (res.is_valid()) {
+		res->set_path(local_path); //loaders that are not interactive do not set it
+		_resource_loaded(res, _path_remap(local_path), local_path);
+	} else {
+		if (err == OK)
+			err = ERR_CANT_OPEN;
+		ERR_PRINTS("Failed loading resource: " + local_path);
+	}
+
+	thread_load_mutex->lock();
+	_thread_load_end(task, previous, res, err);
+	thread_load_mutex->unlock();
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, int p_priority) {
+
+	ERR_FAIL_COND_V(!thread_load_mutex, ERR_UNCONFIGURED);
+
+	String local_path;
+	if (p_path.is_rel_path())
+		local_path = "res://" + p_path;
+	else
+		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask *task = _thread_load_get_task(local_path, p_type_hint, p_priority);
+	task->requests++;
+	task->refcount++;
+
+	if (!_thread_load_use_pool()) {
+		_thread_load_wait(task);
+	}
+
+	thread_load_mutex->unlock();
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
+
+	ERR_FAIL_COND_V(!thread_load_mutex, THREAD_LOAD_INVALID_RESOURCE);
+
+	String local_path;
+	if (p_path.is_rel_path())
+		local_path = "res://" + p_path;
+	else
+		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask **taskp = thread_load_tasks.getptr(local_path);
+	if (!taskp || (*taskp)->requests == 0) {
+		thread_load_mutex->unlock();
+		return THREAD_LOAD_INVALID_RESOURCE;
+	}
+
+	ThreadLoadStatus status = (*taskp)->status;
+	if (r_progress) {
+		*r_progress = _thread_load_get_progress(*taskp);
+	}
+
+	thread_load_mutex->unlock();
+
+	return status;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+
+	if (r_error)
+		*r_error = ERR_INVALID_PARAMETER;
+
+	ERR_FAIL_COND_V(!thread_load_mutex, RES());
+
+	String local_path;
+	if (p_path.is_rel_path())
+		local_path = "res://" + p_path;
+	else
+		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask **taskp = thread_load_tasks.getptr(local_path);
+	if (!taskp || (*taskp)->requests == 0) {
+		thread_load_mutex->unlock();
+		ERR_EXPLAIN("Resource was not requested with load_threaded_request(): " + local_path);
+		ERR_FAIL_V(RES());
+	}
+
+	ThreadLoadTask *task = *taskp;
+	_thread_load_wait(task);
+
+	RES res = task->resource;
+	if (r_error)
+		*r_error = task->error;
+
+	task->requests--;
+	_thread_load_release(task);
+
+	thread_load_mutex->unlock();
+
+	return res;
+}
+
+void ResourceLoader::clear_thread_load_tasks() {
+
+	if (!thread_load_mutex)
+		return;
+
+	thread_load_mutex->lock();
+
+	// Workers may still be using the tasks, let everything in flight finish.
+	while (thread_load_groups.size()) {
+		int group = thread_load_groups[thread_load_groups.size() - 1];
+		thread_load_groups.resize(thread_load_groups.size() - 1);
+		thread_load_mutex->unlock();
+		WorkerThreadPool::get_singleton()->wait_for_group(group);
+		thread_load_mutex->lock();
+	}
+
+	const String *K = NULL;
+	while ((K = thread_load_tasks.next(K))) {
+		ThreadLoadTask *task = thread_load_tasks[*K];
+		if (task->done) {
+			memdelete(task->done);
+		}
+		memdelete(task);
+	}
+	thread_load_tasks.clear();
+	thread_load_ready.clear();
+
+	thread_load_mutex->unlock();
+}
+
+void ResourceLoader::initialize() {
+
+	thread_load_mutex = Mutex::create();
+}
+
+void ResourceLoader::finalize() {
+
+	clear_thread_load_tasks();
+
+	if (thread_load_mutex) {
+		memdelete(thread_load_mutex);
+		thread_load_mutex = NULL;
+	}
+}
+
 void ResourceLoader::add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front) {
 
 	ERR_FAIL_COND(p_format_loader.is_null());
@@ -847,3 +1375,10 @@ HashMap<String, Vector<String> > ResourceLoader::translation_remaps;
 HashMap<String, String> ResourceLoader::path_remaps;
 
 ResourceLoaderImport ResourceLoader::import = NULL;
+
+Mutex *ResourceLoader::thread_load_mutex = NULL;
+HashMap<String, ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_tasks;
+Vector<ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_ready;
+Vector<int> ResourceLoader::thread_load_groups;
+HashMap<Thread::ID, ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_current;
+uint64_t ResourceLoader::thread_load_order = 0;
@@ -31,6 +31,9 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/resource.h"
 
 /**
@@ -92,6 +95,16 @@ class ResourceLoader {
 		MAX_LOADERS = 64
 	};
 
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
+
+private:
+
 	static Ref<ResourceFormatLoader> loader[MAX_LOADERS];
 	static int loader_count;
 	static bool timestamp_on_load;
@@ -117,11 +130,86 @@ class ResourceLoader {
 
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
+	static RES _get_cached(const String &p_local_path);
+	static RES _load_local(const String &p_local_path, const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error);
+	static void _resource_loaded(RES &p_resource, const String &p_remapped_path, const String &p_path);
+
+	// Threaded load queue. Every path requested with load_threaded_request()
+	// (and every dependency found while loading it) gets one task. A task
+	// first scans its dependencies, queues the ones that are neither cached
+	// nor already in flight, and only loads itself once they are all done, so
+	// independent dependencies load in parallel on the WorkerThreadPool.
+	// Plain load() calls register a task too while they run, so a path is
+	// never loaded twice at the same time.
+	struct ThreadLoadTask {
+		String local_path;
+		String type_hint;
+		int priority;
+		uint64_t order;
+		ThreadLoadStatus status;
+		Error error;
+		RES resource;
+		float progress; // own stages, dependencies are not included
+		bool dependencies_scanned;
+		int pending_dependencies;
+		Vector<ThreadLoadTask *> dependencies;
+		Vector<ThreadLoadTask *> dependents;
+		int requests; // load_threaded_request() calls not yet matched by load_threaded_get()
+		int refcount; // requests, unfinished dependents and threads waiting for it
+		int waiters;
+		Semaphore *done;
+		bool loading; // the resource itself is being loaded by loader_thread
+		Thread::ID loader_thread;
+		ThreadLoadTask *waiting_for; // task an undeclared dependency is being waited from while loading
+
+		ThreadLoadTask() {
+			priority = 0;
+			order = 0;
+			status = THREAD_LOAD_IN_PROGRESS;
+			error = OK;
+			progress = 0;
+			dependencies_scanned = false;
+			pending_dependencies = 0;
+			requests = 0;
+			refcount = 0;
+			waiters = 0;
+			done = NULL;
+			loading = false;
+			loader_thread = 0;
+			waiting_for = NULL;
+		}
+	};
+
+	static Mutex *thread_load_mutex;
+	static HashMap<String, ThreadLoadTask *> thread_load_tasks;
+	static Vector<ThreadLoadTask *> thread_load_ready;
+	static Vector<int> thread_load_groups;
+	static HashMap<Thread::ID, ThreadLoadTask *> thread_load_current; // innermost task each thread is loading
+	static uint64_t thread_load_order;
+
+	static ThreadLoadTask *_thread_load_get_task(const String &p_local_path, const String &p_type_hint, int p_priority);
+	static void _thread_load_raise_priority(ThreadLoadTask *p_task, int p_priority);
+	static bool _thread_load_depends_on(ThreadLoadTask *p_task, ThreadLoadTask *p_dependency);
+	static void _thread_load_queue(ThreadLoadTask *p_task);
+	static ThreadLoadTask *_thread_load_begin(ThreadLoadTask *p_task);
+	static void _thread_load_end(ThreadLoadTask *p_task, ThreadLoadTask *p_previous, const RES &p_resource, Error p_error);
+	static void _thread_load_finish(ThreadLoadTask *p_task);
+	static void _thread_load_release(ThreadLoadTask *p_task);
+	static void _thread_load_wait(ThreadLoadTask *p_task);
+	static float _thread_load_get_progress(ThreadLoadTask *p_task);
+	static bool _thread_load_use_pool();
+	static void _thread_load_function(void *p_userdata, uint32_t p_index);
+
 public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = NULL);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", int p_priority = 0);
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = NULL);
+	static RES load_threaded_get(const String &p_path, Error *r_error = NULL);
+	static void clear_thread_load_tasks();
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front = false);
 	static void remove_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader);
@@ -170,6 +258,9 @@ public:
 	static void remove_custom_resource_format_loader(String script_path);
 	static void add_custom_loaders();
 	static void remove_custom_loaders();
+
+	static void initialize();
+	static void finalize();
 };
 
 #endif
@@ -0,0 +1,1078 @@
+/*************************************************************************/
+/*  bvh.h                                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BVH_H
+#define BVH_H
+
+#include "core/list.h"
+#include "core/math/aabb.h"
+#include "core/math/vector3.h"
+#include "core/os/copymem.h"
+#include "core/os/memory.h"
+#include "core/vector.h"
+
+/**
+	Dynamic AABB tree, with the same element, culling and pairing interface as Octree.
+
+	Leaves keep an enlarged ("fat") AABB, so elements moving a bit don't touch the
+	tree at all. When they leave it, the leaf is refit in place if its parent still
+	encloses it, or reinserted otherwise. Rotations keep the tree balanced.
+
+	Pairs are tracked between elements whose fat AABBs overlap, and reported through
+	the pair/unpair callbacks while their real AABBs intersect, as Octree does.
+*/
+
+typedef uint32_t BVHElementID;
+
+#define BVH_ELEMENT_INVALID_ID 0
+
+template <class T, bool use_pairs = false, class AL = DefaultAllocator>
+class BVH {
+public:
+	typedef void *(*PairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int);
+	typedef void (*UnpairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int, void *);
+
+private:
+	enum {
+		NODE_NULL = -1
+	};
+
+	struct PairData;
+
+	struct Element {
+
+		T *userdata;
+		int subindex;
+		bool pairable;
+		uint32_t pairable_mask;
+		uint32_t pairable_type;
+
+		uint64_t last_pass;
+		BVHElementID _id;
+		int node; // leaf, NODE_NULL while the element has no surface
+
+		AABB aabb;
+
+		List<PairData *, AL> pair_list;
+
+		Element() {
+			userdata = 0;
+			subindex = 0;
+			pairable = false;
+			pairable_mask = 0;
+			pairable_type = 0;
+			last_pass = 0;
+			_id = 0;
+			node = NODE_NULL;
+		}
+	};
+
+	struct PairData {
+
+		bool intersect;
+		Element *A, *B;
+		void *ud;
+		typename List<PairData *, AL>::Element *eA, *eB;
+	};
+
+	struct Node {
+
+		AABB aabb; // fat AABB for leaves, union of children otherwise
+		int parent; // next free node while unused
+		int children[2];
+		int height; // 0 for leaves
+		Element *element;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == NODE_NULL; }
+	};
+
+	PairCallback pair_callback;
+	UnpairCallback unpair_callback;
+	void *pair_callback_userdata;
+	void *unpair_callback_userdata;
+
+	Node *nodes;
+	int node_capacity;
+	int node_count;
+	int free_node;
+	int root;
+
+	Vector<Element *> elements; // indexed by ID, 0 is never used
+	Vector<BVHElementID> free_ids;
+	int element_count;
+
+	uint64_t pass;
+	real_t fat_margin;
+	int pair_count;
+
+	static _FORCE_INLINE_ real_t _cost(const AABB &p_aabb) {
+
+		// half the surface area, enough to compare
+		const Vector3 &s = p_aabb.size;
+		return s.x * s.y + s.y * s.z + s.z * s.x;
+	}
+
+	static _FORCE_INLINE_ AABB _merge(const AABB &p_a, const AABB &p_b) {
+
+		AABB r = p_a;
+		r.merge_with(p_b);
+		return r;
+	}
+
+	_FORCE_INLINE_ Element *_get_element(BVHElementID p_id) const {
+
+		if (p_id == BVH_ELEMENT_INVALID_ID || (int)p_id >= elements.size())
+			return NULL;
+		return elements[p_id];
+	}
+
+	_FORCE_INLINE_ bool _can_pair(const Element *p_A, const Element *p_B) const {
+
+		if (p_A == p_B || (p_A->userdata == p_B->userdata && p_A->userdata))
+			return false;
+
+		if (!p_A->pairable && !p_B->pairable)
+			return false; // at least one must be pairable
+
+		if (!(p_A->pairable_type & p_B->pairable_mask) &&
+				!(p_B->pairable_type & p_A->pairable_mask))
+			return false; // none can pair with none
+
+		return true;
+	}
+
+	_FORCE_INLINE_ void _pair_check(PairData *p_pair) {
+
+		bool intersect = p_pair->A->aabb.intersects_inclusive(p_pair->B->aabb);
+
+		if (intersect != p_pair->intersect) {
+
+			if (intersect) {
+
+				if (pair_callback) {
+					p_pair->ud = pair_callback(pair_callback_userdata, p_pair->A->_id, p_pair->A->userdata, p_pair->A->subindex, p_pair->B->_id, p_pair->B->userdata, p_pair->B->subindex);
+				}
+				pair_count++;
+			} else {
+
+				if (unpair_callback) {
+					unpair_callback(unpair_callback_userdata, p_pair->A->_id, p_pair->A->userdata, p_pair->A->subindex, p_pair->B->_id, p_pair->B->userdata, p_pair->B->subindex, p_pair->ud);
+				}
+				pair_count--;
+			}
+
+			p_pair->intersect = intersect;
+		}
+	}
+
+	_FORCE_INLINE_ void _element_check_pairs(Element *p_element) {
+
+		typename List<PairData *, AL>::Element *E = p_element->pair_list.front();
+		while (E) {
+
+			_pair_check(E->get());
+			E = E->next();
+		}
+	}
+
+	int _alloc_node();
+	void _free_node(int p_node);
+	int _balance(int p_node);
+	void _refit_upwards(int p_node);
+	void _insert_leaf(int p_leaf);
+	void _remove_leaf(int p_leaf);
+
+	void _add_pair(Element *p_A, Element *p_B);
+	void _remove_pair(PairData *p_pair);
+	void _update_pairs(Element *p_element);
+	void _remove_pairs(Element *p_element);
+
+	void _insert_element(Element *p_element, const AABB &p_fat_aabb);
+	void _remove_element(Element *p_element);
+	AABB _fatten(const AABB &p_aabb, const AABB &p_prev_aabb) const;
+
+	void _cull_convex(int p_node, const Plane *p_planes, int p_plane_count, T **p_result_array, int *p_result_idx, int p_result_max, uint32_t p_mask) const;
+	void _cull_aabb(int p_node, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+	void _cull_segment(int p_node, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+	void _cull_point(int p_node, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+
+public:
+	BVHElementID create(T *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void move(BVHElementID p_id, const AABB &p_aabb);
+	void set_pairable(BVHElementID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void erase(BVHElementID p_id);
+
+	bool is_pairable(BVHElementID p_id) const;
+	T *get(BVHElementID p_id) const;
+	int get_subindex(BVHElementID p_id) const;
+
+	// Culling never modifies the tree, so these can run from several threads at once (as long as nothing modifies the tree meanwhile).
+	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_convex_mt(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const { return cull_convex(p_convex, p_result_array, p_result_max, p_mask); }
+	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+
+	int cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) const;
+
+	void set_pair_callback(PairCallback p_callback, void *p_userdata);
+	void set_unpair_callback(UnpairCallback p_callback, void *p_userdata);
+
+	int get_node_count() const { return node_count; }
+	int get_elem_count() const { return element_count; }
+	int get_pair_count() const { return pair_count; }
+	int get_height() const { return root == NODE_NULL ? 0 : nodes[root].height; }
+
+	BVH(real_t p_fat_margin = 0.1);
+	~BVH();
+};
+
+/* PRIVATE FUNCTIONS */
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_alloc_node() {
+
+	if (free_node == NODE_NULL) {
+
+		int new_capacity = node_capacity ? node_capacity * 2 : 16;
+		nodes = (Node *)memrealloc(nodes, sizeof(Node) * new_capacity);
+
+		for (int i = node_capacity; i < new_capacity; i++) {
+			nodes[i].parent = i + 1 < new_capacity ? i + 1 : int(NODE_NULL);
+			nodes[i].height = -1;
+		}
+
+		free_node = node_capacity;
+		node_capacity = new_capacity;
+	}
+
+	int index = free_node;
+	Node &node = nodes[index];
+	free_node = node.parent;
+
+	node.aabb = AABB();
+	node.parent = NODE_NULL;
+	node.children[0] = NODE_NULL;
+	node.children[1] = NODE_NULL;
+	node.height = 0;
+	node.element = NULL;
+
+	node_count++;
+	return index;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_free_node(int p_node) {
+
+	nodes[p_node].parent = free_node;
+	nodes[p_node].height = -1;
+	nodes[p_node].element = NULL;
+	free_node = p_node;
+	node_count--;
+}
+
+// AVL style rotation, returns the new root of the subtree
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_balance(int p_node) {
+
+	int iA = p_node;
+	Node *A = &nodes[iA];
+	if (A->is_leaf() || A->height < 2)
+		return iA;
+
+	int iB = A->children[0];
+	int iC = A->children[1];
+	Node *B = &nodes[iB];
+	Node *C = &nodes[iC];
+
+	int balance = C->height - B->height;
+
+	if (balance > 1) {
+		// rotate C up
+		int iF = C->children[0];
+		int iG = C->children[1];
+		Node *F = &nodes[iF];
+		Node *G = &nodes[iG];
+
+		C->children[0] = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if (C->parent != NODE_NULL) {
+			Node &P = nodes[C->parent];
+			P.children[P.children[0] == iA ? 0 : 1] = iC;
+		} else {
+			root = iC;
+		}
+
+		if (F->height > G->height) {
+			C->children[1] = iF;
+			A->children[1] = iG;
+			G->parent = iA;
+			A->aabb = _merge(B->aabb, G->aabb);
+			C->aabb = _merge(A->aabb, F->aabb);
+			A->height = 1 + MAX(B->height, G->height);
+			C->height = 1 + MAX(A->height, F->height);
+		} else {
+			C->children[1] = iG;
+			A->children[1] = iF;
+			F->parent = iA;
+			A->aabb = _merge(B->aabb, F->aabb);
+			C->aabb = _merge(A->aabb, G->aabb);
+			A->height = 1 + MAX(B->height, F->height);
+			C->height = 1 + MAX(A->height, G->height);
+		}
+
+		return iC;
+	}
+
+	if (balance < -1) {
+		// rotate B up
+		int iD = B->children[0];
+		int iE = B->children[1];
+		Node *D = &nodes[iD];
+		Node *E = &nodes[iE];
+
+		B->children[0] = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if (B->parent != NODE_NULL) {
+			Node &P = nodes[B->parent];
+			P.children[P.children[0] == iA ? 0 : 1] = iB;
+		} else {
+			root = iB;
+		}
+
+		if (D->height > E->height) {
+			B->children[1] = iD;
+			A->children[0] = iE;
+			E->parent = iA;
+			A->aabb = _merge(C->aabb, E->aabb);
+			B->aabb = _merge(A->aabb, D->aabb);
+			A->height = 1 + MAX(C->height, E->height);
+			B->height = 1 + MAX(A->height, D->height);
+		} else {
+			B->children[1] = iE;
+			A->children[0] = iD;
+			D->parent = iA;
+			A->aabb = _merge(C->aabb, D->aabb);
+			B->aabb = _merge(A->aabb, E->aabb);
+			A->height = 1 + MAX(C->height, D->height);
+			B->height = 1 + MAX(A->height, E->height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_refit_upwards(int p_node) {
+
+	int index = p_node;
+	while (index != NODE_NULL) {
+
+		index = _balance(index);
+
+		Node &node = nodes[index];
+		const Node &c0 = nodes[node.children[0]];
+		const Node &c1 = nodes[node.children[1]];
+
+		node.height = 1 + MAX(c0.height, c1.height);
+		node.aabb = _merge(c0.aabb, c1.aabb);
+
+		index = node.parent;
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_insert_leaf(int p_leaf) {
+
+	if (root == NODE_NULL) {
+		root = p_leaf;
+		nodes[root].parent = NODE_NULL;
+		return;
+	}
+
+	// find the best sibling, using the surface area heuristic
+	AABB leaf_aabb = nodes[p_leaf].aabb;
+	int index = root;
+
+	while (!nodes[index].is_leaf()) {
+
+		const Node &node = nodes[index];
+
+		real_t area = _cost(node.aabb);
+		real_t combined_area = _cost(_merge(node.aabb, leaf_aabb));
+
+		// cost of creating a new parent for this node and the leaf
+		real_t cost = 2.0 * combined_area;
+		// minimum cost of pushing the leaf further down the tree
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t child_cost[2];
+		for (int i = 0; i < 2; i++) {
+
+			const Node &child = nodes[node.children[i]];
+			real_t merged = _cost(_merge(child.aabb, leaf_aabb));
+			if (child.is_leaf()) {
+				child_cost[i] = merged + inheritance_cost;
+			} else {
+				child_cost[i] = (merged - _cost(child.aabb)) + inheritance_cost;
+			}
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1])
+			break;
+
+		index = child_cost[0] < child_cost[1] ? node.children[0] : node.children[1];
+	}
+
+	int sibling = index;
+
+	int new_parent = _alloc_node(); // may reallocate, don't keep node references across it
+	int old_parent = nodes[sibling].parent;
+
+	Node &parent = nodes[new_parent];
+	parent.parent = old_parent;
+	parent.aabb = _merge(leaf_aabb, nodes[sibling].aabb);
+	parent.height = nodes[sibling].height + 1;
+	parent.children[0] = sibling;
+	parent.children[1] = p_leaf;
+
+	if (old_parent != NODE_NULL) {
+		Node &op = nodes[old_parent];
+		op.children[op.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+		root = new_parent;
+	}
+
+	nodes[sibling].parent = new_parent;
+	nodes[p_leaf].parent = new_parent;
+
+	_refit_upwards(old_parent);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_remove_leaf(int p_leaf) {
+
+	if (p_leaf == root) {
+		root = NODE_NULL;
+		return;
+	}
+
+	int parent = nodes[p_leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = nodes[parent].children[0] == p_leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	_free_node(parent);
+
+	if (grand_parent != NODE_NULL) {
+
+		Node &gp = nodes[grand_parent];
+		gp.children[gp.children[0] == parent ? 0 : 1] = sibling;
+		nodes[sibling].parent = grand_parent;
+
+		_refit_upwards(grand_parent);
+	} else {
+
+		root = sibling;
+		nodes[sibling].parent = NODE_NULL;
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_add_pair(Element *p_A, Element *p_B) {
+
+	PairData *pd = memnew_allocator(PairData, AL);
+	pd->A = p_A;
+	pd->B = p_B;
+	pd->intersect = false;
+	pd->ud = NULL;
+	pd->eA = p_A->pair_list.push_back(pd);
+	pd->eB = p_B->pair_list.push_back(pd);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_remove_pair(PairData *p_pair) {
+
+	if (p_pair->intersect) {
+		if (unpair_callback) {
+			unpair_callback(unpair_callback_userdata, p_pair->A->_id, p_pair->A->userdata, p_pair->A->subindex, p_pair->B->_id, p_pair->B->userdata, p_pair->B->subindex, p_pair->ud);
+		}
+		pair_count--;
+	}
+
+	p_pair->A->pair_list.erase(p_pair->eA);
+	p_pair->B->pair_list.erase(p_pair->eB);
+	memdelete_allocator<PairData, AL>(p_pair);
+}
+
+// Makes the pair list of the element match the elements its fat AABB overlaps
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_update_pairs(Element *p_element) {
+
+	// current partners are marked with one pass, partners found below with the next one
+	uint64_t paired_pass = ++pass;
+	uint64_t found_pass = ++pass;
+
+	for (typename List<PairData *, AL>::Element *E = p_element->pair_list.front(); E; E = E->next()) {
+
+		PairData *pd = E->get();
+		(pd->A == p_element ? pd->B : pd->A)->last_pass = paired_pass;
+	}
+
+	if (p_element->node != NODE_NULL) {
+
+		const AABB &fat = nodes[p_element->node].aabb;
+
+		int stack_buf[64];
+		int *stack = stack_buf;
+		int stack_max = 64;
+		int stack_size = 0;
+		Vector<int> stack_heap;
+
+		stack[stack_size++] = root;
+
+		while (stack_size) {
+
+			const Node &node = nodes[stack[--stack_size]];
+			if (!node.aabb.intersects_inclusive(fat))
+				continue;
+
+			if (node.is_leaf()) {
+
+				Element *e = node.element;
+				if (_can_pair(p_element, e)) {
+					if (e->last_pass != paired_pass) {
+						_add_pair(p_element, e);
+					}
+					e->last_pass = found_pass;
+				}
+				continue;
+			}
+
+			if (stack_size + 2 > stack_max) {
+				stack_heap.resize(stack_max * 2);
+				if (stack == stack_buf) {
+					copymem(stack_heap.ptrw(), stack_buf, sizeof(int) * stack_size);
+				}
+				stack = stack_heap.ptrw();
+				stack_max *= 2;
+			}
+
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	// drop the pairs that no longer overlap
+	typename List<PairData *, AL>::Element *E = p_element->pair_list.front();
+	while (E) {
+
+		typename List<PairData *, AL>::Element *N = E->next();
+		PairData *pd = E->get();
+		if ((pd->A == p_element ? pd->B : pd->A)->last_pass != found_pass) {
+			_remove_pair(pd);
+		}
+		E = N;
+	}
+
+	_element_check_pairs(p_element);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_remove_pairs(Element *p_element) {
+
+	while (p_element->pair_list.front()) {
+		_remove_pair(p_element->pair_list.front()->get());
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_insert_element(Element *p_element, const AABB &p_fat_aabb) {
+
+	int leaf = _alloc_node();
+	nodes[leaf].aabb = p_fat_aabb;
+	nodes[leaf].element = p_element;
+	p_element->node = leaf;
+
+	_insert_leaf(leaf);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_remove_element(Element *p_element) {
+
+	_remove_leaf(p_element->node);
+	_free_node(p_element->node);
+	p_element->node = NODE_NULL;
+}
+
+template <class T, bool use_pairs, class AL>
+AABB BVH<T, use_pairs, AL>::_fatten(const AABB &p_aabb, const AABB &p_prev_aabb) const {
+
+	AABB fat = p_aabb.grow(MAX(fat_margin, p_aabb.get_longest_axis_size() * 0.1));
+
+	// extend towards where the element is moving, so it won't leave the fat AABB next frame
+	Vector3 motion = (p_aabb.position - p_prev_aabb.position) * 4.0;
+	for (int i = 0; i < 3; i++) {
+		if (motion[i] < 0) {
+			fat.position[i] += motion[i];
+			fat.size[i] -= motion[i];
+		} else {
+			fat.size[i] += motion[i];
+		}
+	}
+
+	return fat;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_cull_convex(int p_node, const Plane *p_planes, int p_plane_count, T **p_result_array, int *p_result_idx, int p_result_max, uint32_t p_mask) const {
+
+	if (*p_result_idx == p_result_max)
+		return; //pointless
+
+	const Node &node = nodes[p_node];
+
+	if (node.is_leaf()) {
+
+		const Element *e = node.element;
+		if (use_pairs && !(e->pairable_type & p_mask))
+			return;
+
+		if (e->aabb.intersects_convex_shape(p_planes, p_plane_count)) {
+			p_result_array[*p_result_idx] = e->userdata;
+			(*p_result_idx)++;
+		}
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+
+		if (nodes[node.children[i]].aabb.intersects_convex_shape(p_planes, p_plane_count)) {
+			_cull_convex(node.children[i], p_planes, p_plane_count, p_result_array, p_result_idx, p_result_max, p_mask);
+		}
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_cull_aabb(int p_node, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (*p_result_idx == p_result_max)
+		return; //pointless
+
+	const Node &node = nodes[p_node];
+
+	if (node.is_leaf()) {
+
+		const Element *e = node.element;
+		if (use_pairs && !(e->pairable_type & p_mask))
+			return;
+
+		if (p_aabb.intersects_inclusive(e->aabb)) {
+			p_result_array[*p_result_idx] = e->userdata;
+			if (p_subindex_array)
+				p_subindex_array[*p_result_idx] = e->subindex;
+			(*p_result_idx)++;
+		}
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+
+		if (nodes[node.children[i]].aabb.intersects_inclusive(p_aabb)) {
+			_cull_aabb(node.children[i], p_aabb, p_result_array, p_result_idx, p_result_max, p_subindex_array, p_mask);
+		}
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_cull_segment(int p_node, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (*p_result_idx == p_result_max)
+		return; //pointless
+
+	const Node &node = nodes[p_node];
+
+	if (node.is_leaf()) {
+
+		const Element *e = node.element;
+		if (use_pairs && !(e->pairable_type & p_mask))
+			return;
+
+		if (e->aabb.intersects_segment(p_from, p_to)) {
+			p_result_array[*p_result_idx] = e->userdata;
+			if (p_subindex_array)
+				p_subindex_array[*p_result_idx] = e->subindex;
+			(*p_result_idx)++;
+		}
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+
+		if (nodes[node.children[i]].aabb.intersects_segment(p_from, p_to)) {
+			_cull_segment(node.children[i], p_from, p_to, p_result_array, p_result_idx, p_result_max, p_subindex_array, p_mask);
+		}
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_cull_point(int p_node, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (*p_result_idx == p_result_max)
+		return; //pointless
+
+	const Node &node = nodes[p_node];
+
+	if (node.is_leaf()) {
+
+		const Element *e = node.element;
+		if (use_pairs && !(e->pairable_type & p_mask))
+			return;
+
+		if (e->aabb.has_point(p_point)) {
+			p_result_array[*p_result_idx] = e->userdata;
+			if (p_subindex_array)
+				p_subindex_array[*p_result_idx] = e->subindex;
+			(*p_result_idx)++;
+		}
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+
+		if (nodes[node.children[i]].aabb.has_point(p_point)) {
+			_cull_point(node.children[i], p_point, p_result_array, p_result_idx, p_result_max, p_subindex_array, p_mask);
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+template <class T, bool use_pairs, class AL>
+BVHElementID BVH<T, use_pairs, AL>::create(T *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+// check for AABB validity
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_COND_V(p_aabb.position.x > 1e15 || p_aabb.position.x < -1e15, 0);
+	ERR_FAIL_COND_V(p_aabb.position.y > 1e15 || p_aabb.position.y < -1e15, 0);
+	ERR_FAIL_COND_V(p_aabb.position.z > 1e15 || p_aabb.position.z < -1e15, 0);
+	ERR_FAIL_COND_V(p_aabb.size.x > 1e15 || p_aabb.size.x < 0.0, 0);
+	ERR_FAIL_COND_V(p_aabb.size.y > 1e15 || p_aabb.size.y < 0.0, 0);
+	ERR_FAIL_COND_V(p_aabb.size.z > 1e15 || p_aabb.size.z < 0.0, 0);
+	ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.x), 0);
+	ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.y), 0);
+	ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.z), 0);
+#endif
+
+	BVHElementID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		if (elements.size() == 0) {
+			elements.push_back(NULL); // ID 0 is invalid
+		}
+		id = elements.size();
+		elements.push_back(NULL);
+	}
+
+	Element *e = memnew_allocator(Element, AL);
+	elements.write[id] = e;
+	element_count++;
+
+	e->aabb = p_aabb;
+	e->userdata = p_userdata;
+	e->subindex = p_subindex;
+	e->pairable = p_pairable;
+	e->pairable_type = p_pairable_type;
+	e->pairable_mask = p_pairable_mask;
+	e->_id = id;
+
+	if (!p_aabb.has_no_surface()) {
+		_insert_element(e, _fatten(p_aabb, p_aabb));
+		if (use_pairs)
+			_update_pairs(e);
+	}
+
+	return id;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::move(BVHElementID p_id, const AABB &p_aabb) {
+
+#ifdef DEBUG_ENABLED
+	// check for AABB validity
+	ERR_FAIL_COND(p_aabb.position.x > 1e15 || p_aabb.position.x < -1e15);
+	ERR_FAIL_COND(p_aabb.position.y > 1e15 || p_aabb.position.y < -1e15);
+	ERR_FAIL_COND(p_aabb.position.z > 1e15 || p_aabb.position.z < -1e15);
+	ERR_FAIL_COND(p_aabb.size.x > 1e15 || p_aabb.size.x < 0.0);
+	ERR_FAIL_COND(p_aabb.size.y > 1e15 || p_aabb.size.y < 0.0);
+	ERR_FAIL_COND(p_aabb.size.z > 1e15 || p_aabb.size.z < 0.0);
+	ERR_FAIL_COND(Math::is_nan(p_aabb.size.x));
+	ERR_FAIL_COND(Math::is_nan(p_aabb.size.y));
+	ERR_FAIL_COND(Math::is_nan(p_aabb.size.z));
+#endif
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	bool old_has_surf = !e->aabb.has_no_surface();
+	bool new_has_surf = !p_aabb.has_no_surface();
+
+	if (old_has_surf != new_has_surf) {
+
+		if (old_has_surf) {
+			_remove_element(e); // removing
+			e->aabb = AABB();
+			if (use_pairs)
+				_remove_pairs(e);
+		} else {
+			e->aabb = p_aabb; // inserting
+			_insert_element(e, _fatten(p_aabb, p_aabb));
+			if (use_pairs)
+				_update_pairs(e);
+		}
+
+		return;
+	}
+
+	if (!old_has_surf) // doing nothing
+		return;
+
+	Node &leaf = nodes[e->node];
+
+	// still inside the fat AABB, the tree doesn't change
+	if (leaf.aabb.encloses(p_aabb)) {
+
+		e->aabb = p_aabb;
+		if (use_pairs)
+			_element_check_pairs(e); // must check pairs anyway
+
+		return;
+	}
+
+	AABB fat = _fatten(p_aabb, e->aabb);
+	e->aabb = p_aabb;
+
+	if (leaf.parent != NODE_NULL && nodes[leaf.parent].aabb.encloses(fat)) {
+		// refit in place, the ancestors still enclose it
+		leaf.aabb = fat;
+	} else {
+		_remove_leaf(e->node);
+		nodes[e->node].aabb = fat;
+		_insert_leaf(e->node);
+	}
+
+	if (use_pairs)
+		_update_pairs(e);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_pairable(BVHElementID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (p_pairable == e->pairable && e->pairable_type == p_pairable_type && e->pairable_mask == p_pairable_mask)
+		return; // no changes, return
+
+	e->pairable = p_pairable;
+	e->pairable_type = p_pairable_type;
+	e->pairable_mask = p_pairable_mask;
+
+	if (use_pairs) {
+		// pairs that can't happen anymore go away, new ones are found
+		_remove_pairs(e);
+		_update_pairs(e);
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::erase(BVHElementID p_id) {
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (e->node != NODE_NULL) {
+		_remove_element(e);
+	}
+
+	if (use_pairs)
+		_remove_pairs(e);
+
+	memdelete_allocator<Element, AL>(e);
+	elements.write[p_id] = NULL;
+	free_ids.push_back(p_id);
+	element_count--;
+}
+
+template <class T, bool use_pairs, class AL>
+bool BVH<T, use_pairs, AL>::is_pairable(BVHElementID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, false);
+	return e->pairable;
+}
+
+template <class T, bool use_pairs, class AL>
+T *BVH<T, use_pairs, AL>::get(BVHElementID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, NULL);
+	return e->userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::get_subindex(BVHElementID p_id) const {
+
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, -1);
+	return e->subindex;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) const {
+
+	if (root == NODE_NULL || !p_convex.size())
+		return 0;
+
+	int result_count = 0;
+	if (nodes[root].aabb.intersects_convex_shape(&p_convex[0], p_convex.size())) {
+		_cull_convex(root, &p_convex[0], p_convex.size(), p_result_array, &result_count, p_result_max, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (root == NODE_NULL)
+		return 0;
+
+	int result_count = 0;
+	if (nodes[root].aabb.intersects_inclusive(p_aabb)) {
+		_cull_aabb(root, p_aabb, p_result_array, &result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (root == NODE_NULL)
+		return 0;
+
+	int result_count = 0;
+	if (nodes[root].aabb.intersects_segment(p_from, p_to)) {
+		_cull_segment(root, p_from, p_to, p_result_array, &result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+
+	if (root == NODE_NULL)
+		return 0;
+
+	int result_count = 0;
+	if (nodes[root].aabb.has_point(p_point)) {
+		_cull_point(root, p_point, p_result_array, &result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_pair_callback(PairCallback p_callback, void *p_userdata) {
+
+	pair_callback = p_callback;
+	pair_callback_userdata = p_userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_unpair_callback(UnpairCallback p_callback, void *p_userdata) {
+
+	unpair_callback = p_callback;
+	unpair_callback_userdata = p_userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+BVH<T, use_pairs, AL>::BVH(real_t p_fat_margin) {
+
+	pair_callback = NULL;
+	unpair_callback = NULL;
+	pair_callback_userdata = NULL;
+	unpair_callback_userdata = NULL;
+
+	nodes = NULL;
+	node_capacity = 0;
+	node_count = 0;
+	free_node = NODE_NULL;
+	root = NODE_NULL;
+
+	element_count = 0;
+	pass = 1;
+	fat_margin = p_fat_margin;
+	pair_count = 0;
+}
+
+template <class T, bool use_pairs, class AL>
+BVH<T, use_pairs, AL>::~BVH() {
+
+	for (int i = 0; i < elements.size(); i++) {
+
+		Element *e = elements[i];
+		if (!e)
+			continue;
+
+		// both elements of a pair list it, so it's unlinked from the other one before being freed
+		for (typename List<PairData *, AL>::Element *E = e->pair_list.front(); E; E = E->next()) {
+			PairData *pd = E->get();
+			Element *other = pd->A == e ? pd->B : pd->A;
+			other->pair_list.erase(pd->A == e ? pd->eB : pd->eA);
+			memdelete_allocator<PairData, AL>(pd);
+		}
+
+		memdelete_allocator<Element, AL>(e);
+	}
+
+	if (nodes) {
+		memfree(nodes);
+	}
+}
+
+#endif // BVH_H
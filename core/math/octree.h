@@ -351,7 +351,19 @@ private:
 		uint32_t mask;
 	};
 
+	struct _CullConvexMTData {
+
+		const Plane *planes;
+		int plane_count;
+		T **result_array;
+		int *result_idx;
+		int result_max;
+		uint32_t mask;
+		Vector<Element *> *shared_elements; // elements owned by several octants, deduplicated afterwards
+	};
+
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
+	void _cull_convex_mt(const Octant *p_octant, _CullConvexMTData *p_cull) const;
 	void _cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_point(Octant *p_octant, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -381,6 +393,8 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	// Same as cull_convex(), but does not touch the octree, so it can run from several threads at once (as long as nothing modifies the octree meanwhile).
+	int cull_convex_mt(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1313,6 +1327,82 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	return result_count;
 }
 
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::_cull_convex_mt(const Octant *p_octant, _CullConvexMTData *p_cull) const {
+
+	if (*p_cull->result_idx == p_cull->result_max)
+		return; //pointless
+
+	for (int l = 0; l < (use_pairs ? 2 : 1); l++) {
+
+		const List<Element *, AL> &elements = l == 0 ? p_octant->elements : p_octant->pairable_elements;
+
+		for (const typename List<Element *, AL>::Element *I = elements.front(); I; I = I->next()) {
+
+			Element *e = I->get();
+
+			if (use_pairs && !(e->pairable_type & p_cull->mask))
+				continue;
+
+			if (!e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count))
+				continue;
+
+			if (e->octant_owners.size() > 1) {
+				// can't mark it as visited without a pass, so collect it and remove duplicates later
+				p_cull->shared_elements->push_back(e);
+				continue;
+			}
+
+			if (*p_cull->result_idx < p_cull->result_max) {
+				p_cull->result_array[*p_cull->result_idx] = e->userdata;
+				(*p_cull->result_idx)++;
+			} else {
+
+				return; // pointless to continue
+			}
+		}
+	}
+
+	for (int i = 0; i < 8; i++) {
+
+		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
+			_cull_convex_mt(p_octant->children[i], p_cull);
+		}
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_mt(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) const {
+
+	if (!root)
+		return 0;
+
+	int result_count = 0;
+	Vector<Element *> shared_elements;
+	_CullConvexMTData cdata;
+	cdata.planes = &p_convex[0];
+	cdata.plane_count = p_convex.size();
+	cdata.result_array = p_result_array;
+	cdata.result_max = p_result_max;
+	cdata.result_idx = &result_count;
+	cdata.mask = p_mask;
+	cdata.shared_elements = &shared_elements;
+
+	_cull_convex_mt(root, &cdata);
+
+	if (shared_elements.size()) {
+		shared_elements.sort();
+		const Element *const *ptr = shared_elements.ptr();
+		for (int i = 0; i < shared_elements.size() && result_count < p_result_max; i++) {
+			if (i > 0 && ptr[i] == ptr[i - 1])
+				continue;
+			p_result_array[result_count++] = ptr[i]->userdata;
+		}
+	}
+
+	return result_count;
+}
+
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
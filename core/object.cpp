@@ -41,19 +41,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -2004,17 +1991,46 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
+ObjectDB::Slot *volatile ObjectDB::slot_pages[ObjectDB::SLOT_PAGE_COUNT] = {};
+uint32_t ObjectDB::slot_count = 1; // slot 0 is never handed out, so no valid ID is 0
+uint32_t ObjectDB::slot_free_list = 0;
+uint32_t ObjectDB::object_count = 0;
 HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
 ObjectID ObjectDB::add_instance(Object *p_object) {
 
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
 	rw_lock->write_lock();
-	ObjectID instance_id = ++instance_counter;
-	instances[instance_id] = p_object;
+
+	uint32_t index;
+	if (slot_free_list) {
+		index = slot_free_list;
+		slot_free_list = slot_pages[index >> SLOT_PAGE_BITS][index & (SLOT_PAGE_SIZE - 1)].next_free;
+	} else {
+		if (slot_count == SLOT_MAX) {
+			rw_lock->write_unlock();
+			ERR_EXPLAIN("Too many objects in ObjectDB (" + itos(SLOT_MAX) + ")");
+			ERR_FAIL_V(0);
+		}
+		index = slot_count++;
+		uint32_t page = index >> SLOT_PAGE_BITS;
+		if (!slot_pages[page]) {
+			Slot *slots = (Slot *)memalloc(sizeof(Slot) * SLOT_PAGE_SIZE);
+			zeromem(slots, sizeof(Slot) * SLOT_PAGE_SIZE);
+			atomic_store_release(&slot_pages[page], slots);
+		}
+	}
+
+	Slot &slot = slot_pages[index >> SLOT_PAGE_BITS][index & (SLOT_PAGE_SIZE - 1)];
+	slot.generation = (slot.generation + 1) & ((uint64_t(1) << GENERATION_BITS) - 1);
+	if (slot.generation == 0)
+		slot.generation = 1;
+
+	ObjectID instance_id = (slot.generation << SLOT_BITS) | index;
+	atomic_store_release(&slot.object, p_object);
+	atomic_store_release(&slot.validator, instance_id);
 	instance_checks[p_object] = instance_id;
+	object_count++;
 
 	rw_lock->write_unlock();
 
@@ -2023,32 +2039,38 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 
 void ObjectDB::remove_instance(Object *p_object) {
 
+	ObjectID instance_id = p_object->get_instance_id();
+	uint32_t index = instance_id & (SLOT_MAX - 1);
+
 	rw_lock->write_lock();
 
-	instances.erase(p_object->get_instance_id());
-	instance_checks.erase(p_object);
+	Slot *page = slot_pages[index >> SLOT_PAGE_BITS];
+	if (!page || page[index & (SLOT_PAGE_SIZE - 1)].validator != instance_id) {
+		rw_lock->write_unlock();
+		ERR_FAIL();
+	}
 
-	rw_lock->write_unlock();
-}
-Object *ObjectDB::get_instance(ObjectID p_instance_ID) {
+	Slot &slot = page[index & (SLOT_PAGE_SIZE - 1)];
+	atomic_store_release(&slot.validator, 0);
+	atomic_store_release(&slot.object, (Object *)NULL);
+	slot.next_free = slot_free_list;
+	slot_free_list = index;
 
-	rw_lock->read_lock();
-	Object **obj = instances.getptr(p_instance_ID);
-	rw_lock->read_unlock();
+	instance_checks.erase(p_object);
+	object_count--;
 
-	if (!obj)
-		return NULL;
-	return *obj;
+	rw_lock->write_unlock();
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
 
 	rw_lock->read_lock();
 
-	const ObjectID *K = NULL;
-	while ((K = instances.next(K))) {
+	for (uint32_t i = 1; i < slot_count; i++) {
 
-		p_func(instances[*K]);
+		Slot &slot = slot_pages[i >> SLOT_PAGE_BITS][i & (SLOT_PAGE_SIZE - 1)];
+		if (slot.validator)
+			p_func(slot.object);
 	}
 
 	rw_lock->read_unlock();
@@ -2059,11 +2081,7 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 
 int ObjectDB::get_object_count() {
 
-	rw_lock->read_lock();
-	int count = instances.size();
-	rw_lock->read_unlock();
-
-	return count;
+	return object_count;
 }
 
 RWLock *ObjectDB::rw_lock = NULL;
@@ -2076,23 +2094,36 @@ void ObjectDB::setup() {
 void ObjectDB::cleanup() {
 
 	rw_lock->write_lock();
-	if (instances.size()) {
+	if (object_count) {
 
 		WARN_PRINT("ObjectDB Instances still exist!");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			const ObjectID *K = NULL;
-			while ((K = instances.next(K))) {
+			for (uint32_t i = 1; i < slot_count; i++) {
+
+				Slot &slot = slot_pages[i >> SLOT_PAGE_BITS][i & (SLOT_PAGE_SIZE - 1)];
+				if (!slot.validator)
+					continue;
 
+				Object *obj = slot.object;
 				String node_name;
-				if (instances[*K]->is_class("Node"))
-					node_name = " - Node name: " + String(instances[*K]->call("get_name"));
-				if (instances[*K]->is_class("Resource"))
-					node_name = " - Resource name: " + String(instances[*K]->call("get_name")) + " Path: " + String(instances[*K]->call("get_path"));
-				print_line("Leaked instance: " + String(instances[*K]->get_class()) + ":" + itos(*K) + node_name);
+				if (obj->is_class("Node"))
+					node_name = " - Node name: " + String(obj->call("get_name"));
+				if (obj->is_class("Resource"))
+					node_name = " - Resource name: " + String(obj->call("get_name")) + " Path: " + String(obj->call("get_path"));
+				print_line("Leaked instance: " + String(obj->get_class()) + ":" + itos(slot.validator) + node_name);
 			}
 		}
 	}
-	instances.clear();
+
+	for (int i = 0; i < SLOT_PAGE_COUNT; i++) {
+		if (slot_pages[i]) {
+			memfree(slot_pages[i]);
+			slot_pages[i] = NULL;
+		}
+	}
+	slot_count = 1;
+	slot_free_list = 0;
+	object_count = 0;
 	instance_checks.clear();
 	rw_lock->write_unlock();
 	memdelete(rw_lock);
@@ -35,6 +35,7 @@
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/rw_lock.h"
+#include "core/safe_refcount.h"
 #include "core/set.h"
 #include "core/variant.h"
 #include "core/vmap.h"
@@ -736,11 +737,44 @@ public:
 	virtual ~Object();
 };
 
+#ifdef DEBUG_ENABLED
+
+// Marks an object as busy in a call, so scripts can't free it from under the caller.
+// Script VMs that call MethodBinds directly take it the same way Object::call() does.
+struct _ObjectDebugLock {
+
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+
+#endif
+
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
 class ObjectDB {
 
+	// An ObjectID packs the index of the object's slot in the low bits and the
+	// generation of that slot above them. Slots are reused through a free list
+	// and get a new generation each time, so a stale ID never resolves to a
+	// newer object. Slots live in fixed size pages that never move once
+	// allocated, which lets get_instance() read them without taking the lock.
+	enum {
+		SLOT_BITS = 24,
+		SLOT_MAX = 1 << SLOT_BITS,
+		SLOT_PAGE_BITS = 12,
+		SLOT_PAGE_SIZE = 1 << SLOT_PAGE_BITS,
+		SLOT_PAGE_COUNT = SLOT_MAX / SLOT_PAGE_SIZE,
+		GENERATION_BITS = 63 - SLOT_BITS, // keep IDs positive when stored in an int Variant
+	};
+
 	struct ObjectPtrHash {
 
 		static _FORCE_INLINE_ uint32_t hash(const Object *p_obj) {
@@ -754,10 +788,20 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<ObjectID, Object *> instances;
+	struct Slot {
+		volatile ObjectID validator; // ID of the object in the slot, 0 while free.
+		Object *volatile object;
+		uint64_t generation;
+		uint32_t next_free;
+	};
+
+	static Slot *volatile slot_pages[SLOT_PAGE_COUNT];
+	static uint32_t slot_count;
+	static uint32_t slot_free_list;
+	static uint32_t object_count;
+
 	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
 
-	static ObjectID instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
@@ -771,7 +815,24 @@ class ObjectDB {
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(ObjectID p_instance_ID);
+	_FORCE_INLINE_ static Object *get_instance(ObjectID p_instance_ID) {
+
+		uint32_t index = p_instance_ID & (SLOT_MAX - 1);
+		Slot *page = atomic_load_acquire(&slot_pages[index >> SLOT_PAGE_BITS]);
+		if (unlikely(!page))
+			return NULL;
+
+		// The slot can be released and reused while it's read, so the object
+		// only counts if the validator still matches after loading it.
+		Slot &slot = page[index & (SLOT_PAGE_SIZE - 1)];
+		if (atomic_load_acquire(&slot.validator) != p_instance_ID)
+			return NULL;
+		Object *object = atomic_load_acquire(&slot.object);
+		if (atomic_load_acquire(&slot.validator) != p_instance_ID)
+			return NULL;
+		return object;
+	}
+
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
 
@@ -110,6 +110,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_ptr(int p_length) const { return NULL; } ///< get a read-only pointer to the next p_length bytes and skip them, or NULL if the file is not memory backed (nothing is read then)
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -0,0 +1,61 @@
+/*************************************************************************/
+/*  file_watcher.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include "core/set.h"
+#include "core/ustring.h"
+
+/**
+ * Change feed for directories of the host file system.
+ * Each watched directory is reported (by its absolute path) when an entry in
+ * it is added, removed, renamed or modified. Directories are not watched
+ * recursively, every subdirectory must be added on its own.
+ * Platforms without support return NULL from create(), users must fall back
+ * to scanning.
+ */
+
+class FileWatcher {
+protected:
+	static FileWatcher *(*create_func)();
+
+public:
+	virtual Error add_dir(const String &p_path) = 0; ///< Start watching a directory, ERR_OUT_OF_MEMORY if the system limit is reached
+	virtual void remove_dir(const String &p_path) = 0; ///< Stop watching a directory
+	virtual bool get_changed_dirs(Set<String> *r_dirs) = 0; ///< Collect the directories changed since the last call, false if events were lost and everything must be rescanned
+
+	static bool is_supported() { return create_func != NULL; }
+	static FileWatcher *create(); ///< Create a watcher, NULL if not supported
+
+	virtual ~FileWatcher();
+};
+
+#endif // FILE_WATCHER_H
@@ -32,6 +32,7 @@
 
 #include "core/error_macros.h"
 #include "core/os/copymem.h"
+#include "core/os/slab_allocator.h"
 #include "core/safe_refcount.h"
 
 #include <stdio.h>
@@ -74,6 +75,33 @@ uint64_t Memory::max_usage = 0;
 
 uint64_t Memory::alloc_count = 0;
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+
+#define MEMORY_ALLOC(m_size) SlabAllocator::alloc(m_size)
+#define MEMORY_REALLOC(m_mem, m_size) SlabAllocator::realloc(m_mem, m_size)
+#define MEMORY_FREE(m_mem) SlabAllocator::free(m_mem)
+
+// Counted per thread by the slab allocator, summed up when read.
+#define MEMORY_COUNT_ALLOC() SlabAllocator::get_thread_stats()->alloc_count++
+#define MEMORY_COUNT_FREE() SlabAllocator::get_thread_stats()->alloc_count--
+#define MEMORY_ADD_USAGE(m_bytes) SlabAllocator::get_thread_stats()->mem_usage += m_bytes
+#define MEMORY_SUB_USAGE(m_bytes) SlabAllocator::get_thread_stats()->mem_usage -= m_bytes
+
+#else
+
+#define MEMORY_ALLOC(m_size) malloc(m_size)
+#define MEMORY_REALLOC(m_mem, m_size) realloc(m_mem, m_size)
+#define MEMORY_FREE(m_mem) free(m_mem)
+
+#define MEMORY_COUNT_ALLOC() atomic_increment(&alloc_count)
+#define MEMORY_COUNT_FREE() atomic_decrement(&alloc_count)
+#define MEMORY_ADD_USAGE(m_bytes)       \
+	atomic_add(&mem_usage, m_bytes); \
+	atomic_exchange_if_greater(&max_usage, mem_usage)
+#define MEMORY_SUB_USAGE(m_bytes) atomic_sub(&mem_usage, m_bytes)
+
+#endif
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 #ifdef DEBUG_ENABLED
@@ -82,11 +110,11 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = MEMORY_ALLOC(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, NULL);
 
-	atomic_increment(&alloc_count);
+	MEMORY_COUNT_ALLOC();
 
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
@@ -95,8 +123,7 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 		uint8_t *s8 = (uint8_t *)mem;
 
 #ifdef DEBUG_ENABLED
-		atomic_add(&mem_usage, p_bytes);
-		atomic_exchange_if_greater(&max_usage, mem_usage);
+		MEMORY_ADD_USAGE(p_bytes);
 #endif
 		return s8 + PAD_ALIGN;
 	} else {
@@ -124,20 +151,19 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 #ifdef DEBUG_ENABLED
 		if (p_bytes > *s) {
-			atomic_add(&mem_usage, p_bytes - *s);
-			atomic_exchange_if_greater(&max_usage, mem_usage);
+			MEMORY_ADD_USAGE(p_bytes - *s);
 		} else {
-			atomic_sub(&mem_usage, *s - p_bytes);
+			MEMORY_SUB_USAGE(*s - p_bytes);
 		}
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			MEMORY_FREE(mem);
 			return NULL;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)MEMORY_REALLOC(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, NULL);
 
 			s = (uint64_t *)mem;
@@ -148,7 +174,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		}
 	} else {
 
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)MEMORY_REALLOC(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == NULL && p_bytes > 0, NULL);
 
@@ -168,20 +194,20 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	atomic_decrement(&alloc_count);
+	MEMORY_COUNT_FREE();
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
 #ifdef DEBUG_ENABLED
 		uint64_t *s = (uint64_t *)mem;
-		atomic_sub(&mem_usage, *s);
+		MEMORY_SUB_USAGE(*s);
 #endif
 
-		free(mem);
+		MEMORY_FREE(mem);
 	} else {
 
-		free(mem);
+		MEMORY_FREE(mem);
 	}
 }
 
@@ -191,7 +217,13 @@ uint64_t Memory::get_mem_available() {
 }
 
 uint64_t Memory::get_mem_usage() {
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) && defined(SLAB_ALLOCATOR_ENABLED)
+	SlabAllocator::Stats stats;
+	SlabAllocator::get_stats(&stats);
+	mem_usage = stats.mem_usage;
+	atomic_exchange_if_greater(&max_usage, mem_usage); // peak as seen by whoever asks
+	return mem_usage;
+#elif defined(DEBUG_ENABLED)
 	return mem_usage;
 #else
 	return 0;
@@ -199,13 +231,22 @@ uint64_t Memory::get_mem_usage() {
 }
 
 uint64_t Memory::get_mem_max_usage() {
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) && defined(SLAB_ALLOCATOR_ENABLED)
+	get_mem_usage();
+	return max_usage;
+#elif defined(DEBUG_ENABLED)
 	return max_usage;
 #else
 	return 0;
 #endif
 }
 
+void Memory::release_thread_cache() {
+#ifdef SLAB_ALLOCATOR_ENABLED
+	SlabAllocator::release_thread_cache();
+#endif
+}
+
 _GlobalNil::_GlobalNil() {
 
 	color = 1;
@@ -61,6 +61,9 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// Call from a thread that is about to end, so its cached memory can be reused.
+	static void release_thread_cache();
 };
 
 class DefaultAllocator {
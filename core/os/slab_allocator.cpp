@@ -0,0 +1,409 @@
+/*************************************************************************/
+/*  slab_allocator.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "slab_allocator.h"
+
+#ifdef SLAB_ALLOCATOR_ENABLED
+
+#include "core/os/copymem.h"
+#include "core/safe_refcount.h"
+
+#include <stdlib.h>
+
+#if defined(NO_THREADS)
+#define SLAB_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define SLAB_THREAD_LOCAL __declspec(thread)
+#else
+#define SLAB_THREAD_LOCAL __thread
+#endif
+
+// Memory is in use long before the OS can create a Mutex, so use a plain ticket lock.
+// Everything here is zero initialized on purpose, allocations happen during static init.
+struct SlabLock {
+
+	volatile uint32_t next;
+	volatile uint32_t serving;
+
+	_FORCE_INLINE_ void lock() {
+		uint32_t ticket = atomic_increment(&next) - 1;
+		while (serving != ticket) {
+		}
+		atomic_add(&serving, 0); // full barrier before touching what the lock guards
+	}
+
+	_FORCE_INLINE_ void unlock() {
+		atomic_increment(&serving);
+	}
+};
+
+static const uint32_t class_sizes[SlabAllocator::SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512
+};
+
+// Indexed by the size rounded up to 16 bytes, divided by 16.
+static const uint8_t class_lookup[SlabAllocator::MAX_BLOCK_SIZE / 16 + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 7,
+	8, 8, 9, 9, 10, 10, 11, 11,
+	12, 12, 12, 12, 13, 13, 13, 13,
+	14, 14, 14, 14, 15, 15, 15, 15
+};
+
+// Blocks moved between a thread and the global pool at once, about 4KiB worth.
+static _FORCE_INLINE_ uint32_t _get_batch(int p_class) {
+
+	uint32_t batch = 4096 / class_sizes[p_class];
+	return batch < 8 ? 8 : (batch > 64 ? 64 : batch);
+}
+
+/* Chunk map, tells which size class a 64KiB chunk belongs to (plus one), or zero for memory that came from malloc().
+   Two levels cover a 48 bit address space: address bits 32-47 pick a leaf, bits 16-31 the entry in it. */
+
+#define SLAB_ADDRESS_BITS 48
+#define SLAB_CHUNK_SHIFT 16
+#define SLAB_LEAF_SHIFT 32
+#define SLAB_LEAF_SIZE (1 << (SLAB_LEAF_SHIFT - SLAB_CHUNK_SHIFT))
+
+static uint8_t *chunk_map[1 << (SLAB_ADDRESS_BITS - SLAB_LEAF_SHIFT)];
+
+static _FORCE_INLINE_ int _get_class(const void *p_memory) {
+
+	uint64_t addr = (uint64_t)(uintptr_t)p_memory;
+	if (unlikely(addr >> SLAB_ADDRESS_BITS)) {
+		return -1;
+	}
+	const uint8_t *leaf = chunk_map[addr >> SLAB_LEAF_SHIFT];
+	if (!leaf) {
+		return -1;
+	}
+	return int(leaf[(addr >> SLAB_CHUNK_SHIFT) & (SLAB_LEAF_SIZE - 1)]) - 1;
+}
+
+#define SLAB_ARENA_CHUNKS 16
+
+static SlabLock chunk_lock;
+static uint8_t *arena_pos;
+static uint8_t *arena_end;
+static volatile bool slab_disabled;
+
+// Chunks are cut from malloc()ed arenas aligned to CHUNK_SIZE, and are never freed.
+static uint8_t *_alloc_chunk(int p_class) {
+
+	chunk_lock.lock();
+
+	if (arena_pos == arena_end) {
+		uint8_t *mem = (uint8_t *)malloc(SlabAllocator::CHUNK_SIZE * (SLAB_ARENA_CHUNKS + 1));
+		if (!mem) {
+			chunk_lock.unlock();
+			return NULL;
+		}
+
+		uint8_t *aligned = (uint8_t *)(((uintptr_t)mem + SlabAllocator::CHUNK_SIZE - 1) & ~(uintptr_t)(SlabAllocator::CHUNK_SIZE - 1));
+		if (((uint64_t)(uintptr_t)(aligned + SlabAllocator::CHUNK_SIZE * SLAB_ARENA_CHUNKS)) >> SLAB_ADDRESS_BITS) {
+			// outside what the chunk map can describe, leave everything to malloc()
+			free(mem);
+			slab_disabled = true;
+			chunk_lock.unlock();
+			return NULL;
+		}
+
+		arena_pos = aligned;
+		arena_end = aligned + SlabAllocator::CHUNK_SIZE * SLAB_ARENA_CHUNKS;
+	}
+
+	uint8_t *chunk = arena_pos;
+	uint64_t addr = (uint64_t)(uintptr_t)chunk;
+
+	uint8_t *&leaf = chunk_map[addr >> SLAB_LEAF_SHIFT];
+	if (!leaf) {
+		leaf = (uint8_t *)calloc(SLAB_LEAF_SIZE, 1);
+		if (!leaf) {
+			chunk_lock.unlock();
+			return NULL;
+		}
+	}
+	leaf[(addr >> SLAB_CHUNK_SHIFT) & (SLAB_LEAF_SIZE - 1)] = p_class + 1;
+	arena_pos += SlabAllocator::CHUNK_SIZE;
+
+	chunk_lock.unlock();
+	return chunk;
+}
+
+/* Global pool per size class, blocks come back here in batches from the thread caches. */
+
+struct SlabPool {
+
+	SlabLock lock;
+	void *free_list;
+	uint8_t *carve_pos;
+	uint8_t *carve_end;
+	uint64_t reserved_blocks;
+};
+
+static SlabPool pools[SlabAllocator::SIZE_CLASS_COUNT];
+
+/* Thread caches. They live for the whole run, a thread that ends leaves its cache for the next one to adopt. */
+
+struct SlabThreadCache {
+
+	SlabThreadCache *next;
+	bool in_use;
+	void *free_list[SlabAllocator::SIZE_CLASS_COUNT];
+	uint32_t free_count[SlabAllocator::SIZE_CLASS_COUNT];
+	SlabAllocator::Stats stats;
+};
+
+static SlabLock cache_lock;
+static SlabThreadCache *caches;
+static SLAB_THREAD_LOCAL SlabThreadCache *thread_cache;
+
+static _FORCE_INLINE_ SlabThreadCache *_get_thread_cache() {
+
+	SlabThreadCache *tc = thread_cache;
+	if (likely(tc)) {
+		return tc;
+	}
+
+	cache_lock.lock();
+	for (tc = caches; tc; tc = tc->next) {
+		if (!tc->in_use) {
+			break;
+		}
+	}
+	if (!tc) {
+		tc = (SlabThreadCache *)calloc(1, sizeof(SlabThreadCache));
+		if (!tc) {
+			cache_lock.unlock();
+			abort(); // no memory left for even this, nothing sensible to do
+		}
+		tc->next = caches;
+		caches = tc;
+	}
+	tc->in_use = true;
+	cache_lock.unlock();
+
+	thread_cache = tc;
+	return tc;
+}
+
+// Takes a batch from the pool, returns one block of it and keeps the rest in the thread cache.
+static void *_refill(SlabThreadCache *p_cache, int p_class) {
+
+	SlabPool &pool = pools[p_class];
+	uint32_t size = class_sizes[p_class];
+	uint32_t batch = _get_batch(p_class);
+	void *list = NULL;
+	uint32_t count = 0;
+
+	pool.lock.lock();
+
+	while (count < batch && pool.free_list) {
+		void *block = pool.free_list;
+		pool.free_list = *(void **)block;
+		*(void **)block = list;
+		list = block;
+		count++;
+	}
+
+	while (count < batch) {
+		if (pool.carve_pos == pool.carve_end) {
+			uint8_t *chunk = _alloc_chunk(p_class);
+			if (!chunk) {
+				break;
+			}
+			pool.carve_pos = chunk;
+			pool.carve_end = chunk + (SlabAllocator::CHUNK_SIZE / size) * size;
+			pool.reserved_blocks += SlabAllocator::CHUNK_SIZE / size;
+		}
+
+		void *block = pool.carve_pos;
+		pool.carve_pos += size;
+		*(void **)block = list;
+		list = block;
+		count++;
+	}
+
+	pool.lock.unlock();
+
+	if (!list) {
+		return NULL;
+	}
+
+	p_cache->free_list[p_class] = *(void **)list;
+	p_cache->free_count[p_class] = count - 1;
+	return list;
+}
+
+// Hands the first p_count cached blocks of a class back to the pool.
+static void _flush(SlabThreadCache *p_cache, int p_class, uint32_t p_count) {
+
+	void *head = p_cache->free_list[p_class];
+	void *tail = head;
+	for (uint32_t i = 1; i < p_count; i++) {
+		tail = *(void **)tail;
+	}
+
+	p_cache->free_list[p_class] = *(void **)tail;
+	p_cache->free_count[p_class] -= p_count;
+
+	SlabPool &pool = pools[p_class];
+	pool.lock.lock();
+	*(void **)tail = pool.free_list;
+	pool.free_list = head;
+	pool.lock.unlock();
+}
+
+void *SlabAllocator::alloc(size_t p_bytes) {
+
+	if (p_bytes > MAX_BLOCK_SIZE || slab_disabled) {
+		return ::malloc(p_bytes);
+	}
+
+	int size_class = class_lookup[(p_bytes + 15) >> 4];
+	SlabThreadCache *tc = _get_thread_cache();
+
+	void *block = tc->free_list[size_class];
+	if (likely(block)) {
+		tc->free_list[size_class] = *(void **)block;
+		tc->free_count[size_class]--;
+	} else {
+		block = _refill(tc, size_class);
+		if (!block) {
+			return ::malloc(p_bytes);
+		}
+	}
+
+	tc->stats.used_blocks[size_class]++;
+	return block;
+}
+
+void *SlabAllocator::realloc(void *p_memory, size_t p_bytes) {
+
+	int size_class = _get_class(p_memory);
+	if (size_class < 0) {
+		return ::realloc(p_memory, p_bytes);
+	}
+
+	if (p_bytes == 0) {
+		free(p_memory);
+		return NULL;
+	}
+
+	uint32_t block_size = class_sizes[size_class];
+	if (p_bytes <= block_size) {
+		return p_memory;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (!mem) {
+		return NULL;
+	}
+	copymem(mem, p_memory, block_size);
+	free(p_memory);
+	return mem;
+}
+
+void SlabAllocator::free(void *p_memory) {
+
+	int size_class = _get_class(p_memory);
+	if (size_class < 0) {
+		::free(p_memory);
+		return;
+	}
+
+	SlabThreadCache *tc = _get_thread_cache();
+	*(void **)p_memory = tc->free_list[size_class];
+	tc->free_list[size_class] = p_memory;
+	tc->stats.used_blocks[size_class]--;
+
+	uint32_t batch = _get_batch(size_class);
+	if (unlikely(++tc->free_count[size_class] > batch * 2)) {
+		_flush(tc, size_class, batch);
+	}
+}
+
+SlabAllocator::Stats *SlabAllocator::get_thread_stats() {
+
+	return &_get_thread_cache()->stats;
+}
+
+void SlabAllocator::get_stats(Stats *r_total) {
+
+	Stats total = {};
+
+	cache_lock.lock();
+	for (const SlabThreadCache *tc = caches; tc; tc = tc->next) {
+		total.alloc_count += tc->stats.alloc_count;
+		total.mem_usage += tc->stats.mem_usage;
+		for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+			total.used_blocks[i] += tc->stats.used_blocks[i];
+		}
+	}
+	cache_lock.unlock();
+
+	*r_total = total;
+}
+
+void SlabAllocator::get_size_class_info(SizeClassInfo *r_info) {
+
+	Stats total;
+	get_stats(&total);
+
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		pools[i].lock.lock();
+		r_info[i].reserved_blocks = pools[i].reserved_blocks;
+		pools[i].lock.unlock();
+
+		r_info[i].block_size = class_sizes[i];
+		r_info[i].used_blocks = total.used_blocks[i] > 0 ? total.used_blocks[i] : 0;
+	}
+}
+
+void SlabAllocator::release_thread_cache() {
+
+	SlabThreadCache *tc = thread_cache;
+	if (!tc) {
+		return;
+	}
+
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		if (tc->free_count[i]) {
+			_flush(tc, i, tc->free_count[i]);
+		}
+	}
+
+	thread_cache = NULL;
+
+	cache_lock.lock();
+	tc->in_use = false;
+	cache_lock.unlock();
+}
+
+#endif // SLAB_ALLOCATOR_ENABLED
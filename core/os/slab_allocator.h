@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  slab_allocator.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+#ifdef SLAB_ALLOCATOR_ENABLED
+
+/**
+	Thread caching size class allocator used by Memory for small blocks.
+
+	Small blocks are carved from 64KiB chunks, each dedicated to one size class.
+	Every thread keeps a short free list per class and trades batches with the
+	global pools, so most allocations never take a lock. Larger requests go to
+	malloc(). Chunks are never given back to the system.
+
+	Statistics are kept per thread and only summed up when asked for.
+*/
+
+class SlabAllocator {
+public:
+	enum {
+		SIZE_CLASS_COUNT = 16,
+		MAX_BLOCK_SIZE = 512,
+		CHUNK_SIZE = 65536
+	};
+
+	struct Stats {
+		int64_t alloc_count;
+		int64_t mem_usage;
+		int64_t used_blocks[SIZE_CLASS_COUNT];
+	};
+
+	struct SizeClassInfo {
+		uint32_t block_size;
+		uint64_t used_blocks;
+		uint64_t reserved_blocks;
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Only touched by the calling thread, never NULL.
+	static Stats *get_thread_stats();
+	static void get_stats(Stats *r_total);
+	static void get_size_class_info(SizeClassInfo *r_info);
+
+	// Gives the calling thread's cached blocks back, called when a thread ends.
+	static void release_thread_cache();
+};
+
+#endif // SLAB_ALLOCATOR_ENABLED
+
+#endif // SLAB_ALLOCATOR_H
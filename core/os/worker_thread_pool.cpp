@@ -0,0 +1,420 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/os.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = NULL;
+
+WorkerThreadPool::TaskQueue::TaskQueue() {
+
+	mutex = NULL;
+	buffer = NULL;
+	capacity = 0;
+	head = 0;
+	count = 0;
+}
+
+void WorkerThreadPool::TaskQueue::push_back(Group *p_group) {
+
+	if (count == capacity) {
+		uint32_t new_capacity = capacity ? capacity * 2 : 16;
+		Group **new_buffer = (Group **)memalloc(sizeof(Group *) * new_capacity);
+		for (uint32_t i = 0; i < count; i++) {
+			new_buffer[i] = buffer[(head + i) & (capacity - 1)];
+		}
+		if (buffer) {
+			memfree(buffer);
+		}
+		buffer = new_buffer;
+		capacity = new_capacity;
+		head = 0;
+	}
+
+	buffer[(head + count) & (capacity - 1)] = p_group;
+	count++;
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::TaskQueue::pop_back() {
+
+	if (count == 0)
+		return NULL;
+	count--;
+	return buffer[(head + count) & (capacity - 1)];
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::TaskQueue::pop_front() {
+
+	if (count == 0)
+		return NULL;
+	Group *g = buffer[head];
+	head = (head + 1) & (capacity - 1);
+	count--;
+	return g;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+
+	ThreadData *td = (ThreadData *)p_user;
+	WorkerThreadPool *pool = td->pool;
+
+	Thread::set_name("WorkerThreadPool");
+
+	while (true) {
+		pool->task_available->wait();
+		if (pool->exit_threads)
+			break;
+
+		while (Group *task = pool->_pop_task(td->index)) {
+			pool->_process_task(task);
+		}
+	}
+}
+
+int WorkerThreadPool::_get_current_worker() const {
+
+	Thread::ID caller = Thread::get_caller_id();
+	for (int i = 0; i < thread_count; i++) {
+		if (threads[i].thread && threads[i].thread->get_id() == caller)
+			return i;
+	}
+	return -1;
+}
+
+void WorkerThreadPool::_push_task(Group *p_group, int p_worker) {
+
+	// Workers keep their own work local, others spread it over all queues.
+	int q = p_worker >= 0 ? p_worker : int(atomic_increment(&next_queue) % queue_count);
+
+	TaskQueue &queue = queues[q];
+	queue.mutex->lock();
+	queue.push_back(p_group);
+	queue.mutex->unlock();
+
+	task_available->post();
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::_pop_task(int p_worker) {
+
+	if (p_worker >= 0) {
+		TaskQueue &own = queues[p_worker];
+		own.mutex->lock();
+		Group *g = own.pop_back();
+		own.mutex->unlock();
+		if (g)
+			return g;
+	}
+
+	// Steal, starting from the external queue so submitted work is picked up first.
+	for (int i = 0; i < queue_count; i++) {
+		int q = (thread_count + i) % queue_count;
+		if (q == p_worker)
+			continue;
+		TaskQueue &victim = queues[q];
+		victim.mutex->lock();
+		Group *g = victim.pop_front();
+		victim.mutex->unlock();
+		if (g)
+			return g;
+	}
+
+	return NULL;
+}
+
+void WorkerThreadPool::_schedule_group(Group *p_group) {
+
+	int worker = _get_current_worker();
+	for (uint32_t i = 0; i < p_group->tasks; i++) {
+		_push_task(p_group, worker);
+	}
+}
+
+void WorkerThreadPool::_process_task(Group *p_group) {
+
+	// Read before finishing, once the last share is done the group can be freed.
+	uint32_t tasks = p_group->tasks;
+
+	while (true) {
+		uint32_t idx = atomic_increment(&p_group->index) - 1;
+		if (idx >= p_group->elements)
+			break;
+
+		if (p_group->native_func) {
+			p_group->native_func(p_group->native_userdata, idx);
+		} else if (p_group->template_userdata) {
+			p_group->template_userdata->callback_indexed(idx);
+		} else {
+			Object *obj = ObjectDB::get_instance(p_group->script_instance);
+			ERR_CONTINUE(!obj);
+
+			Variant index = idx;
+			const Variant *args[2] = { &index, &p_group->script_userdata };
+			Variant::CallError ce;
+			obj->call(p_group->script_method, args, 2, ce);
+			if (ce.error != Variant::CallError::CALL_OK) {
+				ERR_PRINTS("Error calling group task method '" + String(p_group->script_method) + "': " + Variant::get_call_error_text(obj, p_group->script_method, args, 2, ce));
+			}
+		}
+	}
+
+	// The last share to finish completes the group. Shares that found no
+	// index left still count, so no queue references the group afterwards.
+	if (atomic_increment(&p_group->finished_tasks) == tasks) {
+		_group_completed(p_group);
+	}
+}
+
+void WorkerThreadPool::_group_completed(Group *p_group) {
+
+	Vector<Group *> ready;
+
+	groups_mutex->lock();
+	p_group->completed = true;
+	for (int i = 0; i < p_group->dependents.size(); i++) {
+		Group *dependent = p_group->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_group->dependents.clear();
+	// Posted under the lock, the waiter takes it again before freeing the group.
+	p_group->done->post();
+	groups_mutex->unlock();
+
+	for (int i = 0; i < ready.size(); i++) {
+		_schedule_group(ready[i]);
+	}
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group(Group *p_group, uint32_t p_elements, const Vector<GroupID> &p_dependencies) {
+
+	if (!queues) {
+		ERR_PRINT("WorkerThreadPool is not initialized.");
+		if (p_group->template_userdata) {
+			memdelete(p_group->template_userdata);
+		}
+		memdelete(p_group);
+		return INVALID_GROUP_ID;
+	}
+
+	p_group->elements = p_elements;
+	// One share per worker plus one for the thread that waits.
+	p_group->tasks = MAX(1, MIN(p_elements, uint32_t(thread_count + 1)));
+	p_group->done = Semaphore::create();
+
+	groups_mutex->lock();
+	p_group->id = ++last_group_id;
+	groups.set(p_group->id, p_group);
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		Group **dep = groups.getptr(p_dependencies[i]);
+		if (!dep || (*dep)->completed)
+			continue; // Already done (or already waited for and freed).
+		(*dep)->dependents.push_back(p_group);
+		p_group->pending_dependencies++;
+	}
+	bool ready = p_group->pending_dependencies == 0;
+	groups_mutex->unlock();
+
+	if (ready) {
+		_schedule_group(p_group);
+	}
+
+	return p_group->id;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(NativeGroupFunc p_func, void *p_userdata, uint32_t p_elements, const Vector<GroupID> &p_dependencies) {
+
+	ERR_FAIL_COND_V(!p_func, INVALID_GROUP_ID);
+
+	Group *group = memnew(Group);
+	group->native_func = p_func;
+	group->native_userdata = p_userdata;
+	return _add_group(group, p_elements, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_script_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, const PoolVector<int> &p_dependencies) {
+
+	ERR_FAIL_NULL_V(p_instance, INVALID_GROUP_ID);
+	ERR_FAIL_COND_V(p_elements < 0, INVALID_GROUP_ID);
+
+	Vector<GroupID> dependencies;
+	PoolVector<int>::Read r = p_dependencies.read();
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		dependencies.push_back(r[i]);
+	}
+
+	Group *group = memnew(Group);
+	group->script_instance = p_instance->get_instance_id();
+	group->script_method = p_method;
+	group->script_userdata = p_userdata;
+	return _add_group(group, p_elements, dependencies);
+}
+
+bool WorkerThreadPool::is_group_completed(GroupID p_group) const {
+
+	groups_mutex->lock();
+	Group *const *g = groups.getptr(p_group);
+	bool completed = !g || (*g)->completed;
+	groups_mutex->unlock();
+	return completed;
+}
+
+void WorkerThreadPool::wait_for_group(GroupID p_group) {
+
+	groups_mutex->lock();
+	Group **gp = groups.getptr(p_group);
+	Group *group = gp ? *gp : NULL;
+	groups_mutex->unlock();
+
+	ERR_FAIL_COND(!group);
+
+	int worker = _get_current_worker();
+
+	// Help with whatever is queued, block only when there is nothing left to steal.
+	while (!group->completed) {
+		Group *task = _pop_task(worker);
+		if (task) {
+			_process_task(task);
+		} else {
+			group->done->wait();
+			break;
+		}
+	}
+
+	groups_mutex->lock();
+	groups.erase(p_group);
+	groups_mutex->unlock();
+
+	memdelete(group->done);
+	if (group->template_userdata) {
+		memdelete(group->template_userdata);
+	}
+	memdelete(group);
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(threads != NULL);
+
+	if (p_thread_count < 0) {
+		// The thread that waits for a group also works, so leave it a core.
+		p_thread_count = MAX(1, OS::get_singleton()->get_processor_count() - 1);
+	}
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#endif
+
+	thread_count = p_thread_count;
+	queue_count = thread_count + 1;
+	queues = memnew_arr(TaskQueue, queue_count);
+	for (int i = 0; i < queue_count; i++) {
+		queues[i].mutex = Mutex::create();
+	}
+
+	exit_threads = false;
+	threads = memnew_arr(ThreadData, MAX(1, thread_count));
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].index = i;
+		threads[i].thread = NULL;
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].thread = Thread::create(_thread_function, &threads[i]);
+	}
+}
+
+void WorkerThreadPool::finish() {
+
+	if (!threads)
+		return;
+
+	groups_mutex->lock();
+	if (groups.size()) {
+		WARN_PRINTS("WorkerThreadPool: " + itos(groups.size()) + " group(s) were never waited for.");
+	}
+	groups_mutex->unlock();
+
+	exit_threads = true;
+	for (int i = 0; i < thread_count; i++) {
+		task_available->post();
+	}
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i].thread);
+		memdelete(threads[i].thread);
+	}
+	memdelete_arr(threads);
+	threads = NULL;
+
+	for (int i = 0; i < queue_count; i++) {
+		memdelete(queues[i].mutex);
+		if (queues[i].buffer) {
+			memfree(queues[i].buffer);
+		}
+	}
+	memdelete_arr(queues);
+	queues = NULL;
+	thread_count = 0;
+	queue_count = 0;
+}
+
+void WorkerThreadPool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add_group_task", "instance", "method", "elements", "userdata", "dependencies"), &WorkerThreadPool::_add_script_group_task, DEFVAL(Variant()), DEFVAL(PoolVector<int>()));
+	ClassDB::bind_method(D_METHOD("is_group_completed", "group_id"), &WorkerThreadPool::is_group_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_group", "group_id"), &WorkerThreadPool::wait_for_group);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &WorkerThreadPool::get_thread_count);
+	ClassDB::bind_method(D_METHOD("get_thread_index"), &WorkerThreadPool::get_thread_index);
+
+	BIND_CONSTANT(INVALID_GROUP_ID);
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+
+	singleton = this;
+	threads = NULL;
+	thread_count = 0;
+	queues = NULL;
+	queue_count = 0;
+	next_queue = 0;
+	exit_threads = false;
+	last_group_id = 0;
+	task_available = Semaphore::create();
+	groups_mutex = Mutex::create();
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+
+	finish();
+	memdelete(task_available);
+	memdelete(groups_mutex);
+	singleton = NULL;
+}
@@ -0,0 +1,201 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/hash_map.h"
+#include "core/object.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
+/**
+ * Persistent pool of worker threads shared by the whole engine.
+ *
+ * Work is submitted as groups: a group runs a callback once for every
+ * element index in [0, elements), spread over the workers. A group may
+ * depend on other groups, in which case it is only scheduled once all of
+ * them have completed. Every group must be waited for exactly once with
+ * wait_for_group(), which also frees it. The waiting thread helps running
+ * queued work until the group completes, so waiting from inside a task is
+ * allowed.
+ *
+ * Each worker owns a deque: it pushes and pops work at the back, while idle
+ * workers and waiting threads steal from the front.
+ */
+
+class WorkerThreadPool : public Object {
+
+	GDCLASS(WorkerThreadPool, Object);
+
+public:
+	typedef int GroupID;
+
+	enum {
+		INVALID_GROUP_ID = -1
+	};
+
+	typedef void (*NativeGroupFunc)(void *p_userdata, uint32_t p_index);
+
+	struct BaseTemplateUserdata {
+		virtual void callback_indexed(uint32_t p_index) = 0;
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+private:
+	struct Group {
+		GroupID id;
+		uint32_t elements;
+		volatile uint32_t index;
+		uint32_t tasks;
+		volatile uint32_t finished_tasks;
+		volatile bool completed;
+		int pending_dependencies;
+		Vector<Group *> dependents;
+		Semaphore *done;
+
+		NativeGroupFunc native_func;
+		void *native_userdata;
+		BaseTemplateUserdata *template_userdata;
+
+		ObjectID script_instance;
+		StringName script_method;
+		Variant script_userdata;
+
+		Group() {
+			id = INVALID_GROUP_ID;
+			elements = 0;
+			index = 0;
+			tasks = 0;
+			finished_tasks = 0;
+			completed = false;
+			pending_dependencies = 0;
+			done = NULL;
+			native_func = NULL;
+			native_userdata = NULL;
+			template_userdata = NULL;
+			script_instance = 0;
+		}
+	};
+
+	// Ring buffer of task entries, each entry runs one share of a group.
+	struct TaskQueue {
+		Mutex *mutex;
+		Group **buffer;
+		uint32_t capacity;
+		uint32_t head;
+		uint32_t count;
+
+		void push_back(Group *p_group);
+		Group *pop_back();
+		Group *pop_front();
+
+		TaskQueue();
+	};
+
+	struct ThreadData {
+		WorkerThreadPool *pool;
+		Thread *thread;
+		int index;
+	};
+
+	static WorkerThreadPool *singleton;
+
+	ThreadData *threads;
+	int thread_count;
+	TaskQueue *queues; // one per worker, plus one for external submitters
+	int queue_count;
+	volatile uint32_t next_queue;
+	Semaphore *task_available;
+	volatile bool exit_threads;
+
+	Mutex *groups_mutex;
+	HashMap<GroupID, Group *> groups;
+	GroupID last_group_id;
+
+	static void _thread_function(void *p_user);
+
+	int _get_current_worker() const;
+	void _push_task(Group *p_group, int p_worker);
+	Group *_pop_task(int p_worker);
+	void _schedule_group(Group *p_group);
+	void _process_task(Group *p_group);
+	void _group_completed(Group *p_group);
+	GroupID _add_group(Group *p_group, uint32_t p_elements, const Vector<GroupID> &p_dependencies);
+
+	GroupID _add_script_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, const PoolVector<int> &p_dependencies);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static _FORCE_INLINE_ WorkerThreadPool *get_singleton() { return singleton; }
+
+	GroupID add_native_group_task(NativeGroupFunc p_func, void *p_userdata, uint32_t p_elements, const Vector<GroupID> &p_dependencies = Vector<GroupID>());
+
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, const Vector<GroupID> &p_dependencies = Vector<GroupID>()) {
+
+		GroupUserData<C, M, U> *ud = memnew((GroupUserData<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Group *group = memnew(Group);
+		group->template_userdata = ud;
+		return _add_group(group, p_elements, p_dependencies);
+	}
+
+	bool is_group_completed(GroupID p_group) const;
+	void wait_for_group(GroupID p_group);
+
+	int get_thread_count() const { return thread_count; }
+	int get_thread_index() const { return _get_current_worker(); }
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
@@ -59,6 +59,7 @@
 #include "core/math/triangle_mesh.h"
 #include "core/os/input.h"
 #include "core/os/main_loop.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/packed_data_container.h"
 #include "core/path_remap.h"
 #include "core/project_settings.h"
@@ -94,6 +95,7 @@ void register_core_types() {
 
 	ObjectDB::setup();
 	ResourceCache::setup();
+	ResourceLoader::initialize();
 	MemoryPool::setup();
 
 	_global_mutex = Mutex::create();
@@ -155,6 +157,7 @@ void register_core_types() {
 	ClassDB::register_class<PacketPeerStream>();
 	ClassDB::register_virtual_class<NetworkedMultiplayerPeer>();
 	ClassDB::register_class<MultiplayerAPI>();
+	ClassDB::register_virtual_class<MultiplayerReplicator>();
 	ClassDB::register_class<MainLoop>();
 	ClassDB::register_class<Translation>();
 	ClassDB::register_class<PHashTranslation>();
@@ -220,6 +223,7 @@ void register_core_singletons() {
 	ClassDB::register_class<TranslationServer>();
 	ClassDB::register_virtual_class<Input>();
 	ClassDB::register_class<InputMap>();
+	ClassDB::register_virtual_class<WorkerThreadPool>();
 	ClassDB::register_class<_JSON>();
 	ClassDB::register_class<Expression>();
 
@@ -235,6 +239,7 @@ void register_core_singletons() {
 	Engine::get_singleton()->add_singleton(Engine::Singleton("TranslationServer", TranslationServer::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("Input", Input::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("InputMap", InputMap::get_singleton()));
+	Engine::get_singleton()->add_singleton(Engine::Singleton("WorkerThreadPool", WorkerThreadPool::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("JSON", _JSON::get_singleton()));
 }
 
@@ -274,6 +279,7 @@ void unregister_core_types() {
 	unregister_global_constants();
 
 	ClassDB::cleanup();
+	ResourceLoader::finalize();
 	ResourceCache::clear();
 	CoreStringNames::free();
 	StringName::cleanup();
@@ -93,6 +93,18 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	return *pw;
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	*pw = val;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -148,6 +160,18 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	}
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	__atomic_store_n(pw, val, __ATOMIC_RELEASE);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -165,6 +189,19 @@ uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
 
+// MSVC gives volatile accesses acquire/release semantics (/volatile:ms, the default on x86 and x64).
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	*pw = val;
+}
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
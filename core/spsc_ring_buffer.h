@@ -0,0 +1,179 @@
+/*************************************************************************/
+/*  spsc_ring_buffer.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include "core/os/memory.h"
+#include "core/safe_refcount.h"
+
+// Fixed size ring buffer shared by exactly one producer thread and one consumer thread, without locks.
+// Each position is only written by one side: the producer publishes items by moving write_pos, the
+// consumer releases slots by moving read_pos. Resizing and clearing are not thread safe.
+
+template <typename T>
+class SPSCRingBuffer {
+
+	T *data;
+	uint32_t size_mask;
+
+	// Kept apart so producer and consumer don't share a cache line.
+	uint8_t padding0[64];
+	volatile uint32_t write_pos;
+	uint8_t padding1[64];
+	volatile uint32_t read_pos;
+	uint8_t padding2[64];
+
+public:
+	// Producer side.
+	bool write(const T &p_value) {
+
+		uint32_t pos = write_pos;
+		if (pos - atomic_load_acquire(&read_pos) > size_mask)
+			return false; // full
+
+		data[pos & size_mask] = p_value;
+		atomic_store_release(&write_pos, pos + 1);
+		return true;
+	}
+
+	// Producer side, writes as many items as fit and publishes them at once.
+	int write(const T *p_from, int p_count) {
+
+		uint32_t pos = write_pos;
+		int count = MIN(p_count, int(size_mask + 1 - (pos - atomic_load_acquire(&read_pos))));
+
+		// Two contiguous runs at most, so the copies stay simple loops.
+		int start = pos & size_mask;
+		int first = MIN(count, int(size_mask + 1) - start);
+		for (int i = 0; i < first; i++) {
+			data[start + i] = p_from[i];
+		}
+		for (int i = first; i < count; i++) {
+			data[i - first] = p_from[i];
+		}
+		atomic_store_release(&write_pos, pos + count);
+		return count;
+	}
+
+	// Producer side, takes back the last items written. Only safe while the consumer can't be reading
+	// them, e.g. when they are part of a message it doesn't know about yet.
+	void decrease_write(int p_count) {
+
+		atomic_store_release(&write_pos, write_pos - p_count);
+	}
+
+	// Consumer side. The slot is reset, so it doesn't keep references alive until it's reused.
+	bool read(T &r_value) {
+
+		uint32_t pos = read_pos;
+		if (pos == atomic_load_acquire(&write_pos))
+			return false; // empty
+
+		r_value = data[pos & size_mask];
+		data[pos & size_mask] = T();
+		atomic_store_release(&read_pos, pos + 1);
+		return true;
+	}
+
+	// Consumer side, reads as many items as available and releases their slots at once.
+	int read(T *r_to, int p_count) {
+
+		uint32_t pos = read_pos;
+		int count = MIN(p_count, int(atomic_load_acquire(&write_pos) - pos));
+
+		int start = pos & size_mask;
+		int first = MIN(count, int(size_mask + 1) - start);
+		for (int i = 0; i < first; i++) {
+			r_to[i] = data[start + i];
+		}
+		for (int i = first; i < count; i++) {
+			r_to[i] = data[i - first];
+		}
+		atomic_store_release(&read_pos, pos + count);
+		return count;
+	}
+
+	// Consumer side, the item stays valid until it is read.
+	T *peek() {
+
+		uint32_t pos = read_pos;
+		if (pos == atomic_load_acquire(&write_pos))
+			return NULL;
+
+		return &data[pos & size_mask];
+	}
+
+	// Exact when called by one of the two sides while the other is idle, a snapshot otherwise.
+	int data_left() const {
+
+		return atomic_load_acquire(&write_pos) - atomic_load_acquire(&read_pos);
+	}
+
+	int space_left() const {
+
+		return size() - data_left();
+	}
+
+	int size() const {
+
+		return size_mask + 1;
+	}
+
+	void clear() {
+
+		write_pos = 0;
+		read_pos = 0;
+	}
+
+	// Drops the contents.
+	void resize(int p_power) {
+
+		if (data) {
+			memdelete_arr(data);
+		}
+		data = memnew_arr(T, 1 << p_power);
+		size_mask = (1 << p_power) - 1;
+		clear();
+	}
+
+	SPSCRingBuffer(int p_power = 0) {
+
+		data = NULL;
+		resize(p_power);
+	}
+
+	~SPSCRingBuffer() {
+
+		memdelete_arr(data);
+	}
+};
+
+#endif // SPSC_RING_BUFFER_H
@@ -47,13 +47,15 @@ StringName _scs_create(const char *p_chr) {
 }
 
 bool StringName::configured = false;
-Mutex *StringName::lock = NULL;
+Mutex *StringName::shard_locks[STRING_SHARD_COUNT];
 
 void StringName::setup() {
 
-	lock = Mutex::create();
-
 	ERR_FAIL_COND(configured);
+	for (int i = 0; i < STRING_SHARD_COUNT; i++) {
+
+		shard_locks[i] = Mutex::create();
+	}
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
 
 		_table[i] = NULL;
@@ -63,7 +65,10 @@ void StringName::setup() {
 
 void StringName::cleanup() {
 
-	lock->lock();
+	for (int i = 0; i < STRING_SHARD_COUNT; i++) {
+
+		shard_locks[i]->lock();
+	}
 
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
@@ -87,17 +92,29 @@ void StringName::cleanup() {
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock->unlock();
 
-	memdelete(lock);
+	// static names (see SNAME) are released after this, they must not touch the table anymore
+	configured = false;
+
+	for (int i = 0; i < STRING_SHARD_COUNT; i++) {
+
+		shard_locks[i]->unlock();
+		memdelete(shard_locks[i]);
+		shard_locks[i] = NULL;
+	}
 }
 
 void StringName::unref() {
 
-	ERR_FAIL_COND(!configured);
+	if (!configured) {
+		// released after cleanup, the data is already gone
+		_data = NULL;
+		return;
+	}
 
 	if (_data && _data->refcount.unref()) {
 
+		Mutex *lock = _get_shard_lock(_data->idx);
 		lock->lock();
 
 		if (_data->prev) {
@@ -184,12 +201,13 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -232,12 +250,13 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -281,12 +300,13 @@ StringName::StringName(const String &p_name) {
 	if (p_name == String())
 		return;
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -328,12 +348,13 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -362,12 +383,13 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -390,12 +412,13 @@ StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_shard_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
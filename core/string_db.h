@@ -50,7 +50,11 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+
+		// the table is split in shards by the upper bits of the bucket index, each with its own lock
+		STRING_SHARD_BITS = 6,
+		STRING_SHARD_COUNT = 1 << STRING_SHARD_BITS
 	};
 
 	struct _Data {
@@ -85,7 +89,9 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex *lock;
+	static Mutex *shard_locks[STRING_SHARD_COUNT];
+	static _FORCE_INLINE_ Mutex *_get_shard_lock(uint32_t p_idx) { return shard_locks[p_idx >> (STRING_TABLE_BITS - STRING_SHARD_BITS)]; }
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -169,4 +175,8 @@ public:
 
 StringName _scs_create(const char *p_chr);
 
+// Interns a string literal once per call site. Further uses only take a
+// reference, without hashing the string or locking the table.
+#define SNAME(m_arg) ([]() -> const StringName & { static StringName sname = _scs_create(m_arg); return sname; })()
+
 #endif
@@ -117,6 +117,7 @@ public:
 
 private:
 	friend struct _VariantCall;
+	friend struct _VariantOp;
 	// Variant takes 20 bytes when real_t is float, and 36 if double
 	// it only allocates extra memory for aabb/matrix.
 
@@ -338,6 +339,12 @@ public:
 		return res;
 	}
 
+	// Evaluators for operand types known ahead of time, such as by a script compiler
+	// with static types. They don't check the types, the caller must. Returns NULL when
+	// there is no fast path for the combination, evaluate() must be used then.
+	typedef void (*ValidatedOperatorEvaluator)(const Variant *p_a, const Variant *p_b, Variant *r_ret);
+	static ValidatedOperatorEvaluator get_validated_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b);
+
 	void zero();
 	Variant duplicate(bool deep = false) const;
 	static void blend(const Variant &a, const Variant &b, float c, Variant &r_dst);
@@ -358,6 +365,12 @@ public:
 	};
 
 	void call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
+
+	// Built-in methods can be looked up once and then called without a name lookup,
+	// as long as the Variant they are called on is of the type they were looked up for.
+	struct InternalMethod;
+	static InternalMethod *get_internal_method(Type p_type, const StringName &p_method);
+	void call_internal(InternalMethod *p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant &p_arg1 = Variant(), const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant());
 
@@ -376,6 +389,10 @@ public:
 	void set_named(const StringName &p_index, const Variant &p_value, bool *r_valid = NULL);
 	Variant get_named(const StringName &p_index, bool *r_valid = NULL) const;
 
+	// Same rules as the validated operators, the base must be of the type the getter was looked up for.
+	typedef void (*ValidatedGetter)(const Variant *p_base, Variant *r_ret);
+	static ValidatedGetter get_validated_getter(Type p_type, const StringName &p_member);
+
 	void set(const Variant &p_index, const Variant &p_value, bool *r_valid = NULL);
 	Variant get(const Variant &p_index, bool *r_valid = NULL) const;
 	bool in(const Variant &p_index, bool *r_valid = NULL) const;
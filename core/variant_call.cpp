@@ -40,87 +40,89 @@
 typedef void (*VariantFunc)(Variant &r_ret, Variant &p_self, const Variant **p_args);
 typedef void (*VariantConstructFunc)(Variant &r_ret, const Variant **p_args);
 
-struct _VariantCall {
+struct Variant::InternalMethod {
 
-	static void Vector3_dot(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+	int arg_count;
+	Vector<Variant> default_args;
+	Vector<Variant::Type> arg_types;
+	Vector<StringName> arg_names;
+	Variant::Type return_type;
 
-		r_ret = reinterpret_cast<Vector3 *>(p_self._data._mem)->dot(*reinterpret_cast<const Vector3 *>(p_args[0]->_data._mem));
-	}
+	bool _const;
+	bool returns;
 
-	struct FuncData {
-
-		int arg_count;
-		Vector<Variant> default_args;
-		Vector<Variant::Type> arg_types;
-		Vector<StringName> arg_names;
-		Variant::Type return_type;
+	VariantFunc func;
 
-		bool _const;
-		bool returns;
+	_FORCE_INLINE_ bool verify_arguments(const Variant **p_args, Variant::CallError &r_error) {
 
-		VariantFunc func;
-
-		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args, Variant::CallError &r_error) {
-
-			if (arg_count == 0)
-				return true;
+		if (arg_count == 0)
+			return true;
 
-			const Variant::Type *tptr = &arg_types[0];
+		const Variant::Type *tptr = &arg_types[0];
 
-			for (int i = 0; i < arg_count; i++) {
+		for (int i = 0; i < arg_count; i++) {
 
-				if (!tptr[i] || tptr[i] == p_args[i]->type)
-					continue; // all good
-				if (!Variant::can_convert(p_args[i]->type, tptr[i])) {
-					r_error.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
-					r_error.argument = i;
-					r_error.expected = tptr[i];
-					return false;
-				}
+			if (!tptr[i] || tptr[i] == p_args[i]->type)
+				continue; // all good
+			if (!Variant::can_convert(p_args[i]->type, tptr[i])) {
+				r_error.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
+				r_error.argument = i;
+				r_error.expected = tptr[i];
+				return false;
 			}
-			return true;
 		}
+		return true;
+	}
 
-		_FORCE_INLINE_ void call(Variant &r_ret, Variant &p_self, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+	_FORCE_INLINE_ void call(Variant &r_ret, Variant &p_self, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
 #ifdef DEBUG_ENABLED
-			if (p_argcount > arg_count) {
-				r_error.error = Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
-				r_error.argument = arg_count;
-				return;
-			} else
+		if (p_argcount > arg_count) {
+			r_error.error = Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+			r_error.argument = arg_count;
+			return;
+		} else
 #endif
-					if (p_argcount < arg_count) {
-				int def_argcount = default_args.size();
+				if (p_argcount < arg_count) {
+			int def_argcount = default_args.size();
 #ifdef DEBUG_ENABLED
-				if (p_argcount < (arg_count - def_argcount)) {
-					r_error.error = Variant::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
-					r_error.argument = arg_count - def_argcount;
-					return;
-				}
+			if (p_argcount < (arg_count - def_argcount)) {
+				r_error.error = Variant::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+				r_error.argument = arg_count - def_argcount;
+				return;
+			}
 
 #endif
-				ERR_FAIL_COND(p_argcount > VARIANT_ARG_MAX);
-				const Variant *newargs[VARIANT_ARG_MAX];
-				for (int i = 0; i < p_argcount; i++)
-					newargs[i] = p_args[i];
-				// fill in any remaining parameters with defaults
-				int first_default_arg = arg_count - def_argcount;
-				for (int i = p_argcount; i < arg_count; i++)
-					newargs[i] = &default_args[i - first_default_arg];
+			ERR_FAIL_COND(p_argcount > VARIANT_ARG_MAX);
+			const Variant *newargs[VARIANT_ARG_MAX];
+			for (int i = 0; i < p_argcount; i++)
+				newargs[i] = p_args[i];
+			// fill in any remaining parameters with defaults
+			int first_default_arg = arg_count - def_argcount;
+			for (int i = p_argcount; i < arg_count; i++)
+				newargs[i] = &default_args[i - first_default_arg];
 #ifdef DEBUG_ENABLED
-				if (!verify_arguments(newargs, r_error))
-					return;
+			if (!verify_arguments(newargs, r_error))
+				return;
 #endif
-				func(r_ret, p_self, newargs);
-			} else {
+			func(r_ret, p_self, newargs);
+		} else {
 #ifdef DEBUG_ENABLED
-				if (!verify_arguments(p_args, r_error))
-					return;
+			if (!verify_arguments(p_args, r_error))
+				return;
 #endif
-				func(r_ret, p_self, p_args);
-			}
+			func(r_ret, p_self, p_args);
 		}
-	};
+	}
+};
+
+struct _VariantCall {
+
+	static void Vector3_dot(Variant &r_ret, Variant &p_self, const Variant **p_args) {
+
+		r_ret = reinterpret_cast<Vector3 *>(p_self._data._mem)->dot(*reinterpret_cast<const Vector3 *>(p_args[0]->_data._mem));
+	}
+
+	typedef Variant::InternalMethod FuncData;
 
 	struct TypeFunc {
 
@@ -1069,6 +1071,29 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 		*r_ret = ret;
 }
 
+Variant::InternalMethod *Variant::get_internal_method(Type p_type, const StringName &p_method) {
+
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, NULL);
+	if (p_type == OBJECT)
+		return NULL;
+
+	Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[p_type].functions.find(p_method);
+	if (!E)
+		return NULL;
+
+	return &E->get();
+}
+
+void Variant::call_internal(InternalMethod *p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) {
+
+	Variant ret;
+	r_error.error = Variant::CallError::CALL_OK;
+	p_method->call(ret, *this, p_args, p_argcount, r_error);
+
+	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+}
+
 #define VCALL(m_type, m_method) _VariantCall::_call_##m_type##_##m_method
 
 Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, int p_argcount, CallError &r_error, bool p_strict) {
@@ -3761,3 +3761,219 @@ String Variant::get_operator_name(Operator p_op) {
 	ERR_FAIL_INDEX_V(p_op, OP_MAX, "");
 	return _op_names[p_op];
 }
+
+/* VALIDATED OPERATORS AND GETTERS */
+
+template <class T>
+struct _VariantOpType {};
+
+template <>
+struct _VariantOpType<bool> { enum { TYPE = Variant::BOOL }; };
+template <>
+struct _VariantOpType<int64_t> { enum { TYPE = Variant::INT }; };
+template <>
+struct _VariantOpType<double> { enum { TYPE = Variant::REAL }; };
+template <>
+struct _VariantOpType<Vector2> { enum { TYPE = Variant::VECTOR2 }; };
+template <>
+struct _VariantOpType<Vector3> { enum { TYPE = Variant::VECTOR3 }; };
+template <>
+struct _VariantOpType<Rect2> { enum { TYPE = Variant::RECT2 }; };
+template <>
+struct _VariantOpType<Quat> { enum { TYPE = Variant::QUAT }; };
+template <>
+struct _VariantOpType<Color> { enum { TYPE = Variant::COLOR }; };
+
+struct _VariantOp {
+
+	// Only used for types stored inside the Variant, so the value lives in _mem.
+	template <class T>
+	static _FORCE_INLINE_ const T &get(const Variant *p_v) {
+		return *reinterpret_cast<const T *>(p_v->_data._mem);
+	}
+
+	template <class T>
+	static _FORCE_INLINE_ void set(Variant *r_v, const T &p_value) {
+		if (r_v->type == Variant::Type(_VariantOpType<T>::TYPE)) {
+			*reinterpret_cast<T *>(r_v->_data._mem) = p_value;
+		} else {
+			*r_v = p_value;
+		}
+	}
+
+#define VALIDATED_OP_BINARY(m_name, m_op)                                           \
+	template <class R, class A, class B>                                            \
+	static void m_name(const Variant *p_a, const Variant *p_b, Variant *r_ret) {    \
+		set<R>(r_ret, R(get<A>(p_a) m_op get<B>(p_b)));                             \
+	}
+
+#define VALIDATED_OP_UNARY(m_name, m_op)                                            \
+	template <class R, class A, class B>                                            \
+	static void m_name(const Variant *p_a, const Variant *p_b, Variant *r_ret) {    \
+		set<R>(r_ret, R(m_op get<A>(p_a)));                                         \
+	}
+
+	VALIDATED_OP_BINARY(equal, ==)
+	VALIDATED_OP_BINARY(not_equal, !=)
+	VALIDATED_OP_BINARY(less, <)
+	VALIDATED_OP_BINARY(less_equal, <=)
+	VALIDATED_OP_BINARY(greater, >)
+	VALIDATED_OP_BINARY(greater_equal, >=)
+	VALIDATED_OP_BINARY(add, +)
+	VALIDATED_OP_BINARY(subtract, -)
+	VALIDATED_OP_BINARY(multiply, *)
+	VALIDATED_OP_BINARY(divide, /)
+	VALIDATED_OP_BINARY(module, %)
+	VALIDATED_OP_BINARY(shift_left, <<)
+	VALIDATED_OP_BINARY(shift_right, >>)
+	VALIDATED_OP_BINARY(bit_and, &)
+	VALIDATED_OP_BINARY(bit_or, |)
+	VALIDATED_OP_BINARY(bit_xor, ^)
+	VALIDATED_OP_UNARY(negate, -)
+	VALIDATED_OP_UNARY(positive, +)
+	VALIDATED_OP_UNARY(bit_negate, ~)
+	VALIDATED_OP_UNARY(not_, !)
+
+#undef VALIDATED_OP_BINARY
+#undef VALIDATED_OP_UNARY
+
+#define VALIDATED_GETTER(m_type, m_member, m_ret)                                    \
+	static void get_##m_type##_##m_member(const Variant *p_base, Variant *r_ret) { \
+		set<m_ret>(r_ret, m_ret(get<m_type>(p_base).m_member));                      \
+	}
+
+	VALIDATED_GETTER(Vector2, x, double)
+	VALIDATED_GETTER(Vector2, y, double)
+	VALIDATED_GETTER(Vector3, x, double)
+	VALIDATED_GETTER(Vector3, y, double)
+	VALIDATED_GETTER(Vector3, z, double)
+	VALIDATED_GETTER(Rect2, position, Vector2)
+	VALIDATED_GETTER(Rect2, size, Vector2)
+	VALIDATED_GETTER(Quat, x, double)
+	VALIDATED_GETTER(Quat, y, double)
+	VALIDATED_GETTER(Quat, z, double)
+	VALIDATED_GETTER(Quat, w, double)
+	VALIDATED_GETTER(Color, r, double)
+	VALIDATED_GETTER(Color, g, double)
+	VALIDATED_GETTER(Color, b, double)
+	VALIDATED_GETTER(Color, a, double)
+
+#undef VALIDATED_GETTER
+};
+
+#define VALIDATED_OP(m_op, m_func, m_ret, m_a, m_b)                                                                       \
+	if (p_op == m_op && p_type_a == Variant::Type(_VariantOpType<m_a>::TYPE) && p_type_b == Variant::Type(_VariantOpType<m_b>::TYPE)) \
+		return &_VariantOp::m_func<m_ret, m_a, m_b>;
+
+#define VALIDATED_OP_NUM(m_op, m_func)                   \
+	VALIDATED_OP(m_op, m_func, int64_t, int64_t, int64_t) \
+	VALIDATED_OP(m_op, m_func, double, int64_t, double)   \
+	VALIDATED_OP(m_op, m_func, double, double, int64_t)   \
+	VALIDATED_OP(m_op, m_func, double, double, double)
+
+#define VALIDATED_OP_NUM_CMP(m_op, m_func)            \
+	VALIDATED_OP(m_op, m_func, bool, int64_t, int64_t) \
+	VALIDATED_OP(m_op, m_func, bool, int64_t, double)  \
+	VALIDATED_OP(m_op, m_func, bool, double, int64_t)  \
+	VALIDATED_OP(m_op, m_func, bool, double, double)
+
+#define VALIDATED_OP_VEC(m_op, m_func, m_vec)        \
+	VALIDATED_OP(m_op, m_func, m_vec, m_vec, m_vec)   \
+	VALIDATED_OP(m_op, m_func, m_vec, m_vec, int64_t) \
+	VALIDATED_OP(m_op, m_func, m_vec, m_vec, double)
+
+Variant::ValidatedOperatorEvaluator Variant::get_validated_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b) {
+
+	VALIDATED_OP_NUM_CMP(OP_EQUAL, equal);
+	VALIDATED_OP_NUM_CMP(OP_NOT_EQUAL, not_equal);
+	VALIDATED_OP_NUM_CMP(OP_LESS, less);
+	VALIDATED_OP_NUM_CMP(OP_LESS_EQUAL, less_equal);
+	VALIDATED_OP_NUM_CMP(OP_GREATER, greater);
+	VALIDATED_OP_NUM_CMP(OP_GREATER_EQUAL, greater_equal);
+	VALIDATED_OP_NUM(OP_ADD, add);
+	VALIDATED_OP_NUM(OP_SUBTRACT, subtract);
+	VALIDATED_OP_NUM(OP_MULTIPLY, multiply);
+#ifndef DEBUG_ENABLED
+	// evaluate() reports division by zero on debug builds, keep going through it there.
+	VALIDATED_OP_NUM(OP_DIVIDE, divide);
+	VALIDATED_OP(OP_MODULE, module, int64_t, int64_t, int64_t);
+#endif
+	VALIDATED_OP(OP_NEGATE, negate, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_NEGATE, negate, double, double, double);
+	VALIDATED_OP(OP_POSITIVE, positive, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_POSITIVE, positive, double, double, double);
+	VALIDATED_OP(OP_SHIFT_LEFT, shift_left, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_SHIFT_RIGHT, shift_right, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_BIT_AND, bit_and, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_BIT_OR, bit_or, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_BIT_XOR, bit_xor, int64_t, int64_t, int64_t);
+	VALIDATED_OP(OP_BIT_NEGATE, bit_negate, int64_t, int64_t, int64_t);
+
+	VALIDATED_OP(OP_EQUAL, equal, bool, bool, bool);
+	VALIDATED_OP(OP_NOT_EQUAL, not_equal, bool, bool, bool);
+	VALIDATED_OP(OP_NOT, not_, bool, bool, bool);
+
+	VALIDATED_OP(OP_EQUAL, equal, bool, Vector2, Vector2);
+	VALIDATED_OP(OP_NOT_EQUAL, not_equal, bool, Vector2, Vector2);
+	VALIDATED_OP(OP_ADD, add, Vector2, Vector2, Vector2);
+	VALIDATED_OP(OP_SUBTRACT, subtract, Vector2, Vector2, Vector2);
+	VALIDATED_OP_VEC(OP_MULTIPLY, multiply, Vector2);
+	VALIDATED_OP_VEC(OP_DIVIDE, divide, Vector2);
+	VALIDATED_OP(OP_MULTIPLY, multiply, Vector2, int64_t, Vector2);
+	VALIDATED_OP(OP_MULTIPLY, multiply, Vector2, double, Vector2);
+	VALIDATED_OP(OP_NEGATE, negate, Vector2, Vector2, Vector2);
+
+	VALIDATED_OP(OP_EQUAL, equal, bool, Vector3, Vector3);
+	VALIDATED_OP(OP_NOT_EQUAL, not_equal, bool, Vector3, Vector3);
+	VALIDATED_OP(OP_ADD, add, Vector3, Vector3, Vector3);
+	VALIDATED_OP(OP_SUBTRACT, subtract, Vector3, Vector3, Vector3);
+	VALIDATED_OP_VEC(OP_MULTIPLY, multiply, Vector3);
+	VALIDATED_OP_VEC(OP_DIVIDE, divide, Vector3);
+	VALIDATED_OP(OP_MULTIPLY, multiply, Vector3, int64_t, Vector3);
+	VALIDATED_OP(OP_MULTIPLY, multiply, Vector3, double, Vector3);
+	VALIDATED_OP(OP_NEGATE, negate, Vector3, Vector3, Vector3);
+
+	return NULL;
+}
+
+#undef VALIDATED_OP
+#undef VALIDATED_OP_NUM
+#undef VALIDATED_OP_NUM_CMP
+#undef VALIDATED_OP_VEC
+
+Variant::ValidatedGetter Variant::get_validated_getter(Type p_type, const StringName &p_member) {
+
+	const CoreStringNames *names = CoreStringNames::singleton;
+
+	switch (p_type) {
+		case VECTOR2: {
+			if (p_member == names->x) return &_VariantOp::get_Vector2_x;
+			if (p_member == names->y) return &_VariantOp::get_Vector2_y;
+		} break;
+		case VECTOR3: {
+			if (p_member == names->x) return &_VariantOp::get_Vector3_x;
+			if (p_member == names->y) return &_VariantOp::get_Vector3_y;
+			if (p_member == names->z) return &_VariantOp::get_Vector3_z;
+		} break;
+		case RECT2: {
+			if (p_member == names->position) return &_VariantOp::get_Rect2_position;
+			if (p_member == names->size) return &_VariantOp::get_Rect2_size;
+		} break;
+		case QUAT: {
+			if (p_member == names->x) return &_VariantOp::get_Quat_x;
+			if (p_member == names->y) return &_VariantOp::get_Quat_y;
+			if (p_member == names->z) return &_VariantOp::get_Quat_z;
+			if (p_member == names->w) return &_VariantOp::get_Quat_w;
+		} break;
+		case COLOR: {
+			if (p_member == names->r) return &_VariantOp::get_Color_r;
+			if (p_member == names->g) return &_VariantOp::get_Color_g;
+			if (p_member == names->b) return &_VariantOp::get_Color_b;
+			if (p_member == names->a) return &_VariantOp::get_Color_a;
+		} break;
+		default: {
+		}
+	}
+
+	return NULL;
+}
@@ -131,6 +131,8 @@ public:
 
 	_FORCE_INLINE_ int size() const { return _data.size(); }
 
+	_FORCE_INLINE_ void clear() { _data.clear(); }
+
 	inline T &operator[](int p_index) {
 
 		return _data.write[p_index];
@@ -212,8 +212,16 @@ public:
 
 	VisualServer::TextureType texture_get_type(RID p_texture) const { return VS::TEXTURE_TYPE_2D; }
 	uint32_t texture_get_texid(RID p_texture) const { return 0; }
-	uint32_t texture_get_width(RID p_texture) const { return 0; }
-	uint32_t texture_get_height(RID p_texture) const { return 0; }
+	uint32_t texture_get_width(RID p_texture) const {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND_V(!t, 0);
+		return t->width;
+	}
+	uint32_t texture_get_height(RID p_texture) const {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND_V(!t, 0);
+		return t->height;
+	}
 	uint32_t texture_get_depth(RID p_texture) const { return 0; }
 	void texture_set_size_override(RID p_texture, int p_width, int p_height, int p_depth_3d) {}
 
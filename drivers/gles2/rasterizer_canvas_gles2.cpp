@@ -442,15 +442,19 @@ static const GLenum gl_primitive[] = {
 	GL_TRIANGLE_FAN
 };
 
-void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material) {
+void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material, int p_from_command, int p_command_count) {
 
-	int command_count = p_item->commands.size();
+	int command_count = p_command_count < 0 ? p_item->commands.size() : p_from_command + p_command_count;
 	Item::Command **commands = p_item->commands.ptrw();
 
-	for (int i = 0; i < command_count; i++) {
+	for (int i = p_from_command; i < command_count; i++) {
 
 		Item::Command *command = commands[i];
 
+		if (command->type != Item::Command::TYPE_TRANSFORM && command->type != Item::Command::TYPE_CLIP_IGNORE) {
+			storage->info.render._2d_draw_call_count++;
+		}
+
 		switch (command->type) {
 
 			case Item::Command::TYPE_LINE: {
@@ -1160,6 +1164,96 @@ void RasterizerCanvasGLES2::_canvas_item_render_commands(Item *p_item, Item *cur
 	}
 }
 
+bool RasterizerCanvasGLES2::Batcher::_get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags) {
+
+	RasterizerStorageGLES2::Texture *texture = storage->texture_owner.getornull(p_texture);
+
+	if (!texture)
+		return false;
+
+	texture = texture->get_ptr();
+	r_size = Size2(texture->width, texture->height);
+	r_flags = texture->flags;
+	return true;
+}
+
+void RasterizerCanvasGLES2::_canvas_render_batches(bool &reclip, const Color &p_modulate) {
+
+	int batch_count = batcher.get_batch_count();
+	const RasterizerCanvasBatcher::Batch *batches = batcher.get_batches();
+
+	bool uploaded = false;
+	bool canvas_space = false;
+
+	for (int i = 0; i < batch_count; i++) {
+
+		const RasterizerCanvasBatcher::Batch &b = batches[i];
+
+		if (b.type == RasterizerCanvasBatcher::Batch::TYPE_COMMANDS) {
+
+			Item *ci = b.item;
+
+			state.uniforms.final_modulate = Color(ci->final_modulate.r * p_modulate.r, ci->final_modulate.g * p_modulate.g, ci->final_modulate.b * p_modulate.b, ci->final_modulate.a * p_modulate.a);
+			state.uniforms.modelview_matrix = ci->final_transform;
+			state.uniforms.extra_matrix = b.extra_matrix;
+
+			_set_uniforms();
+
+			_canvas_item_render_commands(ci, NULL, reclip, NULL, b.first_command, b.command_count);
+			canvas_space = false;
+			continue;
+		}
+
+		if (!uploaded) {
+
+			glBindBuffer(GL_ARRAY_BUFFER, data.batch_vertex_buffer);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, batcher.get_vertex_count() * sizeof(RasterizerCanvasBatcher::Vertex), batcher.get_vertices());
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.batch_index_buffer);
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, batcher.get_index_count() * sizeof(uint16_t), batcher.get_indices());
+			uploaded = true;
+		}
+
+		if (!canvas_space) {
+
+			// vertices are already in canvas space and carry the item modulate
+			state.uniforms.final_modulate = p_modulate;
+			state.uniforms.modelview_matrix = Transform2D();
+			state.uniforms.extra_matrix = Transform2D();
+		}
+
+		state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_TEXTURE_RECT, false);
+		if (state.canvas_shader.bind() || !canvas_space) {
+			_set_uniforms();
+			canvas_space = true;
+		}
+
+		_bind_canvas_texture(b.texture, RID());
+
+		int stride = sizeof(RasterizerCanvasBatcher::Vertex);
+
+		glBindBuffer(GL_ARRAY_BUFFER, data.batch_vertex_buffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.batch_index_buffer);
+
+		glEnableVertexAttribArray(VS::ARRAY_VERTEX);
+		glVertexAttribPointer(VS::ARRAY_VERTEX, 2, GL_FLOAT, GL_FALSE, stride, NULL);
+		glEnableVertexAttribArray(VS::ARRAY_TEX_UV);
+		glVertexAttribPointer(VS::ARRAY_TEX_UV, 2, GL_FLOAT, GL_FALSE, stride, (uint8_t *)0 + sizeof(Vector2));
+		glEnableVertexAttribArray(VS::ARRAY_COLOR);
+		glVertexAttribPointer(VS::ARRAY_COLOR, 4, GL_FLOAT, GL_FALSE, stride, (uint8_t *)0 + sizeof(Vector2) * 2);
+
+		glDrawElements(GL_TRIANGLES, b.index_count, GL_UNSIGNED_SHORT, (uint8_t *)0 + b.first_index * sizeof(uint16_t));
+
+		glDisableVertexAttribArray(VS::ARRAY_TEX_UV);
+		glDisableVertexAttribArray(VS::ARRAY_COLOR);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+		storage->info.render._2d_draw_call_count++;
+		storage->info.render._2d_batch_count++;
+	}
+}
+
 void RasterizerCanvasGLES2::_copy_texscreen(const Rect2 &p_rect) {
 
 	// This isn't really working yet, so disabling for now.
@@ -1402,6 +1496,21 @@ void RasterizerCanvasGLES2::canvas_render_items(Item *p_item_list, int p_z, cons
 
 		_set_uniforms();
 
+		if (use_batching && !shader_cache && !skeleton && batcher.can_join(ci, p_light, p_z)) {
+
+			Item *next = batcher.build(ci, p_light, p_z, p_modulate);
+
+			if (next != ci) {
+				_canvas_render_batches(reclip, p_modulate);
+				storage->info.render._2d_item_count += batcher.get_item_count();
+				rebind_shader = true;
+				p_item_list = next;
+				continue;
+			}
+		}
+
+		storage->info.render._2d_item_count++;
+
 		if (unshaded || (state.uniforms.final_modulate.a > 0.001 && (!shader_cache || shader_cache->canvas_item.light_mode != RasterizerStorageGLES2::Shader::CanvasItem::LIGHT_MODE_LIGHT_ONLY) && !ci->light_masked))
 			_canvas_item_render_commands(p_item_list, NULL, reclip, material_ptr);
 
@@ -1923,6 +2032,23 @@ void RasterizerCanvasGLES2::initialize() {
 	state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_PIXEL_SNAP, GLOBAL_DEF("rendering/quality/2d/use_pixel_snap", false));
 
 	state.using_light = NULL;
+
+	// batching buffers
+	{
+		use_batching = GLOBAL_GET("rendering/batching/use_batching");
+		batcher.storage = storage;
+		batcher.set_reorder_lookahead(GLOBAL_GET("rendering/batching/item_reordering_lookahead"));
+
+		glGenBuffers(1, &data.batch_vertex_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, data.batch_vertex_buffer);
+		glBufferData(GL_ARRAY_BUFFER, batcher.get_max_vertices() * sizeof(RasterizerCanvasBatcher::Vertex), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glGenBuffers(1, &data.batch_index_buffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.batch_index_buffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, batcher.get_max_indices() * sizeof(uint16_t), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
 }
 
 void RasterizerCanvasGLES2::finalize() {
@@ -33,6 +33,7 @@
 
 #include "rasterizer_storage_gles2.h"
 #include "servers/visual/rasterizer.h"
+#include "servers/visual/rasterizer_canvas_batcher.h"
 
 #include "shaders/canvas.glsl.gen.h"
 #include "shaders/lens_distorted.glsl.gen.h"
@@ -69,6 +70,9 @@ public:
 		GLuint ninepatch_vertices;
 		GLuint ninepatch_elements;
 
+		GLuint batch_vertex_buffer;
+		GLuint batch_index_buffer;
+
 	} data;
 
 	struct State {
@@ -104,6 +108,17 @@ public:
 
 	bool use_nvidia_rect_workaround;
 
+	class Batcher : public RasterizerCanvasBatcher {
+	protected:
+		virtual bool _get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags);
+
+	public:
+		RasterizerStorageGLES2 *storage;
+	};
+
+	Batcher batcher;
+	bool use_batching;
+
 	virtual RID light_internal_create();
 	virtual void light_internal_update(RID p_rid, Light *p_light);
 	virtual void light_internal_free(RID p_rid);
@@ -117,7 +132,8 @@ public:
 	_FORCE_INLINE_ void _draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor, const float *p_weights = NULL, const int *p_bones = NULL);
 	_FORCE_INLINE_ void _draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 
-	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material);
+	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, RasterizerStorageGLES2::Material *p_material, int p_from_command = 0, int p_command_count = -1);
+	_FORCE_INLINE_ void _canvas_render_batches(bool &reclip, const Color &p_modulate);
 	_FORCE_INLINE_ void _copy_texscreen(const Rect2 &p_rect);
 
 	virtual void canvas_render_items(Item *p_item_list, int p_z, const Color &p_modulate, Light *p_light, const Transform2D &p_base_transform);
@@ -4624,7 +4624,17 @@ int RasterizerStorageGLES2::get_captured_render_info(VS::RenderInfo p_info) {
 }
 
 int RasterizerStorageGLES2::get_render_info(VS::RenderInfo p_info) {
-	return 0;
+
+	switch (p_info) {
+		case VS::INFO_2D_ITEMS_IN_FRAME:
+			return info.render_final._2d_item_count;
+		case VS::INFO_2D_DRAW_CALLS_IN_FRAME:
+			return info.render_final._2d_draw_call_count;
+		case VS::INFO_2D_BATCHES_IN_FRAME:
+			return info.render_final._2d_batch_count;
+		default:
+			return 0;
+	}
 }
 
 void RasterizerStorageGLES2::initialize() {
@@ -125,6 +125,9 @@ public:
 			uint32_t surface_switch_count;
 			uint32_t shader_rebind_count;
 			uint32_t vertices_count;
+			uint32_t _2d_item_count;
+			uint32_t _2d_draw_call_count;
+			uint32_t _2d_batch_count;
 
 			void reset() {
 				object_count = 0;
@@ -133,6 +136,9 @@ public:
 				surface_switch_count = 0;
 				shader_rebind_count = 0;
 				vertices_count = 0;
+				_2d_item_count = 0;
+				_2d_draw_call_count = 0;
+				_2d_batch_count = 0;
 			}
 		} render, render_final, snap;
 
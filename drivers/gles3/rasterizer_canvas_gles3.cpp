@@ -522,15 +522,19 @@ static const GLenum gl_primitive[] = {
 	GL_TRIANGLE_FAN
 };
 
-void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip) {
+void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, int p_from_command, int p_command_count) {
 
-	int cc = p_item->commands.size();
+	int cc = p_command_count < 0 ? p_item->commands.size() : p_from_command + p_command_count;
 	Item::Command **commands = p_item->commands.ptrw();
 
-	for (int i = 0; i < cc; i++) {
+	for (int i = p_from_command; i < cc; i++) {
 
 		Item::Command *c = commands[i];
 
+		if (c->type != Item::Command::TYPE_TRANSFORM && c->type != Item::Command::TYPE_CLIP_IGNORE) {
+			storage->info.render._2d_draw_call_count++;
+		}
+
 		switch (c->type) {
 			case Item::Command::TYPE_LINE: {
 
@@ -1145,6 +1149,86 @@ void RasterizerCanvasGLES3::_canvas_item_render_commands(Item *p_item, Item *cur
 	}
 }
 
+bool RasterizerCanvasGLES3::Batcher::_get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags) {
+
+	RasterizerStorageGLES3::Texture *texture = storage->texture_owner.getornull(p_texture);
+
+	if (!texture)
+		return false;
+
+	texture = texture->get_ptr();
+	r_size = Size2(texture->width, texture->height);
+	r_flags = texture->flags;
+	return true;
+}
+
+void RasterizerCanvasGLES3::_canvas_render_batches(Item *current_clip, bool &reclip, const Color &p_modulate) {
+
+	int batch_count = batcher.get_batch_count();
+	const RasterizerCanvasBatcher::Batch *batches = batcher.get_batches();
+
+	bool uploaded = false;
+	bool canvas_space = false;
+
+	for (int i = 0; i < batch_count; i++) {
+
+		const RasterizerCanvasBatcher::Batch &b = batches[i];
+
+		if (b.type == RasterizerCanvasBatcher::Batch::TYPE_COMMANDS) {
+
+			Item *ci = b.item;
+
+			state.canvas_item_modulate = Color(ci->final_modulate.r * p_modulate.r, ci->final_modulate.g * p_modulate.g, ci->final_modulate.b * p_modulate.b, ci->final_modulate.a * p_modulate.a);
+			state.final_transform = ci->final_transform;
+			state.extra_matrix = b.extra_matrix;
+
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::FINAL_MODULATE, state.canvas_item_modulate);
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::MODELVIEW_MATRIX, state.final_transform);
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::EXTRA_MATRIX, state.extra_matrix);
+
+			_canvas_item_render_commands(ci, current_clip, reclip, b.first_command, b.command_count);
+			canvas_space = false;
+			continue;
+		}
+
+		if (!uploaded) {
+
+			glBindVertexArray(data.batch_array);
+			glBindBuffer(GL_ARRAY_BUFFER, data.batch_vertex_buffer);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, batcher.get_vertex_count() * sizeof(RasterizerCanvasBatcher::Vertex), batcher.get_vertices());
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, batcher.get_index_count() * sizeof(uint16_t), batcher.get_indices());
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			uploaded = true;
+		}
+
+		_set_texture_rect_mode(false);
+
+		if (!canvas_space) {
+
+			// vertices are already in canvas space and carry the item modulate
+			state.canvas_item_modulate = p_modulate;
+			state.final_transform = Transform2D();
+			state.extra_matrix = Transform2D();
+
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::FINAL_MODULATE, state.canvas_item_modulate);
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::MODELVIEW_MATRIX, state.final_transform);
+			state.canvas_shader.set_uniform(CanvasShaderGLES3::EXTRA_MATRIX, state.extra_matrix);
+			canvas_space = true;
+		}
+
+		_bind_canvas_texture(b.texture, RID());
+
+		glBindVertexArray(data.batch_array);
+		glDrawElements(GL_TRIANGLES, b.index_count, GL_UNSIGNED_SHORT, ((uint8_t *)NULL) + b.first_index * sizeof(uint16_t));
+		glBindVertexArray(0);
+
+		storage->frame.canvas_draw_commands++;
+		storage->info.render._2d_draw_call_count++;
+		storage->info.render._2d_batch_count++;
+	}
+}
+
 void RasterizerCanvasGLES3::_copy_texscreen(const Rect2 &p_rect) {
 
 	if (storage->frame.current_rt->effects.mip_maps[0].sizes.size() == 0) {
@@ -1510,6 +1594,21 @@ void RasterizerCanvasGLES3::canvas_render_items(Item *p_item_list, int p_z, cons
 		} else {
 			state.canvas_shader.set_uniform(CanvasShaderGLES3::SCREEN_PIXEL_SIZE, Vector2(1.0, 1.0));
 		}
+
+		if (use_batching && !shader_cache && !skeleton && batcher.can_join(ci, p_light, p_z)) {
+
+			Item *next = batcher.build(ci, p_light, p_z, p_modulate);
+
+			if (next != ci) {
+				_canvas_render_batches(current_clip, reclip, p_modulate);
+				storage->info.render._2d_item_count += batcher.get_item_count();
+				p_item_list = next;
+				continue;
+			}
+		}
+
+		storage->info.render._2d_item_count++;
+
 		if (unshaded || (state.canvas_item_modulate.a > 0.001 && (!shader_cache || shader_cache->canvas_item.light_mode != RasterizerStorageGLES3::Shader::CanvasItem::LIGHT_MODE_LIGHT_ONLY) && !ci->light_masked))
 			_canvas_item_render_commands(ci, current_clip, reclip);
 
@@ -2112,6 +2211,37 @@ void RasterizerCanvasGLES3::initialize() {
 	state.canvas_shadow_shader.set_conditional(CanvasShadowShaderGLES3::USE_RGBA_SHADOWS, storage->config.use_rgba_2d_shadows);
 
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_PIXEL_SNAP, GLOBAL_DEF("rendering/quality/2d/use_pixel_snap", false));
+
+	{
+		//batching buffers
+
+		use_batching = GLOBAL_GET("rendering/batching/use_batching");
+		batcher.storage = storage;
+		batcher.set_reorder_lookahead(GLOBAL_GET("rendering/batching/item_reordering_lookahead"));
+
+		glGenBuffers(1, &data.batch_vertex_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, data.batch_vertex_buffer);
+		glBufferData(GL_ARRAY_BUFFER, batcher.get_max_vertices() * sizeof(RasterizerCanvasBatcher::Vertex), NULL, GL_DYNAMIC_DRAW);
+
+		glGenBuffers(1, &data.batch_index_buffer);
+
+		glGenVertexArrays(1, &data.batch_array);
+		glBindVertexArray(data.batch_array);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.batch_index_buffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, batcher.get_max_indices() * sizeof(uint16_t), NULL, GL_DYNAMIC_DRAW);
+
+		int stride = sizeof(RasterizerCanvasBatcher::Vertex);
+		glEnableVertexAttribArray(VS::ARRAY_VERTEX);
+		glVertexAttribPointer(VS::ARRAY_VERTEX, 2, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + 0);
+		glEnableVertexAttribArray(VS::ARRAY_TEX_UV);
+		glVertexAttribPointer(VS::ARRAY_TEX_UV, 2, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + sizeof(Vector2));
+		glEnableVertexAttribArray(VS::ARRAY_COLOR);
+		glVertexAttribPointer(VS::ARRAY_COLOR, 4, GL_FLOAT, GL_FALSE, stride, ((uint8_t *)NULL) + sizeof(Vector2) * 2);
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
 }
 
 void RasterizerCanvasGLES3::finalize() {
@@ -2123,6 +2253,10 @@ void RasterizerCanvasGLES3::finalize() {
 	glDeleteVertexArrays(1, &data.canvas_quad_array);
 
 	glDeleteVertexArrays(1, &data.polygon_buffer_pointer_array);
+
+	glDeleteBuffers(1, &data.batch_vertex_buffer);
+	glDeleteBuffers(1, &data.batch_index_buffer);
+	glDeleteVertexArrays(1, &data.batch_array);
 }
 
 RasterizerCanvasGLES3::RasterizerCanvasGLES3() {
@@ -33,6 +33,7 @@
 
 #include "rasterizer_storage_gles3.h"
 #include "servers/visual/rasterizer.h"
+#include "servers/visual/rasterizer_canvas_batcher.h"
 
 #include "shaders/canvas_shadow.glsl.gen.h"
 #include "shaders/lens_distorted.glsl.gen.h"
@@ -65,6 +66,10 @@ public:
 
 		uint32_t polygon_buffer_size;
 
+		GLuint batch_vertex_buffer;
+		GLuint batch_index_buffer;
+		GLuint batch_array;
+
 	} data;
 
 	struct State {
@@ -95,6 +100,17 @@ public:
 
 	RasterizerStorageGLES3 *storage;
 
+	class Batcher : public RasterizerCanvasBatcher {
+	protected:
+		virtual bool _get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags);
+
+	public:
+		RasterizerStorageGLES3 *storage;
+	};
+
+	Batcher batcher;
+	bool use_batching;
+
 	struct LightInternal : public RID_Data {
 
 		struct UBOData {
@@ -132,7 +148,8 @@ public:
 	_FORCE_INLINE_ void _draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor, const int *p_bones, const float *p_weights);
 	_FORCE_INLINE_ void _draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 
-	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip);
+	_FORCE_INLINE_ void _canvas_item_render_commands(Item *p_item, Item *current_clip, bool &reclip, int p_from_command = 0, int p_command_count = -1);
+	_FORCE_INLINE_ void _canvas_render_batches(Item *current_clip, bool &reclip, const Color &p_modulate);
 	_FORCE_INLINE_ void _copy_texscreen(const Rect2 &p_rect);
 
 	virtual void canvas_render_items(Item *p_item_list, int p_z, const Color &p_modulate, Light *p_light, const Transform2D &p_transform);
@@ -7654,6 +7654,12 @@ int RasterizerStorageGLES3::get_render_info(VS::RenderInfo p_info) {
 			return info.texture_mem;
 		case VS::INFO_VERTEX_MEM_USED:
 			return info.vertex_mem;
+		case VS::INFO_2D_ITEMS_IN_FRAME:
+			return info.render_final._2d_item_count;
+		case VS::INFO_2D_DRAW_CALLS_IN_FRAME:
+			return info.render_final._2d_draw_call_count;
+		case VS::INFO_2D_BATCHES_IN_FRAME:
+			return info.render_final._2d_batch_count;
 		default:
 			return 0; //no idea either
 	}
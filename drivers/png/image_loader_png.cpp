@@ -202,19 +202,6 @@ Error ImageLoaderPNG::_load_image(void *rf_up, png_rw_ptr p_func, Ref<Image> p_i
 	return OK;
 }
 
-Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
-
-	Error err = _load_image(f, _read_png_data, p_image);
-	f->close();
-
-	return err;
-}
-
-void ImageLoaderPNG::get_recognized_extensions(List<String> *p_extensions) const {
-
-	p_extensions->push_back("png");
-}
-
 struct PNGReadStatus {
 
 	uint32_t offset;
@@ -236,6 +223,31 @@ static void user_read_data(png_structp png_ptr, png_bytep data, png_size_t p_len
 	}
 }
 
+Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
+
+	Error err;
+	int len = f->get_len() - f->get_position();
+	const uint8_t *mapped = f->get_buffer_ptr(len);
+	if (mapped) {
+		// the whole file is already in memory, decode from it instead of reading it in chunks
+		PNGReadStatus prs;
+		prs.image = mapped;
+		prs.offset = 0;
+		prs.size = len;
+		err = _load_image(&prs, user_read_data, p_image);
+	} else {
+		err = _load_image(f, _read_png_data, p_image);
+	}
+	f->close();
+
+	return err;
+}
+
+void ImageLoaderPNG::get_recognized_extensions(List<String> *p_extensions) const {
+
+	p_extensions->push_back("png");
+}
+
 static Ref<Image> _load_mem_png(const uint8_t *p_png, int p_size) {
 
 	PNGReadStatus prs;
@@ -251,13 +263,17 @@ static Ref<Image> _load_mem_png(const uint8_t *p_png, int p_size) {
 	return img;
 }
 
+static Ref<Image> _lossless_unpack_png_memory(const uint8_t *p_data, int p_size) {
+
+	ERR_FAIL_COND_V(p_size < 4, Ref<Image>());
+	ERR_FAIL_COND_V(p_data[0] != 'P' || p_data[1] != 'N' || p_data[2] != 'G' || p_data[3] != ' ', Ref<Image>());
+	return _load_mem_png(&p_data[4], p_size - 4);
+}
+
 static Ref<Image> _lossless_unpack_png(const PoolVector<uint8_t> &p_data) {
 
-	int len = p_data.size();
-	ERR_FAIL_COND_V(len < 4, Ref<Image>());
 	PoolVector<uint8_t>::Read r = p_data.read();
-	ERR_FAIL_COND_V(r[0] != 'P' || r[1] != 'N' || r[2] != 'G' || r[3] != ' ', Ref<Image>());
-	return _load_mem_png(&r[4], len - 4);
+	return _lossless_unpack_png_memory(r.ptr(), p_data.size());
 }
 
 static void _write_png_data(png_structp png_ptr, png_bytep data, png_size_t p_length) {
@@ -388,5 +404,6 @@ ImageLoaderPNG::ImageLoaderPNG() {
 
 	Image::_png_mem_loader_func = _load_mem_png;
 	Image::lossless_unpacker = _lossless_unpack_png;
+	Image::lossless_memory_unpacker = _lossless_unpack_png_memory;
 	Image::lossless_packer = _lossless_pack_png;
 }
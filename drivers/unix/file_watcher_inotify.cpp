@@ -0,0 +1,163 @@
+/*************************************************************************/
+/*  file_watcher_inotify.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_watcher_inotify.h"
+
+#if defined(UNIX_ENABLED) && defined(__linux__)
+
+#include "core/error_macros.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define INOTIFY_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+FileWatcher *FileWatcherInotify::create_func_inotify() {
+
+	FileWatcherInotify *watcher = memnew(FileWatcherInotify);
+	if (watcher->fd < 0) {
+		memdelete(watcher);
+		return NULL;
+	}
+	return watcher;
+}
+
+void FileWatcherInotify::make_default() {
+
+	create_func = create_func_inotify;
+}
+
+Error FileWatcherInotify::add_dir(const String &p_path) {
+
+	ERR_FAIL_COND_V(fd < 0, ERR_UNAVAILABLE);
+
+	int wd = inotify_add_watch(fd, p_path.utf8().get_data(), INOTIFY_WATCH_MASK);
+	if (wd < 0) {
+		// ENOSPC means fs.inotify.max_user_watches was reached.
+		return errno == ENOSPC ? ERR_OUT_OF_MEMORY : ERR_FILE_CANT_OPEN;
+	}
+
+	MutexLock lock(mutex);
+
+	// Watching a directory twice hands back the same descriptor.
+	watch_paths[wd] = p_path;
+	path_watches[p_path] = wd;
+
+	return OK;
+}
+
+void FileWatcherInotify::remove_dir(const String &p_path) {
+
+	MutexLock lock(mutex);
+
+	const int *wd = path_watches.getptr(p_path);
+	if (!wd)
+		return;
+
+	inotify_rm_watch(fd, *wd);
+	watch_paths.erase(*wd);
+	path_watches.erase(p_path);
+}
+
+bool FileWatcherInotify::get_changed_dirs(Set<String> *r_dirs) {
+
+	ERR_FAIL_COND_V(fd < 0, false);
+
+	MutexLock lock(mutex);
+
+	uint8_t buffer[4096];
+
+	while (true) {
+
+		ssize_t len = read(fd, buffer, sizeof(buffer));
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			break; // EAGAIN, nothing else queued
+		}
+		if (len == 0)
+			break;
+
+		ssize_t ofs = 0;
+		while (ofs + (ssize_t)sizeof(inotify_event) <= len) {
+
+			inotify_event ev;
+			memcpy(&ev, &buffer[ofs], sizeof(inotify_event));
+			ofs += sizeof(inotify_event) + ev.len;
+
+			if (ev.mask & IN_Q_OVERFLOW) {
+				events_lost = true;
+				continue;
+			}
+
+			const String *path = watch_paths.getptr(ev.wd);
+			if (!path)
+				continue;
+
+			r_dirs->insert(*path);
+
+			if (ev.mask & IN_IGNORED) {
+				// The directory is gone, the kernel already dropped the watch.
+				path_watches.erase(*path);
+				watch_paths.erase(ev.wd);
+			} else if (ev.mask & IN_MOVE_SELF) {
+				// The stored path is stale now, the parent gets rescanned and watches it again under its new name.
+				inotify_rm_watch(fd, ev.wd);
+				path_watches.erase(*path);
+				watch_paths.erase(ev.wd);
+			}
+		}
+	}
+
+	bool complete = !events_lost;
+	events_lost = false;
+	return complete;
+}
+
+FileWatcherInotify::FileWatcherInotify() {
+
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		ERR_PRINTS("inotify_init1 failed: " + String(strerror(errno)));
+	}
+	mutex = Mutex::create();
+	events_lost = false;
+}
+
+FileWatcherInotify::~FileWatcherInotify() {
+
+	if (fd >= 0)
+		close(fd);
+	memdelete(mutex);
+}
+
+#endif
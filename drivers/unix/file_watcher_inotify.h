@@ -0,0 +1,63 @@
+/*************************************************************************/
+/*  file_watcher_inotify.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_WATCHER_INOTIFY_H
+#define FILE_WATCHER_INOTIFY_H
+
+#if defined(UNIX_ENABLED) && defined(__linux__)
+
+#include "core/hash_map.h"
+#include "core/os/file_watcher.h"
+#include "core/os/mutex.h"
+
+class FileWatcherInotify : public FileWatcher {
+
+	int fd;
+	Mutex *mutex;
+	HashMap<int, String> watch_paths;
+	HashMap<String, int> path_watches;
+	bool events_lost;
+
+	static FileWatcher *create_func_inotify();
+
+public:
+	virtual Error add_dir(const String &p_path);
+	virtual void remove_dir(const String &p_path);
+	virtual bool get_changed_dirs(Set<String> *r_dirs);
+
+	static void make_default();
+
+	FileWatcherInotify();
+	~FileWatcherInotify();
+};
+
+#endif
+
+#endif // FILE_WATCHER_INOTIFY_H
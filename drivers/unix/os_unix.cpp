@@ -36,8 +36,10 @@
 #include "core/project_settings.h"
 #include "drivers/unix/dir_access_unix.h"
 #include "drivers/unix/file_access_unix.h"
+#include "drivers/unix/file_watcher_inotify.h"
 #include "drivers/unix/mutex_posix.h"
 #include "drivers/unix/net_socket_posix.h"
+#include "drivers/unix/pack_source_mmap.h"
 #include "drivers/unix/rw_lock_posix.h"
 #include "drivers/unix/semaphore_posix.h"
 #include "drivers/unix/thread_posix.h"
@@ -148,6 +150,18 @@ void OS_Unix::initialize_core() {
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_USERDATA);
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_FILESYSTEM);
 
+#ifdef __linux__
+	FileWatcherInotify::make_default();
+#endif
+
+#ifndef NO_MMAP_PACKS
+	// Main::setup() picks up this PackedData and adds the other sources after ours.
+	PackedData *packed_data = PackedData::get_singleton();
+	if (!packed_data)
+		packed_data = memnew(PackedData);
+	packed_data->add_pack_source(memnew(PackSourceMMap), true);
+#endif
+
 #ifndef NO_NETWORK
 	NetSocketPosix::make_default();
 	IP_Unix::make_default();
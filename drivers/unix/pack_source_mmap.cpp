@@ -0,0 +1,119 @@
+/*************************************************************************/
+/*  pack_source_mmap.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "pack_source_mmap.h"
+
+#if defined(UNIX_ENABLED) && !defined(NO_MMAP_PACKS)
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void FileAccessPackMMap::store_8(uint8_t p_byte) {
+
+	ERR_FAIL();
+}
+
+void FileAccessPackMMap::store_buffer(const uint8_t *p_src, int p_length) {
+
+	ERR_FAIL();
+}
+
+bool PackSourceMMap::try_open_pack(const String &p_path) {
+
+	if (p_path.begins_with("res://") || p_path.begins_with("user://"))
+		return false;
+
+	if (mappings.has(p_path))
+		return PackedSourcePCK::try_open_pack(p_path);
+
+	int fd = ::open(p_path.utf8().get_data(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || uint64_t(st.st_size) > uint64_t(SIZE_MAX)) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps the file referenced
+	if (data == MAP_FAILED)
+		return false;
+
+	Mapping m;
+	m.data = (uint8_t *)data;
+	m.size = st.st_size;
+	mappings[p_path] = m;
+
+	// The directory is parsed by the regular PCK code, which registers the
+	// files with this source.
+	if (!PackedSourcePCK::try_open_pack(p_path)) {
+		munmap(data, st.st_size);
+		mappings.erase(p_path);
+		return false;
+	}
+
+	return true;
+}
+
+FileAccess *PackSourceMMap::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+
+	Map<String, Mapping>::Element *E = mappings.find(p_file->pack);
+	ERR_FAIL_COND_V(!E, NULL);
+
+	const Mapping &m = E->get();
+	ERR_FAIL_COND_V(p_file->offset > m.size || p_file->size > m.size - p_file->offset, NULL);
+	ERR_FAIL_COND_V(p_file->size > 0x7FFFFFFF, NULL);
+
+	// Files are mostly read whole once opened, so read ahead just this one instead of the whole pack.
+	if (p_file->size > 0) {
+		uintptr_t page_mask = uintptr_t(sysconf(_SC_PAGESIZE)) - 1;
+		uintptr_t begin = uintptr_t(m.data + p_file->offset) & ~page_mask;
+		uintptr_t end = uintptr_t(m.data + p_file->offset + p_file->size);
+		madvise((void *)begin, end - begin, MADV_WILLNEED);
+	}
+
+	FileAccessPackMMap *f = memnew(FileAccessPackMMap);
+	f->open_custom(m.data + p_file->offset, p_file->size);
+	return f;
+}
+
+PackSourceMMap::~PackSourceMMap() {
+
+	for (Map<String, Mapping>::Element *E = mappings.front(); E; E = E->next()) {
+		munmap(E->get().data, E->get().size);
+	}
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*************************************************************************/
+/*  pack_source_mmap.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef PACK_SOURCE_MMAP_H
+#define PACK_SOURCE_MMAP_H
+
+#include "core/io/file_access_memory.h"
+#include "core/io/file_access_pack.h"
+
+#if defined(UNIX_ENABLED) && !defined(NO_MMAP_PACKS)
+
+/**
+ * PCK source that maps whole pack files into memory instead of reading
+ * them through a FileAccess. Files opened from a mapped pack are served
+ * straight from the mapping, so get_buffer_ptr() hands out pointers into
+ * the pack and loaders can decode without copying.
+ *
+ * Only packs on the filesystem are mapped, packs behind res:// or user://
+ * (and packs that fail to map) are left to the regular PCK source.
+ */
+
+class FileAccessPackMMap : public FileAccessMemory {
+
+public:
+	virtual void store_8(uint8_t p_byte);
+	virtual void store_buffer(const uint8_t *p_src, int p_length);
+};
+
+class PackSourceMMap : public PackedSourcePCK {
+
+	struct Mapping {
+		uint8_t *data;
+		size_t size;
+	};
+
+	Map<String, Mapping> mappings;
+
+public:
+	virtual bool try_open_pack(const String &p_path);
+	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	~PackSourceMMap();
+};
+
+#endif
+
+#endif // PACK_SOURCE_MMAP_H
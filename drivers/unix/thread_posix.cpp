@@ -70,6 +70,7 @@ void *ThreadPosix::thread_callback(void *userdata) {
 	t->callback(t->user);
 
 	ScriptServer::thread_exit();
+	Memory::release_thread_cache();
 
 	return NULL;
 }
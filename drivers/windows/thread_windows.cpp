@@ -54,6 +54,7 @@ DWORD ThreadWindows::thread_callback(LPVOID userdata) {
 	t->callback(t->user);
 
 	ScriptServer::thread_exit();
+	Memory::release_thread_cache();
 
 	return 0;
 }
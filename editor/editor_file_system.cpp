@@ -35,6 +35,7 @@
 #include "core/io/resource_saver.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "core/variant_parser.h"
 #include "editor_node.h"
@@ -196,60 +197,19 @@ void EditorFileSystem::_scan_filesystem() {
 	ERR_FAIL_COND(!scanning || new_filesystem);
 
 	//read .fscache
-	String cpath;
-
 	sources_changed.clear();
 	file_cache.clear();
 
 	String project = ProjectSettings::get_singleton()->get_resource_path();
 
-	String fscache = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("filesystem_cache4");
+	String fscache = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("filesystem_cache5");
 	FileAccess *f = FileAccess::open(fscache, FileAccess::READ);
 
 	if (f) {
 		//read the disk cache
-		while (!f->eof_reached()) {
-
-			String l = f->get_line().strip_edges();
-			if (l == String())
-				continue;
-
-			if (l.begins_with("::")) {
-				Vector<String> split = l.split("::");
-				ERR_CONTINUE(split.size() != 3);
-				String name = split[1];
-
-				cpath = name;
-
-			} else {
-				Vector<String> split = l.split("::");
-				ERR_CONTINUE(split.size() != 7);
-				String name = split[0];
-				String file;
-
-				file = name;
-				name = cpath.plus_file(name);
-
-				FileCache fc;
-				fc.type = split[1];
-				fc.modification_time = split[2].to_int64();
-				fc.import_modification_time = split[3].to_int64();
-				fc.import_valid = split[4].to_int64() != 0;
-				fc.script_class_name = split[5].get_slice("<>", 0);
-				fc.script_class_extends = split[5].get_slice("<>", 1);
-				fc.script_class_icon_path = split[5].get_slice("<>", 2);
-
-				String deps = split[6].strip_edges();
-				if (deps.length()) {
-					Vector<String> dp = deps.split("<>");
-					for (int i = 0; i < dp.size(); i++) {
-						String path = dp[i];
-						fc.deps.push_back(path);
-					}
-				}
-
-				file_cache[name] = fc;
-			}
+		if (!_load_filesystem_cache(f)) {
+			WARN_PRINTS("Invalid filesystem cache, rescanning everything: " + fscache);
+			file_cache.clear();
 		}
 
 		f->close();
@@ -304,7 +264,7 @@ void EditorFileSystem::_scan_filesystem() {
 }
 
 void EditorFileSystem::_save_filesystem_cache() {
-	String fscache = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("filesystem_cache4");
+	String fscache = EditorSettings::get_singleton()->get_project_settings_dir().plus_file("filesystem_cache5");
 
 	FileAccess *f = FileAccess::open(fscache, FileAccess::WRITE);
 	if (f == NULL) {
@@ -496,6 +456,7 @@ bool EditorFileSystem::_update_scan_actions() {
 			case ItemAction::ACTION_DIR_REMOVE: {
 
 				ERR_CONTINUE(!ia.dir->parent);
+				_unwatch_dir(ia.dir);
 				ia.dir->parent->subdirs.erase(ia.dir);
 				memdelete(ia.dir);
 				fs_changed = true;
@@ -579,6 +540,7 @@ void EditorFileSystem::scan() {
 		return;
 
 	_update_extensions();
+	_setup_file_watcher();
 
 	abort_scan = false;
 	if (!use_threads) {
@@ -633,6 +595,8 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 
 	String cd = da->get_current_dir();
 
+	_watch_dir(cd); //before listing, so nothing added meanwhile is missed
+
 	p_dir->modified_time = FileAccess::get_modified_time(cd);
 
 	da->list_dir_begin();
@@ -790,14 +754,15 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 	}
 }
 
-void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress) {
+void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress, bool p_recursive) {
 
 	uint64_t current_mtime = FileAccess::get_modified_time(p_dir->get_path());
 
 	bool updated_dir = false;
 	String cd = p_dir->get_path();
 
-	if (current_mtime != p_dir->modified_time) {
+	//non recursive scans come from the file watcher, which already knows something changed here (mtime has only second precision)
+	if (current_mtime != p_dir->modified_time || !p_recursive) {
 
 		updated_dir = true;
 		p_dir->modified_time = current_mtime;
@@ -977,7 +942,9 @@ void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const
 			scan_actions.push_back(ia);
 			continue;
 		}
-		_scan_fs_changes(p_dir->get_subdir(i), p_progress);
+		if (p_recursive) {
+			_scan_fs_changes(p_dir->get_subdir(i), p_progress);
+		}
 	}
 }
 
@@ -1003,11 +970,107 @@ void EditorFileSystem::_thread_func_sources(void *_userdata) {
 		sp.progress = &pr;
 		sp.hi = 1;
 		sp.low = 0;
-		efs->_scan_fs_changes(efs->filesystem, sp);
+		efs->_scan_changes(sp);
 	}
 	efs->scanning_changes_done = true;
 }
 
+void EditorFileSystem::_setup_file_watcher() {
+
+	if (file_watcher) {
+		memdelete(file_watcher);
+		file_watcher = NULL;
+	}
+
+	file_watcher_failed = false;
+	if (EditorSettings::get_singleton()->get("filesystem/directories/watch_for_changes")) {
+		file_watcher = FileWatcher::create(); //NULL when the platform has no support, changes are then found by full scans
+	}
+}
+
+static String _get_watch_path(const String &p_path) {
+
+	String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	if (path.length() > 1 && path.ends_with("/")) {
+		path = path.substr(0, path.length() - 1); //directory paths come with and without it
+	}
+	return path;
+}
+
+void EditorFileSystem::_watch_dir(const String &p_path) {
+
+	if (!file_watcher || file_watcher_failed)
+		return;
+
+	if (file_watcher->add_dir(_get_watch_path(p_path)) != OK) {
+		file_watcher_failed = true; //most likely the system watch limit, dropped in _collect_changed_dirs()
+	}
+}
+
+void EditorFileSystem::_unwatch_dir(EditorFileSystemDirectory *p_dir) {
+
+	if (!file_watcher)
+		return;
+
+	file_watcher->remove_dir(_get_watch_path(p_dir->get_path()));
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+		_unwatch_dir(p_dir->subdirs[i]);
+	}
+}
+
+void EditorFileSystem::_collect_changed_dirs() {
+
+	scan_changes_full = true;
+	scan_changes_dirs.clear();
+
+	if (!file_watcher)
+		return;
+
+	if (file_watcher_failed) {
+		WARN_PRINT("Could not watch all project directories for changes, falling back to full scans.");
+		memdelete(file_watcher);
+		file_watcher = NULL;
+		return;
+	}
+
+	Set<String> changed;
+	if (!file_watcher->get_changed_dirs(&changed))
+		return; //events were lost
+
+	scan_changes_full = false;
+	String root = _get_watch_path("res://");
+	for (Set<String>::Element *E = changed.front(); E; E = E->next()) {
+
+		//the inverse of _get_watch_path()
+		if (E->get() == root) {
+			scan_changes_dirs.push_back("res://");
+		} else if (E->get().begins_with(root + "/")) {
+			scan_changes_dirs.push_back("res://" + E->get().substr(root.length() + 1, E->get().length()));
+		}
+	}
+}
+
+void EditorFileSystem::_scan_changes(const ScanProgress &p_progress) {
+
+	if (scan_changes_full) {
+		_scan_fs_changes(filesystem, p_progress);
+		return;
+	}
+
+	//children sort after their parents, going backwards queues their actions before a parent can remove them
+	scan_changes_dirs.sort();
+	int total = scan_changes_dirs.size();
+	for (int i = total - 1; i >= 0; i--) {
+
+		const String &path = scan_changes_dirs[i];
+		EditorFileSystemDirectory *dir = get_filesystem_path(path);
+		if (dir && DirAccess::exists(path)) {
+			_scan_fs_changes(dir, p_progress.get_sub(total - 1 - i, total), false);
+		}
+		p_progress.update(total - i, total);
+	}
+}
+
 void EditorFileSystem::get_changed_sources(List<String> *r_changed) {
 
 	*r_changed = sources_changed;
@@ -1019,6 +1082,7 @@ void EditorFileSystem::scan_changes() {
 		return;
 
 	_update_extensions();
+	_collect_changed_dirs();
 	sources_changed.clear();
 	scanning_changes = true;
 	scanning_changes_done = false;
@@ -1033,7 +1097,7 @@ void EditorFileSystem::scan_changes() {
 			sp.hi = 1;
 			sp.low = 0;
 			scan_total = 0;
-			_scan_fs_changes(filesystem, sp);
+			_scan_changes(sp);
 			if (_update_scan_actions())
 				emit_signal("filesystem_changed");
 		}
@@ -1137,30 +1201,169 @@ EditorFileSystemDirectory *EditorFileSystem::get_filesystem() {
 	return filesystem;
 }
 
+// The cache is binary: a header, a table with every distinct string (types,
+// script classes and dependency paths repeat a lot), then each directory
+// followed by its files, which refer to strings by their index in the table.
+
+#define FILESYSTEM_CACHE_MAGIC "GDFC"
+#define FILESYSTEM_CACHE_VERSION 1
+
+static _FORCE_INLINE_ void _add_cache_string(const String &p_string, HashMap<String, uint32_t> &r_map, Vector<String> &r_strings) {
+
+	if (!r_map.has(p_string)) {
+		r_map[p_string] = r_strings.size();
+		r_strings.push_back(p_string);
+	}
+}
+
+void EditorFileSystem::_collect_cache_strings(EditorFileSystemDirectory *p_dir, HashMap<String, uint32_t> &r_map, Vector<String> &r_strings, uint32_t &r_dir_count) const {
+
+	r_dir_count++;
+	_add_cache_string(p_dir->get_path(), r_map, r_strings);
+
+	for (int i = 0; i < p_dir->files.size(); i++) {
+
+		const EditorFileSystemDirectory::FileInfo *fi = p_dir->files[i];
+		_add_cache_string(fi->file, r_map, r_strings);
+		_add_cache_string(fi->type, r_map, r_strings);
+		_add_cache_string(fi->script_class_name, r_map, r_strings);
+		_add_cache_string(fi->script_class_extends, r_map, r_strings);
+		_add_cache_string(fi->script_class_icon_path, r_map, r_strings);
+		for (int j = 0; j < fi->deps.size(); j++) {
+			_add_cache_string(fi->deps[j], r_map, r_strings);
+		}
+	}
+
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+
+		_collect_cache_strings(p_dir->subdirs[i], r_map, r_strings, r_dir_count);
+	}
+}
+
+void EditorFileSystem::_store_cache_dir(EditorFileSystemDirectory *p_dir, FileAccess *p_file, const HashMap<String, uint32_t> &p_map) const {
+
+	p_file->store_32(p_map[p_dir->get_path()]);
+	p_file->store_32(p_dir->files.size());
+
+	for (int i = 0; i < p_dir->files.size(); i++) {
+
+		const EditorFileSystemDirectory::FileInfo *fi = p_dir->files[i];
+		p_file->store_32(p_map[fi->file]);
+		p_file->store_32(p_map[fi->type]);
+		p_file->store_64(fi->modified_time);
+		p_file->store_64(fi->import_modified_time);
+		p_file->store_8(fi->import_valid);
+		p_file->store_32(p_map[fi->script_class_name]);
+		p_file->store_32(p_map[fi->script_class_extends]);
+		p_file->store_32(p_map[fi->script_class_icon_path]);
+		p_file->store_32(fi->deps.size());
+		for (int j = 0; j < fi->deps.size(); j++) {
+			p_file->store_32(p_map[fi->deps[j]]);
+		}
+	}
+
+	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+
+		_store_cache_dir(p_dir->subdirs[i], p_file, p_map);
+	}
+}
+
 void EditorFileSystem::_save_filesystem_cache(EditorFileSystemDirectory *p_dir, FileAccess *p_file) {
 
 	if (!p_dir)
 		return; //none
-	p_file->store_line("::" + p_dir->get_path() + "::" + String::num(p_dir->modified_time));
 
-	for (int i = 0; i < p_dir->files.size(); i++) {
+	HashMap<String, uint32_t> map;
+	Vector<String> strings;
+	uint32_t dir_count = 0;
+	_add_cache_string(String(), map, strings);
+	_collect_cache_strings(p_dir, map, strings, dir_count);
 
-		String s = p_dir->files[i]->file + "::" + p_dir->files[i]->type + "::" + itos(p_dir->files[i]->modified_time) + "::" + itos(p_dir->files[i]->import_modified_time) + "::" + itos(p_dir->files[i]->import_valid) + "::" + p_dir->files[i]->script_class_name + "<>" + p_dir->files[i]->script_class_extends + "<>" + p_dir->files[i]->script_class_icon_path;
-		s += "::";
-		for (int j = 0; j < p_dir->files[i]->deps.size(); j++) {
+	p_file->store_buffer((const uint8_t *)FILESYSTEM_CACHE_MAGIC, 4);
+	p_file->store_32(FILESYSTEM_CACHE_VERSION);
 
-			if (j > 0)
-				s += "<>";
-			s += p_dir->files[i]->deps[j];
-		}
+	p_file->store_32(strings.size());
+	for (int i = 0; i < strings.size(); i++) {
 
-		p_file->store_line(s);
+		CharString utf8 = strings[i].utf8();
+		p_file->store_32(utf8.length());
+		p_file->store_buffer((const uint8_t *)utf8.get_data(), utf8.length());
 	}
 
-	for (int i = 0; i < p_dir->subdirs.size(); i++) {
+	p_file->store_32(dir_count);
+	_store_cache_dir(p_dir, p_file, map);
+}
+
+bool EditorFileSystem::_load_filesystem_cache(FileAccess *p_file) {
+
+	uint8_t magic[4];
+	if (p_file->get_buffer(magic, 4) != 4 || memcmp(magic, FILESYSTEM_CACHE_MAGIC, 4) != 0)
+		return false;
+	if (p_file->get_32() != FILESYSTEM_CACHE_VERSION)
+		return false;
+
+	uint32_t string_count = p_file->get_32();
+	uint64_t file_len = p_file->get_len();
+	ERR_FAIL_COND_V(string_count > file_len, false);
+
+	Vector<String> strings;
+	strings.resize(string_count);
+	Vector<uint8_t> buffer;
+	for (uint32_t i = 0; i < string_count; i++) {
+
+		uint32_t len = p_file->get_32();
+		ERR_FAIL_COND_V(len > file_len, false);
+		buffer.resize(len + 1);
+		ERR_FAIL_COND_V(p_file->get_buffer(buffer.ptrw(), len) != (int)len, false);
+		strings.write[i].parse_utf8((const char *)buffer.ptr(), len);
+	}
+
+	uint32_t dir_count = p_file->get_32();
+	for (uint32_t i = 0; i < dir_count; i++) {
+
+		uint32_t path_idx = p_file->get_32();
+		ERR_FAIL_COND_V(path_idx >= string_count, false);
+		const String &dir_path = strings[path_idx];
+
+		uint32_t file_count = p_file->get_32();
+		ERR_FAIL_COND_V(p_file->eof_reached(), false);
+
+		for (uint32_t j = 0; j < file_count; j++) {
 
-		_save_filesystem_cache(p_dir->subdirs[i], p_file);
+			uint32_t idx[5];
+			idx[0] = p_file->get_32();
+			idx[1] = p_file->get_32();
+
+			FileCache fc;
+			fc.modification_time = p_file->get_64();
+			fc.import_modification_time = p_file->get_64();
+			fc.import_valid = p_file->get_8() != 0;
+
+			idx[2] = p_file->get_32();
+			idx[3] = p_file->get_32();
+			idx[4] = p_file->get_32();
+			for (int k = 0; k < 5; k++) {
+				ERR_FAIL_COND_V(idx[k] >= string_count, false);
+			}
+
+			fc.type = strings[idx[1]];
+			fc.script_class_name = strings[idx[2]];
+			fc.script_class_extends = strings[idx[3]];
+			fc.script_class_icon_path = strings[idx[4]];
+
+			uint32_t dep_count = p_file->get_32();
+			ERR_FAIL_COND_V(p_file->eof_reached(), false);
+			for (uint32_t k = 0; k < dep_count; k++) {
+				uint32_t dep_idx = p_file->get_32();
+				ERR_FAIL_COND_V(dep_idx >= string_count || p_file->eof_reached(), false);
+				fc.deps.push_back(strings[dep_idx]);
+			}
+
+			file_cache[dir_path.plus_file(strings[idx[0]])] = fc;
+		}
 	}
+
+	return true;
 }
 
 bool EditorFileSystem::_find_file(const String &p_file, EditorFileSystemDirectory **r_d, int &r_file_pos) const {
@@ -1492,16 +1695,20 @@ void EditorFileSystem::update_file(const String &p_file) {
 	_queue_update_script_classes();
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
+bool EditorFileSystem::_reimport_prepare(const String &p_file, ReimportJob &r_job) {
+
+	r_job.path = p_file;
+	r_job.valid = false;
+	r_job.imported = false;
 
 	EditorFileSystemDirectory *fs = NULL;
 	int cpos = -1;
 	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND(!found);
+	ERR_FAIL_COND_V(!found, false);
 
 	//try to obtain existing params
 
-	Map<StringName, Variant> params;
+	Map<StringName, Variant> &params = r_job.params;
 	String importer_name;
 
 	if (FileAccess::exists(p_file + ".import")) {
@@ -1526,7 +1733,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
 	}
 
-	Ref<ResourceImporter> importer;
+	Ref<ResourceImporter> &importer = r_job.importer;
 	bool load_default = false;
 	//find the importer
 	if (importer_name != "") {
@@ -1539,13 +1746,13 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		load_default = true;
 		if (importer.is_null()) {
 			ERR_PRINT("BUG: File queued for import, but can't be imported!");
-			ERR_FAIL();
+			ERR_FAIL_V(false);
 		}
 	}
 
 	//mix with default params, in case a parameter is missing
 
-	List<ResourceImporter::ImportOption> opts;
+	List<ResourceImporter::ImportOption> &opts = r_job.opts;
 	importer->get_import_options(&opts);
 	for (List<ResourceImporter::ImportOption>::Element *E = opts.front(); E; E = E->next()) {
 		if (!params.has(E->get().option.name)) { //this one is not present
@@ -1564,6 +1771,20 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 	}
 
+	r_job.valid = true;
+	return true;
+}
+
+// Runs the import and writes the .import and .md5 files. This only touches
+// the files of this job, so it can run on a worker thread when the importer
+// allows it.
+void EditorFileSystem::_reimport_run(ReimportJob &p_job) {
+
+	const String &p_file = p_job.path;
+	Ref<ResourceImporter> importer = p_job.importer;
+	Map<StringName, Variant> &params = p_job.params;
+	List<ResourceImporter::ImportOption> &opts = p_job.opts;
+
 	//finally, perform import!!
 	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_file);
 
@@ -1668,6 +1889,25 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	md5s->close();
 	memdelete(md5s);
 
+	p_job.imported = true;
+}
+
+// Updates the file system and editor state after an import, main thread only.
+void EditorFileSystem::_reimport_finish(const ReimportJob &p_job) {
+
+	if (!p_job.imported) {
+		return;
+	}
+
+	const String &p_file = p_job.path;
+	const Ref<ResourceImporter> &importer = p_job.importer;
+
+	//look the file up again, the tree may have changed while importing
+	EditorFileSystemDirectory *fs = NULL;
+	int cpos = -1;
+	bool found = _find_file(p_file, &fs, cpos);
+	ERR_FAIL_COND(!found);
+
 	//update modified times, to avoid reimport
 	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
 	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
@@ -1721,10 +1961,59 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	files.sort();
 
-	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	bool use_threads = EditorSettings::get_singleton()->get("filesystem/import/parallel_reimport") && pool && pool->get_thread_count() > 0 && reimport_job_done;
+
+	if (!use_threads) {
+
+		for (int i = 0; i < files.size(); i++) {
+			pr.step(files[i].path.get_file(), i);
+
+			_reimport_file(files[i].path);
+		}
+
+	} else {
+
+		Vector<ReimportJob> jobs;
+		jobs.resize(files.size());
+		for (int i = 0; i < files.size(); i++) {
+			_reimport_prepare(files[i].path, jobs.write[i]);
+		}
+
+		int i = 0;
+		while (i < jobs.size()) {
+
+			if (jobs[i].valid && !jobs[i].importer->can_import_threaded()) {
+				// Not thread safe, import it right here.
+				pr.step(files[i].path.get_file(), i);
+
+				_reimport_run(jobs.write[i]);
+				_reimport_finish(jobs[i]);
+				i++;
+				continue;
+			}
 
-		_reimport_file(files[i].path);
+			// Import consecutive files of the same import order and with thread
+			// safe importers at once, the order keeps imports that depend on
+			// others (like scenes) after them.
+			int from = i;
+			while (i < jobs.size() && files[i].order == files[from].order && (!jobs[i].valid || jobs[i].importer->can_import_threaded())) {
+				i++;
+			}
+
+			WorkerThreadPool::GroupID group = pool->add_template_group_task(this, &EditorFileSystem::_reimport_job, jobs.ptrw() + from, i - from);
+
+			// Each job posts once it's done, so progress is shown without polling.
+			for (int j = from; j < i; j++) {
+				pr.step(files[j].path.get_file(), j);
+				reimport_job_done->wait();
+			}
+			pool->wait_for_group(group);
+
+			for (int j = from; j < i; j++) {
+				_reimport_finish(jobs[j]);
+			}
+		}
 	}
 
 	_save_filesystem_cache();
@@ -1736,6 +2025,25 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 	emit_signal("resources_reimported", p_files);
 }
 
+void EditorFileSystem::_reimport_file(const String &p_file) {
+
+	ReimportJob job;
+	if (!_reimport_prepare(p_file, job)) {
+		return;
+	}
+
+	_reimport_run(job);
+	_reimport_finish(job);
+}
+
+void EditorFileSystem::_reimport_job(uint32_t p_index, ReimportJob *p_jobs) {
+
+	if (p_jobs[p_index].valid) {
+		_reimport_run(p_jobs[p_index]);
+	}
+	reimport_job_done->post();
+}
+
 Error EditorFileSystem::_resource_import(const String &p_path) {
 
 	Vector<String> files;
@@ -1813,7 +2121,17 @@ EditorFileSystem::EditorFileSystem() {
 
 	scan_total = 0;
 	update_script_classes_queued = false;
+	reimport_job_done = Semaphore::create();
+
+	file_watcher = NULL;
+	file_watcher_failed = false;
+	scan_changes_full = true;
 }
 
 EditorFileSystem::~EditorFileSystem() {
+
+	if (file_watcher)
+		memdelete(file_watcher);
+	if (reimport_job_done)
+		memdelete(reimport_job_done);
 }
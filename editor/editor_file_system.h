@@ -31,7 +31,10 @@
 #ifndef EDITOR_FILE_SYSTEM_H
 #define EDITOR_FILE_SYSTEM_H
 
+#include "core/io/resource_import.h"
 #include "core/os/dir_access.h"
+#include "core/os/file_watcher.h"
+#include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/set.h"
@@ -182,10 +185,13 @@ class EditorFileSystem : public Node {
 
 	void _save_filesystem_cache();
 	void _save_filesystem_cache(EditorFileSystemDirectory *p_dir, FileAccess *p_file);
+	void _collect_cache_strings(EditorFileSystemDirectory *p_dir, HashMap<String, uint32_t> &r_map, Vector<String> &r_strings, uint32_t &r_dir_count) const;
+	void _store_cache_dir(EditorFileSystemDirectory *p_dir, FileAccess *p_file, const HashMap<String, uint32_t> &p_map) const;
+	bool _load_filesystem_cache(FileAccess *p_file);
 
 	bool _find_file(const String &p_file, EditorFileSystemDirectory **r_d, int &r_file_pos) const;
 
-	void _scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress);
+	void _scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress, bool p_recursive = true);
 
 	void _delete_internal_files(String p_file);
 
@@ -200,6 +206,16 @@ class EditorFileSystem : public Node {
 
 	static void _thread_func_sources(void *_userdata);
 
+	FileWatcher *file_watcher;
+	volatile bool file_watcher_failed;
+	bool scan_changes_full;
+	Vector<String> scan_changes_dirs;
+	void _setup_file_watcher();
+	void _watch_dir(const String &p_path);
+	void _unwatch_dir(EditorFileSystemDirectory *p_dir);
+	void _collect_changed_dirs();
+	void _scan_changes(const ScanProgress &p_progress);
+
 	List<String> sources_changed;
 	List<ItemAction> scan_actions;
 
@@ -207,7 +223,22 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
+	struct ReimportJob {
+		String path;
+		Ref<ResourceImporter> importer;
+		Map<StringName, Variant> params;
+		List<ResourceImporter::ImportOption> opts;
+		bool valid;
+		bool imported;
+	};
+
+	Semaphore *reimport_job_done;
+
+	bool _reimport_prepare(const String &p_file, ReimportJob &r_job);
+	void _reimport_run(ReimportJob &p_job);
+	void _reimport_finish(const ReimportJob &p_job);
 	void _reimport_file(const String &p_file);
+	void _reimport_job(uint32_t p_index, ReimportJob *p_jobs);
 
 	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
 
@@ -41,6 +41,7 @@
 #include "core/os/input.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/path_remap.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
@@ -1393,7 +1394,7 @@ void EditorNode::push_item(Object *p_object, const String &p_property, bool p_in
 		return;
 	}
 
-	uint32_t id = p_object->get_instance_id();
+	ObjectID id = p_object->get_instance_id();
 	if (id != editor_history.get_current()) {
 
 		if (p_inspector_only) {
@@ -3109,9 +3110,19 @@ void EditorNode::add_io_error(const String &p_error) {
 void EditorNode::_load_error_notify(void *p_ud, const String &p_text) {
 
 	EditorNode *en = (EditorNode *)p_ud;
-	en->load_errors->add_image(en->gui_base->get_icon("Error", "EditorIcons"));
-	en->load_errors->add_text(p_text + "\n");
-	en->load_error_dialog->popup_centered_ratio(0.5);
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		//threaded loads and imports report their errors here, the dialog can only be used from the main thread
+		en->call_deferred("_load_error_deferred", p_text);
+		return;
+	}
+	en->_load_error_deferred(p_text);
+}
+
+void EditorNode::_load_error_deferred(const String &p_text) {
+
+	load_errors->add_image(gui_base->get_icon("Error", "EditorIcons"));
+	load_errors->add_text(p_text + "\n");
+	load_error_dialog->popup_centered_ratio(0.5);
 }
 
 bool EditorNode::_find_scene_in_use(Node *p_node, const String &p_path) const {
@@ -4636,11 +4647,22 @@ void EditorNode::_video_driver_selected(int p_which) {
 }
 
 void EditorNode::_resource_saved(RES p_resource, const String &p_path) {
+
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		//saved by a threaded importer, the file system must be updated from the main thread
+		singleton->call_deferred("_resource_saved_deferred", p_resource, p_path);
+		return;
+	}
+	singleton->_resource_saved_deferred(p_resource, p_path);
+}
+
+void EditorNode::_resource_saved_deferred(RES p_resource, const String &p_path) {
+
 	if (EditorFileSystem::get_singleton()) {
 		EditorFileSystem::get_singleton()->update_file(p_path);
 	}
 
-	singleton->editor_folding.save_resource_folding(p_resource, p_path);
+	editor_folding.save_resource_folding(p_resource, p_path);
 }
 
 void EditorNode::_resource_loaded(RES p_resource, const String &p_path) {
@@ -4651,6 +4673,8 @@ void EditorNode::_resource_loaded(RES p_resource, const String &p_path) {
 void EditorNode::_bind_methods() {
 
 	ClassDB::bind_method("_menu_option", &EditorNode::_menu_option);
+	ClassDB::bind_method("_load_error_deferred", &EditorNode::_load_error_deferred);
+	ClassDB::bind_method("_resource_saved_deferred", &EditorNode::_resource_saved_deferred);
 	ClassDB::bind_method("_tool_menu_option", &EditorNode::_tool_menu_option);
 	ClassDB::bind_method("_menu_confirm_current", &EditorNode::_menu_confirm_current);
 	ClassDB::bind_method("_dialog_action", &EditorNode::_dialog_action);
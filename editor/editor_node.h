@@ -477,6 +477,7 @@ private:
 	void _unhandled_input(const Ref<InputEvent> &p_event);
 
 	static void _load_error_notify(void *p_ud, const String &p_text);
+	void _load_error_deferred(const String &p_text);
 
 	bool has_main_screen() const { return true; }
 
@@ -606,6 +607,7 @@ private:
 	static void _print_handler(void *p_this, const String &p_string, bool p_error);
 
 	static void _resource_saved(RES p_resource, const String &p_path);
+	void _resource_saved_deferred(RES p_resource, const String &p_path);
 	static void _resource_loaded(RES p_resource, const String &p_path);
 
 	void _resources_changed(const PoolVector<String> &p_resources);
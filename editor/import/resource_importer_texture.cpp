@@ -32,10 +32,14 @@
 
 #include "core/io/config_file.h"
 #include "core/io/image_loader.h"
+#include "core/os/dir_access.h"
+#include "core/os/thread.h"
 #include "editor/editor_file_system.h"
 #include "editor/editor_node.h"
 #include "scene/resources/texture.h"
 
+#include "thirdparty/misc/md5.h"
+
 void ResourceImporterTexture::_texture_reimport_srgb(const Ref<StreamTexture> &p_tex) {
 
 	singleton->mutex->lock();
@@ -219,7 +223,161 @@ void ResourceImporterTexture::get_import_options(List<ImportOption> *r_options,
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "svg/scale", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 1.0));
 }
 
-void ResourceImporterTexture::_save_stex(const Ref<Image> &p_image, const String &p_to_path, int p_compress_mode, float p_lossy_quality, Image::CompressMode p_vram_compression, bool p_mipmaps, int p_texture_flags, bool p_streamable, bool p_detect_3d, bool p_detect_srgb, bool p_force_rgbe, bool p_detect_normal, bool p_force_normal) {
+// Bump when the compressors change their output, so old entries are not reused.
+#define VRAM_CACHE_VERSION 1
+#define VRAM_CACHE_DIR "res://.import/.vram_cache/"
+
+String ResourceImporterTexture::_get_vram_cache_path(const Ref<Image> &p_image, Image::CompressMode p_vram_compression, Image::CompressSource p_source, float p_lossy_quality, bool p_mipmaps, bool p_force_rgbe, bool p_force_normal) const {
+
+	// The key covers the source pixels and everything that affects how they
+	// are compressed, so the cached output can be used instead of compressing
+	// again.
+	int32_t params[11] = {
+		VRAM_CACHE_VERSION,
+		p_image->get_width(),
+		p_image->get_height(),
+		p_image->get_format(),
+		p_image->has_mipmaps(),
+		p_vram_compression,
+		p_source,
+		int32_t(p_lossy_quality * 1000),
+		p_mipmaps,
+		p_force_rgbe,
+		p_force_normal
+	};
+
+	MD5_CTX md5;
+	MD5Init(&md5);
+	MD5Update(&md5, (unsigned char *)params, sizeof(params));
+
+	PoolVector<uint8_t> data = p_image->get_data();
+	PoolVector<uint8_t>::Read r = data.read();
+	MD5Update(&md5, (unsigned char *)r.ptr(), data.size());
+	MD5Final(&md5);
+
+	return VRAM_CACHE_DIR + String::md5(md5.digest) + ".vramc";
+}
+
+Ref<Image> ResourceImporterTexture::_load_vram_cache(const String &p_path) const {
+
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::READ);
+	if (!f) {
+		return Ref<Image>();
+	}
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'D' || header[2] != 'V' || header[3] != 'C') {
+		return Ref<Image>();
+	}
+
+	int width = f->get_32();
+	int height = f->get_32();
+	Image::Format format = Image::Format(f->get_32());
+	bool mipmaps = f->get_32();
+	uint32_t size = f->get_32();
+
+	if (format >= Image::FORMAT_MAX || size != uint32_t(Image::get_image_data_size(width, height, format, mipmaps))) {
+		return Ref<Image>();
+	}
+
+	PoolVector<uint8_t> data;
+	data.resize(size);
+	{
+		PoolVector<uint8_t>::Write w = data.write();
+		if (f->get_buffer(w.ptr(), size) != int(size)) {
+			return Ref<Image>(); // truncated, compress again
+		}
+	}
+
+	Ref<Image> image;
+	image.instance();
+	image->create(width, height, mipmaps, format, data);
+	return image;
+}
+
+void ResourceImporterTexture::_save_vram_cache(const String &p_path, const Ref<Image> &p_image) const {
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	if (!da->dir_exists(p_path.get_base_dir())) {
+		if (da->make_dir_recursive(p_path.get_base_dir()) != OK) {
+			return;
+		}
+	}
+
+	// Written under a temporary name and renamed when complete, so an entry
+	// is never read while only part of it is there.
+	String tmp_path = p_path + "." + itos(Thread::get_caller_id()) + ".tmp";
+	FileAccess *f = FileAccess::open(tmp_path, FileAccess::WRITE);
+	if (!f) {
+		return;
+	}
+
+	f->store_8('G');
+	f->store_8('D');
+	f->store_8('V');
+	f->store_8('C');
+	f->store_32(p_image->get_width());
+	f->store_32(p_image->get_height());
+	f->store_32(p_image->get_format());
+	f->store_32(p_image->has_mipmaps());
+
+	PoolVector<uint8_t> data = p_image->get_data();
+	PoolVector<uint8_t>::Read r = data.read();
+	f->store_32(data.size());
+	f->store_buffer(r.ptr(), data.size());
+	memdelete(f);
+
+	if (da->rename(tmp_path, p_path) != OK) {
+		da->remove(tmp_path);
+	}
+}
+
+void ResourceImporterTexture::_update_vram_cache_entries(const String &p_save_path, const Vector<String> &p_entries) const {
+
+	// Entries are keyed by content, a texture that changed leaves its old ones
+	// behind. The entries used by the last import are listed next to the
+	// imported files, those no longer used are removed. Another texture with
+	// the same pixels and settings then has to compress again once.
+	String list_path = p_save_path + ".vram_cache";
+
+	Vector<String> old_entries;
+	{
+		FileAccessRef f = FileAccess::open(list_path, FileAccess::READ);
+		if (f) {
+			while (!f->eof_reached()) {
+				String entry = f->get_line();
+				if (entry.begins_with(VRAM_CACHE_DIR) && entry.ends_with(".vramc")) {
+					old_entries.push_back(entry);
+				}
+			}
+		}
+	}
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	for (int i = 0; i < old_entries.size(); i++) {
+		if (p_entries.find(old_entries[i]) == -1) {
+			da->remove(old_entries[i]);
+		}
+	}
+
+	if (p_entries.empty()) {
+		if (old_entries.size()) {
+			da->remove(list_path);
+		}
+		return;
+	}
+
+	FileAccessRef f = FileAccess::open(list_path, FileAccess::WRITE);
+	if (!f) {
+		return;
+	}
+	for (int i = 0; i < p_entries.size(); i++) {
+		f->store_line(p_entries[i]);
+	}
+}
+
+void ResourceImporterTexture::_save_stex(const Ref<Image> &p_image, const String &p_to_path, int p_compress_mode, float p_lossy_quality, Image::CompressMode p_vram_compression, bool p_mipmaps, int p_texture_flags, bool p_streamable, bool p_detect_3d, bool p_detect_srgb, bool p_force_rgbe, bool p_detect_normal, bool p_force_normal, Vector<String> *r_vram_cache_entries) {
 
 	FileAccess *f = FileAccess::open(p_to_path, FileAccess::WRITE);
 	f->store_8('G');
@@ -309,22 +467,36 @@ void ResourceImporterTexture::_save_stex(const Ref<Image> &p_image, const String
 		} break;
 		case COMPRESS_VIDEO_RAM: {
 
-			Ref<Image> image = p_image->duplicate();
-			if (p_mipmaps) {
-				image->generate_mipmaps(p_force_normal);
+			Image::CompressSource csource = Image::COMPRESS_SOURCE_GENERIC;
+			if (p_force_normal) {
+				csource = Image::COMPRESS_SOURCE_NORMAL;
+			} else if (p_texture_flags & VS::TEXTURE_FLAG_CONVERT_TO_LINEAR) {
+				csource = Image::COMPRESS_SOURCE_SRGB;
 			}
 
-			if (p_force_rgbe && image->get_format() >= Image::FORMAT_R8 && image->get_format() <= Image::FORMAT_RGBE9995) {
-				image->convert(Image::FORMAT_RGBE9995);
-			} else {
-				Image::CompressSource csource = Image::COMPRESS_SOURCE_GENERIC;
-				if (p_force_normal) {
-					csource = Image::COMPRESS_SOURCE_NORMAL;
-				} else if (p_texture_flags & VS::TEXTURE_FLAG_CONVERT_TO_LINEAR) {
-					csource = Image::COMPRESS_SOURCE_SRGB;
+			String cache_path;
+			Ref<Image> image;
+			if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_cache")) {
+				cache_path = _get_vram_cache_path(p_image, p_vram_compression, csource, p_lossy_quality, p_mipmaps, p_force_rgbe, p_force_normal);
+				image = _load_vram_cache(cache_path);
+				r_vram_cache_entries->push_back(cache_path);
+			}
+
+			if (image.is_null()) {
+				image = p_image->duplicate();
+				if (p_mipmaps) {
+					image->generate_mipmaps(p_force_normal);
+				}
+
+				if (p_force_rgbe && image->get_format() >= Image::FORMAT_R8 && image->get_format() <= Image::FORMAT_RGBE9995) {
+					image->convert(Image::FORMAT_RGBE9995);
+				} else {
+					image->compress(p_vram_compression, csource, p_lossy_quality);
 				}
 
-				image->compress(p_vram_compression, csource, p_lossy_quality);
+				if (cache_path != String()) {
+					_save_vram_cache(cache_path, image);
+				}
 			}
 
 			format |= image->get_format();
@@ -446,6 +618,8 @@ Error ResourceImporterTexture::import(const String &p_source_file, const String
 	bool detect_normal = normal == 0;
 	bool force_normal = normal == 1;
 
+	Vector<String> vram_cache_entries;
+
 	if (compress_mode == COMPRESS_VIDEO_RAM) {
 		//must import in all formats, in order of priority (so platform choses the best supported one. IE, etc2 over etc).
 		//Android, GLES 2.x
@@ -478,25 +652,25 @@ Error ResourceImporterTexture::import(const String &p_source_file, const String
 		}
 
 		if (can_bptc || can_s3tc) {
-			_save_stex(image, p_save_path + ".s3tc.stex", compress_mode, lossy, can_bptc ? Image::COMPRESS_BPTC : Image::COMPRESS_S3TC, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal);
+			_save_stex(image, p_save_path + ".s3tc.stex", compress_mode, lossy, can_bptc ? Image::COMPRESS_BPTC : Image::COMPRESS_S3TC, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal, &vram_cache_entries);
 			r_platform_variants->push_back("s3tc");
 			ok_on_pc = true;
 		}
 
 		if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_etc2")) {
 
-			_save_stex(image, p_save_path + ".etc2.stex", compress_mode, lossy, Image::COMPRESS_ETC2, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal);
+			_save_stex(image, p_save_path + ".etc2.stex", compress_mode, lossy, Image::COMPRESS_ETC2, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal, &vram_cache_entries);
 			r_platform_variants->push_back("etc2");
 		}
 
 		if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_etc")) {
-			_save_stex(image, p_save_path + ".etc.stex", compress_mode, lossy, Image::COMPRESS_ETC, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal);
+			_save_stex(image, p_save_path + ".etc.stex", compress_mode, lossy, Image::COMPRESS_ETC, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal, &vram_cache_entries);
 			r_platform_variants->push_back("etc");
 		}
 
 		if (ProjectSettings::get_singleton()->get("rendering/vram_compression/import_pvrtc")) {
 
-			_save_stex(image, p_save_path + ".pvrtc.stex", compress_mode, lossy, Image::COMPRESS_PVRTC4, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal);
+			_save_stex(image, p_save_path + ".pvrtc.stex", compress_mode, lossy, Image::COMPRESS_PVRTC4, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal, &vram_cache_entries);
 			r_platform_variants->push_back("pvrtc");
 		}
 
@@ -505,9 +679,11 @@ Error ResourceImporterTexture::import(const String &p_source_file, const String
 		}
 	} else {
 		//import normally
-		_save_stex(image, p_save_path + ".stex", compress_mode, lossy, Image::COMPRESS_S3TC /*this is ignored */, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal);
+		_save_stex(image, p_save_path + ".stex", compress_mode, lossy, Image::COMPRESS_S3TC /*this is ignored */, mipmaps, tex_flags, stream, detect_3d, detect_srgb, force_rgbe, detect_normal, force_normal, &vram_cache_entries);
 	}
 
+	_update_vram_cache_entries(p_save_path, vram_cache_entries);
+
 	return OK;
 }
 
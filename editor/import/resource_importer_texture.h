@@ -55,6 +55,11 @@ protected:
 
 	static ResourceImporterTexture *singleton;
 
+	String _get_vram_cache_path(const Ref<Image> &p_image, Image::CompressMode p_vram_compression, Image::CompressSource p_source, float p_lossy_quality, bool p_mipmaps, bool p_force_rgbe, bool p_force_normal) const;
+	Ref<Image> _load_vram_cache(const String &p_path) const;
+	void _save_vram_cache(const String &p_path, const Ref<Image> &p_image) const;
+	void _update_vram_cache_entries(const String &p_save_path, const Vector<String> &p_entries) const;
+
 public:
 	static ResourceImporterTexture *get_singleton() { return singleton; }
 	virtual String get_importer_name() const;
@@ -82,8 +87,9 @@ public:
 
 	virtual void get_import_options(List<ImportOption> *r_options, int p_preset = 0) const;
 	virtual bool get_option_visibility(const String &p_option, const Map<StringName, Variant> &p_options) const;
+	virtual bool can_import_threaded() const { return true; }
 
-	void _save_stex(const Ref<Image> &p_image, const String &p_to_path, int p_compress_mode, float p_lossy_quality, Image::CompressMode p_vram_compression, bool p_mipmaps, int p_texture_flags, bool p_streamable, bool p_detect_3d, bool p_detect_srgb, bool p_force_rgbe, bool p_detect_normal, bool p_force_normal);
+	void _save_stex(const Ref<Image> &p_image, const String &p_to_path, int p_compress_mode, float p_lossy_quality, Image::CompressMode p_vram_compression, bool p_mipmaps, int p_texture_flags, bool p_streamable, bool p_detect_3d, bool p_detect_srgb, bool p_force_rgbe, bool p_detect_normal, bool p_force_normal, Vector<String> *r_vram_cache_entries);
 
 	virtual Error import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = NULL);
 
@@ -42,6 +42,7 @@
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "core/register_core_types.h"
 #include "core/script_debugger_local.h"
@@ -86,6 +87,7 @@
 static Engine *engine = NULL;
 static ProjectSettings *globals = NULL;
 static InputMap *input_map = NULL;
+static WorkerThreadPool *worker_thread_pool = NULL;
 static TranslationServer *translation_server = NULL;
 static Performance *performance = NULL;
 static PackedData *packed_data = NULL;
@@ -345,6 +347,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	globals = memnew(ProjectSettings);
 	input_map = memnew(InputMap);
+	worker_thread_pool = memnew(WorkerThreadPool);
 
 	register_core_settings(); //here globals is present
 
@@ -760,6 +763,10 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 #endif
 	}
 
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads", PropertyInfo(Variant::INT, "threading/worker_pool/max_threads", PROPERTY_HINT_RANGE, "-1,256,1,or_greater")); // -1 picks one less than the processor count
+	worker_thread_pool->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	GLOBAL_DEF("memory/limits/multithreaded_server/rid_pool_prealloc", 60);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/multithreaded_server/rid_pool_prealloc", PropertyInfo(Variant::INT, "memory/limits/multithreaded_server/rid_pool_prealloc", PROPERTY_HINT_RANGE, "0,500,1")); // No negative and limit to 500 due to crashes
 	GLOBAL_DEF("network/limits/debugger_stdout/max_chars_per_second", 2048);
@@ -1049,6 +1056,8 @@ error:
 	if (show_help)
 		print_help(execpath);
 
+	if (worker_thread_pool)
+		memdelete(worker_thread_pool);
 	if (performance)
 		memdelete(performance);
 	if (input_map)
@@ -1990,6 +1999,7 @@ void Main::cleanup() {
 	OS::get_singleton()->_execpath = "";
 	OS::get_singleton()->_local_clipboard = "";
 
+	ResourceLoader::clear_thread_load_tasks();
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
@@ -2024,6 +2034,8 @@ void Main::cleanup() {
 		memdelete(packed_data);
 	if (file_access_network_client)
 		memdelete(file_access_network_client);
+	if (worker_thread_pool)
+		memdelete(worker_thread_pool);
 	if (performance)
 		memdelete(performance);
 	if (input_map)
@@ -32,6 +32,7 @@
 
 #include "core/message_queue.h"
 #include "core/os/os.h"
+#include "core/os/slab_allocator.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
 #include "servers/physics_2d_server.h"
@@ -43,6 +44,7 @@ Performance *Performance::singleton = NULL;
 void Performance::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &Performance::get_monitor);
+	ClassDB::bind_method(D_METHOD("get_slab_size_classes"), &Performance::get_slab_size_classes);
 
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
@@ -72,6 +74,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_USED);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_RESERVED);
+	BIND_ENUM_CONSTANT(RENDER_2D_ITEMS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_2D_DRAW_CALLS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_2D_BATCHES_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -109,6 +116,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"memory/slab_used",
+		"memory/slab_reserved",
+		"raster/2d_items",
+		"raster/2d_draw_calls",
+		"raster/2d_batches",
 
 	};
 
@@ -153,6 +165,23 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY: return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_SLAB_USED:
+		case MEMORY_SLAB_RESERVED: {
+#ifdef SLAB_ALLOCATOR_ENABLED
+			SlabAllocator::SizeClassInfo info[SlabAllocator::SIZE_CLASS_COUNT];
+			SlabAllocator::get_size_class_info(info);
+			uint64_t total = 0;
+			for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+				total += (p_monitor == MEMORY_SLAB_USED ? info[i].used_blocks : info[i].reserved_blocks) * info[i].block_size;
+			}
+			return total;
+#else
+			return 0;
+#endif
+		};
+		case RENDER_2D_ITEMS_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_2D_ITEMS_IN_FRAME);
+		case RENDER_2D_DRAW_CALLS_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_2D_DRAW_CALLS_IN_FRAME);
+		case RENDER_2D_BATCHES_IN_FRAME: return VS::get_singleton()->get_render_info(VS::INFO_2D_BATCHES_IN_FRAME);
 
 		default: {}
 	}
@@ -193,12 +222,35 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
 	return types[p_monitor];
 }
 
+// One entry per size class of the slab allocator, empty when the engine is built without it.
+Array Performance::get_slab_size_classes() const {
+
+	Array ret;
+#ifdef SLAB_ALLOCATOR_ENABLED
+	SlabAllocator::SizeClassInfo info[SlabAllocator::SIZE_CLASS_COUNT];
+	SlabAllocator::get_size_class_info(info);
+	for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+		Dictionary d;
+		d["block_size"] = info[i].block_size;
+		d["used_blocks"] = info[i].used_blocks;
+		d["reserved_blocks"] = info[i].reserved_blocks;
+		ret.push_back(d);
+	}
+#endif
+	return ret;
+}
+
 void Performance::set_process_time(float p_pt) {
 
 	_process_time = p_pt;
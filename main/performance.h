@@ -78,6 +78,11 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_SLAB_USED,
+		MEMORY_SLAB_RESERVED,
+		RENDER_2D_ITEMS_IN_FRAME,
+		RENDER_2D_DRAW_CALLS_IN_FRAME,
+		RENDER_2D_BATCHES_IN_FRAME,
 		MONITOR_MAX
 	};
 
@@ -92,6 +97,8 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	Array get_slab_size_classes() const;
+
 	void set_process_time(float p_pt);
 	void set_physics_process_time(float p_pt);
 
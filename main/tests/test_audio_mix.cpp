@@ -0,0 +1,213 @@
+/*************************************************************************/
+/*  test_audio_mix.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_audio_mix.h"
+#include "test_check.h"
+
+#include "core/os/os.h"
+#include "core/print_string.h"
+#include "servers/audio/effects/audio_effect_compressor.h"
+#include "servers/audio/effects/audio_effect_eq.h"
+#include "servers/audio/effects/audio_effect_filter.h"
+#include "servers/audio/effects/audio_effect_reverb.h"
+#include "servers/audio_server.h"
+
+namespace TestAudioMix {
+
+// Mixes a fixed bus layout directly, outside of the running driver, so it
+// works headless (e.g. with --audio-driver Dummy). Serial and parallel
+// mixing must produce the same output.
+
+class AudioDriverBench : public AudioDriver {
+
+public:
+	virtual const char *get_name() const { return "Bench"; }
+	virtual Error init() { return OK; }
+	virtual void start() {}
+	virtual int get_mix_rate() const { return AudioServer::get_singleton()->get_mix_rate(); }
+	virtual SpeakerMode get_speaker_mode() const { return SpeakerMode(AudioServer::get_singleton()->get_speaker_mode()); }
+	virtual void lock() {}
+	virtual void unlock() {}
+	virtual void finish() {}
+
+	void mix(int p_frames, int32_t *p_buffer) { audio_server_process(p_frames, p_buffer, false); }
+};
+
+struct Source {
+
+	int first_bus;
+	int bus_count;
+	uint32_t seed;
+	int steps;
+	uint32_t checksum;
+};
+
+static void _fill_sources(void *p_userdata) {
+
+	Source *source = (Source *)p_userdata;
+	AudioServer *as = AudioServer::get_singleton();
+	int frames = as->thread_get_mix_buffer_size();
+
+	// Peaks are left from the previous step. The driver output can't be
+	// compared between runs, it may start with frames left over from before.
+	if (source->steps++ > 0) {
+		for (int i = 0; i < as->get_bus_count(); i++) {
+			float peak[2] = { as->get_bus_peak_volume_left_db(i, 0), as->get_bus_peak_volume_right_db(i, 0) };
+			source->checksum = source->checksum * 31 + ((uint32_t *)peak)[0];
+			source->checksum = source->checksum * 31 + ((uint32_t *)peak)[1];
+		}
+	}
+
+	for (int i = 0; i < source->bus_count; i++) {
+
+		AudioFrame *buf = as->thread_get_channel_mix_buffer(source->first_bus + i, 0);
+		for (int j = 0; j < frames; j++) {
+			source->seed = source->seed * 1664525 + 1013904223;
+			float l = (int32_t(source->seed) >> 8) * (1.0 / (1 << 24));
+			source->seed = source->seed * 1664525 + 1013904223;
+			float r = (int32_t(source->seed) >> 8) * (1.0 / (1 << 24));
+			buf[j] = AudioFrame(l, r) * 0.25;
+		}
+	}
+}
+
+// Master <- p_groups group buses (reverb) <- p_leaves leaf buses each (EQ, filter, compressor).
+// The compressor of the first leaf uses the last leaf as sidechain, with p_lower_sidechain
+// the one of a middle leaf uses the first group, which some leaves have sent to by then.
+static int _setup_buses(int p_groups, int p_leaves, bool p_lower_sidechain) {
+
+	AudioServer *as = AudioServer::get_singleton();
+	as->set_bus_count(1);
+	as->set_bus_count(1 + p_groups + p_groups * p_leaves);
+
+	for (int i = 0; i < p_groups; i++) {
+
+		int group = 1 + i;
+		as->set_bus_name(group, "Group " + itos(i));
+		Ref<AudioEffectReverb> reverb;
+		reverb.instance();
+		as->add_bus_effect(group, reverb);
+	}
+
+	for (int i = 0; i < p_groups * p_leaves; i++) {
+
+		int leaf = 1 + p_groups + i;
+		as->set_bus_name(leaf, "Leaf " + itos(i));
+		as->set_bus_send(leaf, "Group " + itos(i % p_groups));
+
+		Ref<AudioEffectEQ6> eq;
+		eq.instance();
+		eq->set_band_gain_db(1, 6);
+		as->add_bus_effect(leaf, eq);
+		Ref<AudioEffectLowPassFilter> filter;
+		filter.instance();
+		as->add_bus_effect(leaf, filter);
+		Ref<AudioEffectCompressor> compressor;
+		compressor.instance();
+		if (i == 0) {
+			compressor->set_sidechain("Leaf " + itos(p_groups * p_leaves - 1));
+			compressor->set_threshold(-30);
+		} else if (i == p_groups * p_leaves / 2 && p_lower_sidechain) {
+			compressor->set_sidechain("Group 0");
+			compressor->set_threshold(-30);
+		}
+		as->add_bus_effect(leaf, compressor);
+	}
+
+	return 1 + p_groups;
+}
+
+static uint64_t _run(bool p_parallel, int p_groups, int p_leaves, bool p_lower_sidechain, int p_steps, uint32_t *r_checksum) {
+
+	AudioServer *as = AudioServer::get_singleton();
+
+	Source source;
+	source.first_bus = _setup_buses(p_groups, p_leaves, p_lower_sidechain);
+	source.bus_count = p_groups * p_leaves;
+	source.seed = 1;
+	source.steps = 0;
+	source.checksum = 0;
+
+	AudioDriverBench driver;
+	int frames = as->thread_get_mix_buffer_size();
+	Vector<int32_t> output;
+	output.resize(frames * as->get_channel_count() * 2);
+
+	// Keep the real driver from mixing meanwhile.
+	as->lock();
+
+	bool was_parallel = as->is_parallel_bus_mixing_enabled();
+	as->set_parallel_bus_mixing(p_parallel);
+	as->add_callback(_fill_sources, &source);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_steps; i++) {
+		driver.mix(frames, output.ptrw());
+	}
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	as->remove_callback(_fill_sources, &source);
+	as->set_parallel_bus_mixing(was_parallel);
+
+	as->unlock();
+
+	as->set_bus_count(1);
+
+	uint32_t checksum = source.checksum;
+	*r_checksum = checksum;
+	return time;
+}
+
+MainLoop *test() {
+
+	const int steps = 200;
+	// Groups, leaves per group and whether a compressor uses a bus mixed after it as sidechain.
+	const int layouts[][3] = { { 1, 8, 0 }, { 4, 8, 0 }, { 8, 8, 0 }, { 4, 8, 1 } };
+
+	for (int i = 0; i < 4; i++) {
+
+		int groups = layouts[i][0];
+		int leaves = layouts[i][1];
+		bool lower_sidechain = layouts[i][2];
+		int bus_count = 1 + groups + groups * leaves;
+
+		uint32_t serial_checksum, parallel_checksum;
+		uint64_t serial = _run(false, groups, leaves, lower_sidechain, steps, &serial_checksum);
+		uint64_t parallel = _run(true, groups, leaves, lower_sidechain, steps, &parallel_checksum);
+
+		print_line(itos(bus_count) + " buses" + String(lower_sidechain ? " (lower sidechain)" : "") + ": serial " + rtos(double(serial) / (steps * bus_count)) + " usec/bus, parallel " + rtos(double(parallel) / (steps * bus_count)) + " usec/bus");
+		CHECK(serial_checksum == parallel_checksum);
+	}
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestAudioMix
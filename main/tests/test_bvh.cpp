@@ -0,0 +1,174 @@
+/*************************************************************************/
+/*  test_bvh.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_bvh.h"
+#include "test_check.h"
+
+#include "core/math/bvh.h"
+#include "core/math/camera_matrix.h"
+#include "core/math/octree.h"
+#include "core/os/os.h"
+
+namespace TestBVH {
+
+// Moving-object workload, run the same way on the octree and the BVH. Both must report the same
+// pairs and cull results.
+
+struct Body {
+
+	AABB aabb;
+	Vector3 velocity;
+	uint32_t id;
+};
+
+struct Stats {
+
+	uint64_t create_usec;
+	uint64_t move_usec;
+	uint64_t cull_usec;
+	int pair_events;
+	int pairs;
+	int culled;
+};
+
+static void *_pair(void *p_self, uint32_t, Body *, int, uint32_t, Body *, int) {
+
+	(*(int *)p_self)++;
+	return NULL;
+}
+
+static void _unpair(void *p_self, uint32_t, Body *, int, uint32_t, Body *, int, void *) {
+
+	(*(int *)p_self)++;
+}
+
+template <class TREE>
+static Stats _run(Vector<Body> p_bodies, int p_pairable_every, int p_frames, float p_world_size) {
+
+	Stats stats;
+	stats.pair_events = 0;
+	stats.culled = 0;
+
+	TREE tree;
+	tree.set_pair_callback(_pair, &stats.pair_events);
+	tree.set_unpair_callback(_unpair, &stats.pair_events);
+
+	Body *bodies = p_bodies.ptrw();
+	int count = p_bodies.size();
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		bool pairable = (i % p_pairable_every) == 0;
+		bodies[i].id = tree.create(&bodies[i], bodies[i].aabb, 0, pairable, 1, pairable ? 1 : 0);
+	}
+	stats.create_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	CameraMatrix cm;
+	cm.set_perspective(70, 1.7, 0.1, p_world_size);
+	Vector<Body *> cull;
+	cull.resize(count);
+
+	stats.move_usec = 0;
+	stats.cull_usec = 0;
+
+	for (int f = 0; f < p_frames; f++) {
+
+		t = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+
+			Body &b = bodies[i];
+			if (b.velocity == Vector3())
+				continue; // static
+
+			b.aabb.position += b.velocity;
+			for (int j = 0; j < 3; j++) {
+				if (b.aabb.position[j] < -p_world_size || b.aabb.position[j] > p_world_size)
+					b.velocity[j] = -b.velocity[j];
+			}
+			tree.move(b.id, b.aabb);
+		}
+		stats.move_usec += OS::get_singleton()->get_ticks_usec() - t;
+
+		Transform cam;
+		cam.basis.rotate(Vector3(0, 1, 0), f * 0.05);
+		Vector<Plane> planes = cm.get_projection_planes(cam);
+
+		t = OS::get_singleton()->get_ticks_usec();
+		stats.culled += tree.cull_convex(planes, cull.ptrw(), count);
+		stats.cull_usec += OS::get_singleton()->get_ticks_usec() - t;
+	}
+
+	stats.pairs = tree.get_pair_count();
+
+	return stats;
+}
+
+static void _compare(const String &p_name, int p_count, float p_moving, int p_pairable_every, int p_frames) {
+
+	const float world_size = Math::pow(p_count, 1.0 / 3.0) * 4.0;
+
+	Math::seed(0);
+
+	Vector<Body> bodies;
+	bodies.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+
+		Body &b = bodies.write[i];
+		float size = Math::random(0.5, 3.0);
+		b.aabb = AABB(Vector3(Math::random(-world_size, world_size), Math::random(-world_size, world_size), Math::random(-world_size, world_size)), Vector3(size, size, size));
+		if (Math::randf() < p_moving) {
+			b.velocity = Vector3(Math::random(-0.2, 0.2), Math::random(-0.2, 0.2), Math::random(-0.2, 0.2));
+		}
+	}
+
+	Stats octree = _run<Octree<Body, true> >(bodies, p_pairable_every, p_frames, world_size);
+	Stats bvh = _run<BVH<Body, true> >(bodies, p_pairable_every, p_frames, world_size);
+
+	OS::get_singleton()->print("%s: %d objects, %d%% moving, %d frames\n", p_name.utf8().get_data(), p_count, int(p_moving * 100), p_frames);
+	OS::get_singleton()->print("\toctree: create %.2f ms, move+pair %.2f ms/frame, cull %.3f ms/frame\n", octree.create_usec / 1000.0, octree.move_usec / 1000.0 / p_frames, octree.cull_usec / 1000.0 / p_frames);
+	OS::get_singleton()->print("\tbvh:    create %.2f ms, move+pair %.2f ms/frame, cull %.3f ms/frame\n", bvh.create_usec / 1000.0, bvh.move_usec / 1000.0 / p_frames, bvh.cull_usec / 1000.0 / p_frames);
+
+	CHECK(octree.pairs == bvh.pairs);
+	CHECK(octree.pair_events == bvh.pair_events);
+	CHECK(octree.culled == bvh.culled);
+}
+
+MainLoop *test() {
+
+	_compare("static", 10000, 0.0, 8, 60);
+	_compare("few moving", 10000, 0.1, 8, 60);
+	_compare("all moving", 10000, 1.0, 8, 60);
+	_compare("all moving, all pairable", 5000, 1.0, 1, 60);
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestBVH
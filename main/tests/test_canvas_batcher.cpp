@@ -0,0 +1,330 @@
+/*************************************************************************/
+/*  test_canvas_batcher.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_canvas_batcher.h"
+#include "test_check.h"
+
+#include "core/os/os.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/visual/rasterizer_canvas_batcher.h"
+
+namespace TestCanvasBatcher {
+
+typedef RasterizerCanvas::Item Item;
+
+class Batcher : public RasterizerCanvasBatcher {
+protected:
+	virtual bool _get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags) {
+
+		if (!storage->texture_owner.owns(p_texture))
+			return false;
+
+		r_size = Size2(storage->texture_get_width(p_texture), storage->texture_get_height(p_texture));
+		r_flags = storage->texture_get_flags(p_texture);
+		return true;
+	}
+
+public:
+	RasterizerStorageDummy *storage;
+};
+
+static Item::CommandRect *_add_rect(Item *p_item, const Rect2 &p_rect, const RID &p_texture, uint8_t p_flags = 0) {
+
+	Item::CommandRect *rect = memnew(Item::CommandRect);
+	rect->rect = p_rect;
+	rect->texture = p_texture;
+	rect->modulate = Color(1, 1, 1, 1);
+	rect->flags = p_flags;
+	p_item->commands.push_back(rect);
+	return rect;
+}
+
+static Item *_make_list(Vector<Item *> &r_items, int p_count) {
+
+	for (int i = 0; i < p_count; i++) {
+		r_items.push_back(memnew(Item));
+		if (i > 0) {
+			r_items[i - 1]->next = r_items[i];
+		}
+	}
+
+	return r_items[0];
+}
+
+static void _free_list(Vector<Item *> &r_items) {
+
+	for (int i = 0; i < r_items.size(); i++) {
+		memdelete(r_items[i]);
+	}
+	r_items.clear();
+}
+
+static int _count_batches(const Batcher &p_batcher, RasterizerCanvasBatcher::Batch::Type p_type) {
+
+	int count = 0;
+	for (int i = 0; i < p_batcher.get_batch_count(); i++) {
+		if (p_batcher.get_batches()[i].type == p_type) {
+			count++;
+		}
+	}
+	return count;
+}
+
+static void _test_transform_and_uvs(Batcher &batcher, const RID &p_texture) {
+
+	OS::get_singleton()->print("transform and uvs\n");
+
+	Vector<Item *> items;
+	Item *list = _make_list(items, 2);
+
+	items[0]->final_transform = Transform2D(0, Vector2(100, 50));
+	items[0]->final_modulate = Color(1, 1, 1, 0.5);
+	_add_rect(items[0], Rect2(0, 0, 32, 16), p_texture);
+
+	// flipped region, drawn by the second item with a scaled transform
+	items[1]->final_transform = Transform2D().scaled(Vector2(2, 2));
+	Item::CommandRect *rect = _add_rect(items[1], Rect2(10, 10, 16, 16), p_texture, RasterizerCanvas::CANVAS_RECT_REGION | RasterizerCanvas::CANVAS_RECT_FLIP_H);
+	rect->source = Rect2(16, 0, 16, 16);
+
+	batcher.set_reorder_lookahead(0);
+	Item *next = batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+
+	CHECK(next == NULL);
+	CHECK(batcher.get_item_count() == 2);
+	CHECK(batcher.get_vertex_count() == 8);
+	CHECK(batcher.get_batch_count() == 1);
+	CHECK(_count_batches(batcher, RasterizerCanvasBatcher::Batch::TYPE_TRIANGLES) == 1);
+
+	const RasterizerCanvasBatcher::Vertex *v = batcher.get_vertices();
+
+	CHECK(v[0].pos == Vector2(100, 50));
+	CHECK(v[2].pos == Vector2(132, 66));
+	CHECK(v[2].uv == Vector2(1, 1));
+	CHECK(v[0].color == Color(1, 1, 1, 0.5));
+
+	// flip_h mirrors the geometry, so the top left corner samples the right edge of the region
+	CHECK(v[5].pos == Vector2(20, 20));
+	CHECK(v[5].uv == Vector2(0.5, 0));
+	CHECK(v[4].pos == Vector2(52, 20));
+
+	_free_list(items);
+}
+
+static void _test_barriers(Batcher &batcher, const RID &p_texture, const RID &p_material) {
+
+	OS::get_singleton()->print("barriers\n");
+
+	Vector<Item *> items;
+	Item *list = _make_list(items, 4);
+
+	_add_rect(items[0], Rect2(0, 0, 8, 8), p_texture);
+
+	Item::CommandLine *line = memnew(Item::CommandLine);
+	line->from = Vector2();
+	line->to = Vector2(8, 8);
+	line->width = 1;
+	line->antialiased = false;
+	items[0]->commands.push_back(line);
+
+	_add_rect(items[0], Rect2(8, 0, 8, 8), p_texture);
+
+	_add_rect(items[1], Rect2(16, 0, 8, 8), p_texture);
+
+	// items with a material or another clip can't join the run
+	items[2]->material = p_material;
+	_add_rect(items[2], Rect2(24, 0, 8, 8), p_texture);
+
+	CHECK(!batcher.can_join(items[2], NULL, 0));
+
+	Item *next = batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+
+	CHECK(next == items[2]);
+	CHECK(batcher.get_item_count() == 2);
+	CHECK(batcher.get_batch_count() == 3);
+
+	if (batcher.get_batch_count() == 3) {
+		const RasterizerCanvasBatcher::Batch *b = batcher.get_batches();
+		CHECK(b[0].type == RasterizerCanvasBatcher::Batch::TYPE_TRIANGLES && b[0].index_count == 6);
+		CHECK(b[1].type == RasterizerCanvasBatcher::Batch::TYPE_COMMANDS && b[1].item == items[0] && b[1].first_command == 1 && b[1].command_count == 1);
+		CHECK(b[2].type == RasterizerCanvasBatcher::Batch::TYPE_TRIANGLES && b[2].index_count == 12);
+	}
+
+	// a light over the item keeps it on the per item path
+	RasterizerCanvas::Light light;
+	light.item_mask = 1;
+	light.z_min = -10;
+	light.z_max = 10;
+	light.rect_cache = Rect2(-100, -100, 200, 200);
+	items[3]->global_rect_cache = Rect2(0, 0, 8, 8);
+
+	CHECK(!batcher.can_join(items[3], &light, 0));
+	items[3]->light_mask = 2;
+	CHECK(batcher.can_join(items[3], &light, 0));
+
+	_free_list(items);
+}
+
+static void _test_reordering(Batcher &batcher, const RID &p_texture_a, const RID &p_texture_b) {
+
+	OS::get_singleton()->print("reordering\n");
+
+	Vector<Item *> items;
+	Item *list = _make_list(items, 1);
+
+	// a row of tiles alternating between two textures, nothing overlaps
+	for (int i = 0; i < 64; i++) {
+		_add_rect(items[0], Rect2(i * 16, 0, 16, 16), (i & 1) ? p_texture_b : p_texture_a);
+	}
+
+	batcher.set_reorder_lookahead(0);
+	batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+	int unordered = batcher.get_batch_count();
+
+	batcher.set_reorder_lookahead(64);
+	batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+	int ordered = batcher.get_batch_count();
+
+	OS::get_singleton()->print("\t64 alternating tiles: %d batches in order, %d reordered\n", unordered, ordered);
+	CHECK(unordered == 64);
+	CHECK(ordered == 2);
+	CHECK(batcher.get_index_count() == 64 * 6);
+
+	// the second texture_a rect overlaps the texture_b one and has to stay behind it,
+	// the last one is clear of both and joins the first
+	_free_list(items);
+	list = _make_list(items, 1);
+
+	_add_rect(items[0], Rect2(0, 0, 16, 16), p_texture_a);
+	_add_rect(items[0], Rect2(8, 8, 16, 16), p_texture_b);
+	_add_rect(items[0], Rect2(16, 16, 16, 16), p_texture_a);
+	_add_rect(items[0], Rect2(100, 100, 16, 16), p_texture_a);
+
+	batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+
+	CHECK(batcher.get_batch_count() == 3);
+	if (batcher.get_batch_count() == 3) {
+		const RasterizerCanvasBatcher::Batch *b = batcher.get_batches();
+		CHECK(b[0].texture == p_texture_a && b[0].index_count == 12);
+		CHECK(b[1].texture == p_texture_b && b[1].index_count == 6);
+		CHECK(b[2].texture == p_texture_a && b[2].index_count == 6);
+	}
+
+	_free_list(items);
+}
+
+static void _test_capacity(Batcher &batcher, const RID &p_texture) {
+
+	OS::get_singleton()->print("capacity\n");
+
+	Vector<Item *> items;
+	Item *list = _make_list(items, 6);
+
+	for (int i = 0; i < items.size(); i++) {
+		_add_rect(items[i], Rect2(i * 8, 0, 8, 8), p_texture);
+		_add_rect(items[i], Rect2(i * 8, 8, 8, 8), p_texture);
+	}
+
+	batcher.set_max_vertices(16);
+	Item *next = batcher.build(list, NULL, 0, Color(1, 1, 1, 1));
+
+	CHECK(next == items[2]);
+	CHECK(batcher.get_vertex_count() == 16);
+
+	next = batcher.build(next, NULL, 0, Color(1, 1, 1, 1));
+	CHECK(next == items[4]);
+
+	batcher.set_max_vertices(RasterizerCanvasBatcher::DEFAULT_MAX_VERTICES);
+
+	_free_list(items);
+}
+
+static void _benchmark(Batcher &batcher, const RID &p_texture_a, const RID &p_texture_b) {
+
+	Vector<Item *> items;
+	Item *list = _make_list(items, 256);
+
+	for (int i = 0; i < items.size(); i++) {
+		items[i]->final_transform = Transform2D(0, Vector2((i % 16) * 256, (i / 16) * 256));
+		for (int j = 0; j < 256; j++) {
+			_add_rect(items[i], Rect2((j % 16) * 16, (j / 16) * 16, 16, 16), (j % 3) ? p_texture_a : p_texture_b, RasterizerCanvas::CANVAS_RECT_REGION);
+		}
+	}
+
+	for (int lookahead = 0; lookahead <= 8; lookahead += 4) {
+
+		batcher.set_reorder_lookahead(lookahead);
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		int batches = 0;
+		int runs = 0;
+
+		for (Item *ci = list; ci;) {
+			ci = batcher.build(ci, NULL, 0, Color(1, 1, 1, 1));
+			batches += batcher.get_batch_count();
+			runs++;
+		}
+
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		OS::get_singleton()->print("\t%d rects, lookahead %d: %d draw calls in %d runs, built in %.2f ms\n", items.size() * 256, lookahead, batches, runs, t / 1000.0);
+	}
+
+	_free_list(items);
+}
+
+MainLoop *test() {
+
+	RasterizerStorageDummy storage;
+
+	Batcher batcher;
+	batcher.storage = &storage;
+
+	RID texture_a = storage.texture_create();
+	storage.texture_allocate(texture_a, 64, 32, 0, Image::FORMAT_RGBA8);
+	RID texture_b = storage.texture_create();
+	storage.texture_allocate(texture_b, 32, 32, 0, Image::FORMAT_RGBA8);
+
+	_test_transform_and_uvs(batcher, texture_a);
+	// the batcher only checks whether a material is set, any valid RID will do
+	RID material = storage.texture_create();
+
+	_test_barriers(batcher, texture_a, material);
+	_test_reordering(batcher, texture_a, texture_b);
+	_test_capacity(batcher, texture_a);
+	_benchmark(batcher, texture_a, texture_b);
+
+	storage.free(texture_a);
+	storage.free(texture_b);
+	storage.free(material);
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestCanvasBatcher
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "test_gdscript.h"
+#include "test_check.h"
 
 #include "core/os/file_access.h"
 #include "core/os/main_loop.h"
@@ -577,6 +578,20 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += DADDR(3);
 					incr += 5;
 
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+
+					txt += "op-validated ";
+
+					String opname = Variant::get_operator_name(func.get_validated_operator(code[ip + 1]));
+
+					txt += DADDR(4);
+					txt += " = ";
+					txt += DADDR(2);
+					txt += " " + opname + " ";
+					txt += DADDR(3);
+					incr += 5;
+
 				} break;
 				case GDScriptFunction::OPCODE_SET: {
 
@@ -615,12 +630,24 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 				case GDScriptFunction::OPCODE_GET_NAMED: {
 
 					txt += " get_named ";
-					txt += DADDR(3);
+					txt += DADDR(4);
 					txt += "=";
 					txt += DADDR(1);
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]";
+					incr += 5;
+
+				} break;
+				case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+
+					txt += " get_named-validated ";
+					txt += DADDR(3);
+					txt += "=";
+					txt += DADDR(1);
+					txt += "[\"";
+					txt += func.get_validated_getter_name(code[ip + 2]);
+					txt += "\"]";
 					incr += 4;
 
 				} break;
@@ -731,32 +758,35 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 				} break;
 
 				case GDScriptFunction::OPCODE_CALL:
-				case GDScriptFunction::OPCODE_CALL_RETURN: {
+				case GDScriptFunction::OPCODE_CALL_RETURN:
+				case GDScriptFunction::OPCODE_CALL_INTERNAL:
+				case GDScriptFunction::OPCODE_CALL_INTERNAL_RETURN: {
 
-					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
+					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN || code[ip] == GDScriptFunction::OPCODE_CALL_INTERNAL_RETURN;
+					bool internal = code[ip] == GDScriptFunction::OPCODE_CALL_INTERNAL || code[ip] == GDScriptFunction::OPCODE_CALL_INTERNAL_RETURN;
 
 					if (ret)
-						txt += " call-ret ";
+						txt += internal ? " call-internal-ret " : " call-ret ";
 					else
-						txt += " call ";
+						txt += internal ? " call-internal " : " call ";
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
-					txt += String(func.get_global_name(code[ip + 3]));
+					txt += String(internal ? func.get_internal_method_name(code[ip + 3]) : func.get_global_name(code[ip + 3]));
 					txt += "(";
 
 					for (int i = 0; i < argc; i++) {
 						if (i > 0)
 							txt += ", ";
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -906,8 +936,43 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+// Calls made through the per call site caches must end up where Object::call() would.
+static void _test_call_cache() {
+
+	// reload() is also a native method of Script, calling it on the script must run its static function
+	String code;
+	code += "extends Reference\n";
+	code += "static func reload():\n";
+	code += "\treturn \"static\"\n";
+	code += "static func call_reload(p_script):\n";
+	code += "\treturn p_script.reload()\n";
+
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(code);
+	CHECK(script->reload() == OK);
+
+	Variant arg = script;
+	const Variant *args[1] = { &arg };
+
+	// the first call resolves the call site, the next ones go through its cache
+	for (int i = 0; i < 3; i++) {
+		Variant::CallError ce;
+		Variant ret = static_cast<Object *>(script.ptr())->call("call_reload", args, 1, ce);
+		CHECK(ce.error == Variant::CallError::CALL_OK);
+		CHECK(ret == Variant("static"));
+	}
+
+	CHECK_RESULT();
+}
+
 MainLoop *test(TestType p_type) {
 
+	if (p_type == TEST_CALL_CACHE) {
+		_test_call_cache();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -34,10 +34,15 @@
 #ifdef DEBUG_ENABLED
 
 #include "test_astar.h"
+#include "test_audio_mix.h"
+#include "test_bvh.h"
+#include "test_canvas_batcher.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
 #include "test_image.h"
 #include "test_math.h"
+#include "test_navigation.h"
+#include "test_multiplayer.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics.h"
@@ -45,6 +50,7 @@
 #include "test_render.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_websocket.h"
 
 const char **tests_get_names() {
 
@@ -61,9 +67,16 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_call_cache",
 		"image",
 		"ordered_hash_map",
 		"astar",
+		"bvh",
+		"audio_mix",
+		"canvas_batcher",
+		"multiplayer",
+		"websocket",
+		"navigation",
 		NULL
 	};
 
@@ -134,6 +147,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_call_cache") {
+
+		return TestGDScript::test(TestGDScript::TEST_CALL_CACHE);
+	}
+
 	if (p_test == "image") {
 
 		return TestImage::test();
@@ -149,6 +167,36 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "bvh") {
+
+		return TestBVH::test();
+	}
+
+	if (p_test == "audio_mix") {
+
+		return TestAudioMix::test();
+	}
+
+	if (p_test == "canvas_batcher") {
+
+		return TestCanvasBatcher::test();
+	}
+
+	if (p_test == "multiplayer") {
+
+		return TestMultiplayer::test();
+	}
+
+	if (p_test == "websocket") {
+
+		return TestWebSocket::test();
+	}
+
+	if (p_test == "navigation") {
+
+		return TestNavigation::test();
+	}
+
 	return NULL;
 }
 
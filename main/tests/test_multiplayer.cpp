@@ -0,0 +1,466 @@
+/*************************************************************************/
+/*  test_multiplayer.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_multiplayer.h"
+#include "test_check.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/multiplayer_api.h"
+#include "core/os/os.h"
+#include "scene/main/node.h"
+
+namespace TestMultiplayer {
+
+// Connects peers in the same process. Unreliable packets can be dropped to exercise the acks.
+class LoopbackPeer : public NetworkedMultiplayerPeer {
+
+	GDCLASS(LoopbackPeer, NetworkedMultiplayerPeer);
+
+	struct Packet {
+		int from;
+		Vector<uint8_t> data;
+	};
+
+	List<Packet> incoming;
+	Vector<uint8_t> current;
+	int target;
+	TransferMode transfer_mode;
+	int unreliable_sent;
+
+public:
+	int id;
+	int drop_every;
+	Map<int, LoopbackPeer *> links;
+
+	virtual void set_transfer_mode(TransferMode p_mode) { transfer_mode = p_mode; }
+	virtual TransferMode get_transfer_mode() const { return transfer_mode; }
+	virtual void set_target_peer(int p_peer_id) { target = p_peer_id; }
+
+	virtual int get_packet_peer() const { return incoming.front()->get().from; }
+
+	virtual bool is_server() const { return id == 1; }
+	virtual void poll() {}
+	virtual int get_unique_id() const { return id; }
+
+	virtual void set_refuse_new_connections(bool p_enable) {}
+	virtual bool is_refusing_new_connections() const { return false; }
+	virtual ConnectionStatus get_connection_status() const { return CONNECTION_CONNECTED; }
+
+	virtual int get_available_packet_count() const { return incoming.size(); }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
+
+		ERR_FAIL_COND_V(incoming.empty(), ERR_UNAVAILABLE);
+
+		current = incoming.front()->get().data;
+		incoming.pop_front();
+
+		*r_buffer = current.ptr();
+		r_buffer_size = current.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+
+		for (Map<int, LoopbackPeer *>::Element *E = links.front(); E; E = E->next()) {
+
+			if (target > 0 && E->key() != target)
+				continue;
+			if (target < 0 && E->key() == -target)
+				continue;
+			if (transfer_mode != TRANSFER_MODE_RELIABLE && drop_every && (++unreliable_sent % drop_every) == 0)
+				continue;
+
+			Packet packet;
+			packet.from = id;
+			packet.data.resize(p_buffer_size);
+			copymem(packet.data.ptrw(), p_buffer, p_buffer_size);
+			E->get()->incoming.push_back(packet);
+		}
+
+		return OK;
+	}
+
+	virtual int get_max_packet_size() const { return 1 << 24; }
+
+	LoopbackPeer() {
+
+		target = 0;
+		transfer_mode = TRANSFER_MODE_RELIABLE;
+		unreliable_sent = 0;
+		id = 0;
+		drop_every = 0;
+	}
+};
+
+class TestEntity : public Node {
+
+	GDCLASS(TestEntity, Node);
+
+protected:
+	bool _set(const StringName &p_name, const Variant &p_value) {
+
+		if (p_name == "position") {
+			position = p_value;
+		} else if (p_name == "rotation") {
+			rotation = p_value;
+		} else if (p_name == "health") {
+			health = p_value;
+		} else if (p_name == "label") {
+			label = p_value;
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	bool _get(const StringName &p_name, Variant &r_ret) const {
+
+		if (p_name == "position") {
+			r_ret = position;
+		} else if (p_name == "rotation") {
+			r_ret = rotation;
+		} else if (p_name == "health") {
+			r_ret = health;
+		} else if (p_name == "label") {
+			r_ret = label;
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+public:
+	Vector3 position;
+	Quat rotation;
+	int health;
+	String label;
+
+	TestEntity() {
+		health = 100;
+	}
+};
+
+static Node *_make_scene(int p_entities) {
+
+	Node *root = memnew(Node);
+	root->set_name("root");
+
+	for (int i = 0; i < p_entities; i++) {
+		TestEntity *entity = memnew(TestEntity);
+		entity->set_name("Entity" + itos(i));
+		root->add_child(entity);
+	}
+
+	return root;
+}
+
+static void _test_snapshots(int p_entities, int p_clients, int p_ticks) {
+
+	OS::get_singleton()->print("\n*** Snapshot replication: %i entities, %i clients, %i ticks\n", p_entities, p_clients, p_ticks);
+
+	Node *server_scene = _make_scene(p_entities);
+	Ref<MultiplayerAPI> server;
+	server.instance();
+	server->set_root_node(server_scene);
+
+	Ref<LoopbackPeer> server_peer;
+	server_peer.instance();
+	server_peer->id = 1;
+	server_peer->drop_every = 7;
+	server->set_network_peer(server_peer);
+
+	Vector<Node *> client_scenes;
+	Vector<Ref<MultiplayerAPI> > clients;
+	Vector<Ref<LoopbackPeer> > client_peers;
+
+	for (int i = 0; i < p_clients; i++) {
+
+		int id = i + 2;
+
+		Ref<LoopbackPeer> peer;
+		peer.instance();
+		peer->id = id;
+		peer->drop_every = 5;
+		peer->links[1] = server_peer.ptr();
+		server_peer->links[id] = peer.ptr();
+
+		// replicated properties must be allowed on the client, entity 5 keeps its label local
+		Node *scene = _make_scene(p_entities);
+		for (int j = 0; j < p_entities; j++) {
+			Node *entity = scene->get_child(j);
+			entity->rset_config("position", MultiplayerAPI::RPC_MODE_REMOTE);
+			entity->rset_config("rotation", MultiplayerAPI::RPC_MODE_REMOTE);
+			entity->rset_config("health", MultiplayerAPI::RPC_MODE_REMOTE);
+			if (j != 5) {
+				entity->rset_config("label", MultiplayerAPI::RPC_MODE_REMOTE);
+			}
+		}
+
+		Ref<MultiplayerAPI> client;
+		client.instance();
+		client->set_root_node(scene);
+		client->set_network_peer(peer);
+
+		peer->emit_signal("peer_connected", 1);
+		server_peer->emit_signal("peer_connected", id);
+
+		client_scenes.push_back(scene);
+		clients.push_back(client);
+		client_peers.push_back(peer);
+	}
+
+	MultiplayerReplicator *replicator = server->get_replicator();
+	replicator->set_tick_rate(0); // ticks are sent by hand
+
+	PoolStringArray properties;
+	properties.push_back("position");
+	properties.push_back("rotation");
+	properties.push_back("health");
+	properties.push_back("label");
+
+	// every tenth entity is only visible to the first client
+	for (int i = 0; i < p_entities; i++) {
+		replicator->add_node(server_scene->get_child(i), properties, i % 10 == 0 ? StringName("team") : StringName());
+	}
+
+	PoolStringArray groups;
+	groups.push_back("team");
+	replicator->set_peer_groups(2, groups);
+
+	// what sending each change with rset() would cost: header, path id, name and encoded value
+	uint64_t rset_bytes = 0;
+	uint64_t first_tick_bytes = 0;
+
+	for (int t = 0; t < p_ticks; t++) {
+
+		for (int i = 0; i < p_entities; i++) {
+
+			TestEntity *entity = Object::cast_to<TestEntity>(server_scene->get_child(i));
+			int len = 0;
+
+			if ((i + t) % 10 == 0) {
+				entity->position += Vector3(0.1, 0, 0.05 * (i % 3));
+				encode_variant(entity->position, NULL, len);
+				rset_bytes += 1 + 4 + 9 + len;
+			}
+
+			if ((i * 7 + t) % 50 == 0) {
+				entity->health -= 1;
+				entity->rotation = Quat(Vector3(0, 1, 0), t * 0.01);
+				encode_variant(entity->health, NULL, len);
+				rset_bytes += 1 + 4 + 7 + len;
+				encode_variant(entity->rotation, NULL, len);
+				rset_bytes += 1 + 4 + 9 + len;
+			}
+		}
+
+		if (t == p_ticks / 2) {
+			Object::cast_to<TestEntity>(server_scene->get_child(5))->label = "renamed";
+			replicator->remove_node(server_scene->get_child(7));
+		}
+
+		replicator->send_snapshot();
+		if (t == 0) {
+			first_tick_bytes = replicator->get_last_tick_sent_bytes();
+		}
+
+		for (int i = 0; i < p_clients; i++) {
+			clients.write[i]->poll();
+		}
+		server->poll();
+	}
+
+	uint64_t delta_bytes = replicator->get_sent_bytes() - first_tick_bytes;
+
+	OS::get_singleton()->print("\tfirst tick: %i bytes per client\n", int(first_tick_bytes / p_clients));
+	OS::get_singleton()->print("\tfollowing ticks: %i bytes per client and tick\n", int(delta_bytes / p_clients / (p_ticks - 1)));
+	OS::get_singleton()->print("\trset() estimate: %i bytes per client and tick\n", int(rset_bytes / p_ticks));
+
+	// a few lossless ticks so every client catches up
+	server_peer->drop_every = 0;
+	for (int i = 0; i < p_clients; i++) {
+		client_peers.write[i]->drop_every = 0;
+	}
+
+	for (int t = 0; t < 3; t++) {
+		replicator->send_snapshot();
+		for (int i = 0; i < p_clients; i++) {
+			clients.write[i]->poll();
+		}
+		server->poll();
+	}
+
+	for (int i = 0; i < p_clients; i++) {
+
+		CHECK(clients[i]->get_replicator()->get_last_received_tick() == replicator->get_tick());
+
+		int mismatches = 0;
+		int leaked = 0;
+
+		for (int j = 0; j < p_entities; j++) {
+
+			TestEntity *source = Object::cast_to<TestEntity>(server_scene->get_child(j));
+			TestEntity *replica = Object::cast_to<TestEntity>(client_scenes[i]->get_child(j));
+
+			if (j == 7)
+				continue; // no longer replicated
+
+			if (j % 10 == 0 && i != 0) {
+				if (replica->position != Vector3()) {
+					leaked++;
+				}
+				continue;
+			}
+
+			if (j == 5) {
+				CHECK(replica->label == String());
+			} else if (source->label != replica->label) {
+				mismatches++;
+			}
+
+			if (source->position != replica->position || source->rotation != replica->rotation || source->health != replica->health) {
+				mismatches++;
+			}
+		}
+
+		CHECK(mismatches == 0);
+		CHECK(leaked == 0);
+	}
+
+	for (int i = 0; i < p_clients; i++) {
+		clients.write[i]->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+		memdelete(client_scenes[i]);
+	}
+
+	server->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+	memdelete(server_scene);
+}
+
+static void _test_compact_encoding() {
+
+	OS::get_singleton()->print("\n*** Compact variant encoding\n");
+
+	Array array;
+	array.push_back(-3);
+	array.push_back("text");
+	array.push_back(Vector2(0.5, -2));
+
+	PoolVector<Vector3> points;
+	points.push_back(Vector3(1, 2, 3));
+	points.push_back(Vector3(-4, 0.25, 8));
+
+	PoolVector<int> ints;
+	ints.push_back(7);
+	ints.push_back(-70000);
+
+	Vector<Variant> values;
+	values.push_back(Variant());
+	values.push_back(true);
+	values.push_back(int64_t(-123456789012LL));
+	values.push_back(0.5);
+	values.push_back(0.1);
+	values.push_back("compact");
+	values.push_back(NodePath("Players/Player1"));
+	values.push_back(Vector3(1.5, -2, 1024));
+	values.push_back(Vector3(0, 0.6, -0.8));
+	values.push_back(Quat(Vector3(0, 1, 0), 0.7));
+	values.push_back(Transform(Basis(Vector3(1, 0, 0), 0.3), Vector3(10, 0, -5)));
+	values.push_back(Color(1, 0.5, 0.25));
+	values.push_back(array);
+	values.push_back(points);
+	values.push_back(ints);
+
+	int full_bytes = 0;
+	int compact_bytes = 0;
+	int quantized_bytes = 0;
+
+	for (int i = 0; i < values.size(); i++) {
+
+		for (int q = 0; q < 2; q++) {
+
+			int len;
+			CHECK(encode_variant_compact(values[i], NULL, len, q) == OK);
+
+			Vector<uint8_t> buffer;
+			buffer.resize(len);
+			encode_variant_compact(values[i], buffer.ptrw(), len, q);
+
+			Variant decoded;
+			int used = 0;
+			CHECK(decode_variant_compact(decoded, buffer.ptr(), buffer.size(), &used) == OK);
+			CHECK(used == len);
+			CHECK(decoded.get_type() == values[i].get_type());
+
+			if (q) {
+				quantized_bytes += len;
+				if (values[i].get_type() == Variant::QUAT) {
+					Quat a = values[i];
+					Quat b = decoded;
+					CHECK(Math::abs(a.dot(b)) > 0.999);
+				} else if (values[i].get_type() == Variant::COLOR) {
+					Color a = values[i];
+					Color b = decoded;
+					CHECK(Math::abs(a.r - b.r) + Math::abs(a.g - b.g) + Math::abs(a.b - b.b) + Math::abs(a.a - b.a) < 0.01);
+				} else if (values[i].get_type() == Variant::VECTOR3 && Vector3(values[i]).is_normalized()) {
+					CHECK(Vector3(values[i]).distance_to(decoded) < 0.01);
+					CHECK(len < 1 + 3 * 4); // sent as halves
+				} else if (values[i].get_type() != Variant::ARRAY) {
+					CHECK(decoded == values[i]); // positions and other floats keep full precision
+				}
+			} else {
+				compact_bytes += len;
+				if (values[i].get_type() != Variant::ARRAY) { // compared by reference
+					CHECK(decoded == values[i]);
+				}
+			}
+
+			// truncated buffers must fail cleanly
+			CHECK(decode_variant_compact(decoded, buffer.ptr(), len - 1, NULL) != OK);
+		}
+
+		int len;
+		encode_variant(values[i], NULL, len);
+		full_bytes += len;
+	}
+
+	OS::get_singleton()->print("\tencode_variant: %i bytes, compact: %i bytes, quantized: %i bytes\n", full_bytes, compact_bytes, quantized_bytes);
+}
+
+MainLoop *test() {
+
+	_test_compact_encoding();
+	_test_snapshots(2000, 8, 200);
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestMultiplayer
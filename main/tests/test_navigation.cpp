@@ -0,0 +1,439 @@
+/*************************************************************************/
+/*  test_navigation.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_navigation.h"
+#include "test_check.h"
+
+#include "core/os/os.h"
+#include "scene/2d/navigation2d.h"
+#include "scene/3d/navigation.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestNavigation {
+
+// Grids of square cells with some of them blocked. The same random queries go through the plain
+// search, the hierarchical one and the parallel batch, closest points are checked against a linear
+// search over the cells.
+
+struct Grid {
+
+	int size;
+	Vector<bool> open;
+	Vector<Vector2> cells; // origins of the open cells
+};
+
+static Grid _make_grid(int p_size, float p_blocked) {
+
+	Grid grid;
+	grid.size = p_size;
+	grid.open.resize(p_size * p_size);
+
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+
+			// Short walls rather than single cells, so paths have to go around things.
+			bool blocked = Math::randf() < p_blocked;
+			if (!blocked && x > 0 && y % 8 == 4 && x % 16 < 12) {
+				blocked = true;
+			}
+			grid.open.write[y * p_size + x] = !blocked;
+			if (!blocked) {
+				grid.cells.push_back(Vector2(x, y));
+			}
+		}
+	}
+
+	return grid;
+}
+
+template <class T>
+static bool _same(const Vector<T> &p_a, const Vector<T> &p_b) {
+
+	if (p_a.size() != p_b.size())
+		return false;
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i])
+			return false;
+	}
+	return true;
+}
+
+template <class T>
+static float _length(const Vector<T> &p_path) {
+
+	float length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+static Ref<NavigationMesh> _make_navmesh(const Grid &p_grid) {
+
+	PoolVector<Vector3> vertices;
+	for (int y = 0; y <= p_grid.size; y++) {
+		for (int x = 0; x <= p_grid.size; x++) {
+			vertices.push_back(Vector3(x, 0, y));
+		}
+	}
+
+	Ref<NavigationMesh> mesh;
+	mesh.instance();
+	mesh->set_vertices(vertices);
+	for (int i = 0; i < p_grid.cells.size(); i++) {
+
+		int x = p_grid.cells[i].x;
+		int y = p_grid.cells[i].y;
+		Vector<int> polygon;
+		polygon.push_back(y * (p_grid.size + 1) + x);
+		polygon.push_back(y * (p_grid.size + 1) + x + 1);
+		polygon.push_back((y + 1) * (p_grid.size + 1) + x + 1);
+		polygon.push_back((y + 1) * (p_grid.size + 1) + x);
+		mesh->add_polygon(polygon);
+	}
+
+	return mesh;
+}
+
+static Vector3 _random_point_3d(const Grid &p_grid) {
+
+	Vector2 cell = p_grid.cells[Math::rand() % p_grid.cells.size()];
+	return Vector3(cell.x + Math::randf(), 0, cell.y + Math::randf());
+}
+
+static void _test_3d(int p_size, float p_blocked, int p_queries) {
+
+	Grid grid = _make_grid(p_size, p_blocked);
+	OS::get_singleton()->print("\n*** Navigation: %i polygons, %i queries\n", grid.cells.size(), p_queries);
+
+	Navigation *nav = memnew(Navigation);
+	nav->navmesh_add(_make_navmesh(grid), Transform());
+
+	PoolVector<Vector3> starts;
+	PoolVector<Vector3> ends;
+	for (int i = 0; i < p_queries; i++) {
+		starts.push_back(_random_point_3d(grid));
+		ends.push_back(_random_point_3d(grid));
+	}
+
+	// Closest points, against a linear search.
+	int mismatches = 0;
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_queries; i++) {
+
+		Vector3 point(Math::random(-10, p_size + 10), Math::random(-2, 2), Math::random(-10, p_size + 10));
+		Vector3 closest = nav->get_closest_point(point);
+
+		float best = 1e20;
+		for (int j = 0; j < grid.cells.size(); j++) {
+			Vector3 o(grid.cells[j].x, 0, grid.cells[j].y);
+			Face3 a(o, o + Vector3(1, 0, 0), o + Vector3(1, 0, 1));
+			Face3 b(o, o + Vector3(1, 0, 1), o + Vector3(0, 0, 1));
+			best = MIN(best, MIN(a.get_closest_point_to(point).distance_to(point), b.get_closest_point_to(point).distance_to(point)));
+		}
+		if (Math::abs(closest.distance_to(point) - best) > 0.01) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+	OS::get_singleton()->print("\tclosest point, including the linear check: %.1f us per query, %i mismatches\n", (OS::get_singleton()->get_ticks_usec() - t) / (double)p_queries, mismatches);
+
+	Vector<Vector<Vector3> > flat;
+	Vector<Vector<Vector3> > hierarchical;
+	flat.resize(p_queries);
+	hierarchical.resize(p_queries);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_queries; i++) {
+		flat.write[i] = nav->get_simple_path(starts[i], ends[i]);
+	}
+	uint64_t flat_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	nav->set_hierarchical_pathfinding(true);
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_queries; i++) {
+		hierarchical.write[i] = nav->get_simple_path(starts[i], ends[i]);
+	}
+	uint64_t hierarchical_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Array batch = nav->get_simple_paths(starts, ends);
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - t;
+	nav->set_hierarchical_pathfinding(false);
+
+	int found = 0;
+	float flat_length = 0;
+	float hierarchical_length = 0;
+	for (int i = 0; i < p_queries; i++) {
+
+		// Clusters keep the connectivity of the polygons.
+		CHECK(flat[i].empty() == hierarchical[i].empty());
+		CHECK(_same<Vector3>(batch[i], hierarchical[i]));
+
+		if (flat[i].empty() || hierarchical[i].empty())
+			continue;
+
+		found++;
+		CHECK(flat[i][0].distance_to(starts[i]) < 0.02 && flat[i][flat[i].size() - 1].distance_to(ends[i]) < 0.02);
+		flat_length += _length(flat[i]);
+		hierarchical_length += _length(hierarchical[i]);
+	}
+
+	OS::get_singleton()->print("\t%i paths found\n", found);
+	OS::get_singleton()->print("\tplain search:        %.1f us per path\n", flat_usec / (double)p_queries);
+	OS::get_singleton()->print("\thierarchical search: %.1f us per path, paths %.1f%% longer\n", hierarchical_usec / (double)p_queries, (hierarchical_length / MAX(flat_length, 1) - 1) * 100);
+	OS::get_singleton()->print("\tparallel batch:      %.1f us per path\n", batch_usec / (double)p_queries);
+
+	memdelete(nav);
+}
+
+static void _test_2d(int p_size, float p_blocked, int p_queries) {
+
+	const float cell = 32;
+
+	Grid grid = _make_grid(p_size, p_blocked);
+	OS::get_singleton()->print("\n*** Navigation2D: %i polygons, %i queries\n", grid.cells.size(), p_queries);
+
+	PoolVector<Vector2> vertices;
+	for (int y = 0; y <= p_size; y++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector2(x, y) * cell);
+		}
+	}
+
+	Ref<NavigationPolygon> navpoly;
+	navpoly.instance();
+	navpoly->set_vertices(vertices);
+	for (int i = 0; i < grid.cells.size(); i++) {
+
+		int x = grid.cells[i].x;
+		int y = grid.cells[i].y;
+		Vector<int> polygon;
+		polygon.push_back(y * (p_size + 1) + x);
+		polygon.push_back(y * (p_size + 1) + x + 1);
+		polygon.push_back((y + 1) * (p_size + 1) + x + 1);
+		polygon.push_back((y + 1) * (p_size + 1) + x);
+		navpoly->add_polygon(polygon);
+	}
+
+	Navigation2D *nav = memnew(Navigation2D);
+	nav->navpoly_add(navpoly, Transform2D());
+
+	PoolVector<Vector2> starts;
+	PoolVector<Vector2> ends;
+	for (int i = 0; i < p_queries; i++) {
+		// Some points off the mesh, so they are moved to the closest edge.
+		starts.push_back((grid.cells[Math::rand() % grid.cells.size()] + Vector2(Math::randf(), Math::randf())) * cell);
+		ends.push_back(Vector2(Math::random(-2, p_size + 2), Math::random(-2, p_size + 2)) * cell);
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < p_queries; i++) {
+
+		Vector2 point = ends[i];
+		Vector2 closest = nav->get_closest_point(point);
+
+		float best = 1e20;
+		for (int j = 0; j < grid.cells.size(); j++) {
+			Rect2 r(grid.cells[j] * cell, Vector2(cell, cell));
+			Vector2 p(CLAMP(point.x, r.position.x, r.position.x + cell), CLAMP(point.y, r.position.y, r.position.y + cell));
+			best = MIN(best, p.distance_to(point));
+		}
+		if (Math::abs(closest.distance_to(point) - best) > 0.5) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+	OS::get_singleton()->print("\tclosest point: %i mismatches\n", mismatches);
+
+	Vector<Vector<Vector2> > flat;
+	Vector<Vector<Vector2> > hierarchical;
+	flat.resize(p_queries);
+	hierarchical.resize(p_queries);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_queries; i++) {
+		flat.write[i] = nav->get_simple_path(starts[i], ends[i]);
+	}
+	uint64_t flat_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	nav->set_hierarchical_pathfinding(true);
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_queries; i++) {
+		hierarchical.write[i] = nav->get_simple_path(starts[i], ends[i]);
+	}
+	uint64_t hierarchical_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Array batch = nav->get_simple_paths(starts, ends);
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - t;
+	nav->set_hierarchical_pathfinding(false);
+
+	int found = 0;
+	float flat_length = 0;
+	float hierarchical_length = 0;
+	for (int i = 0; i < p_queries; i++) {
+
+		CHECK(flat[i].empty() == hierarchical[i].empty());
+		CHECK(_same<Vector2>(batch[i], hierarchical[i]));
+
+		if (flat[i].empty() || hierarchical[i].empty())
+			continue;
+
+		found++;
+		flat_length += _length(flat[i]);
+		hierarchical_length += _length(hierarchical[i]);
+	}
+
+	OS::get_singleton()->print("\t%i paths found\n", found);
+	OS::get_singleton()->print("\tplain search:        %.1f us per path\n", flat_usec / (double)p_queries);
+	OS::get_singleton()->print("\thierarchical search: %.1f us per path, paths %.1f%% longer\n", hierarchical_usec / (double)p_queries, (hierarchical_length / MAX(flat_length, 1) - 1) * 100);
+	OS::get_singleton()->print("\tparallel batch:      %.1f us per path\n", batch_usec / (double)p_queries);
+
+	memdelete(nav);
+}
+
+// Path requests, answered while the Navigation node is processed.
+
+class PathReceiver : public Object {
+
+	GDCLASS(PathReceiver, Object);
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_path_found"), &PathReceiver::_path_found);
+	}
+
+public:
+	Vector<int> ids;
+	Vector<Vector<Vector3> > paths;
+
+	void _path_found(int p_id, const Vector<Vector3> &p_path) {
+
+		ids.push_back(p_id);
+		paths.push_back(p_path);
+	}
+};
+
+static void _test_requests() {
+
+	const float frame = 1.0 / 60;
+
+	OS::get_singleton()->print("\n*** Navigation path requests\n");
+
+	// Without blocked cells every point can be reached.
+	Grid grid = _make_grid(32, 0);
+
+	SceneTree *tree = memnew(SceneTree);
+	tree->init();
+
+	Navigation *nav = memnew(Navigation);
+	int mesh_id = nav->navmesh_add(_make_navmesh(grid), Transform());
+	tree->get_root()->add_child(nav);
+
+	PathReceiver *receiver = memnew(PathReceiver);
+
+	Vector3 starts[5];
+	Vector3 ends[5];
+	Vector<Vector3> expected[5];
+	for (int i = 0; i < 5; i++) {
+		starts[i] = _random_point_3d(grid);
+		ends[i] = _random_point_3d(grid);
+		expected[i] = nav->get_simple_path(starts[i], ends[i]);
+		CHECK(expected[i].size() >= 2);
+	}
+
+	// The requests of a frame are searched once the message queue is flushed and delivered
+	// when the node is processed. One is canceled while queued, one while searched.
+	int a = nav->request_simple_path(starts[0], ends[0], receiver, "_path_found");
+	int b = nav->request_simple_path(starts[1], ends[1], receiver, "_path_found");
+	int c = nav->request_simple_path(starts[2], ends[2], receiver, "_path_found");
+	CHECK(a != b && b != c && a != c);
+	nav->cancel_path_request(b);
+	tree->iteration(frame);
+	nav->cancel_path_request(c);
+	CHECK(receiver->ids.empty());
+	tree->idle(frame);
+	CHECK(receiver->ids.size() == 1 && receiver->ids[0] == a);
+	CHECK(receiver->paths.size() == 1 && _same(receiver->paths[0], expected[0]));
+
+	// Changing the navmesh waits for the running search, which still uses the old one.
+	int d = nav->request_simple_path(starts[3], ends[3], receiver, "_path_found");
+	tree->iteration(frame);
+	Transform moved(Basis(), Vector3(0, 1, 0));
+	nav->navmesh_set_transform(mesh_id, moved);
+	tree->idle(frame);
+	CHECK(receiver->ids.size() == 2 && receiver->ids[1] == d);
+	CHECK(receiver->paths.size() == 2 && _same(receiver->paths[1], expected[3]));
+
+	// So does leaving the tree, the result is delivered once the node is processed again.
+	Vector<Vector3> moved_path = nav->get_simple_path(moved.xform(starts[4]), moved.xform(ends[4]));
+	CHECK(moved_path.size() >= 2);
+	int e = nav->request_simple_path(moved.xform(starts[4]), moved.xform(ends[4]), receiver, "_path_found");
+	tree->iteration(frame);
+	tree->get_root()->remove_child(nav);
+	tree->idle(frame);
+	CHECK(receiver->ids.size() == 2);
+	tree->get_root()->add_child(nav);
+	tree->iteration(frame);
+	tree->idle(frame);
+	CHECK(receiver->ids.size() == 3 && receiver->ids[2] == e);
+	CHECK(receiver->paths.size() == 3 && _same(receiver->paths[2], moved_path));
+
+	// Nothing else is pending.
+	for (int i = 0; i < 3; i++) {
+		tree->iteration(frame);
+		tree->idle(frame);
+	}
+	CHECK(receiver->ids.size() == 3);
+	CHECK(!nav->is_processing_internal());
+
+	OS::get_singleton()->print("\t%i callbacks\n", receiver->ids.size());
+
+	// Frees the navigation with the root.
+	tree->finish();
+	memdelete(tree);
+	memdelete(receiver);
+}
+
+MainLoop *test() {
+
+	_test_3d(64, 0.1, 200);
+	_test_3d(200, 0.15, 500);
+	_test_2d(150, 0.15, 500);
+	_test_requests();
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestNavigation
@@ -0,0 +1,215 @@
+/*************************************************************************/
+/*  test_websocket.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_websocket.h"
+#include "test_check.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/networked_multiplayer_peer.h"
+#include "core/os/os.h"
+#include "core/set.h"
+
+namespace TestWebSocket {
+
+// Loopback stress test of the WebSocket server, in both the polled and the threaded mode. The module
+// is only reached through ClassDB, so this builds without it. The multiplayer protocol is used, so
+// everything goes through the NetworkedMultiplayerPeer interface: the server echoes each packet to
+// its sender, which measures the round trip.
+
+enum {
+	HEADER_SIZE = 12, // send time (usec) and sequence
+	WINDOW = 16, // packets in flight per client
+	TIMEOUT_USEC = 30000000,
+};
+
+static Ref<NetworkedMultiplayerPeer> _instance(const String &p_class) {
+
+	Object *obj = ClassDB::instance(p_class);
+	NetworkedMultiplayerPeer *peer = Object::cast_to<NetworkedMultiplayerPeer>(obj);
+	if (!peer) {
+		if (obj)
+			memdelete(obj);
+		return Ref<NetworkedMultiplayerPeer>();
+	}
+	return Ref<NetworkedMultiplayerPeer>(peer);
+}
+
+static uint64_t _percentile(const Vector<uint64_t> &p_sorted, int p_percent) {
+
+	if (p_sorted.empty())
+		return 0;
+	return p_sorted[MIN(p_sorted.size() - 1, p_sorted.size() * p_percent / 100)];
+}
+
+static void _test_loopback(bool p_threaded, int p_clients, int p_messages, int p_size, int p_port) {
+
+	OS::get_singleton()->print("\n*** Loopback %s server: %i clients, %i messages of %i bytes each\n", p_threaded ? "threaded" : "polled", p_clients, p_messages, p_size);
+
+	Ref<NetworkedMultiplayerPeer> server = _instance("WebSocketServer");
+	if (server.is_null()) {
+		OS::get_singleton()->print("\tWebSocket module not available, skipped\n");
+		return;
+	}
+
+	server->set("threaded", p_threaded);
+	Variant ret = server->call("listen", p_port, PoolVector<String>(), true);
+	CHECK(int(ret) == OK);
+	if (int(ret) != OK)
+		return;
+
+	Vector<Ref<NetworkedMultiplayerPeer> > clients;
+	Vector<int> sent;
+	Vector<int> received;
+	for (int i = 0; i < p_clients; i++) {
+		Ref<NetworkedMultiplayerPeer> client = _instance("WebSocketClient");
+		client->call("connect_to_url", "ws://127.0.0.1:" + itos(p_port), PoolVector<String>(), true);
+		clients.push_back(client);
+		sent.push_back(0);
+		received.push_back(0);
+	}
+
+	// Wait until every client got its id
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int connected = 0;
+	while (connected < p_clients && OS::get_singleton()->get_ticks_usec() - begin < TIMEOUT_USEC) {
+		server->poll();
+		connected = 0;
+		for (int i = 0; i < p_clients; i++) {
+			Ref<NetworkedMultiplayerPeer> client = clients[i];
+			client->poll();
+			if (client->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED && client->get_unique_id() != 0)
+				connected++;
+		}
+	}
+	CHECK(connected == p_clients);
+
+	Vector<uint8_t> packet;
+	packet.resize(p_size);
+	for (int i = HEADER_SIZE; i < p_size; i++) {
+		packet.write[i] = i & 0xFF;
+	}
+
+	Vector<uint64_t> latencies;
+	Set<int> server_peers;
+	int total = p_clients * p_messages;
+	int done = 0;
+	int corrupt = 0;
+	uint64_t server_poll_usec = 0;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	while (done < total && OS::get_singleton()->get_ticks_usec() - begin < TIMEOUT_USEC) {
+
+		for (int i = 0; i < p_clients; i++) {
+			Ref<NetworkedMultiplayerPeer> client = clients[i];
+
+			while (sent[i] < p_messages && sent[i] - received[i] < WINDOW) {
+				uint64_t now = OS::get_singleton()->get_ticks_usec();
+				encode_uint64(now, &packet.write[0]);
+				encode_uint32(sent[i], &packet.write[8]);
+				client->set_target_peer(1);
+				client->put_packet(packet.ptr(), packet.size());
+				sent.write[i]++;
+			}
+
+			client->poll();
+
+			while (client->get_available_packet_count()) {
+				const uint8_t *data;
+				int size;
+				client->get_packet(&data, size);
+
+				uint64_t now = OS::get_singleton()->get_ticks_usec();
+				if (size != p_size || int(decode_uint32(&data[8])) != received[i] || data[p_size - 1] != ((p_size - 1) & 0xFF))
+					corrupt++;
+				latencies.push_back(now - decode_uint64(data));
+				received.write[i]++;
+				done++;
+			}
+		}
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		server->poll();
+		while (server->get_available_packet_count()) {
+			int from = server->get_packet_peer();
+			const uint8_t *data;
+			int size;
+			server->get_packet(&data, size);
+			server_peers.insert(from);
+			server->set_target_peer(from);
+			server->put_packet(data, size);
+		}
+		server_poll_usec += OS::get_singleton()->get_ticks_usec() - t;
+	}
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(done == total);
+	CHECK(corrupt == 0);
+
+	latencies.sort();
+	double seconds = MAX(time, 1) / 1000000.0;
+	OS::get_singleton()->print("\tround trips: %i in %.1f ms, %.0f messages/s, %.2f MB/s each way\n", done, time / 1000.0, done / seconds, done * (double)p_size / seconds / (1024 * 1024));
+	OS::get_singleton()->print("\tround trip latency: p50 %i us, p90 %i us, p99 %i us, max %i us\n", int(_percentile(latencies, 50)), int(_percentile(latencies, 90)), int(_percentile(latencies, 99)), int(_percentile(latencies, 100)));
+	OS::get_singleton()->print("\tserver poll and echo on the main thread: %.1f ms\n", server_poll_usec / 1000.0);
+
+	// Backpressure, as seen by the server
+	int dropped = 0;
+	int peak_queued = 0;
+	int choked = 0;
+	for (Set<int>::Element *E = server_peers.front(); E; E = E->next()) {
+		Ref<Reference> peer = server->call("get_peer", E->get());
+		CHECK(peer.is_valid());
+		if (peer.is_null())
+			continue;
+		Dictionary stats = peer->call("get_stats");
+		CHECK(int(stats["packets_in"]) == p_messages);
+		dropped += int(stats["dropped_in"]) + int(stats["dropped_out"]);
+		peak_queued = MAX(peak_queued, int(stats["peak_queued_out"]));
+		choked += int(stats["choked"]);
+	}
+	CHECK(dropped == 0);
+	OS::get_singleton()->print("\tserver peers: %i dropped, peak %i packets queued, choked %i times\n", dropped, peak_queued, choked);
+
+	for (int i = 0; i < p_clients; i++) {
+		Ref<NetworkedMultiplayerPeer> client = clients[i];
+		client->call("disconnect_from_host");
+	}
+	server->call("stop");
+}
+
+MainLoop *test() {
+
+	_test_loopback(false, 32, 500, 128, 17700);
+	_test_loopback(true, 32, 500, 128, 17701);
+
+	CHECK_RESULT();
+
+	return NULL;
+}
+} // namespace TestWebSocket
@@ -31,7 +31,7 @@
 #include "image_compress_cvtt.h"
 
 #include "core/os/os.h"
-#include "core/os/thread.h"
+#include "core/os/threaded_array_processor.h"
 #include "core/print_string.h"
 
 #include <ConvectionKernels.h>
@@ -52,13 +52,6 @@ struct CVTTCompressionRowTask {
 	int height;
 };
 
-struct CVTTCompressionJobQueue {
-	CVTTCompressionJobParams job_params;
-	const CVTTCompressionRowTask *job_tasks;
-	uint32_t num_tasks;
-	uint32_t current_task;
-};
-
 static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const CVTTCompressionRowTask &p_row_task) {
 	const uint8_t *in_bytes = p_row_task.in_mm_bytes;
 	uint8_t *out_bytes = p_row_task.out_mm_bytes;
@@ -128,13 +121,13 @@ static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const
 	}
 }
 
-static void _digest_job_queue(void *p_job_queue) {
-	CVTTCompressionJobQueue *job_queue = static_cast<CVTTCompressionJobQueue *>(p_job_queue);
+struct CVTTCompressionJob {
+	CVTTCompressionJobParams job_params;
 
-	for (uint32_t next_task = atomic_increment(&job_queue->current_task); next_task <= job_queue->num_tasks; next_task = atomic_increment(&job_queue->current_task)) {
-		_digest_row_task(job_queue->job_params, job_queue->job_tasks[next_task - 1]);
+	void digest_row_task(uint32_t p_index, const CVTTCompressionRowTask *p_tasks) {
+		_digest_row_task(job_params, p_tasks[p_index]);
 	}
-}
+};
 
 void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::CompressSource p_source) {
 
@@ -203,19 +196,14 @@ void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::CompressS
 
 	int dst_ofs = 0;
 
-	CVTTCompressionJobQueue job_queue;
-	job_queue.job_params.is_hdr = is_hdr;
-	job_queue.job_params.is_signed = is_signed;
-	job_queue.job_params.options = options;
-	job_queue.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
-
-#ifdef NO_THREADS
-	int num_job_threads = 0;
-#else
-	int num_job_threads = OS::get_singleton()->can_use_threads() ? (OS::get_singleton()->get_processor_count() - 1) : 0;
-#endif
+	CVTTCompressionJob job;
+	job.job_params.is_hdr = is_hdr;
+	job.job_params.is_signed = is_signed;
+	job.job_params.options = options;
+	job.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
 
-	PoolVector<CVTTCompressionRowTask> tasks;
+	// Every row of blocks, over all mipmaps, is compressed as its own task.
+	Vector<CVTTCompressionRowTask> tasks;
 
 	for (int i = 0; i <= mm_count; i++) {
 
@@ -235,11 +223,7 @@ void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::CompressS
 			row_task.in_mm_bytes = in_bytes;
 			row_task.out_mm_bytes = out_bytes;
 
-			if (num_job_threads > 0) {
-				tasks.push_back(row_task);
-			} else {
-				_digest_row_task(job_queue.job_params, row_task);
-			}
+			tasks.push_back(row_task);
 
 			out_bytes += 16 * (bw / 4);
 		}
@@ -249,28 +233,7 @@ void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::CompressS
 		h = MAX(h / 2, 1);
 	}
 
-	if (num_job_threads > 0) {
-		PoolVector<Thread *> threads;
-		threads.resize(num_job_threads);
-
-		PoolVector<Thread *>::Write threads_wb = threads.write();
-
-		PoolVector<CVTTCompressionRowTask>::Read tasks_rb = tasks.read();
-
-		job_queue.job_tasks = &tasks_rb[0];
-		job_queue.current_task = 0;
-		job_queue.num_tasks = static_cast<uint32_t>(tasks.size());
-
-		for (int i = 0; i < num_job_threads; i++) {
-			threads_wb[i] = Thread::create(_digest_job_queue, &job_queue);
-		}
-		_digest_job_queue(&job_queue);
-
-		for (int i = 0; i < num_job_threads; i++) {
-			Thread::wait_to_finish(threads_wb[i]);
-			memdelete(threads_wb[i]);
-		}
-	}
+	thread_process_array(tasks.size(), &job, &CVTTCompressionJob::digest_row_task, tasks.ptr());
 
 	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 }
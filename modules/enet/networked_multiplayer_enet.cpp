@@ -50,17 +50,21 @@ void NetworkedMultiplayerENet::set_target_peer(int p_peer) {
 int NetworkedMultiplayerENet::get_packet_peer() const {
 
 	ERR_FAIL_COND_V(!active, 1);
-	ERR_FAIL_COND_V(incoming_packets.size() == 0, 1);
+	ERR_FAIL_COND_V(incoming_packets.data_left() == 0, 1);
 
-	return incoming_packets.front()->get().from;
+	Packet packet;
+	incoming_packets.copy(&packet, 0, 1);
+	return packet.from;
 }
 
 int NetworkedMultiplayerENet::get_packet_channel() const {
 
 	ERR_FAIL_COND_V(!active, -1);
-	ERR_FAIL_COND_V(incoming_packets.size() == 0, -1);
+	ERR_FAIL_COND_V(incoming_packets.data_left() == 0, -1);
 
-	return incoming_packets.front()->get().channel;
+	Packet packet;
+	incoming_packets.copy(&packet, 0, 1);
+	return packet.channel;
 }
 
 int NetworkedMultiplayerENet::get_last_packet_channel() const {
@@ -111,6 +115,10 @@ Error NetworkedMultiplayerENet::create_server(int p_port, int p_max_clients, int
 	refuse_connections = false;
 	unique_id = 1;
 	connection_status = CONNECTION_CONNECTED;
+
+	if (threaded) {
+		_start_thread();
+	}
 	return OK;
 }
 Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_port, int p_in_bandwidth, int p_out_bandwidth, int p_client_port) {
@@ -197,6 +205,10 @@ Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_por
 	server = false;
 	refuse_connections = false;
 
+	if (threaded) {
+		_start_thread();
+	}
+
 	return OK;
 }
 
@@ -206,215 +218,298 @@ void NetworkedMultiplayerENet::poll() {
 
 	_pop_current_packet();
 
-	ENetEvent event;
+	Event event;
 	/* Keep servicing until there are no available events left in queue. */
 	while (true) {
 
 		if (!host || !active) // Might have been disconnected while emitting a notification
 			return;
 
-		int ret = enet_host_service(host, &event, 0);
+		if (thread) {
+			// The network thread services the host, take what it received.
+			if (!thread_events.read(event)) {
+				break;
+			}
+		} else {
+
+			ENetEvent enet_event;
+			int ret = enet_host_service(host, &enet_event, 0);
+
+			if (ret < 0) {
+				// Error, do something?
+				break;
+			} else if (ret == 0) {
+				break;
+			}
 
-		if (ret < 0) {
-			// Error, do something?
-			break;
-		} else if (ret == 0) {
-			break;
+			if (!_make_event(enet_event, event)) {
+				continue;
+			}
 		}
 
-		switch (event.type) {
-			case ENET_EVENT_TYPE_CONNECT: {
-				// Store any relevant client information here.
+		if (!_process_event(event)) {
+			return;
+		}
+	}
+}
 
-				if (server && refuse_connections) {
-					enet_peer_reset(event.peer);
-					break;
-				}
+// Runs on the thread servicing the host: tracks which ENetPeer belongs to which id and copies what
+// the main thread needs out of the peer. Returns false if the event is to be dropped.
+bool NetworkedMultiplayerENet::_make_event(const ENetEvent &p_enet_event, Event &r_event) {
 
-				int *new_id = memnew(int);
-				*new_id = event.data;
+	r_event.type = p_enet_event.type;
+	r_event.peer = 0;
+	r_event.packet = NULL;
+	r_event.channel = p_enet_event.channelID;
+	zeromem(&r_event.address, sizeof(ENetAddress));
 
-				if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
-					*new_id = 1;
-				}
+	switch (p_enet_event.type) {
+		case ENET_EVENT_TYPE_CONNECT: {
 
-				event.peer->data = new_id;
+			int *new_id = memnew(int);
+			*new_id = p_enet_event.data;
 
-				peer_map[*new_id] = event.peer;
+			if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
+				*new_id = 1;
+			}
 
-				connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
+			p_enet_event.peer->data = new_id;
+			enet_peers[*new_id] = p_enet_event.peer;
 
-				emit_signal("peer_connected", *new_id);
+			r_event.peer = *new_id;
+			r_event.address = p_enet_event.peer->address;
+		} break;
+		case ENET_EVENT_TYPE_DISCONNECT: {
 
-				if (server) {
-					// Someone connected, notify all the peers available
-					for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+			int *id = (int *)p_enet_event.peer->data;
+			if (id) {
+				r_event.peer = *id;
+				_forget_enet_peer(*id);
+			}
+		} break;
+		case ENET_EVENT_TYPE_RECEIVE: {
 
-						if (E->key() == *new_id)
-							continue;
-						// Send existing peers to new peer
-						ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(E->key(), &packet->data[4]);
-						enet_peer_send(event.peer, SYSCH_CONFIG, packet);
-						// Send the new peer to existing peers
-						packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(*new_id, &packet->data[4]);
-						enet_peer_send(E->get(), SYSCH_CONFIG, packet);
-					}
-				} else {
+			int *id = (int *)p_enet_event.peer->data;
+			if (!id) {
+				enet_packet_destroy(p_enet_event.packet);
+				return false;
+			}
 
-					emit_signal("connection_succeeded");
-				}
+			r_event.peer = *id;
+			r_event.packet = p_enet_event.packet;
+		} break;
+		case ENET_EVENT_TYPE_NONE: {
+			return false;
+		} break;
+	}
 
-			} break;
-			case ENET_EVENT_TYPE_DISCONNECT: {
+	return true;
+}
 
-				// Reset the peer's client information.
+void NetworkedMultiplayerENet::_forget_enet_peer(int p_peer) {
 
-				int *id = (int *)event.peer->data;
+	Map<int, ENetPeer *>::Element *E = enet_peers.find(p_peer);
+	if (!E)
+		return;
 
-				if (!id) {
-					if (!server) {
-						emit_signal("connection_failed");
-					}
-				} else {
+	memdelete((int *)E->get()->data);
+	E->get()->data = NULL;
+	enet_peers.erase(E);
+}
 
-					if (server) {
-						// Someone disconnected, notify everyone else
-						for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+// Returns false if the connection was closed.
+bool NetworkedMultiplayerENet::_process_event(const Event &event) {
 
-							if (E->key() == *id)
-								continue;
+	switch (event.type) {
+		case ENET_EVENT_TYPE_CONNECT: {
+			// Store any relevant client information here.
 
-							ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
-							encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
-							encode_uint32(*id, &packet->data[4]);
-							enet_peer_send(E->get(), SYSCH_CONFIG, packet);
-						}
-					} else {
-						emit_signal("server_disconnected");
-						close_connection();
-						return;
-					}
+			if (server && refuse_connections) {
+				_peer_reset(event.peer);
+				break;
+			}
+
+			int new_id = event.peer;
 
-					emit_signal("peer_disconnected", *id);
-					peer_map.erase(*id);
-					memdelete(id);
+			peer_map[new_id] = event.address;
+
+			connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
+
+			emit_signal("peer_connected", new_id);
+
+			if (server) {
+				// Someone connected, notify all the peers available
+				for (Map<int, ENetAddress>::Element *E = peer_map.front(); E; E = E->next()) {
+
+					if (E->key() == new_id)
+						continue;
+					// Send existing peers to new peer
+					ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(E->key(), &packet->data[4]);
+					_peer_send(new_id, SYSCH_CONFIG, packet);
+					// Send the new peer to existing peers
+					packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(new_id, &packet->data[4]);
+					_peer_send(E->key(), SYSCH_CONFIG, packet);
 				}
+			} else {
 
-			} break;
-			case ENET_EVENT_TYPE_RECEIVE: {
+				emit_signal("connection_succeeded");
+			}
 
-				if (event.channelID == SYSCH_CONFIG) {
-					// Some config message
-					ERR_CONTINUE(event.packet->dataLength < 8);
+		} break;
+		case ENET_EVENT_TYPE_DISCONNECT: {
 
-					// Only server can send config messages
-					ERR_CONTINUE(server);
+			// Reset the peer's client information.
 
-					int msg = decode_uint32(&event.packet->data[0]);
-					int id = decode_uint32(&event.packet->data[4]);
+			int id = event.peer;
 
-					switch (msg) {
-						case SYSMSG_ADD_PEER: {
+			if (!id) {
+				if (!server) {
+					emit_signal("connection_failed");
+				}
+			} else if (peer_map.has(id)) { // Not the case for refused peers
 
-							peer_map[id] = NULL;
-							emit_signal("peer_connected", id);
+				if (server) {
+					// Someone disconnected, notify everyone else
+					for (Map<int, ENetAddress>::Element *E = peer_map.front(); E; E = E->next()) {
 
-						} break;
-						case SYSMSG_REMOVE_PEER: {
+						if (E->key() == id)
+							continue;
 
-							peer_map.erase(id);
-							emit_signal("peer_disconnected", id);
-						} break;
+						ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
+						encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
+						encode_uint32(id, &packet->data[4]);
+						_peer_send(E->key(), SYSCH_CONFIG, packet);
 					}
+				} else {
+					emit_signal("server_disconnected");
+					close_connection();
+					return false;
+				}
 
-					enet_packet_destroy(event.packet);
-				} else if (event.channelID < channel_count) {
+				emit_signal("peer_disconnected", id);
+				peer_map.erase(id);
+			}
 
-					Packet packet;
-					packet.packet = event.packet;
+		} break;
+		case ENET_EVENT_TYPE_RECEIVE: {
 
-					uint32_t *id = (uint32_t *)event.peer->data;
+			if (!peer_map.has(event.peer)) {
+				// Sent by a refused peer before it was reset.
+				enet_packet_destroy(event.packet);
+				break;
+			}
 
-					ERR_CONTINUE(event.packet->dataLength < 12)
+			if (event.channel == SYSCH_CONFIG) {
+				// Some config message
+				ERR_FAIL_COND_V(event.packet->dataLength < 8, true);
 
-					uint32_t source = decode_uint32(&event.packet->data[0]);
-					int target = decode_uint32(&event.packet->data[4]);
-					uint32_t flags = decode_uint32(&event.packet->data[8]);
+				// Only server can send config messages
+				ERR_FAIL_COND_V(server, true);
 
-					packet.from = source;
-					packet.channel = event.channelID;
+				int msg = decode_uint32(&event.packet->data[0]);
+				int id = decode_uint32(&event.packet->data[4]);
 
-					if (server) {
-						// Someone is cheating and trying to fake the source!
-						ERR_CONTINUE(source != *id);
+				switch (msg) {
+					case SYSMSG_ADD_PEER: {
 
-						packet.from = *id;
+						peer_map[id] = ENetAddress(); // Relayed through the server
+						emit_signal("peer_connected", id);
 
-						if (target == 0) {
-							// Re-send to everyone but sender :|
+					} break;
+					case SYSMSG_REMOVE_PEER: {
 
-							incoming_packets.push_back(packet);
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+						peer_map.erase(id);
+						emit_signal("peer_disconnected", id);
+					} break;
+				}
 
-								if (uint32_t(E->key()) == source) // Do not resend to self
-									continue;
+				enet_packet_destroy(event.packet);
+			} else if (event.channel < channel_count) {
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+				Packet packet;
+				packet.packet = event.packet;
 
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+				ERR_FAIL_COND_V(event.packet->dataLength < 12, true);
 
-						} else if (target < 0) {
-							// To all but one
+				uint32_t source = decode_uint32(&event.packet->data[0]);
+				int target = decode_uint32(&event.packet->data[4]);
+				uint32_t flags = decode_uint32(&event.packet->data[8]);
 
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+				packet.from = source;
+				packet.channel = event.channel;
 
-								if (uint32_t(E->key()) == source || E->key() == -target) // Do not resend to self, also do not send to excluded
-									continue;
+				if (server) {
+					// Someone is cheating and trying to fake the source!
+					ERR_FAIL_COND_V(source != uint32_t(event.peer), true);
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+					packet.from = event.peer;
+
+					if (target == 0) {
+						// Re-send to everyone but sender :|
+
+						_push_incoming(packet);
+						// And make copies for sending
+						for (Map<int, ENetAddress>::Element *E = peer_map.front(); E; E = E->next()) {
+
+							if (uint32_t(E->key()) == source) // Do not resend to self
+								continue;
+
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
+
+							_peer_send(E->key(), event.channel, packet2);
+						}
+
+					} else if (target < 0) {
+						// To all but one
+
+						// And make copies for sending
+						for (Map<int, ENetAddress>::Element *E = peer_map.front(); E; E = E->next()) {
+
+							if (uint32_t(E->key()) == source || E->key() == -target) // Do not resend to self, also do not send to excluded
+								continue;
 
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
 
-							if (-target != 1) {
-								// Server is not excluded
-								incoming_packets.push_back(packet);
-							} else {
-								// Server is excluded, erase packet
-								enet_packet_destroy(packet.packet);
-							}
+							_peer_send(E->key(), event.channel, packet2);
+						}
 
-						} else if (target == 1) {
-							// To myself and only myself
-							incoming_packets.push_back(packet);
+						if (-target != 1) {
+							// Server is not excluded
+							_push_incoming(packet);
 						} else {
-							// To someone else, specifically
-							ERR_CONTINUE(!peer_map.has(target));
-							enet_peer_send(peer_map[target], event.channelID, packet.packet);
+							// Server is excluded, erase packet
+							enet_packet_destroy(packet.packet);
 						}
-					} else {
 
-						incoming_packets.push_back(packet);
+					} else if (target == 1) {
+						// To myself and only myself
+						_push_incoming(packet);
+					} else {
+						// To someone else, specifically
+						ERR_FAIL_COND_V(!peer_map.has(target), true);
+						_peer_send(target, event.channel, packet.packet);
 					}
-
-					// Destroy packet later
 				} else {
-					ERR_CONTINUE(true);
+
+					_push_incoming(packet);
 				}
 
-			} break;
-			case ENET_EVENT_TYPE_NONE: {
-				// Do nothing
-			} break;
-		}
+				// Destroy packet later
+			} else {
+				ERR_FAIL_V(true);
+			}
+
+		} break;
+		case ENET_EVENT_TYPE_NONE: {
+			// Do nothing
+		} break;
 	}
+
+	return true;
 }
 
 bool NetworkedMultiplayerENet::is_server() const {
@@ -428,15 +523,19 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 	ERR_FAIL_COND(!active);
 	ERR_FAIL_COND(wait_usec < 0);
 
+	_stop_thread(); // The host is only used from here on
+
 	_pop_current_packet();
 
 	bool peers_disconnected = false;
-	for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-		if (E->get()) {
-			enet_peer_disconnect_now(E->get(), unique_id);
-			peers_disconnected = true;
-		}
+	for (Map<int, ENetPeer *>::Element *E = enet_peers.front(); E; E = E->next()) {
+		enet_peer_disconnect_now(E->get(), unique_id);
+		memdelete((int *)E->get()->data);
+		E->get()->data = NULL;
+		peers_disconnected = true;
 	}
+	enet_peers.clear();
+	peer_map.clear();
 
 	if (peers_disconnected) {
 		enet_host_flush(host);
@@ -448,7 +547,10 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 
 	enet_host_destroy(host);
 	active = false;
-	incoming_packets.clear();
+	Packet packet;
+	while (incoming_packets.read(&packet, 1)) {
+		enet_packet_destroy(packet.packet);
+	}
 	unique_id = 1; // Server is 1
 	connection_status = CONNECTION_DISCONNECTED;
 }
@@ -460,12 +562,12 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 	ERR_FAIL_COND(!peer_map.has(p_peer))
 
 	if (now) {
-		enet_peer_disconnect_now(peer_map[p_peer], 0);
+		_peer_disconnect(p_peer, true);
 
 		// enet_peer_disconnect_now doesn't generate ENET_EVENT_TYPE_DISCONNECT,
 		// notify everyone else, send disconnect signal & remove from peer_map like in poll()
 
-		for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+		for (Map<int, ENetAddress>::Element *E = peer_map.front(); E; E = E->next()) {
 
 			if (E->key() == p_peer)
 				continue;
@@ -473,29 +575,28 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 			ENetPacket *packet = enet_packet_create(NULL, 8, ENET_PACKET_FLAG_RELIABLE);
 			encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
 			encode_uint32(p_peer, &packet->data[4]);
-			enet_peer_send(E->get(), SYSCH_CONFIG, packet);
+			_peer_send(E->key(), SYSCH_CONFIG, packet);
 		}
 
 		emit_signal("peer_disconnected", p_peer);
 		peer_map.erase(p_peer);
 	} else {
-		enet_peer_disconnect_later(peer_map[p_peer], 0);
+		_peer_disconnect(p_peer, false);
 	}
 }
 
 int NetworkedMultiplayerENet::get_available_packet_count() const {
 
-	return incoming_packets.size();
+	return incoming_packets.data_left();
 }
 
 Error NetworkedMultiplayerENet::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
-	ERR_FAIL_COND_V(incoming_packets.size() == 0, ERR_UNAVAILABLE);
+	ERR_FAIL_COND_V(incoming_packets.data_left() == 0, ERR_UNAVAILABLE);
 
 	_pop_current_packet();
 
-	current_packet = incoming_packets.front()->get();
-	incoming_packets.pop_front();
+	incoming_packets.read(&current_packet, 1);
 
 	*r_buffer = (const uint8_t *)(&current_packet.packet->data[12]);
 	r_buffer_size = current_packet.packet->dataLength - 12;
@@ -503,6 +604,33 @@ Error NetworkedMultiplayerENet::get_packet(const uint8_t **r_buffer, int &r_buff
 	return OK;
 }
 
+int NetworkedMultiplayerENet::get_packet_batch(PacketInfo *r_packets, int p_max) {
+
+	_pop_current_packet();
+
+	int count = MIN(p_max, incoming_packets.data_left());
+	if (batch_packets.size() < count) {
+		batch_packets.resize(count);
+	}
+
+	Packet *packets = batch_packets.ptrw();
+	incoming_packets.read(packets, count);
+	batch_count = count;
+
+	for (int i = 0; i < count; i++) {
+		r_packets[i].buffer = (const uint8_t *)(&packets[i].packet->data[12]);
+		r_packets[i].size = packets[i].packet->dataLength - 12;
+		r_packets[i].from = packets[i].from;
+	}
+
+	if (count) {
+		// get_last_packet_channel() refers to the last packet handed out.
+		current_packet.channel = packets[count - 1].channel;
+	}
+
+	return count;
+}
+
 Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
 
 	ERR_FAIL_COND_V(!active, ERR_UNCONFIGURED);
@@ -532,12 +660,9 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 	if (transfer_channel > SYSCH_CONFIG)
 		channel = transfer_channel;
 
-	Map<int, ENetPeer *>::Element *E = NULL;
-
 	if (target_peer != 0) {
 
-		E = peer_map.find(ABS(target_peer));
-		if (!E) {
+		if (!peer_map.has(ABS(target_peer))) {
 			ERR_EXPLAIN("Invalid Target Peer: " + itos(target_peer));
 			ERR_FAIL_V(ERR_INVALID_PARAMETER);
 		}
@@ -552,34 +677,36 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 	if (server) {
 
 		if (target_peer == 0) {
-			enet_host_broadcast(host, channel, packet);
+			_host_broadcast(channel, packet);
 		} else if (target_peer < 0) {
 			// Send to all but one
 			// and make copies for sending
 
 			int exclude = -target_peer;
 
-			for (Map<int, ENetPeer *>::Element *F = peer_map.front(); F; F = F->next()) {
+			for (Map<int, ENetAddress>::Element *F = peer_map.front(); F; F = F->next()) {
 
 				if (F->key() == exclude) // Exclude packet
 					continue;
 
 				ENetPacket *packet2 = enet_packet_create(packet->data, packet->dataLength, packet_flags);
 
-				enet_peer_send(F->get(), channel, packet2);
+				_peer_send(F->key(), channel, packet2);
 			}
 
 			enet_packet_destroy(packet); // Original packet no longer needed
 		} else {
-			enet_peer_send(E->get(), channel, packet);
+			_peer_send(target_peer, channel, packet);
 		}
 	} else {
 
 		ERR_FAIL_COND_V(!peer_map.has(1), ERR_BUG);
-		enet_peer_send(peer_map[1], channel, packet); // Send to server for broadcast
+		_peer_send(1, channel, packet); // Send to server for broadcast
 	}
 
-	enet_host_flush(host);
+	if (!thread) {
+		enet_host_flush(host); // The network thread flushes on its own
+	}
 
 	return OK;
 }
@@ -597,6 +724,202 @@ void NetworkedMultiplayerENet::_pop_current_packet() {
 		current_packet.from = 0;
 		current_packet.channel = -1;
 	}
+
+	for (int i = 0; i < batch_count; i++) {
+		enet_packet_destroy(batch_packets[i].packet);
+	}
+	batch_count = 0;
+}
+
+void NetworkedMultiplayerENet::_push_incoming(const Packet &p_packet) {
+
+	if (incoming_packets.space_left() < 1) {
+		incoming_packets.resize(nearest_shift(incoming_packets.size()));
+	}
+	incoming_packets.write(p_packet);
+}
+
+void NetworkedMultiplayerENet::_peer_send(int p_peer, int p_channel, ENetPacket *p_packet) {
+
+	Command command;
+	command.type = Command::SEND;
+	command.peer = p_peer;
+	command.packet = p_packet;
+	command.channel = p_channel;
+	_push_command(command);
+}
+
+void NetworkedMultiplayerENet::_host_broadcast(int p_channel, ENetPacket *p_packet) {
+
+	Command command;
+	command.type = Command::BROADCAST;
+	command.peer = 0;
+	command.packet = p_packet;
+	command.channel = p_channel;
+	_push_command(command);
+}
+
+void NetworkedMultiplayerENet::_peer_reset(int p_peer) {
+
+	Command command;
+	command.type = Command::RESET_PEER;
+	command.peer = p_peer;
+	command.packet = NULL;
+	command.channel = 0;
+	_push_command(command);
+}
+
+void NetworkedMultiplayerENet::_peer_disconnect(int p_peer, bool p_now) {
+
+	Command command;
+	command.type = p_now ? Command::DISCONNECT_PEER_NOW : Command::DISCONNECT_PEER;
+	command.peer = p_peer;
+	command.packet = NULL;
+	command.channel = 0;
+	_push_command(command);
+}
+
+// Commands run right away, unless the network thread owns the host.
+void NetworkedMultiplayerENet::_push_command(const Command &p_command) {
+
+	if (!thread) {
+		_run_command(p_command);
+		return;
+	}
+
+	while (!thread_commands.write(p_command)) {
+		// The network thread is behind, wait for room rather than dropping reliable packets.
+		OS::get_singleton()->delay_usec(100);
+	}
+}
+
+void NetworkedMultiplayerENet::_run_command(const Command &p_command) {
+
+	if (p_command.type == Command::BROADCAST) {
+		enet_host_broadcast(host, p_command.channel, p_command.packet);
+		return;
+	}
+
+	// Peers are looked up here, an ENetPeer can be reset and reused for someone else meanwhile.
+	Map<int, ENetPeer *>::Element *E = enet_peers.find(p_command.peer);
+	if (!E) {
+		if (p_command.packet) {
+			enet_packet_destroy(p_command.packet); // The peer disconnected meanwhile
+		}
+		return;
+	}
+
+	switch (p_command.type) {
+
+		case Command::SEND: {
+
+			if (enet_peer_send(E->get(), p_command.channel, p_command.packet) < 0 && p_command.packet->referenceCount == 0) {
+				enet_packet_destroy(p_command.packet);
+			}
+		} break;
+		case Command::RESET_PEER: {
+
+			ENetPeer *peer = E->get();
+			_forget_enet_peer(p_command.peer);
+			enet_peer_reset(peer);
+		} break;
+		case Command::DISCONNECT_PEER: {
+
+			enet_peer_disconnect_later(E->get(), 0);
+		} break;
+		case Command::DISCONNECT_PEER_NOW: {
+
+			// No disconnect event follows, forget the peer now.
+			ENetPeer *peer = E->get();
+			_forget_enet_peer(p_command.peer);
+			enet_peer_disconnect_now(peer, 0);
+		} break;
+		default: {}
+	}
+}
+
+void NetworkedMultiplayerENet::_thread_func(void *p_self) {
+
+	NetworkedMultiplayerENet *self = (NetworkedMultiplayerENet *)p_self;
+	self->_thread_poll();
+}
+
+void NetworkedMultiplayerENet::_thread_poll() {
+
+	ENetEvent enet_event;
+	Event event;
+	bool pending = false; // An event waiting for room in thread_events
+
+	while (!atomic_load_acquire(&thread_exit)) {
+
+		Command command;
+		while (thread_commands.read(command)) {
+			_run_command(command);
+		}
+
+		if (pending) {
+			if (!thread_events.write(event)) {
+				// The main thread is behind, leave the rest in ENet's and the socket's buffers for now.
+				enet_host_flush(host);
+				OS::get_singleton()->delay_usec(1000);
+				continue;
+			}
+			pending = false;
+		}
+
+		// Wait a little for traffic when idle. Packets queued meanwhile go out on the next pass.
+		int timeout = thread_commands.data_left() ? 0 : 1;
+
+		while (enet_host_service(host, &enet_event, timeout) > 0) {
+
+			timeout = 0;
+			if (!_make_event(enet_event, event))
+				continue;
+
+			if (!thread_events.write(event)) {
+				pending = true;
+				break;
+			}
+		}
+
+		enet_host_flush(host);
+	}
+
+	if (pending && event.type == ENET_EVENT_TYPE_RECEIVE) {
+		enet_packet_destroy(event.packet);
+	}
+}
+
+void NetworkedMultiplayerENet::_start_thread() {
+
+	thread_commands.resize(12);
+	thread_events.resize(12);
+	thread_exit = false;
+	thread = Thread::create(_thread_func, this);
+}
+
+void NetworkedMultiplayerENet::_stop_thread() {
+
+	if (!thread)
+		return;
+
+	atomic_store_release(&thread_exit, true);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+
+	// Whatever was not handed over is run or dropped here, the host is only used by this thread now.
+	Command command;
+	while (thread_commands.read(command)) {
+		_run_command(command);
+	}
+
+	Event event;
+	while (thread_events.read(event)) {
+		if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+			enet_packet_destroy(event.packet);
+		}
+	}
 }
 
 NetworkedMultiplayerPeer::ConnectionStatus NetworkedMultiplayerENet::get_connection_status() const {
@@ -759,13 +1082,12 @@ IP_Address NetworkedMultiplayerENet::get_peer_address(int p_peer_id) const {
 
 	ERR_FAIL_COND_V(!peer_map.has(p_peer_id), IP_Address());
 	ERR_FAIL_COND_V(!is_server() && p_peer_id != 1, IP_Address());
-	ERR_FAIL_COND_V(peer_map[p_peer_id] == NULL, IP_Address());
 
 	IP_Address out;
 #ifdef GODOT_ENET
-	out.set_ipv6((uint8_t *)&(peer_map[p_peer_id]->address.host));
+	out.set_ipv6((uint8_t *)&(peer_map[p_peer_id].host));
 #else
-	out.set_ipv4((uint8_t *)&(peer_map[p_peer_id]->address.host));
+	out.set_ipv4((uint8_t *)&(peer_map[p_peer_id].host));
 #endif
 
 	return out;
@@ -775,11 +1097,10 @@ int NetworkedMultiplayerENet::get_peer_port(int p_peer_id) const {
 
 	ERR_FAIL_COND_V(!peer_map.has(p_peer_id), 0);
 	ERR_FAIL_COND_V(!is_server() && p_peer_id != 1, 0);
-	ERR_FAIL_COND_V(peer_map[p_peer_id] == NULL, 0);
 #ifdef GODOT_ENET
-	return peer_map[p_peer_id]->address.port;
+	return peer_map[p_peer_id].port;
 #else
-	return peer_map[p_peer_id]->address.port;
+	return peer_map[p_peer_id].port;
 #endif
 }
 
@@ -817,6 +1138,16 @@ bool NetworkedMultiplayerENet::is_always_ordered() const {
 	return always_ordered;
 }
 
+void NetworkedMultiplayerENet::set_threaded(bool p_threaded) {
+
+	ERR_FAIL_COND(active);
+	threaded = p_threaded;
+}
+
+bool NetworkedMultiplayerENet::is_threaded() const {
+	return threaded;
+}
+
 void NetworkedMultiplayerENet::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("create_server", "port", "max_clients", "in_bandwidth", "out_bandwidth"), &NetworkedMultiplayerENet::create_server, DEFVAL(32), DEFVAL(0), DEFVAL(0));
@@ -837,11 +1168,14 @@ void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_channel_count"), &NetworkedMultiplayerENet::get_channel_count);
 	ClassDB::bind_method(D_METHOD("set_always_ordered", "ordered"), &NetworkedMultiplayerENet::set_always_ordered);
 	ClassDB::bind_method(D_METHOD("is_always_ordered"), &NetworkedMultiplayerENet::is_always_ordered);
+	ClassDB::bind_method(D_METHOD("set_threaded", "enabled"), &NetworkedMultiplayerENet::set_threaded);
+	ClassDB::bind_method(D_METHOD("is_threaded"), &NetworkedMultiplayerENet::is_threaded);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_mode", PROPERTY_HINT_ENUM, "None,Range Coder,FastLZ,ZLib,ZStd"), "set_compression_mode", "get_compression_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "transfer_channel"), "set_transfer_channel", "get_transfer_channel");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "channel_count"), "set_channel_count", "get_channel_count");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "always_ordered"), "set_always_ordered", "is_always_ordered");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "threaded"), "set_threaded", "is_threaded");
 
 	BIND_ENUM_CONSTANT(COMPRESS_NONE);
 	BIND_ENUM_CONSTANT(COMPRESS_RANGE_CODER);
@@ -858,6 +1192,11 @@ NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
 	unique_id = 0;
 	target_peer = 0;
 	current_packet.packet = NULL;
+	batch_count = 0;
+	incoming_packets.resize(8);
+	threaded = false;
+	thread = NULL;
+	thread_exit = false;
 	transfer_mode = TRANSFER_MODE_RELIABLE;
 	channel_count = SYSCH_MAX;
 	transfer_channel = -1;
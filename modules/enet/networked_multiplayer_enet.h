@@ -33,6 +33,9 @@
 
 #include "core/io/compression.h"
 #include "core/io/networked_multiplayer_peer.h"
+#include "core/os/thread.h"
+#include "core/ring_buffer.h"
+#include "core/spsc_ring_buffer.h"
 
 #include <enet/enet.h>
 
@@ -80,7 +83,17 @@ private:
 
 	ConnectionStatus connection_status;
 
-	Map<int, ENetPeer *> peer_map;
+	Map<int, ENetAddress> peer_map; // Peers known to this side, the address is only set for direct connections
+	Map<int, ENetPeer *> enet_peers; // Only used by the thread servicing the host
+
+	// An ENet event with the peer resolved to its id, so the main thread never touches an ENetPeer.
+	struct Event {
+		ENetEventType type;
+		int peer; // 0 for peers that disconnected before getting an id
+		ENetAddress address;
+		ENetPacket *packet;
+		int channel;
+	};
 
 	struct Packet {
 
@@ -91,9 +104,50 @@ private:
 
 	CompressionMode compression_mode;
 
-	List<Packet> incoming_packets;
+	RingBuffer<Packet> incoming_packets;
 
 	Packet current_packet;
+	Vector<Packet> batch_packets; // Handed out by get_packet_batch()
+	int batch_count;
+
+	// ENet calls made while the network thread owns the host.
+	struct Command {
+		enum Type {
+			SEND,
+			BROADCAST,
+			RESET_PEER,
+			DISCONNECT_PEER,
+			DISCONNECT_PEER_NOW,
+		};
+
+		Type type;
+		int peer;
+		ENetPacket *packet;
+		int channel;
+	};
+
+	bool threaded;
+	Thread *thread;
+	volatile uint32_t thread_exit;
+	SPSCRingBuffer<Command> thread_commands; // From the main thread to the network thread
+	SPSCRingBuffer<Event> thread_events; // From the network thread to the main thread
+
+	static void _thread_func(void *p_self);
+	void _thread_poll();
+	void _run_command(const Command &p_command);
+	void _push_command(const Command &p_command);
+	void _start_thread();
+	void _stop_thread();
+
+	void _peer_send(int p_peer, int p_channel, ENetPacket *p_packet);
+	void _host_broadcast(int p_channel, ENetPacket *p_packet);
+	void _peer_reset(int p_peer);
+	void _peer_disconnect(int p_peer, bool p_now);
+
+	bool _make_event(const ENetEvent &p_enet_event, Event &r_event);
+	void _forget_enet_peer(int p_peer);
+	bool _process_event(const Event &p_event);
+	void _push_incoming(const Packet &p_packet);
 
 	uint32_t _gen_unique_id() const;
 	void _pop_current_packet();
@@ -135,6 +189,7 @@ public:
 
 	virtual int get_available_packet_count() const;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size); ///< buffer is GONE after next get_packet
+	virtual int get_packet_batch(PacketInfo *r_packets, int p_max);
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size);
 
 	virtual int get_max_packet_size() const;
@@ -157,6 +212,8 @@ public:
 	int get_channel_count() const;
 	void set_always_ordered(bool p_ordered);
 	bool is_always_ordered() const;
+	void set_threaded(bool p_threaded);
+	bool is_threaded() const;
 
 	NetworkedMultiplayerENet();
 	~NetworkedMultiplayerENet();
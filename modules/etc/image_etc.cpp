@@ -34,6 +34,7 @@
 #include "core/image.h"
 #include "core/os/copymem.h"
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
 #include "core/print_string.h"
 
 static Image::Format _get_etc2_mode(Image::DetectChannels format) {
@@ -88,6 +89,44 @@ static Etc::Image::Format _image_format_to_etc2comp_format(Image::Format format)
 	}
 }
 
+// Rows of pixels encoded by a single task, a multiple of the block size.
+#define ETC_BAND_ROWS 32
+
+struct ETCEncodeBand {
+	const uint8_t *src; // RGBA8
+	int width;
+	int height;
+
+	unsigned char *etc_data;
+	unsigned int etc_data_len;
+};
+
+struct ETCEncodeJob {
+	Etc::Image::Format format;
+	Etc::ErrorMetric error_metric;
+	float effort;
+
+	void encode_band(uint32_t p_index, ETCEncodeBand *p_bands) {
+
+		ETCEncodeBand &band = p_bands[p_index];
+
+		// convert source image to internal etc2comp format (which is equivalent to Image::FORMAT_RGBAF)
+		// NOTE: We can alternatively add a case to Image::convert to handle Image::FORMAT_RGBAF conversion.
+		Etc::ColorFloatRGBA *src_rgba_f = new Etc::ColorFloatRGBA[band.width * band.height];
+		for (int j = 0; j < band.width * band.height; j++) {
+			int si = j * 4; // RGBA8
+			src_rgba_f[j] = Etc::ColorFloatRGBA::ConvertFromRGBA8(band.src[si], band.src[si + 1], band.src[si + 2], band.src[si + 3]);
+		}
+
+		unsigned int extended_width = 0, extended_height = 0;
+		int encoding_time = 0;
+		// A single job, the bands themselves already run in parallel.
+		Etc::Encode((float *)src_rgba_f, band.width, band.height, format, error_metric, effort, 1, 1, &band.etc_data, &band.etc_data_len, &extended_width, &extended_height, &encoding_time);
+
+		delete[] src_rgba_f;
+	}
+};
+
 static void _compress_etc(Image *p_img, float p_lossy_quality, bool force_etc1_format, Image::CompressSource p_source) {
 	Image::Format img_format = p_img->get_format();
 	Image::DetectChannels detected_channels = p_img->get_detected_channels();
@@ -177,8 +216,6 @@ static void _compress_etc(Image *p_img, float p_lossy_quality, bool force_etc1_f
 	PoolVector<uint8_t>::Write w = dst_data.write();
 
 	// prepare parameters to be passed to etc2comp
-	int num_cpus = OS::get_singleton()->get_processor_count();
-	int encoding_time = 0;
 	float effort = 0.0; //default, reasonable time
 
 	if (p_lossy_quality > 0.75)
@@ -188,37 +225,41 @@ static void _compress_etc(Image *p_img, float p_lossy_quality, bool force_etc1_f
 	else if (p_lossy_quality > 0.95)
 		effort = 0.8;
 
-	Etc::ErrorMetric error_metric = Etc::ErrorMetric::RGBX; // NOTE: we can experiment with other error metrics
-	Etc::Image::Format etc2comp_etc_format = _image_format_to_etc2comp_format(etc_format);
-
-	int wofs = 0;
+	ETCEncodeJob job;
+	job.error_metric = Etc::ErrorMetric::RGBX; // NOTE: we can experiment with other error metrics
+	job.format = _image_format_to_etc2comp_format(etc_format);
+	job.effort = effort;
 
 	print_verbose("ETC: Begin encoding, format: " + Image::get_format_name(etc_format));
 	uint64_t t = OS::get_singleton()->get_ticks_msec();
+
+	// Blocks are encoded independently, so every mipmap is split in bands of
+	// block rows which are encoded in parallel, then stored in order.
+	Vector<ETCEncodeBand> bands;
 	for (int i = 0; i < mmc; i++) {
-		// convert source image to internal etc2comp format (which is equivalent to Image::FORMAT_RGBAF)
-		// NOTE: We can alternatively add a case to Image::convert to handle Image::FORMAT_RGBAF conversion.
 		int mipmap_ofs = 0, mipmap_size = 0, mipmap_w = 0, mipmap_h = 0;
 		img->get_mipmap_offset_size_and_dimensions(i, mipmap_ofs, mipmap_size, mipmap_w, mipmap_h);
-		const uint8_t *src = &r[mipmap_ofs];
 
-		Etc::ColorFloatRGBA *src_rgba_f = new Etc::ColorFloatRGBA[mipmap_w * mipmap_h];
-		for (int j = 0; j < mipmap_w * mipmap_h; j++) {
-			int si = j * 4; // RGBA8
-			src_rgba_f[j] = Etc::ColorFloatRGBA::ConvertFromRGBA8(src[si], src[si + 1], src[si + 2], src[si + 3]);
+		for (int y = 0; y < mipmap_h; y += ETC_BAND_ROWS) {
+			ETCEncodeBand band;
+			band.src = &r[mipmap_ofs + y * mipmap_w * 4];
+			band.width = mipmap_w;
+			band.height = MIN(ETC_BAND_ROWS, mipmap_h - y);
+			band.etc_data = NULL;
+			band.etc_data_len = 0;
+			bands.push_back(band);
 		}
+	}
 
-		unsigned char *etc_data = NULL;
-		unsigned int etc_data_len = 0;
-		unsigned int extended_width = 0, extended_height = 0;
-		Etc::Encode((float *)src_rgba_f, mipmap_w, mipmap_h, etc2comp_etc_format, error_metric, effort, num_cpus, num_cpus, &etc_data, &etc_data_len, &extended_width, &extended_height, &encoding_time);
+	thread_process_array(bands.size(), &job, &ETCEncodeJob::encode_band, bands.ptrw());
 
-		CRASH_COND(wofs + etc_data_len > target_size);
-		memcpy(&w[wofs], etc_data, etc_data_len);
-		wofs += etc_data_len;
+	unsigned int wofs = 0;
+	for (int i = 0; i < bands.size(); i++) {
+		CRASH_COND(wofs + bands[i].etc_data_len > target_size);
+		memcpy(&w[wofs], bands[i].etc_data, bands[i].etc_data_len);
+		wofs += bands[i].etc_data_len;
 
-		delete[] etc_data;
-		delete[] src_rgba_f;
+		delete[] bands[i].etc_data;
 	}
 
 	print_verbose("ETC: Time encoding: " + rtos(OS::get_singleton()->get_ticks_msec() - t));
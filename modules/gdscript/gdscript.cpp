@@ -917,6 +917,7 @@ GDScript::GDScript() :
 }
 
 GDScript::~GDScript() {
+	GDScriptFunction::invalidate_call_caches();
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
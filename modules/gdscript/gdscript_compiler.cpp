@@ -82,8 +82,19 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 	if (src_address_a < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
-	codegen.opcodes.push_back(op); //which operator
+	int validated = -1;
+	Variant::Type type_a;
+	if (_get_builtin_value_type(on->arguments[0], type_a)) {
+		validated = codegen.get_validated_operator_pos(op, type_a, type_a);
+	}
+
+	if (validated >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform typed operator
+		codegen.opcodes.push_back(validated); //which evaluator
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+		codegen.opcodes.push_back(op); //which operator
+	}
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
 	//codegen.opcodes.push_back(GDScriptFunction::ADDR_TYPE_NIL); // argument 2 (unary only takes one parameter)
@@ -104,13 +115,37 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	if (src_address_b < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
-	codegen.opcodes.push_back(op); //which operator
+	int validated = -1;
+	Variant::Type type_a, type_b;
+	if (_get_builtin_value_type(on->arguments[0], type_a) && _get_builtin_value_type(on->arguments[1], type_b)) {
+		validated = codegen.get_validated_operator_pos(op, type_a, type_b);
+	}
+
+	if (validated >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform typed operator
+		codegen.opcodes.push_back(validated); //which evaluator
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+		codegen.opcodes.push_back(op); //which operator
+	}
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
 	return true;
 }
 
+bool GDScriptCompiler::_get_builtin_value_type(const GDScriptParser::Node *p_node, Variant::Type &r_type) const {
+
+	GDScriptParser::DataType datatype = p_node->get_datatype();
+	if (!datatype.has_type || datatype.is_meta_type || datatype.kind != GDScriptParser::DataType::BUILTIN)
+		return false;
+
+	if (datatype.builtin_type == Variant::NIL || datatype.builtin_type == Variant::OBJECT)
+		return false;
+
+	r_type = datatype.builtin_type;
+	return true;
+}
+
 GDScriptDataType GDScriptCompiler::_gdtype_from_datatype(const GDScriptParser::DataType &p_datatype) const {
 	if (!p_datatype.has_type) {
 		return GDScriptDataType();
@@ -663,10 +698,25 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						Variant::Type base_type;
+						int internal_method = -1;
+						if (_get_builtin_value_type(instance, base_type)) {
+							internal_method = codegen.get_internal_method_pos(base_type, static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						}
+
+						if (internal_method >= 0) {
+							// built-in type method, resolved now instead of looked up by name on every call
+							arguments.write[1] = internal_method;
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL_INTERNAL : GDScriptFunction::OPCODE_CALL_INTERNAL_RETURN);
+						} else {
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						}
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
-						for (int i = 0; i < arguments.size(); i++)
+						codegen.opcodes.push_back(arguments[0]); // base
+						codegen.opcodes.push_back(arguments[1]); // method
+						codegen.opcodes.push_back(codegen.alloc_call_cache());
+						for (int i = 2; i < arguments.size(); i++)
 							codegen.opcodes.push_back(arguments[i]);
 					}
 				} break;
@@ -705,6 +755,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 					int slevel = p_stack_level;
 					bool named = (on->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED);
+					bool validated = false;
 
 					int from = _parse_expression(codegen, on->arguments[0], slevel);
 					if (from < 0)
@@ -731,7 +782,17 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							}
 						}
 
-						index = codegen.get_name_map_pos(static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						StringName name = static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+						index = codegen.get_name_map_pos(name);
+
+						Variant::Type base_type;
+						if (_get_builtin_value_type(on->arguments[0], base_type)) {
+							int getter = codegen.get_validated_getter_pos(base_type, name);
+							if (getter >= 0) {
+								index = getter;
+								validated = true;
+							}
+						}
 
 					} else {
 
@@ -754,9 +815,16 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 					}
 
-					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+					if (validated) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED_VALIDATED); // perform typed operator
+					} else {
+						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+					}
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					if (named && !validated) {
+						codegen.opcodes.push_back(codegen.alloc_call_cache());
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1059,6 +1127,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
 							codegen.opcodes.push_back(key_idx);
+							if (named) {
+								codegen.opcodes.push_back(codegen.alloc_call_cache());
+							}
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -1614,6 +1685,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.call_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1761,6 +1833,20 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_global_names_count = 0;
 	}
 
+	//typed operations
+	gdfunc->validated_operators = codegen.validated_operators;
+	gdfunc->_validated_operators_ptr = gdfunc->validated_operators.ptr();
+	gdfunc->_validated_operators_count = gdfunc->validated_operators.size();
+	gdfunc->validated_getters = codegen.validated_getters;
+	gdfunc->_validated_getters_ptr = gdfunc->validated_getters.ptr();
+	gdfunc->_validated_getters_count = gdfunc->validated_getters.size();
+	gdfunc->internal_methods = codegen.internal_methods;
+	gdfunc->_internal_methods_ptr = gdfunc->internal_methods.ptr();
+	gdfunc->_internal_methods_count = gdfunc->internal_methods.size();
+	gdfunc->call_caches.resize(codegen.call_cache_count);
+	gdfunc->_call_caches_ptr = gdfunc->call_caches.ptrw();
+	gdfunc->_call_caches_count = gdfunc->call_caches.size();
+
 #ifdef TOOLS_ENABLED
 	// Named globals
 	if (codegen.named_globals.size()) {
@@ -1877,6 +1963,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, GDScript *p_owner
 	p_script->_base = NULL;
 	p_script->members.clear();
 	p_script->constants.clear();
+	GDScriptFunction::invalidate_call_caches();
 	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -122,6 +122,59 @@ class GDScriptCompiler {
 			return pos;
 		}
 
+		Vector<GDScriptFunction::ValidatedOperator> validated_operators;
+		Vector<GDScriptFunction::ValidatedGetter> validated_getters;
+		Vector<GDScriptFunction::InternalMethod> internal_methods;
+
+		int get_validated_operator_pos(Variant::Operator p_op, Variant::Type p_type_a, Variant::Type p_type_b) {
+			for (int i = 0; i < validated_operators.size(); i++) {
+				const GDScriptFunction::ValidatedOperator &vop = validated_operators[i];
+				if (vop.op == p_op && vop.type_a == p_type_a && vop.type_b == p_type_b)
+					return i;
+			}
+			GDScriptFunction::ValidatedOperator vop;
+			vop.evaluator = Variant::get_validated_operator_evaluator(p_op, p_type_a, p_type_b);
+			if (!vop.evaluator)
+				return -1;
+			vop.op = p_op;
+			vop.type_a = p_type_a;
+			vop.type_b = p_type_b;
+			validated_operators.push_back(vop);
+			return validated_operators.size() - 1;
+		}
+
+		int get_validated_getter_pos(Variant::Type p_base_type, const StringName &p_name) {
+			int name = get_name_map_pos(p_name);
+			for (int i = 0; i < validated_getters.size(); i++) {
+				if (validated_getters[i].base_type == p_base_type && validated_getters[i].name == name)
+					return i;
+			}
+			GDScriptFunction::ValidatedGetter vget;
+			vget.getter = Variant::get_validated_getter(p_base_type, p_name);
+			if (!vget.getter)
+				return -1;
+			vget.base_type = p_base_type;
+			vget.name = name;
+			validated_getters.push_back(vget);
+			return validated_getters.size() - 1;
+		}
+
+		int get_internal_method_pos(Variant::Type p_base_type, const StringName &p_name) {
+			int name = get_name_map_pos(p_name);
+			for (int i = 0; i < internal_methods.size(); i++) {
+				if (internal_methods[i].base_type == p_base_type && internal_methods[i].name == name)
+					return i;
+			}
+			GDScriptFunction::InternalMethod im;
+			im.method = Variant::get_internal_method(p_base_type, p_name);
+			if (!im.method)
+				return -1;
+			im.base_type = p_base_type;
+			im.name = name;
+			internal_methods.push_back(im);
+			return internal_methods.size() - 1;
+		}
+
 		Vector<int> opcodes;
 		void alloc_stack(int p_level) {
 			if (p_level >= stack_max) stack_max = p_level + 1;
@@ -129,10 +182,14 @@ class GDScriptCompiler {
 		void alloc_call(int p_params) {
 			if (p_params >= call_max) call_max = p_params;
 		}
+		int alloc_call_cache() {
+			return call_cache_count++;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int call_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -144,6 +201,7 @@ class GDScriptCompiler {
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false);
 
 	GDScriptDataType _gdtype_from_datatype(const GDScriptParser::DataType &p_datatype) const;
+	bool _get_builtin_value_type(const GDScriptParser::Node *p_node, Variant::Type &r_type) const;
 
 	int _parse_assign_right_expression(CodeGen &codegen, const GDScriptParser::OperatorNode *p_expression, int p_stack_level);
 	int _parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root = false, bool p_initializer = false);
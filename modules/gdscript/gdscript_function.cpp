@@ -30,6 +30,7 @@
 
 #include "gdscript_function.h"
 
+#include "core/core_string_names.h"
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
@@ -155,6 +156,171 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 	return err_text;
 }
 
+uint32_t GDScriptFunction::call_cache_version = 0;
+
+void GDScriptFunction::invalidate_call_caches() {
+
+	atomic_increment(&call_cache_version);
+}
+
+// Same lookup order as Object::call(): the script chain first, then the native class.
+// Classes overriding Object::call() get an entry with neither, so they are not looked up again.
+bool GDScriptFunction::_resolve_call(CallCache::Entry &r_entry, const StringName &p_native_class, GDScript *p_script, const StringName &p_method) {
+
+	GDScriptFunction *function = NULL;
+	MethodBind *method = NULL;
+
+	// scripts find their own (static) functions before native methods, Java wrappers have no native ones
+	bool overrides_call = ClassDB::is_parent_class(p_native_class, "Script") || ClassDB::is_parent_class(p_native_class, "JavaClass") || ClassDB::is_parent_class(p_native_class, "JavaObject");
+
+	for (GDScript *sptr = p_script; sptr && !function && !overrides_call; sptr = sptr->_base) {
+		Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_method);
+		if (E) {
+			function = E->get();
+		}
+	}
+
+	if (!function && !overrides_call) {
+		method = ClassDB::get_method(p_native_class, p_method);
+		if (!method) {
+			return false;
+		}
+	}
+
+	r_entry.native_class = p_native_class;
+	r_entry.script = p_script;
+	r_entry.script_version = call_cache_version;
+	r_entry.function = function;
+	r_entry.method = method;
+	r_entry.index = -1;
+	return true;
+}
+
+// Returns false when the call has to go through Variant::call_ptr() instead.
+bool GDScriptFunction::_call_cached(CallCache &p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err) {
+
+	Object *obj = *p_base;
+	if (unlikely(!obj)) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	if (ScriptDebugger::get_singleton() && !p_base->is_ref() && !ObjectDB::instance_validate(obj)) {
+		return false;
+	}
+#endif
+
+	GDScriptInstance *instance = NULL;
+	GDScript *script = NULL;
+	ScriptInstance *si = obj->get_script_instance();
+	if (si) {
+		// other languages resolve methods their own way
+		if (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder()) {
+			return false;
+		}
+		instance = static_cast<GDScriptInstance *>(si);
+		script = instance->script.ptr();
+	}
+
+	const StringName &native_class = obj->get_class_name();
+	CallCache::Entry *entry = NULL;
+	for (int i = 0; i < p_cache.used; i++) {
+		if (p_cache.entries[i].native_class == native_class && p_cache.entries[i].script == script) {
+			entry = &p_cache.entries[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		// free() is special cased by Object::call(), past CALL_CACHE_SIZE the site is megamorphic
+		if (p_cache.used == CALL_CACHE_SIZE || p_method == CoreStringNames::get_singleton()->_free) {
+			return false;
+		}
+		if (!_resolve_call(p_cache.entries[p_cache.used], native_class, script, p_method)) {
+			return false;
+		}
+		entry = &p_cache.entries[p_cache.used++];
+	} else if (script && entry->script_version != call_cache_version) {
+		if (!_resolve_call(*entry, native_class, script, p_method)) {
+			return false;
+		}
+	}
+
+	GDScriptFunction *function = entry->function;
+	MethodBind *method = entry->method;
+	if (!function && !method) {
+		return false; // the receiver overrides Object::call()
+	}
+
+	r_err.error = Variant::CallError::CALL_OK;
+	Variant ret;
+	{
+#ifdef DEBUG_ENABLED
+		_ObjectDebugLock debug_lock(obj);
+#endif
+		if (function) {
+			ret = function->call(instance, p_args, p_argcount, r_err);
+		} else {
+			ret = method->call(obj, p_args, p_argcount, r_err);
+		}
+	}
+
+	if (r_err.error == Variant::CallError::CALL_OK && r_ret) {
+		*r_ret = ret;
+	}
+	return true;
+}
+
+// Native properties only, scripts may shadow them or implement _get().
+bool GDScriptFunction::_get_named_cached(CallCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret) {
+
+	Object *obj = *p_base;
+	if (unlikely(!obj) || obj->get_script_instance()) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	if (ScriptDebugger::get_singleton() && !p_base->is_ref() && !ObjectDB::instance_validate(obj)) {
+		return false;
+	}
+#endif
+
+	const StringName &native_class = obj->get_class_name();
+	CallCache::Entry *entry = NULL;
+	for (int i = 0; i < p_cache.used; i++) {
+		if (p_cache.entries[i].native_class == native_class) {
+			entry = &p_cache.entries[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		if (p_cache.used == CALL_CACHE_SIZE) {
+			return false;
+		}
+		int index = -1;
+		MethodBind *getter = ClassDB::get_property_getter_method(native_class, p_name, &index);
+		if (!getter) {
+			return false;
+		}
+		entry = &p_cache.entries[p_cache.used++];
+		entry->native_class = native_class;
+		entry->script = NULL;
+		entry->script_version = 0;
+		entry->function = NULL;
+		entry->method = getter;
+		entry->index = index;
+	}
+
+	Variant::CallError ce;
+	if (entry->index >= 0) {
+		Variant index = entry->index;
+		const Variant *arg[1] = { &index };
+		r_ret = entry->method->call(obj, arg, 1, ce);
+	} else {
+		r_ret = entry->method->call(obj, NULL, 0, ce);
+	}
+	return true;
+}
+
 #ifdef DEBUG_ENABLED
 static String _get_var_type(const Variant *p_type) {
 
@@ -187,12 +353,14 @@ static String _get_var_type(const Variant *p_type) {
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_VALIDATED,          \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
 		&&OPCODE_SET_NAMED,                   \
 		&&OPCODE_GET_NAMED,                   \
+		&&OPCODE_GET_NAMED_VALIDATED,         \
 		&&OPCODE_SET_MEMBER,                  \
 		&&OPCODE_GET_MEMBER,                  \
 		&&OPCODE_ASSIGN,                      \
@@ -209,6 +377,8 @@ static String _get_var_type(const Variant *p_type) {
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_INTERNAL,               \
+		&&OPCODE_CALL_INTERNAL_RETURN,        \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -278,6 +448,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
+	bool use_call_caches = Thread::get_caller_id() == Thread::get_main_id(); //no support for other threads than main for now
 
 	if (p_state) {
 		//use existing (supplied) state (yielded)
@@ -468,6 +639,45 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED) {
+
+				CHECK_SPACE(5);
+
+				int index = _code_ptr[ip + 1];
+				GD_ERR_BREAK(index < 0 || index >= _validated_operators_count);
+				const ValidatedOperator &vop = _validated_operators_ptr[index];
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (likely(a->get_type() == vop.type_a && b->get_type() == vop.type_b)) {
+					vop.evaluator(a, b, dst);
+				} else {
+					//types are not what the parser expected, evaluate as a regular operator
+					bool valid;
+#ifdef DEBUG_ENABLED
+					Variant ret;
+					Variant::evaluate(vop.op, *a, *b, ret, valid);
+					if (!valid) {
+
+						if (ret.get_type() == Variant::STRING) {
+							err_text = ret;
+							err_text += " in operator '" + Variant::get_operator_name(vop.op) + "'.";
+						} else {
+							err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(vop.op) + "'.";
+						}
+						OPCODE_BREAK;
+					}
+					*dst = ret;
+#else
+					Variant::evaluate(vop.op, *a, *b, *dst, valid);
+#endif
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 
 				CHECK_SPACE(4);
@@ -634,24 +844,31 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_GET_NAMED) {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
-				GET_VARIANT_PTR(dst, 3);
+				GET_VARIANT_PTR(dst, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cacheidx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cacheidx < 0 || cacheidx >= _call_caches_count);
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, &valid);
-
+				Variant ret;
 #else
-				*dst = src->get_named(*index, &valid);
+				Variant &ret = *dst;
 #endif
+				if (use_call_caches && src->get_type() == Variant::OBJECT && _get_named_cached(_call_caches_ptr[cacheidx], src, *index, ret)) {
+					valid = true;
+				} else {
+					ret = src->get_named(*index, &valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					if (src->has_method(*index)) {
@@ -663,6 +880,38 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_NAMED_VALIDATED) {
+
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(src, 1);
+				GET_VARIANT_PTR(dst, 3);
+
+				int index = _code_ptr[ip + 2];
+				GD_ERR_BREAK(index < 0 || index >= _validated_getters_count);
+				const ValidatedGetter &vget = _validated_getters_ptr[index];
+
+				if (likely(src->get_type() == vget.base_type)) {
+					vget.getter(src, dst);
+				} else {
+					const StringName *name = &_global_names_ptr[vget.name];
+
+					bool valid;
+#ifdef DEBUG_ENABLED
+					Variant ret = src->get_named(*name, &valid);
+					if (!valid) {
+						err_text = "Invalid get index '" + name->operator String() + "' (on base: '" + _get_var_type(src) + "').";
+						OPCODE_BREAK;
+					}
+					*dst = ret;
+#else
+					*dst = src->get_named(*name, &valid);
+#endif
+				}
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
@@ -1030,20 +1279,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_RETURN)
+			OPCODE(OPCODE_CALL_INTERNAL)
+			OPCODE(OPCODE_CALL_INTERNAL_RETURN)
 			OPCODE(OPCODE_CALL) {
 
-				CHECK_SPACE(4);
-				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
+				CHECK_SPACE(5);
+				int call_op = _code_ptr[ip];
+				bool call_ret = call_op == OPCODE_CALL_RETURN || call_op == OPCODE_CALL_INTERNAL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
 				GET_VARIANT_PTR(base, 2);
 				int nameg = _code_ptr[ip + 3];
+				int cacheidx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cacheidx < 0 || cacheidx >= _call_caches_count);
+
+				Variant::InternalMethod *internal_method = NULL;
+				if (call_op == OPCODE_CALL_INTERNAL || call_op == OPCODE_CALL_INTERNAL_RETURN) {
+					GD_ERR_BREAK(nameg < 0 || nameg >= _internal_methods_count);
+					const InternalMethod &im = _internal_methods_ptr[nameg];
+					if (likely(base->get_type() == im.base_type)) {
+						internal_method = im.method;
+					}
+					nameg = im.name;
+				}
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1061,13 +1325,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
+				Variant *ret = NULL;
 				if (call_ret) {
 
-					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
-				} else {
+					GET_VARIANT_PTR(ret_ptr, argc);
+					ret = ret_ptr;
+				}
+
+				if (internal_method) {
 
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					base->call_internal(internal_method, (const Variant **)argptrs, argc, ret, err);
+				} else if (!use_call_caches || base->get_type() != Variant::OBJECT || !_call_cached(_call_caches_ptr[cacheidx], base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1612,6 +1882,24 @@ StringName GDScriptFunction::get_global_name(int p_idx) const {
 	return global_names[p_idx];
 }
 
+Variant::Operator GDScriptFunction::get_validated_operator(int p_idx) const {
+
+	ERR_FAIL_INDEX_V(p_idx, validated_operators.size(), Variant::OP_MAX);
+	return validated_operators[p_idx].op;
+}
+
+StringName GDScriptFunction::get_validated_getter_name(int p_idx) const {
+
+	ERR_FAIL_INDEX_V(p_idx, validated_getters.size(), "<errgname>");
+	return get_global_name(validated_getters[p_idx].name);
+}
+
+StringName GDScriptFunction::get_internal_method_name(int p_idx) const {
+
+	ERR_FAIL_INDEX_V(p_idx, internal_methods.size(), "<errgname>");
+	return get_global_name(internal_methods[p_idx].name);
+}
+
 int GDScriptFunction::get_default_argument_count() const {
 
 	return _default_arg_count;
@@ -1716,6 +2004,14 @@ GDScriptFunction::GDScriptFunction() :
 
 	_stack_size = 0;
 	_call_size = 0;
+	_validated_operators_ptr = NULL;
+	_validated_operators_count = 0;
+	_validated_getters_ptr = NULL;
+	_validated_getters_count = 0;
+	_internal_methods_ptr = NULL;
+	_internal_methods_count = 0;
+	_call_caches_ptr = NULL;
+	_call_caches_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
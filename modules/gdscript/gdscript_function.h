@@ -141,12 +141,14 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_VALIDATED,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
 		OPCODE_GET,
 		OPCODE_SET_NAMED,
 		OPCODE_GET_NAMED,
+		OPCODE_GET_NAMED_VALIDATED,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
@@ -163,6 +165,8 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_INTERNAL,
+		OPCODE_CALL_INTERNAL_RETURN,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -206,6 +210,50 @@ public:
 		StringName identifier;
 	};
 
+	// Emitted when the parser knows the operand types, checked again at runtime
+	// since typed values aren't guaranteed to keep their type in release builds.
+	struct ValidatedOperator {
+		Variant::ValidatedOperatorEvaluator evaluator;
+		Variant::Operator op;
+		Variant::Type type_a;
+		Variant::Type type_b;
+	};
+
+	struct ValidatedGetter {
+		Variant::ValidatedGetter getter;
+		Variant::Type base_type;
+		int name;
+	};
+
+	struct InternalMethod {
+		Variant::InternalMethod *method;
+		Variant::Type base_type;
+		int name;
+	};
+
+	enum {
+		CALL_CACHE_SIZE = 4
+	};
+
+	// What a call or named get on an object resolved to last time at one call site,
+	// keyed on the receiver's native class and script. Only used from the main thread.
+	struct CallCache {
+
+		struct Entry {
+			StringName native_class;
+			GDScript *script;
+			uint32_t script_version;
+			GDScriptFunction *function;
+			MethodBind *method;
+			int index;
+		};
+
+		Entry entries[CALL_CACHE_SIZE];
+		int used;
+
+		CallCache() { used = 0; }
+	};
+
 private:
 	friend class GDScriptCompiler;
 
@@ -220,6 +268,14 @@ private:
 	const StringName *_named_globals_ptr;
 	int _named_globals_count;
 #endif
+	const ValidatedOperator *_validated_operators_ptr;
+	int _validated_operators_count;
+	const ValidatedGetter *_validated_getters_ptr;
+	int _validated_getters_count;
+	const InternalMethod *_internal_methods_ptr;
+	int _internal_methods_count;
+	CallCache *_call_caches_ptr;
+	int _call_caches_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
 	const int *_code_ptr;
@@ -239,6 +295,10 @@ private:
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
+	Vector<ValidatedOperator> validated_operators;
+	Vector<ValidatedGetter> validated_getters;
+	Vector<InternalMethod> internal_methods;
+	Vector<CallCache> call_caches;
 	Vector<int> default_arguments;
 	Vector<int> code;
 	Vector<GDScriptDataType> argument_types;
@@ -253,6 +313,11 @@ private:
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	static uint32_t call_cache_version;
+	static bool _resolve_call(CallCache::Entry &r_entry, const StringName &p_native_class, GDScript *p_script, const StringName &p_method);
+	bool _call_cached(CallCache &p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err);
+	bool _get_named_cached(CallCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret);
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list;
@@ -297,6 +362,9 @@ public:
 	int get_code_size() const;
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
+	Variant::Operator get_validated_operator(int p_idx) const;
+	StringName get_validated_getter_name(int p_idx) const;
+	StringName get_internal_method_name(int p_idx) const;
 	StringName get_name() const;
 	int get_max_stack_size() const;
 	int get_default_argument_count() const;
@@ -327,6 +395,10 @@ public:
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Variant::CallError &r_err, CallState *p_state = NULL);
 
 	_FORCE_INLINE_ MultiplayerAPI::RPCMode get_rpc_mode() const { return rpc_mode; }
+
+	// Script functions are about to be freed, drop every cached call that may point to them.
+	static void invalidate_call_caches();
+
 	GDScriptFunction();
 	~GDScriptFunction();
 };
@@ -104,9 +104,18 @@ Error jpeg_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer, int p
 
 Error ImageLoaderJPG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
 
-	PoolVector<uint8_t> src_image;
 	int src_image_len = f->get_len();
 	ERR_FAIL_COND_V(src_image_len == 0, ERR_FILE_CORRUPT);
+
+	const uint8_t *mapped = f->get_buffer_ptr(src_image_len);
+	if (mapped) {
+		// the file is already in memory, decode from it without a copy
+		Error err = jpeg_load_image_from_buffer(p_image.ptr(), mapped, src_image_len);
+		f->close();
+		return err;
+	}
+
+	PoolVector<uint8_t> src_image;
 	src_image.resize(src_image_len);
 
 	PoolVector<uint8_t>::Write w = src_image.write();
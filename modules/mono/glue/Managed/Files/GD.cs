@@ -50,7 +50,7 @@ namespace Godot
             return godot_icall_GD_hash(var);
         }
 
-        public static Object InstanceFromId(int instanceId)
+        public static Object InstanceFromId(ulong instanceId)
         {
             return godot_icall_GD_instance_from_id(instanceId);
         }
@@ -214,7 +214,7 @@ namespace Godot
         internal extern static int godot_icall_GD_hash(object var);
 
         [MethodImpl(MethodImplOptions.InternalCall)]
-        internal extern static Object godot_icall_GD_instance_from_id(int instance_id);
+        internal extern static Object godot_icall_GD_instance_from_id(ulong instance_id);
 
         [MethodImpl(MethodImplOptions.InternalCall)]
         internal extern static void godot_icall_GD_print(object[] what);
@@ -41,7 +41,7 @@ MonoObject *godot_icall_GD_convert(MonoObject *p_what, int p_type);
 
 int godot_icall_GD_hash(MonoObject *p_var);
 
-MonoObject *godot_icall_GD_instance_from_id(int p_instance_id);
+MonoObject *godot_icall_GD_instance_from_id(uint64_t p_instance_id);
 
 void godot_icall_GD_print(MonoArray *p_what);
 
@@ -30,6 +30,8 @@
 
 #include "image_compress_squish.h"
 
+#include "core/os/threaded_array_processor.h"
+
 #include <squish.h>
 
 void image_decompress_squish(Image *p_image) {
@@ -75,6 +77,26 @@ void image_decompress_squish(Image *p_image) {
 }
 
 #ifdef TOOLS_ENABLED
+
+// Rows of pixels compressed by a single task, a multiple of the block size.
+#define SQUISH_BAND_ROWS 32
+
+struct SquishCompressBand {
+	const uint8_t *src;
+	uint8_t *dst;
+	int width;
+	int height;
+};
+
+struct SquishCompressJob {
+	int flags;
+
+	void compress_band(uint32_t p_index, const SquishCompressBand *p_bands) {
+		const SquishCompressBand &band = p_bands[p_index];
+		squish::CompressImage(band.src, band.width, band.height, band.dst, flags);
+	}
+};
+
 void image_compress_squish(Image *p_image, float p_lossy_quality, Image::CompressSource p_source) {
 
 	if (p_image->get_format() >= Image::FORMAT_DXT1)
@@ -184,6 +206,11 @@ void image_compress_squish(Image *p_image, float p_lossy_quality, Image::Compres
 		PoolVector<uint8_t>::Write wb = data.write();
 
 		int dst_ofs = 0;
+		int block_size = (squish_comp & (squish::kDxt1 | squish::kBc4)) ? 8 : 16;
+
+		// Blocks are independent, so every mipmap is split in bands of block
+		// rows that are compressed in parallel.
+		Vector<SquishCompressBand> bands;
 
 		for (int i = 0; i <= mm_count; i++) {
 
@@ -191,12 +218,25 @@ void image_compress_squish(Image *p_image, float p_lossy_quality, Image::Compres
 			int bh = h % 4 != 0 ? h + (4 - h % 4) : h;
 
 			int src_ofs = p_image->get_mipmap_offset(i);
-			squish::CompressImage(&rb[src_ofs], w, h, &wb[dst_ofs], squish_comp);
+
+			for (int y = 0; y < h; y += SQUISH_BAND_ROWS) {
+				SquishCompressBand band;
+				band.src = &rb[src_ofs + y * w * 4];
+				band.dst = &wb[dst_ofs + (y / 4) * (MAX(4, bw) / 4) * block_size];
+				band.width = w;
+				band.height = MIN(SQUISH_BAND_ROWS, h - y);
+				bands.push_back(band);
+			}
+
 			dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
 			w = MAX(w / 2, 1);
 			h = MAX(h / 2, 1);
 		}
 
+		SquishCompressJob job;
+		job.flags = squish_comp;
+		thread_process_array(bands.size(), &job, &SquishCompressJob::compress_band, bands.ptr());
+
 		rb = PoolVector<uint8_t>::Read();
 		wb = PoolVector<uint8_t>::Write();
 
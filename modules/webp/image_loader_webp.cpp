@@ -75,11 +75,11 @@ static PoolVector<uint8_t> _webp_lossy_pack(const Ref<Image> &p_image, float p_q
 	return dst;
 }
 
-static Ref<Image> _webp_lossy_unpack(const PoolVector<uint8_t> &p_buffer) {
+static Ref<Image> _webp_lossy_unpack_memory(const uint8_t *p_buffer, int p_size) {
 
-	int size = p_buffer.size() - 4;
+	int size = p_size - 4;
 	ERR_FAIL_COND_V(size <= 0, Ref<Image>());
-	PoolVector<uint8_t>::Read r = p_buffer.read();
+	const uint8_t *r = p_buffer;
 
 	ERR_FAIL_COND_V(r[0] != 'W' || r[1] != 'E' || r[2] != 'B' || r[3] != 'P', Ref<Image>());
 	WebPBitstreamFeatures features;
@@ -116,6 +116,12 @@ static Ref<Image> _webp_lossy_unpack(const PoolVector<uint8_t> &p_buffer) {
 	return img;
 }
 
+static Ref<Image> _webp_lossy_unpack(const PoolVector<uint8_t> &p_buffer) {
+
+	PoolVector<uint8_t>::Read r = p_buffer.read();
+	return _webp_lossy_unpack_memory(r.ptr(), p_buffer.size());
+}
+
 Error webp_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer, int p_buffer_len) {
 
 	ERR_FAIL_NULL_V(p_image, ERR_INVALID_PARAMETER);
@@ -158,9 +164,18 @@ static Ref<Image> _webp_mem_loader_func(const uint8_t *p_png, int p_size) {
 
 Error ImageLoaderWEBP::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
 
-	PoolVector<uint8_t> src_image;
 	int src_image_len = f->get_len();
 	ERR_FAIL_COND_V(src_image_len == 0, ERR_FILE_CORRUPT);
+
+	const uint8_t *mapped = f->get_buffer_ptr(src_image_len);
+	if (mapped) {
+		// the file is already in memory, decode from it without a copy
+		Error err = webp_load_image_from_buffer(p_image.ptr(), mapped, src_image_len);
+		f->close();
+		return err;
+	}
+
+	PoolVector<uint8_t> src_image;
 	src_image.resize(src_image_len);
 
 	PoolVector<uint8_t>::Write w = src_image.write();
@@ -185,4 +200,5 @@ ImageLoaderWEBP::ImageLoaderWEBP() {
 	Image::_webp_mem_loader_func = _webp_mem_loader_func;
 	Image::lossy_packer = _webp_lossy_pack;
 	Image::lossy_unpacker = _webp_lossy_unpack;
+	Image::lossy_memory_unpacker = _webp_lossy_unpack_memory;
 }
@@ -41,6 +41,7 @@
 #endif
 
 #include "drivers/unix/net_socket_posix.h"
+#include "lws_server.h"
 
 void LWSPeer::set_wsi(struct lws *p_wsi, unsigned int p_in_buf_size, unsigned int p_in_pkt_size, unsigned int p_out_buf_size, unsigned int p_out_pkt_size) {
 	ERR_FAIL_COND(wsi != NULL);
@@ -48,9 +49,33 @@ void LWSPeer::set_wsi(struct lws *p_wsi, unsigned int p_in_buf_size, unsigned in
 	_in_buffer.resize(p_in_pkt_size, p_in_buf_size);
 	_out_buffer.resize(p_out_pkt_size, p_out_buf_size);
 	_packet_buffer.resize((1 << MAX(p_in_buf_size, p_out_buf_size)) + LWS_PRE);
+	_write_buffer.resize((1 << p_out_buf_size) + LWS_PRE);
 	wsi = p_wsi;
+
+	// Cached, the socket can't be queried from other threads.
+	connected_host = IP_Address();
+	connected_port = 0;
+
+	struct sockaddr_storage addr;
+	socklen_t len = sizeof(addr);
+
+	int fd = lws_get_socket_fd(wsi);
+	if (fd != -1 && getpeername(fd, (struct sockaddr *)&addr, &len) == 0) {
+		NetSocketPosix::_set_ip_port(&addr, connected_host, connected_port);
+	}
+
+	zeromem(&stats, sizeof(stats));
+	pending_reads = 0;
+	pending_writes = 0;
 };
 
+void LWSPeer::set_thread_server(LWSServer *p_server, int32_t p_peer_id) {
+
+	thread_server = p_server;
+	thread_peer_id = p_peer_id;
+	thread_closing = false;
+}
+
 void LWSPeer::set_write_mode(WriteMode p_mode) {
 	write_mode = p_mode;
 }
@@ -61,7 +86,7 @@ LWSPeer::WriteMode LWSPeer::get_write_mode() const {
 
 Error LWSPeer::read_wsi(void *in, size_t len) {
 
-	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
+	ERR_FAIL_COND_V(wsi == NULL, FAILED);
 
 	if (lws_is_first_fragment(wsi))
 		_in_size = 0;
@@ -73,6 +98,7 @@ Error LWSPeer::read_wsi(void *in, size_t len) {
 	if (err != OK) {
 		_in_buffer.discard_payload(_in_size);
 		_in_size = -1;
+		atomic_increment(&stats.dropped_in);
 		ERR_FAIL_V(err);
 	}
 
@@ -84,8 +110,11 @@ Error LWSPeer::read_wsi(void *in, size_t len) {
 		if (err != OK) {
 			_in_buffer.discard_payload(_in_size);
 			_in_size = -1;
+			atomic_increment(&stats.dropped_in);
 			ERR_FAIL_V(err);
 		}
+		atomic_increment(&stats.packets_in);
+		atomic_add(&stats.bytes_in, (uint64_t)_in_size);
 	}
 
 	return OK;
@@ -93,23 +122,37 @@ Error LWSPeer::read_wsi(void *in, size_t len) {
 
 Error LWSPeer::write_wsi() {
 
-	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
+	ERR_FAIL_COND_V(wsi == NULL, FAILED);
 
-	PoolVector<uint8_t> tmp;
 	int count = _out_buffer.packets_left();
 
 	if (count == 0)
 		return OK;
 
-	int read = 0;
-	uint8_t is_string;
-	PoolVector<uint8_t>::Write rw = _packet_buffer.write();
-	_out_buffer.read_packet(&(rw[LWS_PRE]), _packet_buffer.size() - LWS_PRE, &is_string, read);
+	uint8_t *w = _write_buffer.ptrw();
 
-	enum lws_write_protocol mode = is_string ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
-	lws_write(wsi, &(rw[LWS_PRE]), read, mode);
+	// Send everything queued while the socket takes it, rather than one packet per writable callback.
+	// The first write is always allowed, lws keeps what the kernel didn't take and reports the pipe as choked.
+	for (int i = 0; i < count; i++) {
 
-	if (count > 1)
+		if (i > 0 && lws_send_pipe_choked(wsi)) {
+			atomic_increment(&stats.choked);
+			break;
+		}
+
+		int read = 0;
+		uint8_t is_string;
+		_out_buffer.read_packet(&w[LWS_PRE], _write_buffer.size() - LWS_PRE, &is_string, read);
+
+		enum lws_write_protocol mode = is_string ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
+		if (lws_write(wsi, &w[LWS_PRE], read, mode) < 0)
+			return FAILED; // lws closes the connection
+
+		atomic_increment(&stats.packets_out);
+		atomic_add(&stats.bytes_out, (uint64_t)read);
+	}
+
+	if (_out_buffer.packets_left() > 0)
 		lws_callback_on_writable(wsi); // we want to write more!
 
 	return OK;
@@ -120,8 +163,18 @@ Error LWSPeer::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
 	uint8_t is_string = write_mode == WRITE_MODE_TEXT;
-	_out_buffer.write_packet(p_buffer, p_buffer_size, &is_string);
-	lws_callback_on_writable(wsi); // notify that we want to write
+	Error err = _out_buffer.write_packet(p_buffer, p_buffer_size, &is_string);
+	if (err != OK) {
+		atomic_increment(&stats.dropped_out);
+		return err;
+	}
+	atomic_exchange_if_greater(&stats.peak_queued_out, (uint32_t)_out_buffer.packets_left());
+
+	if (thread_server) {
+		thread_server->_request_write(this, thread_peer_id);
+	} else {
+		lws_callback_on_writable(wsi); // notify that we want to write
+	}
 	return OK;
 };
 
@@ -159,9 +212,26 @@ bool LWSPeer::was_string_packet() const {
 
 bool LWSPeer::is_connected_to_host() const {
 
-	return wsi != NULL;
+	return wsi != NULL && !thread_closing;
 };
 
+Dictionary LWSPeer::get_stats() const {
+
+	Dictionary d;
+	d["packets_in"] = atomic_load_acquire(&stats.packets_in);
+	d["packets_out"] = atomic_load_acquire(&stats.packets_out);
+	d["bytes_in"] = atomic_load_acquire(&stats.bytes_in);
+	d["bytes_out"] = atomic_load_acquire(&stats.bytes_out);
+	d["dropped_in"] = atomic_load_acquire(&stats.dropped_in);
+	d["dropped_out"] = atomic_load_acquire(&stats.dropped_out);
+	d["queued_in"] = _in_buffer.packets_left();
+	d["queued_out"] = _out_buffer.packets_left();
+	d["queued_out_bytes"] = _out_buffer.payload_left();
+	d["peak_queued_out"] = atomic_load_acquire(&stats.peak_queued_out);
+	d["choked"] = atomic_load_acquire(&stats.choked);
+	return d;
+}
+
 String LWSPeer::get_close_reason(void *in, size_t len, int &r_code) {
 	String s;
 	r_code = 0;
@@ -195,6 +265,18 @@ void LWSPeer::send_close_status(struct lws *p_wsi) {
 }
 
 void LWSPeer::close(int p_code, String p_reason) {
+	if (thread_server) {
+		// The network thread still uses the wsi and the buffers, it closes the connection and the
+		// server calls release_wsi() once it's gone.
+		if (wsi != NULL && !thread_closing) {
+			close_code = p_code;
+			close_reason = p_reason;
+			thread_closing = true;
+			thread_server->_request_close(thread_peer_id);
+		}
+		return;
+	}
+
 	if (wsi != NULL) {
 		close_code = p_code;
 		close_reason = p_reason;
@@ -207,58 +289,53 @@ void LWSPeer::close(int p_code, String p_reason) {
 		close_reason = "";
 	}
 	wsi = NULL;
+	_clear();
+};
+
+void LWSPeer::release_wsi() {
+
+	wsi = NULL;
+	thread_server = NULL;
+	thread_closing = false;
+	close_code = -1;
+	close_reason = "";
+	_clear();
+}
+
+void LWSPeer::_clear() {
+
 	_in_buffer.clear();
 	_out_buffer.clear();
 	_in_size = 0;
 	_is_string = 0;
 	_packet_buffer.resize(0);
-};
+	_write_buffer.resize(0);
+}
 
 IP_Address LWSPeer::get_connected_host() const {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), IP_Address());
 
-	IP_Address ip;
-	uint16_t port = 0;
-
-	struct sockaddr_storage addr;
-	socklen_t len = sizeof(addr);
-
-	int fd = lws_get_socket_fd(wsi);
-	ERR_FAIL_COND_V(fd == -1, IP_Address());
-
-	int ret = getpeername(fd, (struct sockaddr *)&addr, &len);
-	ERR_FAIL_COND_V(ret != 0, IP_Address());
-
-	NetSocketPosix::_set_ip_port(&addr, ip, port);
-
-	return ip;
+	return connected_host;
 };
 
 uint16_t LWSPeer::get_connected_port() const {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), 0);
 
-	IP_Address ip;
-	uint16_t port = 0;
-
-	struct sockaddr_storage addr;
-	socklen_t len = sizeof(addr);
-
-	int fd = lws_get_socket_fd(wsi);
-	ERR_FAIL_COND_V(fd == -1, 0);
-
-	int ret = getpeername(fd, (struct sockaddr *)&addr, &len);
-	ERR_FAIL_COND_V(ret != 0, 0);
-
-	NetSocketPosix::_set_ip_port(&addr, ip, port);
-
-	return port;
+	return connected_port;
 };
 
 LWSPeer::LWSPeer() {
 	wsi = NULL;
 	write_mode = WRITE_MODE_BINARY;
+	thread_server = NULL;
+	thread_peer_id = 0;
+	thread_closing = false;
+	connected_port = 0;
+	pending_reads = 0;
+	pending_writes = 0;
+	zeromem(&stats, sizeof(stats));
 	close();
 };
 
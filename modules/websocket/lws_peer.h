@@ -41,6 +41,8 @@
 #include "packet_buffer.h"
 #include "websocket_peer.h"
 
+class LWSServer;
+
 class LWSPeer : public WebSocketPeer {
 
 	GDCIIMPL(LWSPeer, WebSocketPeer);
@@ -53,6 +55,7 @@ private:
 	PacketBuffer<uint8_t> _out_buffer;
 
 	PoolVector<uint8_t> _packet_buffer;
+	Vector<uint8_t> _write_buffer;
 
 	struct lws *wsi;
 	WriteMode write_mode;
@@ -60,6 +63,29 @@ private:
 	int close_code;
 	String close_reason;
 
+	IP_Address connected_host;
+	uint16_t connected_port;
+
+	// Set while the peer is serviced by a server network thread. The wsi then belongs to that thread,
+	// requests are forwarded to the server instead of calling lws directly.
+	LWSServer *thread_server;
+	int32_t thread_peer_id;
+	bool thread_closing;
+
+	// Written by the thread that produces the data, read anywhere.
+	struct Stats {
+		volatile uint32_t packets_in;
+		volatile uint32_t packets_out;
+		volatile uint64_t bytes_in;
+		volatile uint64_t bytes_out;
+		volatile uint32_t dropped_in;
+		volatile uint32_t dropped_out;
+		volatile uint32_t peak_queued_out;
+		volatile uint32_t choked;
+	} stats;
+
+	void _clear();
+
 public:
 	struct PeerData {
 		uint32_t peer_id;
@@ -67,6 +93,10 @@ public:
 		bool clean_close;
 	};
 
+	// Notifications between the network thread and the main thread, see LWSServer.
+	volatile uint32_t pending_reads;
+	volatile uint32_t pending_writes;
+
 	virtual int get_available_packet_count() const;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size);
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size);
@@ -80,12 +110,16 @@ public:
 	virtual WriteMode get_write_mode() const;
 	virtual void set_write_mode(WriteMode p_mode);
 	virtual bool was_string_packet() const;
+	virtual Dictionary get_stats() const;
 
 	void set_wsi(struct lws *wsi, unsigned int _in_buf_size, unsigned int _in_pkt_size, unsigned int _out_buf_size, unsigned int _out_pkt_size);
+	void set_thread_server(LWSServer *p_server, int32_t p_peer_id);
+	struct lws *get_wsi() const { return wsi; }
 	Error read_wsi(void *in, size_t len);
 	Error write_wsi();
 	void send_close_status(struct lws *wsi);
 	String get_close_reason(void *in, size_t len, int &r_code);
+	void release_wsi();
 
 	LWSPeer();
 	~LWSPeer();
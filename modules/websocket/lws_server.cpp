@@ -62,9 +62,23 @@ Error LWSServer::listen(int p_port, PoolVector<String> p_protocols, bool gd_mp_a
 		ERR_FAIL_V(FAILED);
 	}
 
+	if (threaded)
+		_start_thread();
+
 	return OK;
 }
 
+void LWSServer::poll() {
+
+	if (_threaded_service) {
+		_process_events();
+		if (commands_queued && _threaded_service)
+			_wake_thread();
+	} else {
+		_lws_poll();
+	}
+}
+
 bool LWSServer::is_listening() const {
 	return context != NULL;
 }
@@ -77,6 +91,9 @@ int LWSServer::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 
 	LWSPeer::PeerData *peer_data = (LWSPeer::PeerData *)user;
 
+	if (_threaded_service)
+		return _handle_thread_cb(wsi, reason, peer_data, in, len);
+
 	switch (reason) {
 		case LWS_CALLBACK_HTTP:
 			// no http for now
@@ -161,10 +178,308 @@ int LWSServer::_handle_cb(struct lws *wsi, enum lws_callback_reasons reason, voi
 	return 0;
 }
 
+int LWSServer::_handle_thread_cb(struct lws *wsi, enum lws_callback_reasons reason, LWSPeer::PeerData *peer_data, void *in, size_t len) {
+
+	// Runs on the network thread, the main thread only sees the events queued here.
+	switch (reason) {
+		case LWS_CALLBACK_HTTP:
+			return -1;
+
+		case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+			_run_commands();
+			break;
+
+		case LWS_CALLBACK_ESTABLISHED: {
+			int32_t id = _gen_unique_id();
+
+			Ref<LWSPeer> peer = Ref<LWSPeer>(memnew(LWSPeer));
+			peer->set_wsi(wsi, _in_buf_size, _in_pkt_size, _out_buf_size, _out_pkt_size);
+			peer->set_thread_server(this, id);
+			_thread_peers[id] = peer;
+
+			peer_data->peer_id = id;
+			peer_data->force_close = false;
+			peer_data->clean_close = false;
+
+			Event event;
+			event.type = Event::CONNECT;
+			event.peer_id = id;
+			event.peer = peer;
+			event.text = lws_get_protocol(wsi)->name;
+			_push_event(event);
+			break;
+		}
+
+		case LWS_CALLBACK_WS_PEER_INITIATED_CLOSE: {
+			if (peer_data == NULL)
+				return 0;
+
+			int32_t id = peer_data->peer_id;
+			if (_thread_peers.has(id)) {
+				Event event;
+				event.type = Event::CLOSE_REQUEST;
+				event.peer_id = id;
+				event.text = _thread_peers[id]->get_close_reason(in, len, event.code);
+				peer_data->clean_close = true;
+				_push_event(event);
+			}
+			return 0;
+		}
+
+		case LWS_CALLBACK_CLOSED: {
+			if (peer_data == NULL)
+				return 0;
+
+			int32_t id = peer_data->peer_id;
+			if (_thread_peers.has(id)) {
+				_thread_peers.erase(id);
+
+				Event event;
+				event.type = Event::DISCONNECT;
+				event.peer_id = id;
+				event.was_clean = peer_data->clean_close;
+				_push_event(event);
+			}
+			return 0;
+		}
+
+		case LWS_CALLBACK_RECEIVE: {
+			int32_t id = peer_data->peer_id;
+			Map<int32_t, Ref<LWSPeer> >::Element *E = _thread_peers.find(id);
+			if (!E)
+				break;
+
+			LWSPeer *peer = E->get().ptr();
+			if (peer->read_wsi(in, len) == OK && lws_is_final_fragment(wsi)) {
+				// Only the first unread packet needs an event, see _process_events().
+				if (atomic_increment(&peer->pending_reads) == 1) {
+					Event event;
+					event.type = Event::RECEIVE;
+					event.peer_id = id;
+					_push_event(event);
+				}
+			}
+			break;
+		}
+
+		case LWS_CALLBACK_SERVER_WRITEABLE: {
+			Map<int32_t, Ref<LWSPeer> >::Element *E = _thread_peers.find(peer_data->peer_id);
+
+			if (peer_data->force_close) {
+				if (E)
+					E->get()->send_close_status(wsi);
+				return -1;
+			}
+
+			if (E)
+				E->get()->write_wsi();
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+void LWSServer::_thread_func(void *p_udata) {
+
+	LWSServer *server = (LWSServer *)p_udata;
+
+	while (!atomic_load_acquire(&server->thread_exit)) {
+		lws_service(server->context, THREAD_SERVICE_TIMEOUT);
+	}
+}
+
+void LWSServer::_start_thread() {
+
+	thread_commands.resize(THREAD_QUEUE_SIZE);
+	thread_events.resize(THREAD_QUEUE_SIZE);
+	thread_exit = 0;
+	wake_requests = 0;
+	commands_queued = false;
+	_threaded_service = true;
+	thread = Thread::create(_thread_func, this);
+}
+
+void LWSServer::_stop_thread() {
+
+	if (!thread)
+		return;
+
+	atomic_store_release(&thread_exit, 1);
+	lws_cancel_service(context);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+	_threaded_service = false;
+
+	// The peers are not serviced anymore, detach them so they don't forward anything to us.
+	Event event;
+	while (thread_events.read(event)) {
+		if (event.type == Event::CONNECT)
+			event.peer->release_wsi();
+	}
+
+	for (Map<int32_t, Ref<LWSPeer> >::Element *E = _thread_peers.front(); E; E = E->next()) {
+		E->get()->release_wsi();
+	}
+	_thread_peers.clear();
+
+	for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
+		static_cast<Ref<LWSPeer> >(E->get())->release_wsi();
+	}
+
+	Command command;
+	while (thread_commands.read(command)) {
+		// Dropped, the connections are going away.
+	}
+}
+
+void LWSServer::_push_command(Command::Type p_type, int32_t p_peer_id) {
+
+	Command command;
+	command.type = p_type;
+	command.peer_id = p_peer_id;
+
+	while (!thread_commands.write(command)) {
+		_wake_thread();
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	// Sent on the next poll(), like the polled server which only writes while polling.
+	commands_queued = true;
+}
+
+void LWSServer::_wake_thread() {
+
+	commands_queued = false;
+
+	// Wakes the network thread once until it has run the queued commands.
+	if (atomic_increment(&wake_requests) == 1)
+		lws_cancel_service(context);
+}
+
+void LWSServer::_run_commands() {
+
+	// Runs everything queued before the wake requests seen so far. Requests made meanwhile keep the
+	// counter above zero, so they are run by the next pass instead of waking the thread again.
+	uint32_t requests = atomic_load_acquire(&wake_requests);
+
+	while (true) {
+
+		Command command;
+		while (thread_commands.read(command)) {
+
+			Map<int32_t, Ref<LWSPeer> >::Element *E = _thread_peers.find(command.peer_id);
+			if (!E)
+				continue; // Already closed
+
+			LWSPeer *peer = E->get().ptr();
+			struct lws *wsi = peer->get_wsi();
+
+			switch (command.type) {
+				case Command::WRITE: {
+					// Packets queued after this reset send a new request.
+					uint32_t writes = atomic_load_acquire(&peer->pending_writes);
+					while (writes) {
+						writes = atomic_sub(&peer->pending_writes, writes);
+					}
+					lws_callback_on_writable(wsi);
+				} break;
+
+				case Command::CLOSE: {
+					LWSPeer::PeerData *data = (LWSPeer::PeerData *)lws_wsi_user(wsi);
+					data->force_close = true;
+					data->clean_close = true;
+					lws_callback_on_writable(wsi); // Notify that we want to disconnect
+				} break;
+			}
+		}
+
+		if (requests == 0)
+			break;
+
+		requests = atomic_sub(&wake_requests, requests);
+	}
+}
+
+void LWSServer::_push_event(const Event &p_event) {
+
+	// Stalls the connections until the main thread catches up.
+	while (!thread_events.write(p_event)) {
+		if (atomic_load_acquire(&thread_exit))
+			return;
+		OS::get_singleton()->delay_usec(1000);
+	}
+}
+
+void LWSServer::_process_events() {
+
+	Event event;
+	while (thread_events.read(event)) {
+
+		int32_t id = event.peer_id;
+
+		switch (event.type) {
+			case Event::CONNECT: {
+				_peer_map[id] = event.peer;
+				_on_connect(id, event.text);
+			} break;
+
+			case Event::RECEIVE: {
+				if (!_peer_map.has(id))
+					break;
+
+				Ref<LWSPeer> peer = _peer_map[id];
+
+				// Each notification is a packet. They keep coming while the count is not back to zero,
+				// but without new events.
+				uint32_t count = atomic_load_acquire(&peer->pending_reads);
+				while (count) {
+					for (uint32_t i = 0; i < count && peer->is_connected_to_host(); i++) {
+						_on_peer_packet(id);
+					}
+					count = atomic_sub(&peer->pending_reads, count);
+				}
+			} break;
+
+			case Event::CLOSE_REQUEST: {
+				if (_peer_map.has(id))
+					_on_close_request(id, event.code, event.text);
+			} break;
+
+			case Event::DISCONNECT: {
+				if (_peer_map.has(id)) {
+					static_cast<Ref<LWSPeer> >(_peer_map[id])->release_wsi();
+					_peer_map.erase(id);
+				}
+				_on_disconnect(id, event.was_clean);
+			} break;
+		}
+
+		if (!_threaded_service)
+			break; // Stopped from a signal
+	}
+}
+
+void LWSServer::_request_write(LWSPeer *p_peer, int32_t p_peer_id) {
+
+	if (atomic_increment(&p_peer->pending_writes) == 1)
+		_push_command(Command::WRITE, p_peer_id);
+}
+
+void LWSServer::_request_close(int32_t p_peer_id) {
+
+	_push_command(Command::CLOSE, p_peer_id);
+}
+
 void LWSServer::stop() {
 	if (context == NULL)
 		return;
 
+	_stop_thread();
 	_peer_map.clear();
 	destroy_context();
 	context = NULL;
@@ -204,9 +519,15 @@ LWSServer::LWSServer() {
 	_out_pkt_size = nearest_shift((int)GLOBAL_GET(WSS_OUT_PKT) - 1);
 	context = NULL;
 	_lws_ref = NULL;
+	_threaded_service = false;
+	thread = NULL;
+	thread_exit = 0;
+	wake_requests = 0;
+	commands_queued = false;
 }
 
 LWSServer::~LWSServer() {
+	_stop_thread();
 	invalidate_lws_ref(); // we do not want any more callbacks
 	stop();
 }
@@ -33,7 +33,9 @@
 
 #ifndef JAVASCRIPT_ENABLED
 
+#include "core/os/thread.h"
 #include "core/reference.h"
+#include "core/spsc_ring_buffer.h"
 #include "lws_helper.h"
 #include "lws_peer.h"
 #include "websocket_server.h"
@@ -51,7 +53,71 @@ private:
 	int _out_buf_size;
 	int _out_pkt_size;
 
+	// Threaded mode: lws is serviced on its own thread and only ever called from it. The main thread
+	// queues commands to it and receives events from it, peer packets go through the lock-free peer
+	// buffers. Requests are coalesced, a peer has at most one write and one receive notification queued,
+	// and the thread is woken up once per poll() for everything queued since the previous one.
+	enum {
+		THREAD_QUEUE_SIZE = 14, // power of two, one pending notification per peer fits
+		THREAD_SERVICE_TIMEOUT = 100, // ms, commands wake the thread up anyway
+	};
+
+	struct Command {
+		enum Type {
+			WRITE,
+			CLOSE,
+		};
+
+		Type type;
+		int32_t peer_id;
+	};
+
+	struct Event {
+		enum Type {
+			CONNECT,
+			RECEIVE,
+			CLOSE_REQUEST,
+			DISCONNECT,
+		};
+
+		Type type;
+		int32_t peer_id;
+		Ref<LWSPeer> peer; // CONNECT
+		int code; // CLOSE_REQUEST
+		bool was_clean; // DISCONNECT
+		String text; // Protocol on CONNECT, reason on CLOSE_REQUEST
+
+		Event() {
+			type = CONNECT;
+			peer_id = 0;
+			code = 0;
+			was_clean = false;
+		}
+	};
+
+	bool _threaded_service;
+	Thread *thread;
+	volatile uint32_t thread_exit;
+	volatile uint32_t wake_requests;
+	bool commands_queued;
+	SPSCRingBuffer<Command> thread_commands;
+	SPSCRingBuffer<Event> thread_events;
+	Map<int32_t, Ref<LWSPeer> > _thread_peers; // Only used by the network thread
+
+	static void _thread_func(void *p_udata);
+	void _start_thread();
+	void _stop_thread();
+	void _push_command(Command::Type p_type, int32_t p_peer_id);
+	void _wake_thread();
+	void _run_commands();
+	void _push_event(const Event &p_event);
+	void _process_events();
+	int _handle_thread_cb(struct lws *wsi, enum lws_callback_reasons reason, LWSPeer::PeerData *peer_data, void *in, size_t len);
+
 public:
+	void _request_write(LWSPeer *p_peer, int32_t p_peer_id);
+	void _request_close(int32_t p_peer_id);
+
 	Error listen(int p_port, PoolVector<String> p_protocols = PoolVector<String>(), bool gd_mp_api = false);
 	void stop();
 	bool is_listening() const;
@@ -61,7 +127,7 @@ public:
 	IP_Address get_peer_address(int p_peer_id) const;
 	int get_peer_port(int p_peer_id) const;
 	void disconnect_peer(int p_peer_id, int p_code = 1000, String p_reason = "");
-	virtual void poll() { _lws_poll(); }
+	virtual void poll();
 
 	LWSServer();
 	~LWSServer();
@@ -32,7 +32,10 @@
 #define PACKET_BUFFER_H
 
 #include "core/os/copymem.h"
-#include "core/ring_buffer.h"
+#include "core/spsc_ring_buffer.h"
+
+// Packets are only published once their payload is written, so one thread can write packets while
+// another one reads them.
 
 template <class T>
 class PacketBuffer {
@@ -43,8 +46,8 @@ private:
 		T info;
 	} _Packet;
 
-	RingBuffer<_Packet> _packets;
-	RingBuffer<uint8_t> _payload;
+	SPSCRingBuffer<_Packet> _packets;
+	SPSCRingBuffer<uint8_t> _payload;
 
 public:
 	Error write_packet(const uint8_t *p_payload, uint32_t p_size, const T *p_info) {
@@ -63,6 +66,11 @@ public:
 		ERR_FAIL_COND_V(p_info && _packets.space_left() < 1, ERR_OUT_OF_MEMORY);
 #endif
 
+		// If p_payload is NULL, only the packet information is written.
+		if (p_payload) {
+			_payload.write((const uint8_t *)p_payload, p_size);
+		}
+
 		// If p_info is NULL, only the payload is written
 		if (p_info) {
 			_Packet p;
@@ -71,29 +79,24 @@ public:
 			_packets.write(p);
 		}
 
-		// If p_payload is NULL, only the packet information is written.
-		if (p_payload) {
-			_payload.write((const uint8_t *)p_payload, p_size);
-		}
-
 		return OK;
 	}
 
 	Error read_packet(uint8_t *r_payload, int p_bytes, T *r_info, int &r_read) {
 		ERR_FAIL_COND_V(_packets.data_left() < 1, ERR_UNAVAILABLE);
-		_Packet p;
-		_packets.read(&p, 1);
+		_Packet p = *_packets.peek();
 		ERR_FAIL_COND_V(_payload.data_left() < p.size, ERR_BUG);
 		ERR_FAIL_COND_V(p_bytes < p.size, ERR_OUT_OF_MEMORY);
 
 		r_read = p.size;
 		copymem(r_info, &p.info, sizeof(T));
 		_payload.read(r_payload, p.size);
+		_packets.read(p);
 		return OK;
 	}
 
 	void discard_payload(int p_size) {
-		_packets.decrease_write(p_size);
+		_payload.decrease_write(p_size);
 	}
 
 	void resize(int p_pkt_shift, int p_buf_shift) {
@@ -105,6 +108,10 @@ public:
 		return _packets.data_left();
 	}
 
+	int payload_left() const {
+		return _payload.data_left();
+	}
+
 	void clear() {
 		_payload.resize(0);
 		_packets.resize(0);
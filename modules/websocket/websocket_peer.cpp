@@ -38,6 +38,11 @@ WebSocketPeer::WebSocketPeer() {
 WebSocketPeer::~WebSocketPeer() {
 }
 
+Dictionary WebSocketPeer::get_stats() const {
+
+	return Dictionary();
+}
+
 void WebSocketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_write_mode"), &WebSocketPeer::get_write_mode);
 	ClassDB::bind_method(D_METHOD("set_write_mode", "mode"), &WebSocketPeer::set_write_mode);
@@ -46,6 +51,7 @@ void WebSocketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("close", "code", "reason"), &WebSocketPeer::close, DEFVAL(1000), DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("get_connected_host"), &WebSocketPeer::get_connected_host);
 	ClassDB::bind_method(D_METHOD("get_connected_port"), &WebSocketPeer::get_connected_port);
+	ClassDB::bind_method(D_METHOD("get_stats"), &WebSocketPeer::get_stats);
 
 	BIND_ENUM_CONSTANT(WRITE_MODE_TEXT);
 	BIND_ENUM_CONSTANT(WRITE_MODE_BINARY);
@@ -64,6 +64,7 @@ public:
 	virtual IP_Address get_connected_host() const = 0;
 	virtual uint16_t get_connected_port() const = 0;
 	virtual bool was_string_packet() const = 0;
+	virtual Dictionary get_stats() const;
 
 	WebSocketPeer();
 	~WebSocketPeer();
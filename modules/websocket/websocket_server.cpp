@@ -34,6 +34,7 @@ GDCINULL(WebSocketServer);
 
 WebSocketServer::WebSocketServer() {
 	_peer_id = 1;
+	threaded = false;
 }
 
 WebSocketServer::~WebSocketServer() {
@@ -48,6 +49,10 @@ void WebSocketServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_peer_address", "id"), &WebSocketServer::get_peer_address);
 	ClassDB::bind_method(D_METHOD("get_peer_port", "id"), &WebSocketServer::get_peer_port);
 	ClassDB::bind_method(D_METHOD("disconnect_peer", "id", "code", "reason"), &WebSocketServer::disconnect_peer, DEFVAL(1000), DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("set_threaded", "enabled"), &WebSocketServer::set_threaded);
+	ClassDB::bind_method(D_METHOD("is_threaded"), &WebSocketServer::is_threaded);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "threaded"), "set_threaded", "is_threaded");
 
 	ADD_SIGNAL(MethodInfo("client_close_request", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::INT, "code"), PropertyInfo(Variant::STRING, "reason")));
 	ADD_SIGNAL(MethodInfo("client_disconnected", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::BOOL, "was_clean_close")));
@@ -62,6 +67,17 @@ NetworkedMultiplayerPeer::ConnectionStatus WebSocketServer::get_connection_statu
 	return CONNECTION_DISCONNECTED;
 };
 
+void WebSocketServer::set_threaded(bool p_threaded) {
+
+	ERR_FAIL_COND(is_listening());
+	threaded = p_threaded;
+}
+
+bool WebSocketServer::is_threaded() const {
+
+	return threaded;
+}
+
 bool WebSocketServer::is_server() const {
 
 	return true;
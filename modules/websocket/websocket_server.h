@@ -43,6 +43,8 @@ class WebSocketServer : public WebSocketMultiplayerPeer {
 protected:
 	static void _bind_methods();
 
+	bool threaded;
+
 public:
 	virtual void poll() = 0;
 	virtual Error listen(int p_port, PoolVector<String> p_protocols = PoolVector<String>(), bool gd_mp_api = false) = 0;
@@ -57,6 +59,9 @@ public:
 	virtual int get_peer_port(int p_peer_id) const = 0;
 	virtual void disconnect_peer(int p_peer_id, int p_code = 1000, String p_reason = "") = 0;
 
+	void set_threaded(bool p_threaded);
+	bool is_threaded() const;
+
 	void _on_peer_packet(int32_t p_peer_id);
 	void _on_connect(int32_t p_peer_id, String p_protocol);
 	void _on_disconnect(int32_t p_peer_id, bool p_was_clean);
@@ -62,6 +62,7 @@ void *ThreadAndroid::thread_callback(void *userdata) {
 	pthread_setspecific(thread_id_key, (void *)t->id);
 	t->callback(t->user);
 	ScriptServer::thread_exit();
+	Memory::release_thread_cache();
 	return NULL;
 }
 
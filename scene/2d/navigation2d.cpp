@@ -30,7 +30,75 @@
 
 #include "navigation2d.h"
 
-#define USE_ENTRY_POINT
+#include "core/message_queue.h"
+#include "core/sort.h"
+
+void Navigation2D::PathSearch::begin(int p_polygons, int p_clusters) {
+
+	if (reached.size() != p_polygons || cluster_reached.size() != p_clusters) {
+
+		reached.resize(p_polygons);
+		closed.resize(p_polygons);
+		distance.resize(p_polygons);
+		prev_edge.resize(p_polygons);
+		entry.resize(p_polygons);
+
+		cluster_reached.resize(p_clusters);
+		cluster_closed.resize(p_clusters);
+		cluster_distance.resize(p_clusters);
+		cluster_prev.resize(p_clusters);
+		corridor.resize(p_clusters);
+
+		pass = 0;
+	}
+
+	pass++;
+	if (pass == 1) {
+		// First use, or the pass counter wrapped around.
+		zeromem(reached.ptrw(), p_polygons * sizeof(uint32_t));
+		zeromem(closed.ptrw(), p_polygons * sizeof(uint32_t));
+		zeromem(cluster_reached.ptrw(), p_clusters * sizeof(uint32_t));
+		zeromem(cluster_closed.ptrw(), p_clusters * sizeof(uint32_t));
+		zeromem(corridor.ptrw(), p_clusters * sizeof(uint32_t));
+	}
+
+	open_count = 0;
+}
+
+void Navigation2D::PathSearch::push_open(float p_cost, int p_id) {
+
+	if (open_count == open.size()) {
+		open.resize(MAX(64, open_count * 2));
+	}
+
+	OpenEntry e;
+	e.cost = p_cost;
+	e.id = p_id;
+
+	OpenEntry *heap = open.ptrw();
+	heap[open_count] = e;
+	SortArray<OpenEntry, OpenComparator> sorter;
+	sorter.push_heap(0, open_count, 0, e, heap);
+	open_count++;
+}
+
+int Navigation2D::PathSearch::pop_open() {
+
+	if (open_count == 0)
+		return -1;
+
+	OpenEntry *heap = open.ptrw();
+	SortArray<OpenEntry, OpenComparator> sorter;
+	sorter.pop_heap(0, open_count, heap);
+	open_count--;
+	return heap[open_count].id;
+}
+
+Navigation2D::PathSearch::PathSearch() {
+
+	pass = 0;
+	open_count = 0;
+}
 
 void Navigation2D::_navpoly_link(int p_id) {
 
@@ -97,6 +165,19 @@ void Navigation2D::_navpoly_link(int p_id) {
 
 		p.center = center / plen;
 
+		Rect2 rect;
+		for (int j = 0; j < plen; j++) {
+			Vector2 v = _get_vertex(p.edges[j].point);
+			if (j == 0)
+				rect = Rect2(v, Vector2());
+			else
+				rect.expand_to(v);
+		}
+		p.aabb = AABB(Vector3(rect.position.x, rect.position.y, 0), Vector3(rect.size.x, rect.size.y, 0));
+		p.index_id = polygon_index.create(&p, p.aabb);
+		p.id = -1;
+		p.cluster = -1;
+
 		//connect
 
 		for (int j = 0; j < plen; j++) {
@@ -135,6 +216,7 @@ void Navigation2D::_navpoly_link(int p_id) {
 	}
 
 	nm.linked = true;
+	graph_dirty = true;
 }
 
 void Navigation2D::_navpoly_unlink(int p_id) {
@@ -146,6 +228,7 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 
 		Polygon &p = E->get();
+		polygon_index.erase(p.index_id);
 
 		int ec = p.edges.size();
 		Polygon::Edge *edges = p.edges.ptrw();
@@ -201,10 +284,13 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	graph_dirty = true;
 }
 
 int Navigation2D::navpoly_add(const Ref<NavigationPolygon> &p_mesh, const Transform2D &p_xform, Object *p_owner) {
 
+	_wait_path_requests();
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -224,6 +310,7 @@ void Navigation2D::navpoly_set_transform(int p_id, const Transform2D &p_xform) {
 	NavMesh &nm = navpoly_map[p_id];
 	if (nm.xform == p_xform)
 		return; //bleh
+	_wait_path_requests();
 	_navpoly_unlink(p_id);
 	nm.xform = p_xform;
 	_navpoly_link(p_id);
@@ -231,20 +318,20 @@ void Navigation2D::navpoly_set_transform(int p_id, const Transform2D &p_xform) {
 void Navigation2D::navpoly_remove(int p_id) {
 
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
+	_wait_path_requests();
 	_navpoly_unlink(p_id);
 	navpoly_map.erase(p_id);
 }
 
-Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
+void Navigation2D::_update_graph() {
 
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
-	Vector2 begin_point;
-	Vector2 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
+	if (!graph_dirty)
+		return;
 
-	//look for point inside triangle
+	polygons.clear();
+	clusters.clear();
+	polygon_bounds = AABB();
+	search_radius = 0;
 
 	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
 
@@ -253,234 +340,325 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
 
 			Polygon &p = F->get();
-			if (begin_d || end_d) {
-				for (int i = 2; i < p.edges.size(); i++) {
+			p.id = polygons.size();
+			p.cluster = -1;
 
-					if (begin_d > 0) {
+			if (polygons.empty())
+				polygon_bounds = p.aabb;
+			else
+				polygon_bounds.merge_with(p.aabb);
+			search_radius += p.aabb.get_longest_axis_size();
 
-						if (Geometry::is_point_in_triangle(p_start, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+			polygons.push_back(&p);
+		}
+	}
 
-							begin_poly = &p;
-							begin_point = p_start;
-							begin_d = 0;
-							if (end_d == 0)
-								break;
-						}
-					}
+	// Closest polygon searches start with a box about the size of a polygon.
+	if (polygons.size()) {
+		search_radius /= polygons.size();
+	}
+	search_radius = MAX(search_radius, cell_size);
 
-					if (end_d > 0) {
+	// Clusters grow breadth first, so they are connected and roughly round.
+	Polygon **polys = polygons.ptrw();
+	Vector<Polygon *> queue;
+	queue.resize(polygons.size());
+	Polygon **q = queue.ptrw();
 
-						if (Geometry::is_point_in_triangle(p_end, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+	for (int i = 0; i < polygons.size(); i++) {
 
-							end_poly = &p;
-							end_point = p_end;
-							end_d = 0;
-							if (begin_d == 0)
-								break;
-						}
-					}
+		if (polys[i]->cluster != -1)
+			continue;
+
+		Cluster c;
+		int cluster = clusters.size();
+		int count = 1;
+		q[0] = polys[i];
+		polys[i]->cluster = cluster;
+
+		for (int j = 0; j < count; j++) {
+
+			Polygon *p = q[j];
+			c.center += p->center;
+
+			for (int k = 0; k < p->edges.size(); k++) {
+
+				Polygon *n = p->edges[k].C;
+				if (n && n->cluster == -1 && count < cluster_size) {
+					n->cluster = cluster;
+					q[count++] = n;
 				}
 			}
-
-			p.prev_edge = -1;
 		}
+
+		c.center /= count;
+		clusters.push_back(c);
 	}
 
-	//start or end not inside triangle.. look for closest segment :|
-	if (begin_d || end_d) {
-		for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	Cluster *cl = clusters.ptrw();
+	for (int i = 0; i < polygons.size(); i++) {
 
-			if (!E->get().linked)
-				continue;
-			for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-				Polygon &p = F->get();
-				int es = p.edges.size();
-				for (int i = 0; i < es; i++) {
-
-					Vector2 edge[2] = {
-						_get_vertex(p.edges[i].point),
-						_get_vertex(p.edges[(i + 1) % es].point)
-					};
-
-					if (begin_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_start, edge);
-						float d = spoint.distance_to(p_start);
-						if (d < begin_d) {
-							begin_poly = &p;
-							begin_point = spoint;
-							begin_d = d;
-						}
-					}
+		Polygon *p = polys[i];
+		for (int j = 0; j < p->edges.size(); j++) {
 
-					if (end_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_end, edge);
-						float d = spoint.distance_to(p_end);
-						if (d < end_d) {
-							end_poly = &p;
-							end_point = spoint;
-							end_d = d;
-						}
-					}
-				}
+			Polygon *n = p->edges[j].C;
+			if (n && n->cluster != p->cluster && cl[p->cluster].neighbors.find(n->cluster) == -1) {
+				cl[p->cluster].neighbors.push_back(n->cluster);
 			}
 		}
 	}
 
-	if (!begin_poly || !end_poly) {
+	graph_dirty = false;
+}
 
-		return Vector<Vector2>(); //no path
+int Navigation2D::_cull_polygons(const AABB &p_aabb, PathSearch &r_search) const {
+
+	if (r_search.cull.empty()) {
+		r_search.cull.resize(64);
 	}
 
-	if (begin_poly == end_poly) {
+	while (true) {
 
-		Vector<Vector2> path;
-		path.resize(2);
-		path.write[0] = begin_point;
-		path.write[1] = end_point;
-		return path;
+		int count = polygon_index.cull_aabb(p_aabb, r_search.cull.ptrw(), r_search.cull.size());
+		if (count < r_search.cull.size())
+			return count;
+
+		r_search.cull.resize(count * 2);
 	}
+}
 
-	bool found_route = false;
+Navigation2D::Polygon *Navigation2D::_get_closest_polygon(const Vector2 &p_point, PathSearch &r_search, Vector2 *r_closest) const {
 
-	List<Polygon *> open_list;
+	if (polygons.empty())
+		return NULL;
 
-	begin_poly->entry = p_start;
+	Vector3 point(p_point.x, p_point.y, 0);
 
-	for (int i = 0; i < begin_poly->edges.size(); i++) {
+	//look for point inside triangle
 
-		if (begin_poly->edges[i].C) {
+	int count = _cull_polygons(AABB(point, Vector3()), r_search);
 
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
-#ifdef USE_ENTRY_POINT
-			Vector2 edge[2] = {
-				_get_vertex(begin_poly->edges[i].point),
-				_get_vertex(begin_poly->edges[(i + 1) % begin_poly->edges.size()].point)
-			};
+	for (int i = 0; i < count; i++) {
+
+		Polygon *p = r_search.cull[i];
+		for (int j = 2; j < p->edges.size(); j++) {
 
-			Vector2 entry = Geometry::get_closest_point_to_segment_2d(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_poly->entry.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
-#else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
-#endif
-			open_list.push_back(begin_poly->edges[i].C);
+			if (Geometry::is_point_in_triangle(p_point, _get_vertex(p->edges[0].point), _get_vertex(p->edges[j - 1].point), _get_vertex(p->edges[j].point))) {
 
-			if (begin_poly->edges[i].C == end_poly) {
-				found_route = true;
+				*r_closest = p_point;
+				return p;
 			}
 		}
 	}
 
-	while (!found_route) {
+	//not inside a triangle.. look for closest segment :|
+	//nothing outside the searched box can be closer than its half size, so it grows until something is,
+	//or until it holds all polygons.
 
-		if (open_list.size() == 0) {
-			break;
-		}
-		//check open list
+	Polygon *closest = NULL;
+	float closest_d = 1e20;
 
-		List<Polygon *>::Element *least_cost_poly = NULL;
-		float least_cost = 1e30;
+	Vector3 to_min = (polygon_bounds.position - point).abs();
+	Vector3 to_max = (polygon_bounds.position + polygon_bounds.size - point).abs();
+	real_t max_radius = MAX(MAX(to_min.x, to_max.x), MAX(to_min.y, to_max.y));
+	real_t radius = search_radius;
 
-		//this could be faster (cache previous results)
-		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
+	while (true) {
 
-			Polygon *p = E->get();
+		AABB box(point - Vector3(radius, radius, 0), Vector3(radius, radius, 0) * 2);
+		count = _cull_polygons(box, r_search);
 
-			float cost = p->distance;
+		for (int i = 0; i < count; i++) {
 
-#ifdef USE_ENTRY_POINT
+			Polygon *p = r_search.cull[i];
 			int es = p->edges.size();
-
-			float shortest_distance = 1e30;
-
-			for (int i = 0; i < es; i++) {
-				Polygon::Edge &e = p->edges.write[i];
-
-				if (!e.C)
-					continue;
+			for (int j = 0; j < es; j++) {
 
 				Vector2 edge[2] = {
-					_get_vertex(p->edges[i].point),
-					_get_vertex(p->edges[(i + 1) % es].point)
+					_get_vertex(p->edges[j].point),
+					_get_vertex(p->edges[(j + 1) % es].point)
 				};
 
-				Vector2 edge_point = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-				float dist = p->entry.distance_to(edge_point);
-				if (dist < shortest_distance)
-					shortest_distance = dist;
+				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
+				float d = spoint.distance_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = p;
+					*r_closest = spoint;
+				}
 			}
+		}
+
+		if (closest_d <= radius || radius >= max_radius)
+			break;
+
+		radius *= 2;
+	}
+
+	return closest;
+}
+
+bool Navigation2D::_find_corridor(int p_from_cluster, int p_to_cluster, PathSearch &r_search) const {
+
+	uint32_t pass = r_search.pass;
+	const Cluster *cl = clusters.ptr();
+	uint32_t *reached = r_search.cluster_reached.ptrw();
+	uint32_t *closed = r_search.cluster_closed.ptrw();
+	float *distance = r_search.cluster_distance.ptrw();
+	int *prev = r_search.cluster_prev.ptrw();
+
+	reached[p_from_cluster] = pass;
+	distance[p_from_cluster] = 0;
+	prev[p_from_cluster] = -1;
+	r_search.push_open(cl[p_from_cluster].center.distance_to(cl[p_to_cluster].center), p_from_cluster);
+
+	bool found = false;
+	int id;
+
+	while ((id = r_search.pop_open()) != -1) {
+
+		if (closed[id] == pass)
+			continue;
+		closed[id] = pass;
 
-			cost += shortest_distance;
-#else
-			cost += p->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_poly = E;
-				least_cost = cost;
+		if (id == p_to_cluster) {
+			found = true;
+			break;
+		}
+
+		const Cluster &c = cl[id];
+		for (int i = 0; i < c.neighbors.size(); i++) {
+
+			int n = c.neighbors[i];
+			if (closed[n] == pass)
+				continue;
+
+			float d = distance[id] + c.center.distance_to(cl[n].center);
+			if (reached[n] != pass || d < distance[n]) {
+				reached[n] = pass;
+				distance[n] = d;
+				prev[n] = id;
+				r_search.push_open(d + cl[n].center.distance_to(cl[p_to_cluster].center), n);
 			}
 		}
+	}
 
-		Polygon *p = least_cost_poly->get();
-		//open the neighbours for search
+	r_search.open_count = 0;
+
+	if (!found)
+		return false;
+
+	uint32_t *corridor = r_search.corridor.ptrw();
+	for (int c = p_to_cluster; c != -1; c = prev[c]) {
+		corridor[c] = pass;
+	}
+
+	return true;
+}
+
+Vector<Vector2> Navigation2D::_get_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize, PathSearch &r_search) const {
+
+	Vector2 begin_point;
+	Vector2 end_point;
+	Polygon *begin_poly = _get_closest_polygon(p_start, r_search, &begin_point);
+	Polygon *end_poly = _get_closest_polygon(p_end, r_search, &end_point);
+
+	if (!begin_poly || !end_poly) {
+
+		return Vector<Vector2>(); //no path
+	}
+
+	if (begin_poly == end_poly) {
+
+		Vector<Vector2> path;
+		path.resize(2);
+		path.write[0] = begin_point;
+		path.write[1] = end_point;
+		return path;
+	}
+
+	r_search.begin(polygons.size(), clusters.size());
+	uint32_t pass = r_search.pass;
+
+	bool use_corridor = hierarchical_pathfinding && begin_poly->cluster != end_poly->cluster;
+	if (use_corridor && !_find_corridor(begin_poly->cluster, end_poly->cluster, r_search)) {
+
+		return Vector<Vector2>(); //not connected
+	}
+
+	uint32_t *reached = r_search.reached.ptrw();
+	uint32_t *closed = r_search.closed.ptrw();
+	float *distance = r_search.distance.ptrw();
+	int *prev_edge = r_search.prev_edge.ptrw();
+	Vector2 *entry = r_search.entry.ptrw();
+	const uint32_t *corridor = r_search.corridor.ptr();
+	Polygon *const *polys = polygons.ptr();
+
+	reached[begin_poly->id] = pass;
+	distance[begin_poly->id] = 0;
+	prev_edge[begin_poly->id] = -1;
+	entry[begin_poly->id] = p_start;
+	r_search.push_open(p_start.distance_to(end_point), begin_poly->id);
+
+	bool found_route = false;
+	int id;
+
+	while (!found_route && (id = r_search.pop_open()) != -1) {
+
+		if (closed[id] == pass)
+			continue; //expanded already, with a lower cost
+		closed[id] = pass;
+
+		const Polygon *p = polys[id];
+		const Polygon::Edge *edges = p->edges.ptr();
 		int es = p->edges.size();
 
+		//open the neighbours for search
 		for (int i = 0; i < es; i++) {
 
-			Polygon::Edge &e = p->edges.write[i];
-
-			if (!e.C)
+			Polygon *c = edges[i].C;
+			if (!c || c == begin_poly)
+				continue;
+			if (use_corridor && corridor[c->cluster] != pass)
 				continue;
 
-#ifdef USE_ENTRY_POINT
 			Vector2 edge[2] = {
-				_get_vertex(p->edges[i].point),
-				_get_vertex(p->edges[(i + 1) % es].point)
+				_get_vertex(edges[i].point),
+				_get_vertex(edges[(i + 1) % es].point)
 			};
 
-			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-			float distance = p->entry.distance_to(edge_entry) + p->distance;
-
-#else
-
-			float distance = p->center.distance_to(e.C->center) + p->distance;
-
-#endif
+			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(entry[id], edge);
+			float d = entry[id].distance_to(edge_entry) + distance[id];
 
-			if (e.C->prev_edge != -1) {
+			int cid = c->id;
+			if (reached[cid] == pass) {
 				//oh this was visited already, can we win the cost?
 
-				if (e.C->distance > distance) {
+				if (distance[cid] > d) {
 
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
-#ifdef USE_ENTRY_POINT
-					e.C->entry = edge_entry;
-#endif
+					prev_edge[cid] = edges[i].C_edge;
+					distance[cid] = d;
+					entry[cid] = edge_entry;
+					if (closed[cid] != pass) {
+						r_search.push_open(d + edge_entry.distance_to(end_point), cid);
+					}
 				}
 			} else {
 				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
-#ifdef USE_ENTRY_POINT
-				e.C->entry = edge_entry;
-#endif
-
-				open_list.push_back(e.C);
+				reached[cid] = pass;
+				prev_edge[cid] = edges[i].C_edge;
+				distance[cid] = d;
+				entry[cid] = edge_entry;
+				r_search.push_open(d + edge_entry.distance_to(end_point), cid);
 
-				if (e.C == end_poly) {
+				if (c == end_poly) {
 					//oh my reached end! stop algorithm
 					found_route = true;
 					break;
 				}
 			}
 		}
-
-		if (found_route)
-			break;
-
-		open_list.erase(least_cost_poly);
 	}
 
 	if (found_route) {
@@ -502,44 +680,24 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 				Vector2 left;
 				Vector2 right;
 
-//#define CLOCK_TANGENT(m_a,m_b,m_c) ( ((m_a)-(m_c)).cross((m_a)-(m_b)) )
 #define CLOCK_TANGENT(m_a, m_b, m_c) ((((m_a).x - (m_c).x) * ((m_b).y - (m_c).y) - ((m_b).x - (m_c).x) * ((m_a).y - (m_c).y)))
 
 				if (p == begin_poly) {
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
+					int prev = prev_edge[p->id];
+					int prev_n = (prev + 1) % p->edges.size();
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
 					if (p->clockwise) {
 						SWAP(left, right);
 					}
-					/*if (CLOCK_TANGENT(apex_point,left,(left+right)*0.5) < 0){
-						SWAP(left,right);
-					}*/
 				}
 
 				bool skip = false;
 
-				/*
-				print_line("-----\nAPEX: "+(apex_point-end_point));
-				print_line("LEFT:");
-				print_line("\tPortal: "+(portal_left-end_point));
-				print_line("\tPoint: "+(left-end_point));
-				print_line("\tLeft Tangent: "+rtos(CLOCK_TANGENT(apex_point,portal_left,left)));
-				print_line("\tLeft Distance: "+rtos(portal_left.distance_squared_to(apex_point)));
-				print_line("\tLeft Test: "+rtos(CLOCK_TANGENT(apex_point,left,portal_right)));
-				print_line("RIGHT:");
-				print_line("\tPortal: "+(portal_right-end_point));
-				print_line("\tPoint: "+(right-end_point));
-				print_line("\tRight Tangent: "+rtos(CLOCK_TANGENT(apex_point,portal_right,right)));
-				print_line("\tRight Distance: "+rtos(portal_right.distance_squared_to(apex_point)));
-				print_line("\tRight Test: "+rtos(CLOCK_TANGENT(apex_point,right,portal_left)));
-				*/
-
 				if (CLOCK_TANGENT(apex_point, portal_left, left) >= 0) {
 					//process
 					if (portal_left.distance_squared_to(apex_point) < CMP_EPSILON || CLOCK_TANGENT(apex_point, left, portal_right) > 0) {
@@ -576,7 +734,7 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 				}
 
 				if (p != begin_poly)
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[prev_edge[p->id]].C;
 				else
 					p = NULL;
 			}
@@ -586,8 +744,8 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 			Polygon *p = end_poly;
 
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
+				int prev = prev_edge[p->id];
+				int prev_n = (prev + 1) % p->edges.size();
 				Vector2 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 				path.push_back(point);
 				p = p->edges[prev].C;
@@ -616,108 +774,244 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 	return Vector<Vector2>();
 }
 
-Vector2 Navigation2D::get_closest_point(const Vector2 &p_point) {
+Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
 
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
+	_update_graph();
+	return _get_path(p_start, p_end, p_optimize, main_search);
+}
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+void Navigation2D::_run_path_job(uint32_t p_index, PathBatch *p_batch) {
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	int from = p_batch->count * p_index / p_batch->job_count;
+	int to = p_batch->count * (p_index + 1) / p_batch->job_count;
+	PathSearch &search = p_batch->searches[p_index];
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	for (int i = from; i < to; i++) {
+
+		PathRequest &r = p_batch->requests[i];
+		r.path = _get_path(r.start, r.end, r.optimize, search);
+	}
+}
 
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+WorkerThreadPool::GroupID Navigation2D::_start_path_batch(PathBatch &r_batch, Vector<PathSearch> &r_searches, PathRequest *p_requests, int p_count) {
 
-					return p_point; //inside triangle, nothing else to discuss
-				}
-			}
-		}
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	int job_count = 1;
+	if (pool) {
+		job_count = CLAMP((p_count + PATH_REQUESTS_PER_JOB - 1) / PATH_REQUESTS_PER_JOB, 1, pool->get_thread_count() + 1);
 	}
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	if (r_searches.size() < job_count) {
+		r_searches.resize(job_count);
+	}
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	r_batch.requests = p_requests;
+	r_batch.count = p_count;
+	r_batch.searches = r_searches.ptrw();
+	r_batch.job_count = job_count;
 
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
+	if (!pool) {
+		_run_path_job(0, &r_batch);
+		return WorkerThreadPool::INVALID_GROUP_ID;
+	}
 
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
+	return pool->add_template_group_task(this, &Navigation2D::_run_path_job, &r_batch, job_count);
+}
 
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
+Array Navigation2D::get_simple_paths(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize) {
 
-					closest_point = spoint;
-					closest_point_d = d;
-				}
-			}
+	ERR_FAIL_COND_V(p_starts.size() != p_ends.size(), Array());
+
+	_update_graph();
+
+	int count = p_starts.size();
+	Vector<PathRequest> requests;
+	requests.resize(count);
+	PathRequest *w = requests.ptrw();
+
+	PoolVector<Vector2>::Read rs = p_starts.read();
+	PoolVector<Vector2>::Read re = p_ends.read();
+	for (int i = 0; i < count; i++) {
+		w[i].start = rs[i];
+		w[i].end = re[i];
+		w[i].optimize = p_optimize;
+	}
+
+	if (count <= PATH_REQUESTS_PER_JOB) {
+		for (int i = 0; i < count; i++) {
+			w[i].path = _get_path(w[i].start, w[i].end, p_optimize, main_search);
+		}
+	} else {
+		PathBatch batch;
+		WorkerThreadPool::GroupID group = _start_path_batch(batch, batch_searches, w, count);
+		if (group != WorkerThreadPool::INVALID_GROUP_ID) {
+			WorkerThreadPool::get_singleton()->wait_for_group(group);
 		}
 	}
 
-	return closest_point;
+	Array paths;
+	paths.resize(count);
+	for (int i = 0; i < count; i++) {
+		paths[i] = w[i].path;
+	}
+
+	return paths;
 }
 
-Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
+int Navigation2D::request_simple_path(const Vector2 &p_start, const Vector2 &p_end, Object *p_target, const StringName &p_method, bool p_optimize) {
+
+	ERR_FAIL_NULL_V(p_target, 0);
+	ERR_EXPLAIN("Path requests are answered while the Navigation2D node is processed, it must be inside the tree.");
+	ERR_FAIL_COND_V(!is_inside_tree(), 0);
+
+	PathRequest r;
+	r.id = last_request_id++;
+	r.start = p_start;
+	r.end = p_end;
+	r.optimize = p_optimize;
+	r.target = p_target->get_instance_id();
+	r.method = p_method;
+	queued_requests.push_back(r);
+
+	if (!dispatch_queued) {
+		// Sent once the frame is done, so all the requests made during it are searched together.
+		MessageQueue::get_singleton()->push_call(this, "_dispatch_path_requests");
+		dispatch_queued = true;
+	}
 
-	Object *owner = NULL;
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
+	set_process_internal(true);
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	return r.id;
+}
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+void Navigation2D::cancel_path_request(int p_id) {
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	for (int i = 0; i < queued_requests.size(); i++) {
+
+		if (queued_requests[i].id == p_id) {
+			queued_requests.remove(i);
+			return;
+		}
+	}
 
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+	// Already being searched, only the callback is dropped.
+	for (int i = 0; i < running_requests.size(); i++) {
 
-					return E->get().owner;
-				}
-			}
+		if (running_requests[i].id == p_id) {
+			running_requests.write[i].target = 0;
+			return;
 		}
 	}
+}
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+void Navigation2D::_dispatch_path_requests() {
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	dispatch_queued = false;
 
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
+	// The previous batch is not delivered yet, these are sent after it.
+	if (running_requests.size() || queued_requests.empty())
+		return;
 
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
+	_update_graph();
 
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
+	running_requests = queued_requests;
+	queued_requests.clear();
+	running_group = _start_path_batch(running_batch, request_searches, running_requests.ptrw(), running_requests.size());
+}
 
-					closest_point = spoint;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
+void Navigation2D::_wait_path_requests() {
+
+	if (running_group == WorkerThreadPool::INVALID_GROUP_ID)
+		return;
+
+	WorkerThreadPool::get_singleton()->wait_for_group(running_group);
+	running_group = WorkerThreadPool::INVALID_GROUP_ID;
+}
+
+void Navigation2D::_deliver_path_requests() {
+
+	_wait_path_requests();
+
+	// Callbacks may request new paths.
+	Vector<PathRequest> requests = running_requests;
+	running_requests.clear();
+
+	for (int i = 0; i < requests.size(); i++) {
+
+		const PathRequest &r = requests[i];
+		Object *target = ObjectDB::get_instance(r.target);
+		if (!target)
+			continue;
+
+		target->call(r.method, r.id, r.path);
+	}
+
+	if (queued_requests.size()) {
+		if (!dispatch_queued) {
+			MessageQueue::get_singleton()->push_call(this, "_dispatch_path_requests");
+			dispatch_queued = true;
 		}
+	} else {
+		set_process_internal(false);
 	}
+}
+
+Vector2 Navigation2D::get_closest_point(const Vector2 &p_point) {
+
+	_update_graph();
+
+	Vector2 closest_point;
+	_get_closest_polygon(p_point, main_search, &closest_point);
+	return closest_point;
+}
+
+Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
+
+	_update_graph();
+
+	Vector2 closest_point;
+	Polygon *closest = _get_closest_polygon(p_point, main_search, &closest_point);
+	return closest ? closest->owner->owner : NULL;
+}
+
+void Navigation2D::set_hierarchical_pathfinding(bool p_enable) {
+
+	_wait_path_requests();
+	hierarchical_pathfinding = p_enable;
+}
+
+bool Navigation2D::is_hierarchical_pathfinding_enabled() const {
+
+	return hierarchical_pathfinding;
+}
+
+void Navigation2D::set_cluster_size(int p_size) {
+
+	ERR_FAIL_COND(p_size < 1);
+	_wait_path_requests();
+	cluster_size = p_size;
+	graph_dirty = true;
+}
+
+int Navigation2D::get_cluster_size() const {
 
-	return owner;
+	return cluster_size;
+}
+
+void Navigation2D::_notification(int p_what) {
+
+	switch (p_what) {
+
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			_deliver_path_requests();
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+
+			_wait_path_requests();
+		} break;
+	}
 }
 
 void Navigation2D::_bind_methods() {
@@ -727,8 +1021,22 @@ void Navigation2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navpoly_remove", "id"), &Navigation2D::navpoly_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation2D::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths", "starts", "ends", "optimize"), &Navigation2D::get_simple_paths, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("request_simple_path", "start", "end", "target", "method", "optimize"), &Navigation2D::request_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("cancel_path_request", "id"), &Navigation2D::cancel_path_request);
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation2D::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_owner", "to_point"), &Navigation2D::get_closest_point_owner);
+
+	ClassDB::bind_method(D_METHOD("set_hierarchical_pathfinding", "enable"), &Navigation2D::set_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("is_hierarchical_pathfinding_enabled"), &Navigation2D::is_hierarchical_pathfinding_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "size"), &Navigation2D::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &Navigation2D::get_cluster_size);
+
+	ClassDB::bind_method(D_METHOD("_dispatch_path_requests"), &Navigation2D::_dispatch_path_requests);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "hierarchical_pathfinding"), "set_hierarchical_pathfinding", "is_hierarchical_pathfinding_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cluster_size", PROPERTY_HINT_RANGE, "1,1024,1"), "set_cluster_size", "get_cluster_size");
 }
 
 Navigation2D::Navigation2D() {
@@ -736,4 +1044,18 @@ Navigation2D::Navigation2D() {
 	ERR_FAIL_COND(sizeof(Point) != 8);
 	cell_size = 1; // one pixel
 	last_id = 1;
+
+	graph_dirty = true;
+	search_radius = 0;
+	hierarchical_pathfinding = false;
+	cluster_size = 64;
+
+	last_request_id = 1;
+	running_group = WorkerThreadPool::INVALID_GROUP_ID;
+	dispatch_queued = false;
+}
+
+Navigation2D::~Navigation2D() {
+
+	_wait_path_requests();
 }
@@ -71,9 +71,9 @@ void TileMap::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 
 			_update_quadrant_space(RID());
-			for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+			for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-				Quadrant &q = E->get();
+				Quadrant &q = quadrant_map.get(*K);
 				if (navigation) {
 					for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
 
@@ -102,9 +102,9 @@ void TileMap::_notification(int p_what) {
 
 void TileMap::_update_quadrant_space(const RID &p_space) {
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Physics2DServer::get_singleton()->body_set_space(q.body, p_space);
 	}
 }
@@ -120,9 +120,9 @@ void TileMap::_update_quadrant_transform() {
 	if (navigation)
 		nav_rel = get_relative_transform_to_parent(navigation);
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Transform2D xform;
 		xform.set_origin(q.pos);
 		xform = global_transform * xform;
@@ -288,8 +288,25 @@ void TileMap::update_dirty_quadrants() {
 
 		q.canvas_items.clear();
 
-		ps->body_clear_shapes(q.body);
-		int shape_idx = 0;
+		for (List<RID>::Element *E = q.meshes.front(); E; E = E->next()) {
+
+			vs->free(E->get());
+		}
+
+		q.meshes.clear();
+
+		if (q.shapes_dirty) {
+			ps->body_clear_shapes(q.body);
+			q.shape_cells.clear();
+		} else {
+			// only the shapes of the cells that changed are replaced, the rest of the body is kept
+			for (int i = q.shape_cells.size() - 1; i >= 0; i--) {
+				if (q.dirty_cells.has(q.shape_cells[i])) {
+					ps->body_remove_shape(q.body, i);
+					q.shape_cells.remove(i);
+				}
+			}
+		}
 
 		if (navigation) {
 			for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
@@ -307,6 +324,7 @@ void TileMap::update_dirty_quadrants() {
 		int prev_z_index = 0;
 		RID prev_canvas_item;
 		RID prev_debug_canvas_item;
+		Vector<BakedSurface> baked_surfaces;
 
 		for (int i = 0; i < q.cells.size(); i++) {
 
@@ -454,13 +472,16 @@ void TileMap::update_dirty_quadrants() {
 			Color self_modulate = get_self_modulate();
 			modulate = Color(modulate.r * self_modulate.r, modulate.g * self_modulate.g,
 					modulate.b * self_modulate.b, modulate.a * self_modulate.a);
-			if (r == Rect2()) {
+			if (bake_quadrants) {
+				_bake_tile(baked_surfaces, canvas_item, tex, normal_map, rect, r, modulate, c.transpose);
+			} else if (r == Rect2()) {
 				tex->draw_rect(canvas_item, rect, false, modulate, c.transpose, normal_map);
 			} else {
 				tex->draw_rect_region(canvas_item, rect, r, modulate, c.transpose, normal_map, clip_uv);
 			}
 
 			Vector<TileSet::ShapeData> shapes = tile_set->tile_get_shapes(c.id);
+			bool add_shapes = q.shapes_dirty || q.dirty_cells.has(E->key());
 
 			for (int i = 0; i < shapes.size(); i++) {
 				Ref<Shape2D> shape = shapes[i].shape;
@@ -479,10 +500,13 @@ void TileMap::update_dirty_quadrants() {
 							vs->canvas_item_add_set_transform(debug_canvas_item, xform);
 							shape->draw(debug_canvas_item, debug_collision_color);
 						}
-						ps->body_add_shape(q.body, shape->get_rid(), xform);
-						ps->body_set_shape_metadata(q.body, shape_idx, Vector2(E->key().x, E->key().y));
-						ps->body_set_shape_as_one_way_collision(q.body, shape_idx, shapes[i].one_way_collision, shapes[i].one_way_collision_margin);
-						shape_idx++;
+						if (add_shapes) {
+							int shape_idx = q.shape_cells.size();
+							ps->body_add_shape(q.body, shape->get_rid(), xform);
+							ps->body_set_shape_metadata(q.body, shape_idx, Vector2(E->key().x, E->key().y));
+							ps->body_set_shape_as_one_way_collision(q.body, shape_idx, shapes[i].one_way_collision, shapes[i].one_way_collision_margin);
+							q.shape_cells.push_back(E->key());
+						}
 					}
 				}
 			}
@@ -589,6 +613,26 @@ void TileMap::update_dirty_quadrants() {
 			}
 		}
 
+		for (int i = 0; i < baked_surfaces.size(); i++) {
+
+			const BakedSurface &bs = baked_surfaces[i];
+
+			Array arrays;
+			arrays.resize(VS::ARRAY_MAX);
+			arrays[VS::ARRAY_VERTEX] = bs.points;
+			arrays[VS::ARRAY_TEX_UV] = bs.uvs;
+			arrays[VS::ARRAY_COLOR] = bs.colors;
+			arrays[VS::ARRAY_INDEX] = bs.indices;
+
+			RID mesh = vs->mesh_create();
+			vs->mesh_add_surface_from_arrays(mesh, VS::PRIMITIVE_TRIANGLES, arrays, Array(), 0);
+			vs->canvas_item_add_mesh(bs.canvas_item, mesh, bs.texture, bs.normal_map);
+			q.meshes.push_back(mesh);
+		}
+
+		q.shapes_dirty = false;
+		q.dirty_cells.clear();
+
 		dirty_quadrant_list.remove(dirty_quadrant_list.first());
 		quadrant_order_dirty = true;
 	}
@@ -597,10 +641,19 @@ void TileMap::update_dirty_quadrants() {
 
 	if (quadrant_order_dirty) {
 
+		// draw order follows the quadrant positions, which the hashed grid does not keep sorted
+		Vector<PosKey> keys;
+		keys.resize(quadrant_map.size());
+		int key_count = 0;
+		for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
+			keys.write[key_count++] = *K;
+		}
+		keys.sort();
+
 		int index = -(int64_t)0x80000000; //always must be drawn below children
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+		for (int i = 0; i < keys.size(); i++) {
 
-			Quadrant &q = E->get();
+			Quadrant &q = quadrant_map.get(keys[i]);
 			for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 				VS::get_singleton()->canvas_item_set_draw_index(E->get(), index++);
@@ -621,17 +674,20 @@ void TileMap::_recompute_rect_cache() {
 		return;
 
 	Rect2 r_total;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	bool first = true;
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
 		Rect2 r;
-		r.position = _map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size());
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		if (E == quadrant_map.front())
+		r.position = _map_to_world(K->x * _get_quadrant_size(), K->y * _get_quadrant_size());
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size() + _get_quadrant_size(), K->y * _get_quadrant_size()));
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size() + _get_quadrant_size(), K->y * _get_quadrant_size() + _get_quadrant_size()));
+		r.expand_to(_map_to_world(K->x * _get_quadrant_size(), K->y * _get_quadrant_size() + _get_quadrant_size()));
+		if (first) {
 			r_total = r;
-		else
+			first = false;
+		} else {
 			r_total = r_total.merge(r);
+		}
 	}
 
 	rect_cache = r_total;
@@ -642,7 +698,7 @@ void TileMap::_recompute_rect_cache() {
 #endif
 }
 
-Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(const PosKey &p_qk) {
+TileMap::Quadrant *TileMap::_create_quadrant(const PosKey &p_qk) {
 
 	Transform2D xform;
 	//xform.set_origin(Point2(p_qk.x,p_qk.y)*cell_size*quadrant_size);
@@ -675,18 +731,25 @@ Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(cons
 
 	rect_cache_dirty = true;
 	quadrant_order_dirty = true;
-	return quadrant_map.insert(p_qk, q);
+	return &quadrant_map.set(p_qk, q)->value();
 }
 
-void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
+void TileMap::_erase_quadrant(const PosKey &p_qk) {
 
-	Quadrant &q = Q->get();
+	Quadrant *Q = quadrant_map.getptr(p_qk);
+	ERR_FAIL_COND(!Q);
+	Quadrant &q = *Q;
 	Physics2DServer::get_singleton()->free(q.body);
 	for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 		VisualServer::get_singleton()->free(E->get());
 	}
 	q.canvas_items.clear();
+	for (List<RID>::Element *E = q.meshes.front(); E; E = E->next()) {
+
+		VisualServer::get_singleton()->free(E->get());
+	}
+	q.meshes.clear();
 	if (q.dirty_list.in_list())
 		dirty_quadrant_list.remove(&q.dirty_list);
 
@@ -703,15 +766,14 @@ void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
 	}
 	q.occluder_instances.clear();
 
-	quadrant_map.erase(Q);
+	quadrant_map.erase(p_qk);
 	rect_cache_dirty = true;
 }
 
-void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update) {
+void TileMap::_queue_quadrant_update(Quadrant *p_q, bool update) {
 
-	Quadrant &q = Q->get();
-	if (!q.dirty_list.in_list())
-		dirty_quadrant_list.add(&q.dirty_list);
+	if (!p_q->dirty_list.in_list())
+		dirty_quadrant_list.add(&p_q->dirty_list);
 
 	if (pending_update)
 		return;
@@ -724,6 +786,78 @@ void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool updat
 	}
 }
 
+void TileMap::_make_quadrant_dirty(Quadrant *p_q, bool update) {
+
+	p_q->shapes_dirty = true;
+	p_q->dirty_cells.clear();
+	_queue_quadrant_update(p_q, update);
+}
+
+void TileMap::_make_cell_dirty(Quadrant *p_q, const PosKey &p_cell) {
+
+	if (!p_q->shapes_dirty)
+		p_q->dirty_cells.insert(p_cell);
+	_queue_quadrant_update(p_q, true);
+}
+
+void TileMap::_bake_tile(Vector<BakedSurface> &r_surfaces, const RID &p_canvas_item, const Ref<Texture> &p_texture, const Ref<Texture> &p_normal_map, const Rect2 &p_rect, const Rect2 &p_region, const Color &p_modulate, bool p_transpose) {
+
+	Rect2 rect;
+	Rect2 src_rect;
+	if (!p_texture->get_rect_region(p_rect, p_region == Rect2() ? Rect2(Point2(), p_texture->get_size()) : p_region, rect, src_rect))
+		return;
+
+	RID texture = p_texture->get_rid();
+	RID normal_map = p_normal_map.is_valid() ? p_normal_map->get_rid() : RID();
+	Size2 texture_size(VS::get_singleton()->texture_get_width(texture), VS::get_singleton()->texture_get_height(texture));
+	if (texture_size.x <= 0 || texture_size.y <= 0)
+		return;
+
+	BakedSurface *surface = NULL;
+	for (int i = 0; i < r_surfaces.size(); i++) {
+		BakedSurface &bs = r_surfaces.write[i];
+		if (bs.canvas_item == p_canvas_item && bs.texture == texture && bs.normal_map == normal_map) {
+			surface = &bs;
+			break;
+		}
+	}
+
+	if (!surface) {
+		BakedSurface bs;
+		bs.canvas_item = p_canvas_item;
+		bs.texture = texture;
+		bs.normal_map = normal_map;
+		r_surfaces.push_back(bs);
+		surface = &r_surfaces.write[r_surfaces.size() - 1];
+	}
+
+	// same placement rules as canvas_item_add_texture_rect_region: negative sizes flip in place, transpose swaps the axes
+	bool flip_h = rect.size.x < 0;
+	bool flip_v = rect.size.y < 0;
+	rect.size = rect.size.abs();
+	if (p_transpose)
+		SWAP(rect.size.x, rect.size.y);
+
+	static const Vector2 corners[4] = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1) };
+
+	int base = surface->points.size();
+	for (int i = 0; i < 4; i++) {
+
+		Vector2 c = corners[i];
+		Vector2 p(flip_h ? 1 - c.x : c.x, flip_v ? 1 - c.y : c.y);
+		Vector2 uv = p_transpose ? Vector2(c.y, c.x) : c;
+
+		surface->points.push_back(rect.position + rect.size * p);
+		surface->uvs.push_back((src_rect.position + src_rect.size * uv) / texture_size);
+		surface->colors.push_back(p_modulate);
+	}
+
+	static const int quad_indices[6] = { 0, 1, 2, 2, 3, 0 };
+	for (int i = 0; i < 6; i++) {
+		surface->indices.push_back(base + quad_indices[i]);
+	}
+}
+
 void TileMap::set_cellv(const Vector2 &p_pos, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose) {
 
 	set_cell(p_pos.x, p_pos.y, p_tile, p_flip_x, p_flip_y, p_transpose);
@@ -746,26 +880,26 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 	if (p_tile == INVALID_CELL) {
 		//erase existing
 		tile_map.erase(pk);
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+		Quadrant *Q = quadrant_map.getptr(qk);
 		ERR_FAIL_COND(!Q);
-		Quadrant &q = Q->get();
+		Quadrant &q = *Q;
 		q.cells.erase(pk);
 		if (q.cells.size() == 0)
-			_erase_quadrant(Q);
+			_erase_quadrant(qk);
 		else
-			_make_quadrant_dirty(Q);
+			_make_cell_dirty(Q, pk);
 
 		return;
 	}
 
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant *Q = quadrant_map.getptr(qk);
 
 	if (!E) {
 		E = tile_map.insert(pk, Cell());
 		if (!Q) {
 			Q = _create_quadrant(qk);
 		}
-		Quadrant &q = Q->get();
+		Quadrant &q = *Q;
 		q.cells.insert(pk);
 	} else {
 		ERR_FAIL_COND(!Q); // quadrant should exist...
@@ -783,7 +917,7 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 	c.autotile_coord_x = (uint16_t)p_autotile_coord.x;
 	c.autotile_coord_y = (uint16_t)p_autotile_coord.y;
 
-	_make_quadrant_dirty(Q);
+	_make_cell_dirty(Q, pk);
 	used_size_cache_dirty = true;
 }
 
@@ -901,8 +1035,8 @@ void TileMap::update_cell_bitmask(int p_x, int p_y) {
 			E->get().autotile_coord_y = (int)coord.y;
 
 			PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
-			Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
-			_make_quadrant_dirty(Q);
+			Quadrant *Q = quadrant_map.getptr(qk);
+			_make_cell_dirty(Q, PosKey(p_x, p_y));
 
 		} else if (tile_set->tile_get_tile_mode(id) == TileSet::SINGLE_TILE) {
 			E->get().autotile_coord_x = 0;
@@ -989,12 +1123,12 @@ void TileMap::set_cell_autotile_coord(int p_x, int p_y, const Vector2 &p_coord)
 	tile_map[pk] = c;
 
 	PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant *Q = quadrant_map.getptr(qk);
 
 	if (!Q)
 		return;
 
-	_make_quadrant_dirty(Q);
+	_make_cell_dirty(Q, pk);
 }
 
 Vector2 TileMap::get_cell_autotile_coord(int p_x, int p_y) const {
@@ -1017,13 +1151,13 @@ void TileMap::_recreate_quadrants() {
 
 		PosKey qk(E->key().x / _get_quadrant_size(), E->key().y / _get_quadrant_size());
 
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+		Quadrant *Q = quadrant_map.getptr(qk);
 		if (!Q) {
 			Q = _create_quadrant(qk);
-			dirty_quadrant_list.add(&Q->get().dirty_list);
+			dirty_quadrant_list.add(&Q->dirty_list);
 		}
 
-		Q->get().cells.insert(E->key());
+		Q->cells.insert(E->key());
 		_make_quadrant_dirty(Q, false);
 	}
 	update_dirty_quadrants();
@@ -1031,8 +1165,11 @@ void TileMap::_recreate_quadrants() {
 
 void TileMap::_clear_quadrants() {
 
-	while (quadrant_map.size()) {
-		_erase_quadrant(quadrant_map.front());
+	// Keys are collected first, looking up the first one again after each erase rescans the table.
+	List<PosKey> keys;
+	quadrant_map.get_key_list(&keys);
+	for (List<PosKey>::Element *E = keys.front(); E; E = E->next()) {
+		_erase_quadrant(E->get());
 	}
 }
 
@@ -1050,9 +1187,9 @@ void TileMap::set_use_parent_material(bool p_use_parent_material) {
 
 void TileMap::_update_all_items_material_state() {
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
 			_update_item_material_state(E->get());
@@ -1162,9 +1299,9 @@ Rect2 TileMap::_edit_get_rect() const {
 void TileMap::set_collision_layer(uint32_t p_layer) {
 
 	collision_layer = p_layer;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Physics2DServer::get_singleton()->body_set_collision_layer(q.body, collision_layer);
 	}
 }
@@ -1172,9 +1309,9 @@ void TileMap::set_collision_layer(uint32_t p_layer) {
 void TileMap::set_collision_mask(uint32_t p_mask) {
 
 	collision_mask = p_mask;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Physics2DServer::get_singleton()->body_set_collision_mask(q.body, collision_mask);
 	}
 }
@@ -1214,9 +1351,9 @@ void TileMap::set_collision_use_kinematic(bool p_use_kinematic) {
 void TileMap::set_collision_friction(float p_friction) {
 
 	friction = p_friction;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Physics2DServer::get_singleton()->body_set_param(q.body, Physics2DServer::BODY_PARAM_FRICTION, p_friction);
 	}
 }
@@ -1229,9 +1366,9 @@ float TileMap::get_collision_friction() const {
 void TileMap::set_collision_bounce(float p_bounce) {
 
 	bounce = p_bounce;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		Quadrant &q = E->get();
+		Quadrant &q = quadrant_map.get(*K);
 		Physics2DServer::get_singleton()->body_set_param(q.body, Physics2DServer::BODY_PARAM_BOUNCE, p_bounce);
 	}
 }
@@ -1526,9 +1663,9 @@ Rect2 TileMap::get_used_rect() { // Not const because of cache
 void TileMap::set_occluder_light_mask(int p_mask) {
 
 	occluder_light_mask = p_mask;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *F = E->get().occluder_instances.front(); F; F = F->next()) {
+		for (Map<PosKey, Quadrant::Occluder>::Element *F = quadrant_map.get(*K).occluder_instances.front(); F; F = F->next()) {
 			VisualServer::get_singleton()->canvas_light_occluder_set_light_mask(F->get().id, occluder_light_mask);
 		}
 	}
@@ -1542,9 +1679,9 @@ int TileMap::get_occluder_light_mask() const {
 void TileMap::set_light_mask(int p_light_mask) {
 
 	CanvasItem::set_light_mask(p_light_mask);
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	for (const PosKey *K = quadrant_map.next(NULL); K; K = quadrant_map.next(K)) {
 
-		for (List<RID>::Element *F = E->get().canvas_items.front(); F; F = F->next()) {
+		for (List<RID>::Element *F = quadrant_map.get(*K).canvas_items.front(); F; F = F->next()) {
 			VisualServer::get_singleton()->canvas_item_set_light_mask(F->get(), get_light_mask());
 		}
 	}
@@ -1565,6 +1702,21 @@ bool TileMap::get_clip_uv() const {
 	return clip_uv;
 }
 
+void TileMap::set_bake_quadrants(bool p_enable) {
+
+	if (bake_quadrants == p_enable)
+		return;
+
+	_clear_quadrants();
+	bake_quadrants = p_enable;
+	_recreate_quadrants();
+}
+
+bool TileMap::is_baking_quadrants() const {
+
+	return bake_quadrants;
+}
+
 void TileMap::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_tileset", "tileset"), &TileMap::set_tileset);
@@ -1594,6 +1746,9 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_clip_uv", "enable"), &TileMap::set_clip_uv);
 	ClassDB::bind_method(D_METHOD("get_clip_uv"), &TileMap::get_clip_uv);
 
+	ClassDB::bind_method(D_METHOD("set_bake_quadrants", "enable"), &TileMap::set_bake_quadrants);
+	ClassDB::bind_method(D_METHOD("is_baking_quadrants"), &TileMap::is_baking_quadrants);
+
 	ClassDB::bind_method(D_METHOD("set_y_sort_mode", "enable"), &TileMap::set_y_sort_mode);
 	ClassDB::bind_method(D_METHOD("is_y_sort_mode_enabled"), &TileMap::is_y_sort_mode_enabled);
 
@@ -1663,6 +1818,7 @@ void TileMap::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_tile_origin", PROPERTY_HINT_ENUM, "Top Left,Center,Bottom Left"), "set_tile_origin", "get_tile_origin");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cell_y_sort"), "set_y_sort_mode", "is_y_sort_mode_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cell_clip_uv"), "set_clip_uv", "get_clip_uv");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cell_bake_quadrants"), "set_bake_quadrants", "is_baking_quadrants");
 
 	ADD_GROUP("Collision", "collision_");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_use_kinematic", PROPERTY_HINT_NONE, ""), "set_collision_use_kinematic", "get_collision_use_kinematic");
@@ -1716,6 +1872,7 @@ TileMap::TileMap() {
 	y_sort_mode = false;
 	occluder_light_mask = 1;
 	clip_uv = false;
+	bake_quadrants = false;
 	format = FORMAT_1; //Always initialize with the lowest format
 
 	fp_adjust = 0.00001;
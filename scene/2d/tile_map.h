@@ -31,6 +31,7 @@
 #ifndef TILE_MAP_H
 #define TILE_MAP_H
 
+#include "core/hash_map.h"
 #include "core/self_list.h"
 #include "core/vset.h"
 #include "scene/2d/navigation2d.h"
@@ -98,6 +99,10 @@ private:
 		}
 	};
 
+	struct PosKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const PosKey &p_key) { return hash_one_uint64(p_key.key); }
+	};
+
 	union Cell {
 
 		struct {
@@ -120,7 +125,12 @@ private:
 
 		Vector2 pos;
 		List<RID> canvas_items;
+		List<RID> meshes; // baked quadrants only
 		RID body;
+		Vector<PosKey> shape_cells; // cell of each shape in body, in shape order
+
+		bool shapes_dirty; // rebuild every shape, otherwise only the ones of dirty_cells
+		VSet<PosKey> dirty_cells;
 
 		SelfList<Quadrant> dirty_list;
 
@@ -142,7 +152,11 @@ private:
 		void operator=(const Quadrant &q) {
 			pos = q.pos;
 			canvas_items = q.canvas_items;
+			meshes = q.meshes;
 			body = q.body;
+			shape_cells = q.shape_cells;
+			shapes_dirty = q.shapes_dirty;
+			dirty_cells = q.dirty_cells;
 			cells = q.cells;
 			navpoly_ids = q.navpoly_ids;
 			occluder_instances = q.occluder_instances;
@@ -151,16 +165,34 @@ private:
 				dirty_list(this) {
 			pos = q.pos;
 			canvas_items = q.canvas_items;
+			meshes = q.meshes;
 			body = q.body;
+			shape_cells = q.shape_cells;
+			shapes_dirty = q.shapes_dirty;
+			dirty_cells = q.dirty_cells;
 			cells = q.cells;
 			occluder_instances = q.occluder_instances;
 			navpoly_ids = q.navpoly_ids;
 		}
 		Quadrant() :
-				dirty_list(this) {}
+				dirty_list(this) {
+			shapes_dirty = true;
+		}
 	};
 
-	Map<PosKey, Quadrant> quadrant_map;
+	HashMap<PosKey, Quadrant, PosKeyHasher> quadrant_map;
+
+	struct BakedSurface {
+
+		RID canvas_item;
+		RID texture;
+		RID normal_map;
+
+		Vector<Vector2> points;
+		Vector<Vector2> uvs;
+		Vector<Color> colors;
+		Vector<int> indices;
+	};
 
 	SelfList<Quadrant>::List dirty_quadrant_list;
 
@@ -173,6 +205,7 @@ private:
 	bool quadrant_order_dirty;
 	bool y_sort_mode;
 	bool clip_uv;
+	bool bake_quadrants;
 	float fp_adjust;
 	float friction;
 	float bounce;
@@ -186,9 +219,12 @@ private:
 
 	void _fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc);
 
-	Map<PosKey, Quadrant>::Element *_create_quadrant(const PosKey &p_qk);
-	void _erase_quadrant(Map<PosKey, Quadrant>::Element *Q);
-	void _make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update = true);
+	Quadrant *_create_quadrant(const PosKey &p_qk);
+	void _erase_quadrant(const PosKey &p_qk);
+	void _queue_quadrant_update(Quadrant *p_q, bool update);
+	void _make_quadrant_dirty(Quadrant *p_q, bool update = true);
+	void _make_cell_dirty(Quadrant *p_q, const PosKey &p_cell);
+	void _bake_tile(Vector<BakedSurface> &r_surfaces, const RID &p_canvas_item, const Ref<Texture> &p_texture, const Ref<Texture> &p_normal_map, const Rect2 &p_rect, const Rect2 &p_region, const Color &p_modulate, bool p_transpose);
 	void _recreate_quadrants();
 	void _clear_quadrants();
 	void _update_quadrant_space(const RID &p_space);
@@ -312,6 +348,9 @@ public:
 	void set_clip_uv(bool p_enable);
 	bool get_clip_uv() const;
 
+	void set_bake_quadrants(bool p_enable);
+	bool is_baking_quadrants() const;
+
 	void fix_invalid_tiles();
 	void clear();
 
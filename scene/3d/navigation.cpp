@@ -30,7 +30,75 @@
 
 #include "navigation.h"
 
-#define USE_ENTRY_POINT
+#include "core/message_queue.h"
+#include "core/sort.h"
+
+void Navigation::PathSearch::begin(int p_polygons, int p_clusters) {
+
+	if (reached.size() != p_polygons || cluster_reached.size() != p_clusters) {
+
+		reached.resize(p_polygons);
+		closed.resize(p_polygons);
+		distance.resize(p_polygons);
+		prev_edge.resize(p_polygons);
+		entry.resize(p_polygons);
+
+		cluster_reached.resize(p_clusters);
+		cluster_closed.resize(p_clusters);
+		cluster_distance.resize(p_clusters);
+		cluster_prev.resize(p_clusters);
+		corridor.resize(p_clusters);
+
+		pass = 0;
+	}
+
+	pass++;
+	if (pass == 1) {
+		// First use, or the pass counter wrapped around.
+		zeromem(reached.ptrw(), p_polygons * sizeof(uint32_t));
+		zeromem(closed.ptrw(), p_polygons * sizeof(uint32_t));
+		zeromem(cluster_reached.ptrw(), p_clusters * sizeof(uint32_t));
+		zeromem(cluster_closed.ptrw(), p_clusters * sizeof(uint32_t));
+		zeromem(corridor.ptrw(), p_clusters * sizeof(uint32_t));
+	}
+
+	open_count = 0;
+}
+
+void Navigation::PathSearch::push_open(float p_cost, int p_id) {
+
+	if (open_count == open.size()) {
+		open.resize(MAX(64, open_count * 2));
+	}
+
+	OpenEntry e;
+	e.cost = p_cost;
+	e.id = p_id;
+
+	OpenEntry *heap = open.ptrw();
+	heap[open_count] = e;
+	SortArray<OpenEntry, OpenComparator> sorter;
+	sorter.push_heap(0, open_count, 0, e, heap);
+	open_count++;
+}
+
+int Navigation::PathSearch::pop_open() {
+
+	if (open_count == 0)
+		return -1;
+
+	OpenEntry *heap = open.ptrw();
+	SortArray<OpenEntry, OpenComparator> sorter;
+	sorter.pop_heap(0, open_count, heap);
+	open_count--;
+	return heap[open_count].id;
+}
+
+Navigation::PathSearch::PathSearch() {
+
+	pass = 0;
+	open_count = 0;
+}
 
 void Navigation::_navmesh_link(int p_id) {
 
@@ -98,6 +166,17 @@ void Navigation::_navmesh_link(int p_id) {
 			p.center /= plen;
 		}
 
+		for (int j = 0; j < plen; j++) {
+			Vector3 v = _get_vertex(p.edges[j].point);
+			if (j == 0)
+				p.aabb = AABB(v, Vector3());
+			else
+				p.aabb.expand_to(v);
+		}
+		p.index_id = polygon_index.create(&p, p.aabb);
+		p.id = -1;
+		p.cluster = -1;
+
 		//connect
 
 		for (int j = 0; j < plen; j++) {
@@ -136,6 +215,7 @@ void Navigation::_navmesh_link(int p_id) {
 	}
 
 	nm.linked = true;
+	graph_dirty = true;
 }
 
 void Navigation::_navmesh_unlink(int p_id) {
@@ -147,6 +227,7 @@ void Navigation::_navmesh_unlink(int p_id) {
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 
 		Polygon &p = E->get();
+		polygon_index.erase(p.index_id);
 
 		int ec = p.edges.size();
 		Polygon::Edge *edges = p.edges.ptrw();
@@ -202,10 +283,13 @@ void Navigation::_navmesh_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	graph_dirty = true;
 }
 
 int Navigation::navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &p_xform, Object *p_owner) {
 
+	_wait_path_requests();
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -225,6 +309,7 @@ void Navigation::navmesh_set_transform(int p_id, const Transform &p_xform) {
 	NavMesh &nm = navmesh_map[p_id];
 	if (nm.xform == p_xform)
 		return; //bleh
+	_wait_path_requests();
 	_navmesh_unlink(p_id);
 	nm.xform = p_xform;
 	_navmesh_link(p_id);
@@ -232,11 +317,222 @@ void Navigation::navmesh_set_transform(int p_id, const Transform &p_xform) {
 void Navigation::navmesh_remove(int p_id) {
 
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
+	_wait_path_requests();
 	_navmesh_unlink(p_id);
 	navmesh_map.erase(p_id);
 }
 
-void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly) {
+void Navigation::_update_graph() {
+
+	if (!graph_dirty)
+		return;
+
+	polygons.clear();
+	clusters.clear();
+	polygon_bounds = AABB();
+	search_radius = 0;
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+
+		if (!E->get().linked)
+			continue;
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			Polygon &p = F->get();
+			p.id = polygons.size();
+			p.cluster = -1;
+
+			if (polygons.empty())
+				polygon_bounds = p.aabb;
+			else
+				polygon_bounds.merge_with(p.aabb);
+			search_radius += p.aabb.get_longest_axis_size();
+
+			polygons.push_back(&p);
+		}
+	}
+
+	// Closest polygon searches start with a box about the size of a polygon.
+	if (polygons.size()) {
+		search_radius /= polygons.size();
+	}
+	search_radius = MAX(search_radius, cell_size);
+
+	// Clusters grow breadth first, so they are connected and roughly round.
+	Polygon **polys = polygons.ptrw();
+	Vector<Polygon *> queue;
+	queue.resize(polygons.size());
+	Polygon **q = queue.ptrw();
+
+	for (int i = 0; i < polygons.size(); i++) {
+
+		if (polys[i]->cluster != -1)
+			continue;
+
+		Cluster c;
+		int cluster = clusters.size();
+		int count = 1;
+		q[0] = polys[i];
+		polys[i]->cluster = cluster;
+
+		for (int j = 0; j < count; j++) {
+
+			Polygon *p = q[j];
+			c.center += p->center;
+
+			for (int k = 0; k < p->edges.size(); k++) {
+
+				Polygon *n = p->edges[k].C;
+				if (n && n->cluster == -1 && count < cluster_size) {
+					n->cluster = cluster;
+					q[count++] = n;
+				}
+			}
+		}
+
+		c.center /= count;
+		clusters.push_back(c);
+	}
+
+	Cluster *cl = clusters.ptrw();
+	for (int i = 0; i < polygons.size(); i++) {
+
+		Polygon *p = polys[i];
+		for (int j = 0; j < p->edges.size(); j++) {
+
+			Polygon *n = p->edges[j].C;
+			if (n && n->cluster != p->cluster && cl[p->cluster].neighbors.find(n->cluster) == -1) {
+				cl[p->cluster].neighbors.push_back(n->cluster);
+			}
+		}
+	}
+
+	graph_dirty = false;
+}
+
+int Navigation::_cull_polygons(const AABB &p_aabb, PathSearch &r_search) const {
+
+	if (r_search.cull.empty()) {
+		r_search.cull.resize(64);
+	}
+
+	while (true) {
+
+		int count = polygon_index.cull_aabb(p_aabb, r_search.cull.ptrw(), r_search.cull.size());
+		if (count < r_search.cull.size())
+			return count;
+
+		r_search.cull.resize(count * 2);
+	}
+}
+
+Navigation::Polygon *Navigation::_get_closest_polygon(const Vector3 &p_point, PathSearch &r_search, Vector3 *r_closest, Vector3 *r_normal) const {
+
+	Polygon *closest = NULL;
+	float closest_d = 1e20;
+
+	if (polygons.empty())
+		return NULL;
+
+	// Nothing outside the searched box can be closer than its half size, so it grows until something is,
+	// or until it holds all polygons.
+	Vector3 to_min = (polygon_bounds.position - p_point).abs();
+	Vector3 to_max = (polygon_bounds.position + polygon_bounds.size - p_point).abs();
+	real_t max_radius = MAX(MAX(to_min.x, to_max.x), MAX(MAX(to_min.y, to_max.y), MAX(to_min.z, to_max.z)));
+	real_t radius = search_radius;
+
+	while (true) {
+
+		AABB box(p_point - Vector3(radius, radius, radius), Vector3(radius, radius, radius) * 2);
+		int count = _cull_polygons(box, r_search);
+
+		for (int i = 0; i < count; i++) {
+
+			Polygon *p = r_search.cull[i];
+			for (int j = 2; j < p->edges.size(); j++) {
+
+				Face3 f(_get_vertex(p->edges[0].point), _get_vertex(p->edges[j - 1].point), _get_vertex(p->edges[j].point));
+				Vector3 spoint = f.get_closest_point_to(p_point);
+				float d = spoint.distance_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = p;
+					*r_closest = spoint;
+					if (r_normal) {
+						*r_normal = f.get_plane().normal;
+					}
+				}
+			}
+		}
+
+		if (closest_d <= radius || radius >= max_radius)
+			break;
+
+		radius *= 2;
+	}
+
+	return closest;
+}
+
+bool Navigation::_find_corridor(int p_from_cluster, int p_to_cluster, PathSearch &r_search) const {
+
+	uint32_t pass = r_search.pass;
+	const Cluster *cl = clusters.ptr();
+	uint32_t *reached = r_search.cluster_reached.ptrw();
+	uint32_t *closed = r_search.cluster_closed.ptrw();
+	float *distance = r_search.cluster_distance.ptrw();
+	int *prev = r_search.cluster_prev.ptrw();
+
+	reached[p_from_cluster] = pass;
+	distance[p_from_cluster] = 0;
+	prev[p_from_cluster] = -1;
+	r_search.push_open(cl[p_from_cluster].center.distance_to(cl[p_to_cluster].center), p_from_cluster);
+
+	bool found = false;
+	int id;
+
+	while ((id = r_search.pop_open()) != -1) {
+
+		if (closed[id] == pass)
+			continue;
+		closed[id] = pass;
+
+		if (id == p_to_cluster) {
+			found = true;
+			break;
+		}
+
+		const Cluster &c = cl[id];
+		for (int i = 0; i < c.neighbors.size(); i++) {
+
+			int n = c.neighbors[i];
+			if (closed[n] == pass)
+				continue;
+
+			float d = distance[id] + c.center.distance_to(cl[n].center);
+			if (reached[n] != pass || d < distance[n]) {
+				reached[n] = pass;
+				distance[n] = d;
+				prev[n] = id;
+				r_search.push_open(d + cl[n].center.distance_to(cl[p_to_cluster].center), n);
+			}
+		}
+	}
+
+	r_search.open_count = 0;
+
+	if (!found)
+		return false;
+
+	uint32_t *corridor = r_search.corridor.ptrw();
+	for (int c = p_to_cluster; c != -1; c = prev[c]) {
+		corridor[c] = pass;
+	}
+
+	return true;
+}
+
+void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly, const PathSearch &p_search) const {
 
 	Vector3 from = path[path.size() - 1];
 
@@ -251,7 +547,7 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 
 	while (from_poly != p_to_poly) {
 
-		int pe = from_poly->prev_edge;
+		int pe = p_search.prev_edge[from_poly->id];
 		Vector3 a = _get_vertex(from_poly->edges[pe].point);
 		Vector3 b = _get_vertex(from_poly->edges[(pe + 1) % from_poly->edges.size()].point);
 
@@ -270,45 +566,12 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 	}
 }
 
-Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+Vector<Vector3> Navigation::_get_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize, PathSearch &r_search) const {
 
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 spoint = f.get_closest_point_to(p_start);
-				float dpoint = spoint.distance_to(p_start);
-				if (dpoint < begin_d) {
-					begin_d = dpoint;
-					begin_poly = &p;
-					begin_point = spoint;
-				}
-
-				spoint = f.get_closest_point_to(p_end);
-				dpoint = spoint.distance_to(p_end);
-				if (dpoint < end_d) {
-					end_d = dpoint;
-					end_poly = &p;
-					end_point = spoint;
-				}
-			}
-
-			p.prev_edge = -1;
-		}
-	}
+	Polygon *begin_poly = _get_closest_polygon(p_start, r_search, &begin_point);
+	Polygon *end_poly = _get_closest_polygon(p_end, r_search, &end_point);
 
 	if (!begin_poly || !end_poly) {
 
@@ -324,122 +587,88 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		return path;
 	}
 
-	bool found_route = false;
-
-	List<Polygon *> open_list;
+	r_search.begin(polygons.size(), clusters.size());
+	uint32_t pass = r_search.pass;
 
-	for (int i = 0; i < begin_poly->edges.size(); i++) {
+	bool use_corridor = hierarchical_pathfinding && begin_poly->cluster != end_poly->cluster;
+	if (use_corridor && !_find_corridor(begin_poly->cluster, end_poly->cluster, r_search)) {
 
-		if (begin_poly->edges[i].C) {
-
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
-#ifdef USE_ENTRY_POINT
-			Vector3 edge[2] = {
-				_get_vertex(begin_poly->edges[i].point),
-				_get_vertex(begin_poly->edges[(i + 1) % begin_poly->edges.size()].point)
-			};
-
-			Vector3 entry = Geometry::get_closest_point_to_segment(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_poly->entry.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
-#else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
-#endif
-			open_list.push_back(begin_poly->edges[i].C);
-
-			if (begin_poly->edges[i].C == end_poly) {
-				found_route = true;
-			}
-		}
+		return Vector<Vector3>(); //not connected
 	}
 
-	while (!found_route) {
-
-		if (open_list.size() == 0) {
-			break;
-		}
-		//check open list
-
-		List<Polygon *>::Element *least_cost_poly = NULL;
-		float least_cost = 1e30;
-
-		//this could be faster (cache previous results)
-		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
+	uint32_t *reached = r_search.reached.ptrw();
+	uint32_t *closed = r_search.closed.ptrw();
+	float *distance = r_search.distance.ptrw();
+	int *prev_edge = r_search.prev_edge.ptrw();
+	Vector3 *entry = r_search.entry.ptrw();
+	const uint32_t *corridor = r_search.corridor.ptr();
+	Polygon *const *polys = polygons.ptr();
 
-			Polygon *p = E->get();
+	reached[begin_poly->id] = pass;
+	distance[begin_poly->id] = 0;
+	prev_edge[begin_poly->id] = -1;
+	entry[begin_poly->id] = begin_point;
+	r_search.push_open(begin_point.distance_to(end_point), begin_poly->id);
 
-			float cost = p->distance;
-#ifdef USE_ENTRY_POINT
-			int es = p->edges.size();
-
-			float shortest_distance = 1e30;
+	bool found_route = false;
+	int id;
 
-			for (int i = 0; i < es; i++) {
-				Polygon::Edge &e = p->edges.write[i];
+	while (!found_route && (id = r_search.pop_open()) != -1) {
 
-				if (!e.C)
-					continue;
+		if (closed[id] == pass)
+			continue; //expanded already, with a lower cost
+		closed[id] = pass;
 
-				Vector3 edge[2] = {
-					_get_vertex(p->edges[i].point),
-					_get_vertex(p->edges[(i + 1) % es].point)
-				};
-
-				Vector3 edge_point = Geometry::get_closest_point_to_segment(p->entry, edge);
-				float dist = p->entry.distance_to(edge_point);
-				if (dist < shortest_distance)
-					shortest_distance = dist;
-			}
+		const Polygon *p = polys[id];
+		const Polygon::Edge *edges = p->edges.ptr();
+		int es = p->edges.size();
 
-			cost += shortest_distance;
-#else
-			cost += p->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_poly = E;
-				least_cost = cost;
-			}
-		}
-
-		Polygon *p = least_cost_poly->get();
 		//open the neighbours for search
+		for (int i = 0; i < es; i++) {
 
-		for (int i = 0; i < p->edges.size(); i++) {
-
-			Polygon::Edge &e = p->edges.write[i];
-
-			if (!e.C)
+			Polygon *c = edges[i].C;
+			if (!c || c == begin_poly)
+				continue;
+			if (use_corridor && corridor[c->cluster] != pass)
 				continue;
 
-			float distance = p->center.distance_to(e.C->center) + p->distance;
+			Vector3 edge[2] = {
+				_get_vertex(edges[i].point),
+				_get_vertex(edges[(i + 1) % es].point)
+			};
+
+			Vector3 edge_entry = Geometry::get_closest_point_to_segment(entry[id], edge);
+			float d = entry[id].distance_to(edge_entry) + distance[id];
 
-			if (e.C->prev_edge != -1) {
+			int cid = c->id;
+			if (reached[cid] == pass) {
 				//oh this was visited already, can we win the cost?
 
-				if (e.C->distance > distance) {
+				if (distance[cid] > d) {
 
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
+					prev_edge[cid] = edges[i].C_edge;
+					distance[cid] = d;
+					entry[cid] = edge_entry;
+					if (closed[cid] != pass) {
+						r_search.push_open(d + edge_entry.distance_to(end_point), cid);
+					}
 				}
 			} else {
 				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
-				open_list.push_back(e.C);
+				reached[cid] = pass;
+				prev_edge[cid] = edges[i].C_edge;
+				distance[cid] = d;
+				entry[cid] = edge_entry;
+				r_search.push_open(d + edge_entry.distance_to(end_point), cid);
 
-				if (e.C == end_poly) {
+				if (c == end_poly) {
 					//oh my reached end! stop algorithm
 					found_route = true;
 					break;
 				}
 			}
 		}
-
-		if (found_route)
-			break;
-
-		open_list.erase(least_cost_poly);
 	}
 
 	if (found_route) {
@@ -469,8 +698,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
+					int prev = prev_edge[p->id];
+					int prev_n = (prev + 1) % p->edges.size();
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
@@ -489,7 +718,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_left = left;
 					} else {
 
-						_clip_path(path, apex_poly, portal_right, right_poly);
+						_clip_path(path, apex_poly, portal_right, right_poly, r_search);
 
 						apex_point = portal_right;
 						p = right_poly;
@@ -509,7 +738,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_right = right;
 					} else {
 
-						_clip_path(path, apex_poly, portal_left, left_poly);
+						_clip_path(path, apex_poly, portal_left, left_poly, r_search);
 
 						apex_point = portal_left;
 						p = left_poly;
@@ -522,7 +751,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				}
 
 				if (p != begin_poly)
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[prev_edge[p->id]].C;
 				else
 					p = NULL;
 			}
@@ -538,8 +767,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 			path.push_back(end_point);
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
+				int prev = prev_edge[p->id];
+				int prev_n = (prev + 1) % p->edges.size();
 				Vector3 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 				path.push_back(point);
 				p = p->edges[prev].C;
@@ -558,6 +787,189 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 	return Vector<Vector3>();
 }
 
+Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	_update_graph();
+	return _get_path(p_start, p_end, p_optimize, main_search);
+}
+
+void Navigation::_run_path_job(uint32_t p_index, PathBatch *p_batch) {
+
+	int from = p_batch->count * p_index / p_batch->job_count;
+	int to = p_batch->count * (p_index + 1) / p_batch->job_count;
+	PathSearch &search = p_batch->searches[p_index];
+
+	for (int i = from; i < to; i++) {
+
+		PathRequest &r = p_batch->requests[i];
+		r.path = _get_path(r.start, r.end, r.optimize, search);
+	}
+}
+
+WorkerThreadPool::GroupID Navigation::_start_path_batch(PathBatch &r_batch, Vector<PathSearch> &r_searches, PathRequest *p_requests, int p_count) {
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	int job_count = 1;
+	if (pool) {
+		job_count = CLAMP((p_count + PATH_REQUESTS_PER_JOB - 1) / PATH_REQUESTS_PER_JOB, 1, pool->get_thread_count() + 1);
+	}
+
+	if (r_searches.size() < job_count) {
+		r_searches.resize(job_count);
+	}
+
+	r_batch.requests = p_requests;
+	r_batch.count = p_count;
+	r_batch.searches = r_searches.ptrw();
+	r_batch.job_count = job_count;
+
+	if (!pool) {
+		_run_path_job(0, &r_batch);
+		return WorkerThreadPool::INVALID_GROUP_ID;
+	}
+
+	return pool->add_template_group_task(this, &Navigation::_run_path_job, &r_batch, job_count);
+}
+
+Array Navigation::get_simple_paths(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize) {
+
+	ERR_FAIL_COND_V(p_starts.size() != p_ends.size(), Array());
+
+	_update_graph();
+
+	int count = p_starts.size();
+	Vector<PathRequest> requests;
+	requests.resize(count);
+	PathRequest *w = requests.ptrw();
+
+	PoolVector<Vector3>::Read rs = p_starts.read();
+	PoolVector<Vector3>::Read re = p_ends.read();
+	for (int i = 0; i < count; i++) {
+		w[i].start = rs[i];
+		w[i].end = re[i];
+		w[i].optimize = p_optimize;
+	}
+
+	if (count <= PATH_REQUESTS_PER_JOB) {
+		for (int i = 0; i < count; i++) {
+			w[i].path = _get_path(w[i].start, w[i].end, p_optimize, main_search);
+		}
+	} else {
+		PathBatch batch;
+		WorkerThreadPool::GroupID group = _start_path_batch(batch, batch_searches, w, count);
+		if (group != WorkerThreadPool::INVALID_GROUP_ID) {
+			WorkerThreadPool::get_singleton()->wait_for_group(group);
+		}
+	}
+
+	Array paths;
+	paths.resize(count);
+	for (int i = 0; i < count; i++) {
+		paths[i] = w[i].path;
+	}
+
+	return paths;
+}
+
+int Navigation::request_simple_path(const Vector3 &p_start, const Vector3 &p_end, Object *p_target, const StringName &p_method, bool p_optimize) {
+
+	ERR_FAIL_NULL_V(p_target, 0);
+	ERR_EXPLAIN("Path requests are answered while the Navigation node is processed, it must be inside the tree.");
+	ERR_FAIL_COND_V(!is_inside_tree(), 0);
+
+	PathRequest r;
+	r.id = last_request_id++;
+	r.start = p_start;
+	r.end = p_end;
+	r.optimize = p_optimize;
+	r.target = p_target->get_instance_id();
+	r.method = p_method;
+	queued_requests.push_back(r);
+
+	if (!dispatch_queued) {
+		// Sent once the frame is done, so all the requests made during it are searched together.
+		MessageQueue::get_singleton()->push_call(this, "_dispatch_path_requests");
+		dispatch_queued = true;
+	}
+
+	set_process_internal(true);
+
+	return r.id;
+}
+
+void Navigation::cancel_path_request(int p_id) {
+
+	for (int i = 0; i < queued_requests.size(); i++) {
+
+		if (queued_requests[i].id == p_id) {
+			queued_requests.remove(i);
+			return;
+		}
+	}
+
+	// Already being searched, only the callback is dropped.
+	for (int i = 0; i < running_requests.size(); i++) {
+
+		if (running_requests[i].id == p_id) {
+			running_requests.write[i].target = 0;
+			return;
+		}
+	}
+}
+
+void Navigation::_dispatch_path_requests() {
+
+	dispatch_queued = false;
+
+	// The previous batch is not delivered yet, these are sent after it.
+	if (running_requests.size() || queued_requests.empty())
+		return;
+
+	_update_graph();
+
+	running_requests = queued_requests;
+	queued_requests.clear();
+	running_group = _start_path_batch(running_batch, request_searches, running_requests.ptrw(), running_requests.size());
+}
+
+void Navigation::_wait_path_requests() {
+
+	if (running_group == WorkerThreadPool::INVALID_GROUP_ID)
+		return;
+
+	WorkerThreadPool::get_singleton()->wait_for_group(running_group);
+	running_group = WorkerThreadPool::INVALID_GROUP_ID;
+}
+
+void Navigation::_deliver_path_requests() {
+
+	_wait_path_requests();
+
+	// Callbacks may request new paths.
+	Vector<PathRequest> requests = running_requests;
+	running_requests.clear();
+
+	for (int i = 0; i < requests.size(); i++) {
+
+		const PathRequest &r = requests[i];
+		Object *target = ObjectDB::get_instance(r.target);
+		if (!target)
+			continue;
+
+		target->call(r.method, r.id, r.path);
+	}
+
+	if (queued_requests.size()) {
+		if (!dispatch_queued) {
+			MessageQueue::get_singleton()->push_call(this, "_dispatch_path_requests");
+			dispatch_queued = true;
+		}
+	} else {
+		set_process_internal(false);
+	}
+}
+
 Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision) {
 
 	bool use_collision = p_use_collision;
@@ -613,100 +1025,80 @@ Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Ve
 
 Vector3 Navigation::get_closest_point(const Vector3 &p_point) {
 
-	Vector3 closest_point;
-	float closest_point_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
-		}
-	}
+	_update_graph();
 
+	Vector3 closest_point;
+	_get_closest_polygon(p_point, main_search, &closest_point);
 	return closest_point;
 }
 
 Vector3 Navigation::get_closest_point_normal(const Vector3 &p_point) {
 
+	_update_graph();
+
 	Vector3 closest_point;
 	Vector3 closest_normal;
-	float closest_point_d = 1e20;
+	_get_closest_polygon(p_point, main_search, &closest_point, &closest_normal);
+	return closest_normal;
+}
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	_update_graph();
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	Vector3 closest_point;
+	Polygon *closest = _get_closest_polygon(p_point, main_search, &closest_point);
+	return closest ? closest->owner->owner : NULL;
+}
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					closest_normal = f.get_plane().normal;
-				}
-			}
-		}
-	}
+void Navigation::set_up_vector(const Vector3 &p_up) {
 
-	return closest_normal;
+	_wait_path_requests();
+	up = p_up;
 }
 
-Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
+Vector3 Navigation::get_up_vector() const {
 
-	Vector3 closest_point;
-	Object *owner = NULL;
-	float closest_point_d = 1e20;
+	return up;
+}
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+void Navigation::set_hierarchical_pathfinding(bool p_enable) {
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	_wait_path_requests();
+	hierarchical_pathfinding = p_enable;
+}
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+bool Navigation::is_hierarchical_pathfinding_enabled() const {
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
-		}
-	}
+	return hierarchical_pathfinding;
+}
+
+void Navigation::set_cluster_size(int p_size) {
 
-	return owner;
+	ERR_FAIL_COND(p_size < 1);
+	_wait_path_requests();
+	cluster_size = p_size;
+	graph_dirty = true;
 }
 
-void Navigation::set_up_vector(const Vector3 &p_up) {
+int Navigation::get_cluster_size() const {
 
-	up = p_up;
+	return cluster_size;
 }
 
-Vector3 Navigation::get_up_vector() const {
+void Navigation::_notification(int p_what) {
 
-	return up;
+	switch (p_what) {
+
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			_deliver_path_requests();
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+
+			_wait_path_requests();
+		} break;
+	}
 }
 
 void Navigation::_bind_methods() {
@@ -716,6 +1108,9 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navmesh_remove", "id"), &Navigation::navmesh_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths", "starts", "ends", "optimize"), &Navigation::get_simple_paths, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("request_simple_path", "start", "end", "target", "method", "optimize"), &Navigation::request_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("cancel_path_request", "id"), &Navigation::cancel_path_request);
 	ClassDB::bind_method(D_METHOD("get_closest_point_to_segment", "start", "end", "use_collision"), &Navigation::get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_normal", "to_point"), &Navigation::get_closest_point_normal);
@@ -724,7 +1119,17 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_up_vector", "up"), &Navigation::set_up_vector);
 	ClassDB::bind_method(D_METHOD("get_up_vector"), &Navigation::get_up_vector);
 
+	ClassDB::bind_method(D_METHOD("set_hierarchical_pathfinding", "enable"), &Navigation::set_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("is_hierarchical_pathfinding_enabled"), &Navigation::is_hierarchical_pathfinding_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "size"), &Navigation::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &Navigation::get_cluster_size);
+
+	ClassDB::bind_method(D_METHOD("_dispatch_path_requests"), &Navigation::_dispatch_path_requests);
+
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "up_vector"), "set_up_vector", "get_up_vector");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "hierarchical_pathfinding"), "set_hierarchical_pathfinding", "is_hierarchical_pathfinding_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cluster_size", PROPERTY_HINT_RANGE, "1,1024,1"), "set_cluster_size", "get_cluster_size");
 }
 
 Navigation::Navigation() {
@@ -733,4 +1138,18 @@ Navigation::Navigation() {
 	cell_size = 0.01; //one centimeter
 	last_id = 1;
 	up = Vector3(0, 1, 0);
+
+	graph_dirty = true;
+	search_radius = 0;
+	hierarchical_pathfinding = false;
+	cluster_size = 64;
+
+	last_request_id = 1;
+	running_group = WorkerThreadPool::INVALID_GROUP_ID;
+	dispatch_queued = false;
+}
+
+Navigation::~Navigation() {
+
+	_wait_path_requests();
 }
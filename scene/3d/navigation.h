@@ -31,6 +31,8 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include "core/math/bvh.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/3d/spatial.h"
 
@@ -94,13 +96,15 @@ class Navigation : public Spatial {
 		Vector<Edge> edges;
 
 		Vector3 center;
-		Vector3 entry;
-
-		float distance;
-		int prev_edge;
+		AABB aabb;
 		bool clockwise;
 
 		NavMesh *owner;
+		BVHElementID index_id;
+
+		// Only valid while the graph is up to date, see _update_graph().
+		int id;
+		int cluster;
 	};
 
 	struct Connection {
@@ -131,6 +135,78 @@ class Navigation : public Spatial {
 		List<Polygon> polygons;
 	};
 
+	// Group of up to cluster_size connected polygons. Clusters are searched first, and the polygon search
+	// is then restricted to the clusters on that path.
+	struct Cluster {
+
+		Vector3 center;
+		Vector<int> neighbors;
+	};
+
+	struct OpenEntry {
+
+		float cost;
+		int id;
+	};
+
+	struct OpenComparator {
+
+		_FORCE_INLINE_ bool operator()(const OpenEntry &p_a, const OpenEntry &p_b) const { return p_a.cost > p_b.cost; }
+	};
+
+	// Scratch state of one search. Polygons and clusters hold no search state, so searches can run on
+	// several threads at once. Entries are only valid when their pass matches the current one.
+	struct PathSearch {
+
+		uint32_t pass;
+
+		Vector<uint32_t> reached;
+		Vector<uint32_t> closed;
+		Vector<float> distance;
+		Vector<int> prev_edge;
+		Vector<Vector3> entry;
+
+		Vector<uint32_t> cluster_reached;
+		Vector<uint32_t> cluster_closed;
+		Vector<float> cluster_distance;
+		Vector<int> cluster_prev;
+		Vector<uint32_t> corridor;
+
+		Vector<OpenEntry> open; // binary heap
+		int open_count;
+
+		Vector<Polygon *> cull;
+
+		void begin(int p_polygons, int p_clusters);
+		void push_open(float p_cost, int p_id);
+		int pop_open();
+
+		PathSearch();
+	};
+
+	struct PathRequest {
+
+		int id;
+		Vector3 start;
+		Vector3 end;
+		bool optimize;
+		ObjectID target;
+		StringName method;
+		Vector<Vector3> path;
+	};
+
+	struct PathBatch {
+
+		PathRequest *requests;
+		int count;
+		PathSearch *searches;
+		int job_count;
+	};
+
+	enum {
+		PATH_REQUESTS_PER_JOB = 8
+	};
+
 	_FORCE_INLINE_ Point _get_point(const Vector3 &p_pos) const {
 
 		int x = int(Math::floor(p_pos.x / cell_size));
@@ -158,9 +234,43 @@ class Navigation : public Spatial {
 	int last_id;
 
 	Vector3 up;
-	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
+
+	BVH<Polygon> polygon_index;
+	bool graph_dirty;
+	Vector<Polygon *> polygons;
+	Vector<Cluster> clusters;
+	AABB polygon_bounds;
+	real_t search_radius;
+
+	bool hierarchical_pathfinding;
+	int cluster_size;
+
+	PathSearch main_search;
+	Vector<PathSearch> batch_searches;
+	Vector<PathSearch> request_searches;
+
+	int last_request_id;
+	Vector<PathRequest> queued_requests;
+	Vector<PathRequest> running_requests;
+	PathBatch running_batch;
+	WorkerThreadPool::GroupID running_group;
+	bool dispatch_queued;
+
+	void _update_graph();
+	int _cull_polygons(const AABB &p_aabb, PathSearch &r_search) const;
+	Polygon *_get_closest_polygon(const Vector3 &p_point, PathSearch &r_search, Vector3 *r_closest, Vector3 *r_normal = NULL) const;
+	bool _find_corridor(int p_from_cluster, int p_to_cluster, PathSearch &r_search) const;
+	Vector<Vector3> _get_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize, PathSearch &r_search) const;
+	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly, const PathSearch &p_search) const;
+
+	void _run_path_job(uint32_t p_index, PathBatch *p_batch);
+	WorkerThreadPool::GroupID _start_path_batch(PathBatch &r_batch, Vector<PathSearch> &r_searches, PathRequest *p_requests, int p_count);
+	void _dispatch_path_requests();
+	void _wait_path_requests();
+	void _deliver_path_requests();
 
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -173,12 +283,24 @@ public:
 	void navmesh_remove(int p_id);
 
 	Vector<Vector3> get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+	Array get_simple_paths(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize = true);
+
+	int request_simple_path(const Vector3 &p_start, const Vector3 &p_end, Object *p_target, const StringName &p_method, bool p_optimize = true);
+	void cancel_path_request(int p_id);
+
+	void set_hierarchical_pathfinding(bool p_enable);
+	bool is_hierarchical_pathfinding_enabled() const;
+
+	void set_cluster_size(int p_size);
+	int get_cluster_size() const;
+
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision = false);
 	Vector3 get_closest_point(const Vector3 &p_point);
 	Vector3 get_closest_point_normal(const Vector3 &p_point);
 	Object *get_closest_point_owner(const Vector3 &p_point);
 
 	Navigation();
+	~Navigation();
 };
 
 #endif // NAVIGATION_H
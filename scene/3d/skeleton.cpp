@@ -109,7 +109,7 @@ bool Skeleton::_get(const StringName &p_path, Variant &r_ret) const {
 	else if (what == "bound_children") {
 		Array children;
 
-		for (const List<uint32_t>::Element *E = bones[which].nodes_bound.front(); E; E = E->next()) {
+		for (const List<ObjectID>::Element *E = bones[which].nodes_bound.front(); E; E = E->next()) {
 
 			Object *obj = ObjectDB::get_instance(E->get());
 			ERR_CONTINUE(!obj);
@@ -234,29 +234,11 @@ void Skeleton::_notification(int p_what) {
 
 			vs->skeleton_allocate(skeleton, len); // if same size, nothin really happens
 
-			_update_process_order();
+			if (!bone_poses_updated)
+				_update_bone_poses();
 
 			const int *order = process_order.ptr();
 
-			// pose changed, rebuild cache of inverses
-			if (rest_global_inverse_dirty) {
-
-				// calculate global rests and invert them
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					if (b.parent >= 0)
-						b.rest_global_inverse = bonesptr[b.parent].rest_global_inverse * b.rest;
-					else
-						b.rest_global_inverse = b.rest;
-				}
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					b.rest_global_inverse.affine_invert();
-				}
-
-				rest_global_inverse_dirty = false;
-			}
-
 			Transform global_transform = get_global_transform();
 			Transform global_transform_inverse = global_transform.affine_inverse();
 
@@ -264,77 +246,123 @@ void Skeleton::_notification(int p_what) {
 
 				Bone &b = bonesptr[order[i]];
 
-				if (b.disable_rest) {
-					if (b.enabled) {
+				vs->skeleton_bone_set_transform(skeleton, order[i], global_transform * (b.transform_final * global_transform_inverse));
+
+				for (List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+
+					Object *obj = ObjectDB::get_instance(E->get());
+					ERR_CONTINUE(!obj);
+					Spatial *sp = Object::cast_to<Spatial>(obj);
+					ERR_CONTINUE(!sp);
+					sp->set_transform(b.pose_global);
+				}
+			}
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+			dirty = false;
+			bone_poses_updated = false;
+		} break;
+	}
+}
+
+void Skeleton::_update_bone_poses() {
+
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
+
+	_update_process_order();
+
+	const int *order = process_order.ptr();
+
+	// pose changed, rebuild cache of inverses
+	if (rest_global_inverse_dirty) {
+
+		// calculate global rests and invert them
+		for (int i = 0; i < len; i++) {
+			Bone &b = bonesptr[order[i]];
+			if (b.parent >= 0)
+				b.rest_global_inverse = bonesptr[b.parent].rest_global_inverse * b.rest;
+			else
+				b.rest_global_inverse = b.rest;
+		}
+		for (int i = 0; i < len; i++) {
+			Bone &b = bonesptr[order[i]];
+			b.rest_global_inverse.affine_invert();
+		}
 
-							pose = b.custom_pose * pose;
-						}
+		rest_global_inverse_dirty = false;
+	}
 
-						if (b.parent >= 0) {
+	for (int i = 0; i < len; i++) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * pose;
-						} else {
+		Bone &b = bonesptr[order[i]];
 
-							b.pose_global = pose;
-						}
-					} else {
+		if (b.disable_rest) {
+			if (b.enabled) {
 
-						if (b.parent >= 0) {
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
 
-							b.pose_global = bonesptr[b.parent].pose_global;
-						} else {
+					pose = b.custom_pose * pose;
+				}
 
-							b.pose_global = Transform();
-						}
-					}
+				if (b.parent >= 0) {
 
+					b.pose_global = bonesptr[b.parent].pose_global * pose;
 				} else {
-					if (b.enabled) {
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+					b.pose_global = pose;
+				}
+			} else {
+
+				if (b.parent >= 0) {
+
+					b.pose_global = bonesptr[b.parent].pose_global;
+				} else {
 
-							pose = b.custom_pose * pose;
-						}
+					b.pose_global = Transform();
+				}
+			}
 
-						if (b.parent >= 0) {
+		} else {
+			if (b.enabled) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-						} else {
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
 
-							b.pose_global = b.rest * pose;
-						}
-					} else {
+					pose = b.custom_pose * pose;
+				}
 
-						if (b.parent >= 0) {
+				if (b.parent >= 0) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-						} else {
+					b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
+				} else {
 
-							b.pose_global = b.rest;
-						}
-					}
+					b.pose_global = b.rest * pose;
 				}
+			} else {
 
-				b.transform_final = b.pose_global * b.rest_global_inverse;
-				vs->skeleton_bone_set_transform(skeleton, order[i], global_transform * (b.transform_final * global_transform_inverse));
+				if (b.parent >= 0) {
 
-				for (List<uint32_t>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+					b.pose_global = bonesptr[b.parent].pose_global * b.rest;
+				} else {
 
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Spatial *sp = Object::cast_to<Spatial>(obj);
-					ERR_CONTINUE(!sp);
-					sp->set_transform(b.pose_global);
+					b.pose_global = b.rest;
 				}
 			}
+		}
 
-			dirty = false;
-		} break;
+		b.transform_final = b.pose_global * b.rest_global_inverse;
 	}
+
+	bone_poses_updated = true;
+}
+
+void Skeleton::update_bone_poses() {
+
+	if (!dirty || bone_poses_updated)
+		return;
+
+	_update_bone_poses();
 }
 
 Transform Skeleton::get_bone_transform(int p_bone) const {
@@ -517,9 +545,9 @@ void Skeleton::bind_child_node_to_bone(int p_bone, Node *p_node) {
 	ERR_FAIL_NULL(p_node);
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	uint32_t id = p_node->get_instance_id();
+	ObjectID id = p_node->get_instance_id();
 
-	for (const List<uint32_t>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
+	for (const List<ObjectID>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
 
 		if (E->get() == id)
 			return; // already here
@@ -532,14 +560,14 @@ void Skeleton::unbind_child_node_from_bone(int p_bone, Node *p_node) {
 	ERR_FAIL_NULL(p_node);
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	uint32_t id = p_node->get_instance_id();
+	ObjectID id = p_node->get_instance_id();
 	bones.write[p_bone].nodes_bound.erase(id);
 }
 void Skeleton::get_bound_child_nodes_to_bone(int p_bone, List<Node *> *p_bound) const {
 
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	for (const List<uint32_t>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
+	for (const List<ObjectID>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
 
 		Object *obj = ObjectDB::get_instance(E->get());
 		ERR_CONTINUE(!obj);
@@ -591,6 +619,8 @@ Transform Skeleton::get_bone_custom_pose(int p_bone) const {
 
 void Skeleton::_make_dirty() {
 
+	bone_poses_updated = false;
+
 	if (dirty)
 		return;
 
@@ -825,6 +855,7 @@ Skeleton::Skeleton() {
 
 	rest_global_inverse_dirty = true;
 	dirty = false;
+	bone_poses_updated = false;
 	process_order_dirty = true;
 	skeleton = VisualServer::get_singleton()->skeleton_create();
 	set_notify_transform(true);
@@ -75,7 +75,7 @@ class Skeleton : public Spatial {
 		PhysicalBone *cache_parent_physical_bone;
 #endif // _3D_DISABLED
 
-		List<uint32_t> nodes_bound;
+		List<ObjectID> nodes_bound;
 
 		Bone() {
 			parent = -1;
@@ -100,6 +100,7 @@ class Skeleton : public Spatial {
 
 	void _make_dirty();
 	bool dirty;
+	bool bone_poses_updated;
 
 	// bind helpers
 	Array _get_bound_child_nodes_to_bone(int p_bone) const {
@@ -116,6 +117,7 @@ class Skeleton : public Spatial {
 	}
 
 	void _update_process_order();
+	void _update_bone_poses();
 
 protected:
 	bool _get(const StringName &p_path, Variant &r_ret) const;
@@ -132,6 +134,11 @@ public:
 
 	RID get_skeleton() const;
 
+	// computes the global pose of every bone of a dirty skeleton without touching the scene or
+	// the VisualServer, so different skeletons can be updated from worker threads; the pending
+	// NOTIFICATION_UPDATE_SKELETON then only uploads the result
+	void update_bone_poses();
+
 	// skeleton creation api
 	void add_bone(const String &p_name);
 	int find_bone(const String &p_name) const;
@@ -241,7 +241,7 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 			ERR_EXPLAIN("On Animation: '" + p_anim->name + "', couldn't resolve track:  '" + String(a->track_get_path(i)) + "'");
 		}
 		ERR_CONTINUE(!child); // couldn't find the child node
-		uint32_t id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
+		ObjectID id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
 		int bone_idx = -1;
 
 		if (a->track_get_path(i).get_subname_count() == 1 && Object::cast_to<Skeleton>(child)) {
@@ -334,7 +334,7 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 	}
 }
 
-void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
+void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started, int *p_key_cursors) {
 
 	_ensure_node_caches(p_anim);
 	ERR_FAIL_COND(p_anim->node_cache.size() != p_anim->animation->get_track_count());
@@ -366,7 +366,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				Quat rot;
 				Vector3 scale;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale, p_key_cursors ? &p_key_cursors[i] : NULL);
 				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 				if (err != OK)
@@ -446,7 +446,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE || (p_delta == 0 && update_mode == Animation::UPDATE_DISCRETE)) { //delta == 0 means seek
 
-					Variant value = a->value_track_interpolate(i, p_time);
+					Variant value = a->value_track_interpolate(i, p_time, p_key_cursors ? &p_key_cursors[i] : NULL);
 
 					if (value == Variant())
 						continue;
@@ -567,7 +567,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				TrackNodeCache::BezierAnim *ba = &E->get();
 
-				float bezier = a->bezier_track_interpolate(i, p_time);
+				float bezier = a->bezier_track_interpolate(i, p_time, p_key_cursors ? &p_key_cursors[i] : NULL);
 				if (ba->accum_pass != accum_pass) {
 					ERR_CONTINUE(cache_update_bezier_size >= NODE_CACHE_UPDATE_MAX);
 					cache_update_bezier[cache_update_bezier_size++] = ba;
@@ -794,7 +794,15 @@ void AnimationPlayer::_animation_process_data(PlaybackData &cd, float p_delta, f
 
 	cd.pos = next_pos;
 
-	_animation_process_animation(cd.from, cd.pos, delta, p_blend, &cd == &playback.current, p_seeked, p_started);
+	int track_count = cd.from->animation->get_track_count();
+	if (cd.key_cursors.size() != track_count) {
+		cd.key_cursors.resize(track_count);
+		for (int i = 0; i < track_count; i++) {
+			cd.key_cursors.write[i] = -1;
+		}
+	}
+
+	_animation_process_animation(cd.from, cd.pos, delta, p_blend, &cd == &playback.current, p_seeked, p_started, cd.key_cursors.ptrw());
 }
 void AnimationPlayer::_animation_process2(float p_delta, bool p_started) {
 
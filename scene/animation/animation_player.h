@@ -85,7 +85,7 @@ private:
 	struct TrackNodeCache {
 
 		NodePath path;
-		uint32_t id;
+		ObjectID id;
 		RES resource;
 		Node *node;
 		Spatial *spatial;
@@ -152,7 +152,7 @@ private:
 
 	struct TrackNodeCacheKey {
 
-		uint32_t id;
+		ObjectID id;
 		int bone_idx;
 
 		inline bool operator<(const TrackNodeCacheKey &p_right) const {
@@ -204,6 +204,7 @@ private:
 		AnimationData *from;
 		float pos;
 		float speed_scale;
+		Vector<int> key_cursors; // last key sampled on each track, speeds up key lookup
 
 		PlaybackData() {
 
@@ -248,7 +249,7 @@ private:
 
 	NodePath root;
 
-	void _animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
+	void _animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false, int *p_key_cursors = NULL);
 
 	void _ensure_node_caches(AnimationData *p_anim);
 	void _animation_process_data(PlaybackData &cd, float p_delta, float p_blend, bool p_seeked, bool p_started);
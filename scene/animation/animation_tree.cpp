@@ -741,6 +741,15 @@ void AnimationTree::_clear_caches() {
 
 void AnimationTree::_process_graph(float p_delta) {
 
+	if (!_process_graph_prepare())
+		return;
+
+	_process_graph_evaluate(p_delta);
+	_process_graph_apply();
+}
+
+bool AnimationTree::_process_graph_prepare() {
+
 	_update_properties(); //if properties need updating, update them
 
 	//check all tracks, see if they need modification
@@ -751,14 +760,14 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -789,15 +798,22 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
+	state.player = player;
+
+	return true;
+}
+
+void AnimationTree::_process_graph_evaluate(float p_delta) {
+
 	{ //setup
 
 		process_pass++;
@@ -806,7 +822,6 @@ void AnimationTree::_process_graph(float p_delta) {
 		state.invalid_reasons = "";
 		state.animation_states.clear(); //will need to be re-created
 		state.valid = true;
-		state.player = player;
 		state.last_pass = process_pass;
 		state.tree = this;
 
@@ -835,7 +850,12 @@ void AnimationTree::_process_graph(float p_delta) {
 	if (!state.valid) {
 		return; //state is not valid. do nothing.
 	}
-	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
+
+	//apply value/transform/bezier blends to track caches
+	_process_graph_tracks(false);
+}
+
+void AnimationTree::_process_graph_tracks(bool p_side_effects) {
 
 	{
 
@@ -870,6 +890,16 @@ void AnimationTree::_process_graph(float p_delta) {
 				if (blend < CMP_EPSILON)
 					continue; //nothing to blend
 
+				// tracks that call into or change other objects are left for _process_graph_apply()
+				bool side_effects = track->type == Animation::TYPE_METHOD || track->type == Animation::TYPE_AUDIO || track->type == Animation::TYPE_ANIMATION;
+				if (track->type == Animation::TYPE_VALUE) {
+					Animation::UpdateMode update_mode = a->value_track_get_update_mode(i);
+					side_effects = update_mode != Animation::UPDATE_CONTINUOUS && update_mode != Animation::UPDATE_CAPTURE;
+				}
+
+				if (side_effects != p_side_effects)
+					continue;
+
 				switch (track->type) {
 
 					case Animation::TYPE_TRANSFORM: {
@@ -1208,6 +1238,18 @@ void AnimationTree::_process_graph(float p_delta) {
 			}
 		}
 	}
+}
+
+void AnimationTree::_process_graph_apply() {
+
+	posed_skeletons.clear();
+
+	if (!state.valid) {
+		return; //state is not valid. do nothing.
+	}
+
+	//execute method/audio/animation tracks
+	_process_graph_tracks(true);
 
 	{
 		// finally, set the tracks
@@ -1240,6 +1282,9 @@ void AnimationTree::_process_graph(float p_delta) {
 					} else if (t->skeleton && t->bone_idx >= 0) {
 
 						t->skeleton->set_bone_pose(t->bone_idx, xform);
+						if (posed_skeletons.find(t->skeleton) == -1) {
+							posed_skeletons.push_back(t->skeleton);
+						}
 
 					} else {
 
@@ -1274,15 +1319,23 @@ void AnimationTree::advance(float p_time) {
 
 void AnimationTree::_notification(int p_what) {
 
-	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_mode == ANIMATION_PROCESS_PHYSICS) {
+	if (p_what == NOTIFICATION_ENTER_TREE) {
+		add_to_group("_animation_trees");
+	}
+
+	// when the SceneTree processes animation trees in parallel, it has already done it
+	bool processed_by_tree = (p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS || p_what == NOTIFICATION_INTERNAL_PROCESS) && get_tree()->is_parallel_animation_enabled();
+
+	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_mode == ANIMATION_PROCESS_PHYSICS && !processed_by_tree) {
 		_process_graph(get_physics_process_delta_time());
 	}
 
-	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_mode == ANIMATION_PROCESS_IDLE) {
+	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_mode == ANIMATION_PROCESS_IDLE && !processed_by_tree) {
 		_process_graph(get_process_delta_time());
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		remove_from_group("_animation_trees");
 		_clear_caches();
 		if (last_animation_player) {
 
@@ -1383,6 +1436,11 @@ void AnimationTree::_tree_changed() {
 
 void AnimationTree::_update_properties_for_node(const String &p_base_path, Ref<AnimationNode> node) {
 
+	graph_nodes.push_back(node.ptr());
+	if (node->get_script_instance()) {
+		graph_scripted = true;
+	}
+
 	if (!property_parent_map.has(p_base_path)) {
 		property_parent_map[p_base_path] = HashMap<StringName, StringName>();
 	}
@@ -1433,6 +1491,8 @@ void AnimationTree::_update_properties() {
 	property_parent_map.clear();
 	input_activity_map.clear();
 	input_activity_map_get.clear();
+	graph_nodes.clear();
+	graph_scripted = false;
 
 	if (root.is_valid()) {
 		_update_properties_for_node(SceneStringNames::get_singleton()->parameters_base_path, root);
@@ -1562,6 +1622,7 @@ AnimationTree::AnimationTree() {
 	setup_pass = 1;
 	started = true;
 	properties_dirty = true;
+	graph_scripted = false;
 	last_animation_player = 0;
 }
 
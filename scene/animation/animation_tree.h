@@ -270,6 +270,19 @@ private:
 	bool _update_caches(AnimationPlayer *player);
 	void _process_graph(float p_delta);
 
+	// _process_graph() in three steps, so SceneTree can evaluate many trees on worker threads.
+	// Only _process_graph_evaluate() may run off the main thread, and only while no other tree
+	// sharing one of graph_nodes is being evaluated.
+	friend class SceneTree;
+	bool _process_graph_prepare();
+	void _process_graph_evaluate(float p_delta);
+	void _process_graph_tracks(bool p_side_effects);
+	void _process_graph_apply();
+
+	Vector<AnimationNode *> graph_nodes;
+	bool graph_scripted; // some node of the graph has a script, it must be evaluated on the main thread
+	Vector<Skeleton *> posed_skeletons; // skeletons posed by the last _process_graph_apply()
+
 	uint64_t setup_pass;
 	uint64_t process_pass;
 
@@ -35,11 +35,14 @@
 #include "core/message_queue.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
 #include "editor/editor_node.h"
 #include "main/input_default.h"
 #include "node.h"
+#include "scene/3d/skeleton.h"
+#include "scene/animation/animation_tree.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
@@ -468,8 +471,9 @@ bool SceneTree::iteration(float p_time) {
 	MainLoop::iteration(p_time);
 	physics_process_time = p_time;
 
-	emit_signal("physics_frame");
+	emit_signal(SNAME("physics_frame"));
 
+	_process_animation_trees(true);
 	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
@@ -500,12 +504,13 @@ bool SceneTree::idle(float p_time) {
 		multiplayer->poll();
 	}
 
-	emit_signal("idle_frame");
+	emit_signal(SNAME("idle_frame"));
 
 	MessageQueue::get_singleton()->flush(); //small little hack
 
 	flush_transform_notifications();
 
+	_process_animation_trees(false);
 	_notify_group_pause("idle_process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
 	_notify_group_pause("idle_process", Node::NOTIFICATION_PROCESS);
 
@@ -552,7 +557,7 @@ bool SceneTree::idle(float p_time) {
 		E->get()->set_time_left(time_left);
 
 		if (time_left < 0) {
-			E->get()->emit_signal("timeout");
+			E->get()->emit_signal(SNAME("timeout"));
 			timers.erase(E);
 		}
 		if (E == L) {
@@ -973,6 +978,195 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 		call_skip.clear();
 }
 
+void SceneTree::_animation_tree_job(uint32_t p_index, float p_delta) {
+
+	const Vector<AnimationTree *> &trees = animation_tree_jobs[p_index];
+	for (int i = 0; i < trees.size(); i++) {
+		trees[i]->_process_graph_evaluate(p_delta);
+	}
+}
+
+void SceneTree::_animation_skeleton_job(uint32_t p_index, void *p_userdata) {
+
+	animation_skeletons[p_index]->update_bone_poses();
+}
+
+void SceneTree::_process_animation_trees(bool p_physics) {
+
+	if (!is_parallel_animation_enabled())
+		return;
+
+	Map<StringName, Group>::Element *E = group_map.find(SNAME("_animation_trees"));
+	if (!E)
+		return;
+	Group &g = E->get();
+	if (g.nodes.empty())
+		return;
+
+	_update_group_order(g, true);
+
+	Vector<Node *> nodes_copy = g.nodes;
+	int node_count = nodes_copy.size();
+	Node **nodes = nodes_copy.ptrw();
+
+	int notification = p_physics ? Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS : Node::NOTIFICATION_INTERNAL_PROCESS;
+	AnimationTree::AnimationProcessMode process_mode = p_physics ? AnimationTree::ANIMATION_PROCESS_PHYSICS : AnimationTree::ANIMATION_PROCESS_IDLE;
+	float delta = p_physics ? physics_process_time : idle_process_time;
+
+	call_lock++;
+
+	// step 1: gather the trees to process this frame and validate their caches (main thread)
+
+	animation_trees.clear();
+
+	for (int i = 0; i < node_count; i++) {
+
+		AnimationTree *tree = Object::cast_to<AnimationTree>(nodes[i]);
+		if (!tree || (call_lock && call_skip.has(tree)))
+			continue;
+		if (!tree->active || tree->process_mode != process_mode)
+			continue;
+		if (!tree->can_process() || !tree->can_process_notification(notification))
+			continue;
+
+		if (tree->_process_graph_prepare()) {
+			animation_trees.push_back(tree);
+		}
+	}
+
+	int tree_count = animation_trees.size();
+
+	if (tree_count) {
+
+		// step 2: AnimationNodes keep evaluation state, so trees sharing any of them
+		// (such as instances of the same scene) must be evaluated one after another.
+
+		Vector<int> tree_set;
+		tree_set.resize(tree_count);
+		Map<AnimationNode *, int> node_owner;
+
+		for (int i = 0; i < tree_count; i++) {
+
+			tree_set.write[i] = i;
+
+			const Vector<AnimationNode *> &graph_nodes = animation_trees[i]->graph_nodes;
+			for (int j = 0; j < graph_nodes.size(); j++) {
+
+				Map<AnimationNode *, int>::Element *F = node_owner.find(graph_nodes[j]);
+				if (!F) {
+					node_owner.insert(graph_nodes[j], i);
+					continue;
+				}
+
+				int a = F->get();
+				while (tree_set[a] != a) {
+					a = tree_set[a];
+				}
+				int b = i;
+				while (tree_set[b] != b) {
+					b = tree_set[b];
+				}
+				if (a != b) {
+					tree_set.write[MAX(a, b)] = MIN(a, b);
+				}
+			}
+		}
+
+		// step 3: evaluate; sets containing a scripted node stay on the main thread
+
+		animation_tree_jobs.clear();
+		Vector<int> set_job;
+		set_job.resize(tree_count);
+		Vector<bool> set_scripted;
+		set_scripted.resize(tree_count);
+
+		for (int i = 0; i < tree_count; i++) {
+			set_scripted.write[i] = false;
+		}
+
+		for (int i = 0; i < tree_count; i++) {
+
+			int root = i;
+			while (tree_set[root] != root) {
+				root = tree_set[root];
+			}
+			tree_set.write[i] = root;
+
+			if (animation_trees[i]->graph_scripted) {
+				set_scripted.write[root] = true;
+			}
+		}
+
+		for (int i = 0; i < tree_count; i++) {
+
+			int root = tree_set[i];
+			if (set_scripted[root])
+				continue;
+
+			if (root == i) {
+				set_job.write[i] = animation_tree_jobs.size();
+				animation_tree_jobs.push_back(Vector<AnimationTree *>());
+			}
+			animation_tree_jobs.write[set_job[root]].push_back(animation_trees[i]);
+		}
+
+		if (animation_tree_jobs.size() > 1) {
+			thread_process_array(animation_tree_jobs.size(), this, &SceneTree::_animation_tree_job, delta);
+		} else if (animation_tree_jobs.size() == 1) {
+			_animation_tree_job(0, delta);
+		}
+
+		for (int i = 0; i < tree_count; i++) {
+			if (set_scripted[tree_set[i]]) {
+				animation_trees[i]->_process_graph_evaluate(delta);
+			}
+		}
+
+		animation_tree_jobs.clear();
+
+		// step 4: write the results to the scene, in tree order (main thread)
+
+		Set<Skeleton *> posed;
+		animation_skeletons.clear();
+
+		for (int i = 0; i < tree_count; i++) {
+
+			AnimationTree *tree = animation_trees[i];
+			if (call_lock && call_skip.has(tree))
+				continue;
+
+			tree->_process_graph_apply();
+
+			for (int j = 0; j < tree->posed_skeletons.size(); j++) {
+
+				Skeleton *skeleton = tree->posed_skeletons[j];
+				if (!posed.has(skeleton)) {
+					posed.insert(skeleton);
+					animation_skeletons.push_back(skeleton);
+				}
+			}
+		}
+
+		// step 5: compute the global bone poses; the skeletons only upload them when notified
+
+		if (animation_skeletons.size() > 1) {
+			thread_process_array(animation_skeletons.size(), this, &SceneTree::_animation_skeleton_job, (void *)NULL);
+		}
+
+		animation_skeletons.clear();
+		animation_trees.clear();
+	}
+
+	call_lock--;
+	if (call_lock == 0)
+		call_skip.clear();
+}
+
+bool SceneTree::is_parallel_animation_enabled() const {
+
+	return parallel_animation && !Engine::get_singleton()->is_editor_hint();
+}
+
 /*
 void SceneMainLoop::_update_listener_2d() {
 
@@ -1953,6 +2147,8 @@ SceneTree::SceneTree() {
 	debug_navigation_color = GLOBAL_DEF("debug/shapes/navigation/geometry_color", Color(0.1, 1.0, 0.7, 0.4));
 	debug_navigation_disabled_color = GLOBAL_DEF("debug/shapes/navigation/disabled_geometry_color", Color(1.0, 0.7, 0.1, 0.4));
 	collision_debug_contacts = GLOBAL_DEF("debug/shapes/collision/max_contacts_displayed", 10000);
+
+	parallel_animation = GLOBAL_DEF("animation/threads/parallel_process", false);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/shapes/collision/max_contacts_displayed", PropertyInfo(Variant::INT, "debug/shapes/collision/max_contacts_displayed", PROPERTY_HINT_RANGE, "0,20000,1")); // No negative
 
 	tree_version = 1;
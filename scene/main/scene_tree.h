@@ -49,6 +49,8 @@ class Node;
 class Viewport;
 class Material;
 class Mesh;
+class AnimationTree;
+class Skeleton;
 
 class SceneTreeTimer : public Reference {
 	GDCLASS(SceneTreeTimer, Reference);
@@ -207,6 +209,15 @@ private:
 	void make_group_changed(const StringName &p_group);
 
 	void _notify_group_pause(const StringName &p_group, int p_notification);
+
+	bool parallel_animation;
+	Vector<AnimationTree *> animation_trees;
+	Vector<Vector<AnimationTree *> > animation_tree_jobs;
+	Vector<Skeleton *> animation_skeletons;
+
+	void _process_animation_trees(bool p_physics);
+	void _animation_tree_job(uint32_t p_index, float p_delta);
+	void _animation_skeleton_job(uint32_t p_index, void *p_userdata);
 	void _call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input);
 	Variant _call_group_flags(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 	Variant _call_group(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
@@ -329,6 +340,8 @@ public:
 	_FORCE_INLINE_ float get_physics_process_time() const { return physics_process_time; }
 	_FORCE_INLINE_ float get_idle_process_time() const { return idle_process_time; }
 
+	bool is_parallel_animation_enabled() const;
+
 #ifdef TOOLS_ENABLED
 	bool is_node_being_edited(const Node *p_node) const;
 #else
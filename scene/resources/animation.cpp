@@ -119,6 +119,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 					tk.value.scale.z = ofs[11];
 				}
 
+				_transform_track_update_compression(tt);
+
 			} else if (track_get_type(track) == TYPE_VALUE) {
 
 				ValueTrack *vt = static_cast<ValueTrack *>(tracks[track]);
@@ -682,6 +684,7 @@ void Animation::remove_track(int p_track) {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			_clear(tt->transforms);
+			_transform_track_update_compression(tt);
 
 		} break;
 		case TYPE_VALUE: {
@@ -872,6 +875,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	tkey.value.scale = p_scale;
 
 	int ret = _insert(p_time, tt->transforms, tkey);
+	_transform_track_update_compression(tt);
 	emit_changed();
 	return ret;
 }
@@ -894,6 +898,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
+			_transform_track_update_compression(tt);
 
 		} break;
 		case TYPE_VALUE: {
@@ -1354,6 +1359,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 				tt->transforms.write[p_key_idx].value.rot = d["rotation"];
 			if (d.has("scale"))
 				tt->transforms.write[p_key_idx].value.scale = d["scale"];
+			_transform_track_update_compression(tt);
 
 		} break;
 		case TYPE_VALUE: {
@@ -1424,6 +1430,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
+			_transform_track_update_compression(tt);
 		} break;
 		case TYPE_VALUE: {
 
@@ -1448,12 +1455,22 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 }
 
 template <class K>
-int Animation::_find(const Vector<K> &p_keys, float p_time) const {
+int Animation::_find(const Vector<K> &p_keys, float p_time, int p_hint) const {
 
 	int len = p_keys.size();
 	if (len == 0)
 		return -2;
 
+	if (p_hint >= 0 && p_hint < len) {
+		// playing forward stays on the hinted key or moves to the next one
+		const K *keys = &p_keys[0];
+		int hint_end = MIN(p_hint + 2, len);
+		for (int i = p_hint; i < hint_end; i++) {
+			if (keys[i].time - p_time < CMP_EPSILON && (i + 1 == len || keys[i + 1].time - p_time >= CMP_EPSILON))
+				return i;
+		}
+	}
+
 	int low = 0;
 	int high = len - 1;
 	int middle = 0;
@@ -1635,27 +1652,33 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class K>
+bool Animation::_find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *r_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const {
+
+	int len;
+	if (p_keys.size() && p_keys[p_keys.size() - 1].time - length < CMP_EPSILON)
+		len = p_keys.size(); // common case, no keys past the end
+	else
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
 
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	r_len = len;
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
 		// meaning no keys, or only key time is larger than length
-		if (p_ok)
-			*p_ok = false;
-		return T();
+		return false;
 	} else if (len == 1) { // one key found (0+1), return it
 
-		if (p_ok)
-			*p_ok = true;
-		return p_keys[0].value;
+		r_idx = r_next = 0;
+		return true;
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx = _find(p_keys, p_time, r_cursor ? *r_cursor : -1);
+
+	ERR_FAIL_COND_V(idx == -2, false);
 
-	ERR_FAIL_COND_V(idx == -2, T());
+	if (r_cursor && idx >= 0)
+		*r_cursor = idx;
 
 	bool result = true;
 	int next = 0;
@@ -1735,21 +1758,43 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 		}
 	}
 
-	if (p_ok)
-		*p_ok = result;
 	if (!result)
-		return T();
+		return false;
 
 	float tr = p_keys[idx].transition;
 
-	if (tr == 0 || idx == next) {
+	if (tr == 0) {
 		// don't interpolate if not needed
-		return p_keys[idx].value;
+		next = idx;
+	} else if (tr != 1.0) {
+
+		c = Math::ease(c, tr);
 	}
 
-	if (tr != 1.0) {
+	r_idx = idx;
+	r_next = next;
+	r_c = c;
+	return true;
+}
 
-		c = Math::ease(c, tr);
+template <class T>
+T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor) const {
+
+	int idx = 0;
+	int next = 0;
+	int len = 0;
+	float c = 0;
+
+	bool result = _find_interpolation_keys(p_keys, p_time, p_loop_wrap, r_cursor, idx, next, len, c);
+
+	if (p_ok)
+		*p_ok = result;
+	if (!result)
+		return T();
+
+	if (idx == next) {
+		// don't interpolate if not needed
+		return p_keys[idx].value;
 	}
 
 	switch (p_interp) {
@@ -1779,7 +1824,134 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+uint64_t Animation::_quantize_rotation(const Quat &p_rot) {
+
+	// smallest three: the largest component is dropped and rebuilt from the unit length,
+	// the other three lie in [-sqrt(1/2), sqrt(1/2)] and get 20 bits each
+	real_t c[4] = { p_rot.x, p_rot.y, p_rot.z, p_rot.w };
+	real_t len = Math::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3]);
+	if (len < CMP_EPSILON)
+		return _quantize_rotation(Quat());
+
+	int largest = 0;
+	for (int i = 0; i < 4; i++) {
+		c[i] /= len;
+		if (Math::abs(c[i]) > Math::abs(c[largest]))
+			largest = i;
+	}
+
+	uint64_t bits = largest;
+	if (c[largest] < 0)
+		bits |= 1 << 2; // keep the sign, so keys keep the hemisphere they were authored in
+
+	int shift = 3;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		real_t v = CLAMP(c[i] * Math_SQRT2 * 0.5 + 0.5, 0, 1);
+		bits |= uint64_t(Math::fast_ftoi(v * ROTATION_QUANTIZE_MAX)) << shift;
+		shift += ROTATION_QUANTIZE_BITS;
+	}
+
+	return bits;
+}
+
+Quat Animation::_dequantize_rotation(uint64_t p_bits) {
+
+	int largest = p_bits & 3;
+	real_t c[4];
+	real_t sum = 0;
+
+	int shift = 3;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		real_t v = real_t((p_bits >> shift) & ROTATION_QUANTIZE_MAX) / ROTATION_QUANTIZE_MAX;
+		c[i] = (v * 2.0 - 1.0) * Math_SQRT12;
+		sum += c[i] * c[i];
+		shift += ROTATION_QUANTIZE_BITS;
+	}
+
+	c[largest] = Math::sqrt(MAX(0, 1.0 - sum));
+	if (p_bits & (1 << 2))
+		c[largest] = -c[largest];
+
+	return Quat(c[0], c[1], c[2], c[3]);
+}
+
+void Animation::_transform_track_update_compression(TransformTrack *p_track) {
+
+	if (!transform_compression) {
+		p_track->compressed_keys.clear();
+		p_track->compressed_locs.clear();
+		p_track->compressed_rots.clear();
+		p_track->compressed_scales.clear();
+		return;
+	}
+
+	int count = p_track->transforms.size();
+	p_track->compressed_keys.resize(count);
+	p_track->compressed_locs.resize(count);
+	p_track->compressed_rots.resize(count);
+	p_track->compressed_scales.resize(count);
+
+	for (int i = 0; i < count; i++) {
+
+		const TKey<TransformKey> &tk = p_track->transforms[i];
+		Key &k = p_track->compressed_keys.write[i];
+		k.time = tk.time;
+		k.transition = tk.transition;
+		p_track->compressed_locs.write[i] = tk.value.loc;
+		p_track->compressed_rots.write[i] = _quantize_rotation(tk.value.rot);
+		p_track->compressed_scales.write[i] = tk.value.scale;
+	}
+}
+
+Animation::TransformKey Animation::_get_compressed_key(const TransformTrack *p_track, int p_idx) const {
+
+	TransformKey tk;
+	tk.loc = p_track->compressed_locs[p_idx];
+	tk.rot = _dequantize_rotation(p_track->compressed_rots[p_idx]);
+	tk.scale = p_track->compressed_scales[p_idx];
+	return tk;
+}
+
+bool Animation::_transform_track_sample(const TransformTrack *p_track, float p_time, TransformKey *r_key, int *r_cursor) const {
+
+	if (p_track->compressed_keys.size() != p_track->transforms.size()) {
+
+		bool ok = false;
+		*r_key = _interpolate(p_track->transforms, p_time, p_track->interpolation, p_track->loop_wrap, &ok, r_cursor);
+		return ok;
+	}
+
+	int idx = 0;
+	int next = 0;
+	int len = 0;
+	float c = 0;
+
+	if (!_find_interpolation_keys(p_track->compressed_keys, p_time, p_track->loop_wrap, r_cursor, idx, next, len, c))
+		return false;
+
+	if (idx == next || p_track->interpolation == INTERPOLATION_NEAREST) {
+		*r_key = _get_compressed_key(p_track, idx);
+	} else if (p_track->interpolation == INTERPOLATION_CUBIC) {
+		int pre = idx - 1;
+		if (pre < 0)
+			pre = 0;
+		int post = next + 1;
+		if (post >= len)
+			post = next;
+
+		*r_key = _cubic_interpolate(_get_compressed_key(p_track, pre), _get_compressed_key(p_track, idx), _get_compressed_key(p_track, next), _get_compressed_key(p_track, post), c);
+	} else {
+		*r_key = _interpolate(_get_compressed_key(p_track, idx), _get_compressed_key(p_track, next), c);
+	}
+
+	return true;
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
@@ -1787,11 +1959,9 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 
-	bool ok = false;
-
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
 
-	if (!ok)
+	if (!_transform_track_sample(tt, p_time, &tk, r_cursor))
 		return ERR_UNAVAILABLE;
 
 	if (r_loc)
@@ -1806,7 +1976,30 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	return OK;
 }
 
-Variant Animation::value_track_interpolate(int p_track, float p_time) const {
+void Animation::transform_tracks_interpolate(const int *p_tracks, int p_count, float p_time, Vector3 *r_locs, Quat *r_rots, Vector3 *r_scales, Error *r_errors, int *r_cursors) const {
+
+	for (int i = 0; i < p_count; i++) {
+
+		int track = p_tracks[i];
+		if (track < 0 || track >= tracks.size() || tracks[track]->type != TYPE_TRANSFORM) {
+			r_errors[i] = ERR_INVALID_PARAMETER;
+			continue;
+		}
+
+		TransformKey tk;
+		if (!_transform_track_sample(static_cast<const TransformTrack *>(tracks[track]), p_time, &tk, r_cursors ? &r_cursors[i] : NULL)) {
+			r_errors[i] = ERR_UNAVAILABLE;
+			continue;
+		}
+
+		r_locs[i] = tk.loc;
+		r_rots[i] = tk.rot;
+		r_scales[i] = tk.scale;
+		r_errors[i] = OK;
+	}
+}
+
+Variant Animation::value_track_interpolate(int p_track, float p_time, int *r_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
@@ -1815,7 +2008,7 @@ Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok, r_cursor);
 
 	if (ok) {
 
@@ -2294,7 +2487,7 @@ static _FORCE_INLINE_ Vector2 _bezier_interp(real_t t, const Vector2 &start, con
 	return start * omt3 + control_1 * omt2 * t * 3.0 + control_2 * omt * t2 * 3.0 + end * t3;
 }
 
-float Animation::bezier_track_interpolate(int p_track, float p_time) const {
+float Animation::bezier_track_interpolate(int p_track, float p_time, int *r_cursor) const {
 	//this uses a different interpolation scheme
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *track = tracks[p_track];
@@ -2311,10 +2504,13 @@ float Animation::bezier_track_interpolate(int p_track, float p_time) const {
 		return bt->values[0].value.value;
 	}
 
-	int idx = _find(bt->values, p_time);
+	int idx = _find(bt->values, p_time, r_cursor ? *r_cursor : -1);
 
 	ERR_FAIL_COND_V(idx == -2, 0);
 
+	if (r_cursor && idx >= 0)
+		*r_cursor = idx;
+
 	//there really is no looping interpolation on bezier
 
 	if (idx < 0) {
@@ -2611,6 +2807,26 @@ float Animation::get_step() const {
 	return step;
 }
 
+void Animation::set_transform_compression(bool p_enabled) {
+
+	if (transform_compression == p_enabled)
+		return;
+
+	transform_compression = p_enabled;
+
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type == TYPE_TRANSFORM)
+			_transform_track_update_compression(static_cast<TransformTrack *>(tracks[i]));
+	}
+
+	emit_changed();
+}
+
+bool Animation::has_transform_compression() const {
+
+	return transform_compression;
+}
+
 void Animation::copy_track(int p_track, Ref<Animation> p_to_animation) {
 	ERR_FAIL_COND(p_to_animation.is_null());
 	ERR_FAIL_INDEX(p_track, get_track_count());
@@ -2686,7 +2902,7 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bezier_track_get_key_in_handle", "idx", "key_idx"), &Animation::bezier_track_get_key_in_handle);
 	ClassDB::bind_method(D_METHOD("bezier_track_get_key_out_handle", "idx", "key_idx"), &Animation::bezier_track_get_key_out_handle);
 
-	ClassDB::bind_method(D_METHOD("bezier_track_interpolate", "track", "time"), &Animation::bezier_track_interpolate);
+	ClassDB::bind_method(D_METHOD("bezier_track_interpolate", "track", "time"), &Animation::_bezier_track_interpolate);
 
 	ClassDB::bind_method(D_METHOD("audio_track_insert_key", "track", "time", "stream", "start_offset", "end_offset"), &Animation::audio_track_insert_key, DEFVAL(0), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("audio_track_set_key_stream", "idx", "key_idx", "stream"), &Animation::audio_track_set_key_stream);
@@ -2709,12 +2925,16 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_step", "size_sec"), &Animation::set_step);
 	ClassDB::bind_method(D_METHOD("get_step"), &Animation::get_step);
 
+	ClassDB::bind_method(D_METHOD("set_transform_compression", "enabled"), &Animation::set_transform_compression);
+	ClassDB::bind_method(D_METHOD("has_transform_compression"), &Animation::has_transform_compression);
+
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track", "to_animation"), &Animation::copy_track);
 
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "step", PROPERTY_HINT_RANGE, "0,4096,0.001"), "set_step", "get_step");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "transform_compression"), "set_transform_compression", "has_transform_compression");
 
 	BIND_ENUM_CONSTANT(TYPE_VALUE);
 	BIND_ENUM_CONSTANT(TYPE_TRANSFORM);
@@ -2954,6 +3174,8 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 			norm = Vector3();
 		}
 	}
+
+	_transform_track_update_compression(tt);
 }
 
 void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err, float p_max_optimizable_angle) {
@@ -2970,6 +3192,7 @@ Animation::Animation() {
 	step = 0.1;
 	loop = false;
 	length = 1;
+	transform_compression = false;
 }
 
 Animation::~Animation() {
@@ -65,6 +65,11 @@ public:
 	};
 
 private:
+	enum {
+		ROTATION_QUANTIZE_BITS = 20,
+		ROTATION_QUANTIZE_MAX = (1 << ROTATION_QUANTIZE_BITS) - 1
+	};
+
 	struct Track {
 
 		TrackType type;
@@ -110,6 +115,13 @@ private:
 
 		Vector<TKey<TransformKey> > transforms;
 
+		// struct-of-arrays copy of transforms with quantized rotations, sampled instead of
+		// transforms while transform compression is enabled
+		Vector<Key> compressed_keys;
+		Vector<Vector3> compressed_locs;
+		Vector<uint64_t> compressed_rots;
+		Vector<Vector3> compressed_scales;
+
 		TransformTrack() { type = TYPE_TRANSFORM; }
 	};
 
@@ -203,7 +215,10 @@ private:
 	int _insert(float p_time, T &p_keys, const V &p_value);
 
 	template <class K>
-	inline int _find(const Vector<K> &p_keys, float p_time) const;
+	inline int _find(const Vector<K> &p_keys, float p_time, int p_hint = -1) const;
+
+	template <class K>
+	_FORCE_INLINE_ bool _find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *r_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const;
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
@@ -219,7 +234,14 @@ private:
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
 	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor = NULL) const;
+
+	static uint64_t _quantize_rotation(const Quat &p_rot);
+	static Quat _dequantize_rotation(uint64_t p_bits);
+
+	void _transform_track_update_compression(TransformTrack *p_track);
+	_FORCE_INLINE_ TransformKey _get_compressed_key(const TransformTrack *p_track, int p_idx) const;
+	_FORCE_INLINE_ bool _transform_track_sample(const TransformTrack *p_track, float p_time, TransformKey *r_key, int *r_cursor) const;
 
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
@@ -230,6 +252,7 @@ private:
 	float length;
 	float step;
 	bool loop;
+	bool transform_compression;
 
 	// bind helpers
 private:
@@ -245,6 +268,8 @@ private:
 		return ret;
 	}
 
+	float _bezier_track_interpolate(int p_track, float p_time) const { return bezier_track_interpolate(p_track, p_time); }
+
 	PoolVector<int> _value_track_get_key_indices(int p_track, float p_time, float p_delta) const {
 
 		List<int> idxs;
@@ -326,7 +351,7 @@ public:
 	Vector2 bezier_track_get_key_in_handle(int p_track, int p_index) const;
 	Vector2 bezier_track_get_key_out_handle(int p_track, int p_index) const;
 
-	float bezier_track_interpolate(int p_track, float p_time) const;
+	float bezier_track_interpolate(int p_track, float p_time, int *r_cursor = NULL) const;
 
 	int audio_track_insert_key(int p_track, float p_time, const RES &p_stream, float p_start_offset = 0, float p_end_offset = 0);
 	void audio_track_set_key_stream(int p_track, int p_key, const RES &p_stream);
@@ -343,9 +368,12 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	// r_cursor, when given, keeps the key found by the previous call of the same playback so
+	// that monotonic playback does not need to binary search the keys
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor = NULL) const;
+	void transform_tracks_interpolate(const int *p_tracks, int p_count, float p_time, Vector3 *r_locs, Quat *r_rots, Vector3 *r_scales, Error *r_errors, int *r_cursors = NULL) const;
 
-	Variant value_track_interpolate(int p_track, float p_time) const;
+	Variant value_track_interpolate(int p_track, float p_time, int *r_cursor = NULL) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
 	void value_track_set_update_mode(int p_track, UpdateMode p_mode);
 	UpdateMode value_track_get_update_mode(int p_track) const;
@@ -367,6 +395,9 @@ public:
 	void set_step(float p_step);
 	float get_step() const;
 
+	void set_transform_compression(bool p_enabled);
+	bool has_transform_compression() const;
+
 	void clear();
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
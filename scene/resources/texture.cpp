@@ -561,18 +561,24 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &fla
 				size = f->get_32();
 			}
 
-			PoolVector<uint8_t> pv;
-			pv.resize(size);
-			{
-				PoolVector<uint8_t>::Write w = pv.write();
-				f->get_buffer(w.ptr(), size);
-			}
-
 			Ref<Image> img;
-			if (df & FORMAT_BIT_LOSSLESS) {
-				img = Image::lossless_unpacker(pv);
+			const uint8_t *mapped = f->get_buffer_ptr(size);
+			if (mapped) {
+				// decode straight from the file data, e.g. a memory mapped pack
+				img = Image::unpack_from_memory(mapped, size, !(df & FORMAT_BIT_LOSSLESS));
 			} else {
-				img = Image::lossy_unpacker(pv);
+				PoolVector<uint8_t> pv;
+				pv.resize(size);
+				{
+					PoolVector<uint8_t>::Write w = pv.write();
+					f->get_buffer(w.ptr(), size);
+				}
+
+				if (df & FORMAT_BIT_LOSSLESS) {
+					img = Image::lossless_unpacker(pv);
+				} else {
+					img = Image::lossy_unpacker(pv);
+				}
 			}
 
 			if (img.is_null() || img->empty()) {
@@ -2225,14 +2231,20 @@ RES ResourceFormatLoaderTextureLayered::load(const String &p_path, const String
 			for (int i = 0; i < mipmaps; i++) {
 				uint32_t size = f->get_32();
 
-				PoolVector<uint8_t> pv;
-				pv.resize(size);
-				{
-					PoolVector<uint8_t>::Write w = pv.write();
-					f->get_buffer(w.ptr(), size);
-				}
+				Ref<Image> img;
+				const uint8_t *mapped = f->get_buffer_ptr(size);
+				if (mapped) {
+					img = Image::unpack_from_memory(mapped, size, false);
+				} else {
+					PoolVector<uint8_t> pv;
+					pv.resize(size);
+					{
+						PoolVector<uint8_t>::Write w = pv.write();
+						f->get_buffer(w.ptr(), size);
+					}
 
-				Ref<Image> img = Image::lossless_unpacker(pv);
+					img = Image::lossless_unpacker(pv);
+				}
 
 				if (img.is_null() || img->empty() || format != img->get_format()) {
 					if (r_error) {
@@ -32,6 +32,7 @@
 #include "core/io/resource_loader.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
 #include "core/project_settings.h"
 #include "scene/resources/audio_stream_sample.h"
 #include "servers/audio/audio_driver_dummy.h"
@@ -285,175 +286,326 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 #endif
 }
 
-void AudioServer::_mix_step() {
+AudioServer::Bus *AudioServer::_get_bus_send(Bus *p_bus) {
 
-	bool solo_mode = false;
+	if (p_bus == buses[0])
+		return NULL;
 
-	for (int i = 0; i < buses.size(); i++) {
-		Bus *bus = buses[i];
-		bus->index_cache = i; //might be moved around by editor, so..
-		for (int k = 0; k < bus->channels.size(); k++) {
+	//everything has a send save for master bus
+	Map<StringName, Bus *>::Element *E = bus_map.find(p_bus->send);
+	if (!E || E->get()->index_cache >= p_bus->index_cache) {
+		return buses[0]; //invalid, send to master
+	}
+	return E->get();
+}
 
-			bus->channels.write[k].used = false;
-		}
+int AudioServer::_get_bus_sidechain(Bus *p_bus) {
 
-		if (bus->solo) {
-			//solo chain
-			solo_mode = true;
-			bus->soloed = true;
-			do {
+	// A compressor reads the buffer of its sidechain bus while processing.
+	if (p_bus->bypass)
+		return -1;
 
-				if (bus != buses[0]) {
-					//everything has a send save for master bus
-					if (!bus_map.has(bus->send)) {
-						bus = buses[0]; //send to master
-					} else {
-						int prev_index_cache = bus->index_cache;
-						bus = bus_map[bus->send];
-						if (prev_index_cache >= bus->index_cache) { //invalid, send to master
-							bus = buses[0];
-						}
-					}
-
-					bus->soloed = true;
-				} else {
-					bus = NULL;
-				}
+	for (int i = 0; i < p_bus->effects.size(); i++) {
 
-			} while (bus);
-		} else {
-			bus->soloed = false;
+		if (!p_bus->effects[i].enabled)
+			continue;
+		const AudioEffectCompressor *compressor = Object::cast_to<AudioEffectCompressor>(*p_bus->effects[i].effect);
+		if (!compressor)
+			continue;
+		Map<StringName, Bus *>::Element *E = bus_map.find(compressor->get_sidechain());
+		if (E && E->get() != p_bus)
+			return E->get()->index_cache;
+	}
+
+	return -1;
+}
+
+bool AudioServer::_update_mix_levels() {
+
+	int bus_count = buses.size();
+	mix_bus_levels.resize(bus_count);
+	int *levels = mix_bus_levels.ptrw();
+	for (int i = 0; i < bus_count; i++) {
+		levels[i] = 0;
+	}
+
+	// Sends always go from a higher bus index to a lower one, so walking down
+	// finishes each level before it's used.
+	int level_count = 1;
+	for (int i = bus_count - 1; i >= 0; i--) {
+
+		// A sidechain on a lower bus is read while only part of the sends to it
+		// are done, which depends on the serial order. Mix serially then.
+		int sidechain = _get_bus_sidechain(buses[i]);
+		if (sidechain > i) {
+			levels[i] = MAX(levels[i], levels[sidechain] + 1);
+		} else if (sidechain >= 0) {
+			return false;
+		}
+
+		Bus *send = _get_bus_send(buses[i]);
+		if (send) {
+			levels[send->index_cache] = MAX(levels[send->index_cache], levels[i] + 1);
 		}
+
+		level_count = MAX(level_count, levels[i] + 1);
 	}
 
-	//make callbacks for mixing the audio
-	for (Set<CallbackItem>::Element *E = callbacks.front(); E; E = E->next()) {
+	mix_level_ends.resize(level_count);
+	int *ends = mix_level_ends.ptrw();
+	for (int i = 0; i < level_count; i++) {
+		ends[i] = 0;
+	}
+	for (int i = 0; i < bus_count; i++) {
+		ends[levels[i]]++;
+	}
+	for (int i = 1; i < level_count; i++) {
+		ends[i] += ends[i - 1];
+	}
 
-		E->get().callback(E->get().userdata);
+	// Inside a level, keep the serial (descending) bus order.
+	mix_order.resize(bus_count);
+	Bus **order = mix_order.ptrw();
+	for (int i = 0; i < bus_count; i++) {
+		order[--ends[levels[i]]] = buses[i];
+	}
+	for (int i = 0; i < level_count; i++) {
+		ends[i] = i + 1 < level_count ? ends[i + 1] : bus_count;
 	}
 
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
-		Bus *bus = buses[i];
+	return true;
+}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
+void AudioServer::_resize_temp_buffers(int p_sets) {
 
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+	int from = temp_buffers.size();
+	temp_buffers.resize(p_sets);
+	for (int i = 0; i < p_sets; i++) {
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
+		if (i < from && temp_buffers[i].size() == channel_count && (channel_count == 0 || temp_buffers[i][0].size() == int(buffer_size)))
+			continue;
 
-					buf[j] = AudioFrame(0, 0);
-				}
+		temp_buffers.write[i].resize(channel_count);
+		for (int j = 0; j < channel_count; j++) {
+			temp_buffers.write[i].write[j].resize(buffer_size);
+		}
+	}
+}
+
+void AudioServer::_mix_bus(Bus *p_bus, int p_temp_set) {
+
+	Bus *bus = p_bus;
+	Vector<AudioFrame> *temp_buffer = temp_buffers.write[p_temp_set].ptrw();
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
+			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+
+			for (uint32_t j = 0; j < buffer_size; j++) {
+
+				buf[j] = AudioFrame(0, 0);
 			}
 		}
+	}
 
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
+	//process effects
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
 
-				if (!bus->effects[j].enabled)
-					continue;
+			if (!bus->effects[j].enabled)
+				continue;
 
 #ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 #endif
 
-				for (int k = 0; k < bus->channels.size(); k++) {
+			for (int k = 0; k < bus->channels.size(); k++) {
 
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer[k].ptrw(), buffer_size);
+			}
 
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
+			//swap buffers, so internal buffer always has the right data
+			for (int k = 0; k < bus->channels.size(); k++) {
 
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				SWAP(bus->channels.write[k].buffer, temp_buffer[k]);
+			}
 
 #ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
 #endif
+		}
+	}
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (!bus->channels[k].active)
+			continue;
+
+		float *samples = (float *)bus->channels.write[k].buffer.ptrw();
+
+		float volume = Math::db2linear(bus->volume_db);
+
+		if (mix_solo_mode) {
+			if (!bus->soloed) {
+				volume = 0.0;
+			}
+		} else {
+			if (bus->mute) {
+				volume = 0.0;
 			}
 		}
 
-		//process send
+		//apply volume and compute peak, two frames at a time without branches so it vectorizes
+		float peak_l0 = 0, peak_r0 = 0, peak_l1 = 0, peak_r1 = 0;
+		uint32_t sample_count = buffer_size * 2;
+		uint32_t j = 0;
+		for (; j + 4 <= sample_count; j += 4) {
+
+			samples[j + 0] *= volume;
+			samples[j + 1] *= volume;
+			samples[j + 2] *= volume;
+			samples[j + 3] *= volume;
+
+			peak_l0 = MAX(peak_l0, Math::absf(samples[j + 0]));
+			peak_r0 = MAX(peak_r0, Math::absf(samples[j + 1]));
+			peak_l1 = MAX(peak_l1, Math::absf(samples[j + 2]));
+			peak_r1 = MAX(peak_r1, Math::absf(samples[j + 3]));
+		}
+		for (; j < sample_count; j += 2) {
 
-		Bus *send = NULL;
+			samples[j + 0] *= volume;
+			samples[j + 1] *= volume;
 
-		if (i > 0) {
-			//everything has a send save for master bus
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { //invalid, send to master
-					send = buses[0];
-				}
+			peak_l0 = MAX(peak_l0, Math::absf(samples[j + 0]));
+			peak_r0 = MAX(peak_r0, Math::absf(samples[j + 1]));
+		}
+
+		AudioFrame peak = AudioFrame(MAX(peak_l0, peak_l1), MAX(peak_r0, peak_r1));
+
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
+
+		if (!bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false; //went inactive, don't mix.
 			}
 		}
+	}
+}
+
+void AudioServer::_mix_bus_job(uint32_t p_index, Bus **p_buses) {
+
+	_mix_bus(p_buses[p_index], p_index);
+}
+
+void AudioServer::_mix_bus_send(Bus *p_bus) {
+
+	Bus *send = _get_bus_send(p_bus);
+	if (!send)
+		return; //master bus
+
+	for (int k = 0; k < p_bus->channels.size(); k++) {
+
+		if (!p_bus->channels[k].active)
+			continue;
+
+		const float *src = (const float *)p_bus->channels[k].buffer.ptr();
+		float *dst = (float *)thread_get_channel_mix_buffer(send->index_cache, k);
+		uint32_t sample_count = buffer_size * 2;
+
+		for (uint32_t j = 0; j < sample_count; j++) {
+			dst[j] += src[j];
+		}
+	}
+}
+
+void AudioServer::_mix_step() {
 
+	mix_solo_mode = false;
+
+	for (int i = 0; i < buses.size(); i++) {
+		Bus *bus = buses[i];
+		bus->index_cache = i; //might be moved around by editor, so..
 		for (int k = 0; k < bus->channels.size(); k++) {
 
-			if (!bus->channels[k].active)
-				continue;
+			bus->channels.write[k].used = false;
+		}
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+		if (bus->solo) {
+			//solo chain
+			mix_solo_mode = true;
+			do {
+				bus->soloed = true;
+				bus = _get_bus_send(bus);
+			} while (bus);
+		} else {
+			bus->soloed = false;
+		}
+	}
 
-			AudioFrame peak = AudioFrame(0, 0);
+	//make callbacks for mixing the audio
+	for (Set<CallbackItem>::Element *E = callbacks.front(); E; E = E->next()) {
 
-			float volume = Math::db2linear(bus->volume_db);
+		E->get().callback(E->get().userdata);
+	}
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
-				}
-			}
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
 
-			//apply volume and compute peak
-			for (uint32_t j = 0; j < buffer_size; j++) {
+	if (!parallel_bus_mixing || buses.size() < 3 || !pool || pool->get_thread_count() == 0 || !_update_mix_levels()) {
 
-				buf[j] *= volume;
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			//go bus by bus
+			_mix_bus(buses[i], 0);
+			_mix_bus_send(buses[i]);
+		}
 
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
-				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
-				}
-			}
+	} else {
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
+		Bus **order = mix_order.ptrw();
+		int from = 0;
+		for (int i = 0; i < mix_level_ends.size(); i++) {
 
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+			int to = mix_level_ends[i];
 
-				if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
+			// Buses reading a sidechain go last and one at a time, they touch
+			// the buffer of another bus.
+			int parallel_to = to;
+			for (int j = to - 1; j >= from; j--) {
+				if (_get_bus_sidechain(order[j]) >= 0) {
+					SWAP(order[j], order[--parallel_to]);
 				}
 			}
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+			if (parallel_to - from > 1) {
+				if (temp_buffers.size() < parallel_to - from) {
+					_resize_temp_buffers(parallel_to - from);
+				}
+				thread_process_array(parallel_to - from, this, &AudioServer::_mix_bus_job, order + from);
+			} else if (parallel_to > from) {
+				_mix_bus(order[from], 0);
+			}
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
+			for (int j = parallel_to; j < to; j++) {
+				_mix_bus(order[j], 0);
+			}
+
+			// Sends write to buses of later levels, in the same order as mixing serially.
+			for (int j = buses.size() - 1; j >= 0; j--) {
+				if (mix_bus_levels[j] == i) {
+					_mix_bus_send(buses[j]);
 				}
 			}
+
+			from = to;
 		}
 	}
 
@@ -906,6 +1058,18 @@ bool AudioServer::is_bus_effect_enabled(int p_bus, int p_effect) const {
 	return buses[p_bus]->effects[p_effect].enabled;
 }
 
+void AudioServer::set_parallel_bus_mixing(bool p_enable) {
+
+	lock();
+	parallel_bus_mixing = p_enable;
+	unlock();
+}
+
+bool AudioServer::is_parallel_bus_mixing_enabled() const {
+
+	return parallel_bus_mixing;
+}
+
 float AudioServer::get_bus_peak_volume_left_db(int p_bus, int p_channel) const {
 
 	ERR_FAIL_INDEX_V(p_bus, buses.size(), 0);
@@ -931,11 +1095,7 @@ bool AudioServer::is_bus_channel_active(int p_bus, int p_channel) const {
 
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
-	temp_buffer.resize(channel_count);
-
-	for (int i = 0; i < temp_buffer.size(); i++) {
-		temp_buffer.write[i].resize(buffer_size);
-	}
+	_resize_temp_buffers(MAX(temp_buffers.size(), 1));
 
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
@@ -950,6 +1110,7 @@ void AudioServer::init() {
 	channel_disable_threshold_db = GLOBAL_DEF_RST("audio/channel_disable_threshold_db", -60.0);
 	channel_disable_frames = float(GLOBAL_DEF_RST("audio/channel_disable_time", 2.0)) * get_mix_rate();
 	ProjectSettings::get_singleton()->set_custom_property_info("audio/channel_disable_time", PropertyInfo(Variant::REAL, "audio/channel_disable_time", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"));
+	parallel_bus_mixing = GLOBAL_DEF("audio/parallel_bus_mixing", false);
 	buffer_size = 1024; //hardcoded for now
 
 	init_channels_and_buffers();
@@ -1363,6 +1524,8 @@ AudioServer::AudioServer() {
 	to_mix = 0;
 	output_latency = 0;
 	output_latency_ticks = 0;
+	parallel_bus_mixing = false;
+	mix_solo_mode = false;
 #ifdef DEBUG_ENABLED
 	prof_time = 0;
 #endif
@@ -217,11 +217,26 @@ private:
 		int index_cache;
 	};
 
-	Vector<Vector<AudioFrame> > temp_buffer; //temp_buffer for each level
+	Vector<Vector<Vector<AudioFrame> > > temp_buffers; //temp_buffer for each channel, one set per bus mixed at the same time
 	Vector<Bus *> buses;
 	Map<StringName, Bus *> bus_map;
 
+	// Buses are mixed in levels, a bus only receives audio from buses in earlier levels,
+	// so the buses inside a level can be mixed in parallel.
+	bool parallel_bus_mixing;
+	bool mix_solo_mode;
+	Vector<int> mix_bus_levels;
+	Vector<Bus *> mix_order;
+	Vector<int> mix_level_ends;
+
 	void _update_bus_effects(int p_bus);
+	Bus *_get_bus_send(Bus *p_bus);
+	int _get_bus_sidechain(Bus *p_bus);
+	bool _update_mix_levels();
+	void _resize_temp_buffers(int p_sets);
+	void _mix_bus(Bus *p_bus, int p_temp_set);
+	void _mix_bus_job(uint32_t p_index, Bus **p_buses);
+	void _mix_bus_send(Bus *p_bus);
 
 	static AudioServer *singleton;
 
@@ -328,6 +343,9 @@ public:
 	void set_bus_effect_enabled(int p_bus, int p_effect, bool p_enabled);
 	bool is_bus_effect_enabled(int p_bus, int p_effect) const;
 
+	void set_parallel_bus_mixing(bool p_enable);
+	bool is_parallel_bus_mixing_enabled() const;
+
 	float get_bus_peak_volume_left_db(int p_bus, int p_channel) const;
 	float get_bus_peak_volume_right_db(int p_bus, int p_channel) const;
 
@@ -41,27 +41,33 @@ bool AreaPairSW::setup(real_t p_step) {
 		result = true;
 	}
 
-	if (result != colliding) {
+	process_collision = result != colliding;
 
-		if (result) {
+	return false; //never do any post solving
+}
 
-			if (area->get_space_override_mode() != PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
-				body->add_area(area);
-			if (area->has_monitor_callback())
-				area->add_body_to_query(body, body_shape, area_shape);
+void AreaPairSW::post_setup(real_t p_step) {
 
-		} else {
+	if (!process_collision)
+		return;
 
-			if (area->get_space_override_mode() != PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
-				body->remove_area(area);
-			if (area->has_monitor_callback())
-				area->remove_body_from_query(body, body_shape, area_shape);
-		}
+	process_collision = false;
+	colliding = !colliding;
 
-		colliding = result;
-	}
+	if (colliding) {
 
-	return false; //never do any post solving
+		if (area->get_space_override_mode() != PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
+			body->add_area(area);
+		if (area->has_monitor_callback())
+			area->add_body_to_query(body, body_shape, area_shape);
+
+	} else {
+
+		if (area->get_space_override_mode() != PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
+			body->remove_area(area);
+		if (area->has_monitor_callback())
+			area->remove_body_from_query(body, body_shape, area_shape);
+	}
 }
 
 void AreaPairSW::solve(real_t p_step) {
@@ -74,6 +80,7 @@ AreaPairSW::AreaPairSW(BodySW *p_body, int p_body_shape, AreaSW *p_area, int p_a
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	process_collision = false;
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC)
@@ -104,29 +111,35 @@ bool Area2PairSW::setup(real_t p_step) {
 		result = true;
 	}
 
-	if (result != colliding) {
+	process_collision = result != colliding;
 
-		if (result) {
+	return false; //never do any post solving
+}
 
-			if (area_b->has_area_monitor_callback() && area_a->is_monitorable())
-				area_b->add_area_to_query(area_a, shape_a, shape_b);
+void Area2PairSW::post_setup(real_t p_step) {
 
-			if (area_a->has_area_monitor_callback() && area_b->is_monitorable())
-				area_a->add_area_to_query(area_b, shape_b, shape_a);
+	if (!process_collision)
+		return;
 
-		} else {
+	process_collision = false;
+	colliding = !colliding;
 
-			if (area_b->has_area_monitor_callback() && area_a->is_monitorable())
-				area_b->remove_area_from_query(area_a, shape_a, shape_b);
+	if (colliding) {
 
-			if (area_a->has_area_monitor_callback() && area_b->is_monitorable())
-				area_a->remove_area_from_query(area_b, shape_b, shape_a);
-		}
+		if (area_b->has_area_monitor_callback() && area_a->is_monitorable())
+			area_b->add_area_to_query(area_a, shape_a, shape_b);
 
-		colliding = result;
-	}
+		if (area_a->has_area_monitor_callback() && area_b->is_monitorable())
+			area_a->add_area_to_query(area_b, shape_b, shape_a);
 
-	return false; //never do any post solving
+	} else {
+
+		if (area_b->has_area_monitor_callback() && area_a->is_monitorable())
+			area_b->remove_area_from_query(area_a, shape_a, shape_b);
+
+		if (area_a->has_area_monitor_callback() && area_b->is_monitorable())
+			area_a->remove_area_from_query(area_b, shape_b, shape_a);
+	}
 }
 
 void Area2PairSW::solve(real_t p_step) {
@@ -139,6 +152,7 @@ Area2PairSW::Area2PairSW(AreaSW *p_area_a, int p_shape_a, AreaSW *p_area_b, int
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	process_collision = false;
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
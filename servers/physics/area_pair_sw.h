@@ -42,9 +42,11 @@ class AreaPairSW : public ConstraintSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	bool process_collision;
 
 public:
 	bool setup(real_t p_step);
+	void post_setup(real_t p_step);
 	void solve(real_t p_step);
 
 	AreaPairSW(BodySW *p_body, int p_body_shape, AreaSW *p_area, int p_area_shape);
@@ -58,9 +60,11 @@ class Area2PairSW : public ConstraintSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	bool process_collision;
 
 public:
 	bool setup(real_t p_step);
+	void post_setup(real_t p_step);
 	void solve(real_t p_step);
 
 	Area2PairSW(AreaSW *p_area_a, int p_shape_a, AreaSW *p_area_b, int p_shape_b);
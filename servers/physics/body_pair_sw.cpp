@@ -221,6 +221,8 @@ real_t combine_friction(BodySW *A, BodySW *B) {
 
 bool BodyPairSW::setup(real_t p_step) {
 
+	deferred_reports = false;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
@@ -281,6 +283,15 @@ bool BodyPairSW::setup(real_t p_step) {
 
 	real_t inv_dt = 1.0 / p_step;
 
+	// static and kinematic bodies can take part in several islands being set up at
+	// the same time, so contacts reported to them are added from post_setup()
+	bool report_A = A->can_report_contacts() && A->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
+	bool report_B = B->can_report_contacts() && B->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
+	deferred_reports = report_A != A->can_report_contacts() || report_B != B->can_report_contacts();
+#ifdef DEBUG_ENABLED
+	deferred_reports = deferred_reports || space->is_debugging_contacts();
+#endif
+
 	for (int i = 0; i < contact_count; i++) {
 
 		Contact &c = contacts[i];
@@ -298,25 +309,17 @@ bool BodyPairSW::setup(real_t p_step) {
 
 		c.active = true;
 
-#ifdef DEBUG_ENABLED
-
-		if (space->is_debugging_contacts()) {
-			space->add_debug_contact(global_A + offset_A);
-			space->add_debug_contact(global_B + offset_A);
-		}
-#endif
-
 		c.rA = global_A - A->get_center_of_mass();
 		c.rB = global_B - B->get_center_of_mass() - offset_B;
 
 		// contact query reporting...
 
-		if (A->can_report_contacts()) {
+		if (report_A) {
 			Vector3 crA = A->get_angular_velocity().cross(c.rA) + A->get_linear_velocity();
 			A->add_contact(global_A, -c.normal, depth, shape_A, global_B, shape_B, B->get_instance_id(), B->get_self(), crA);
 		}
 
-		if (B->can_report_contacts()) {
+		if (report_B) {
 			Vector3 crB = B->get_angular_velocity().cross(c.rB) + B->get_linear_velocity();
 			B->add_contact(global_B, c.normal, depth, shape_B, global_A, shape_A, A->get_instance_id(), A->get_self(), crB);
 		}
@@ -353,6 +356,47 @@ bool BodyPairSW::setup(real_t p_step) {
 	return true;
 }
 
+void BodyPairSW::post_setup(real_t p_step) {
+
+	if (!deferred_reports)
+		return;
+
+	bool report_A = A->can_report_contacts() && A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC;
+	bool report_B = B->can_report_contacts() && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC;
+
+#ifdef DEBUG_ENABLED
+	Vector3 offset_A = A->get_transform().get_origin();
+#endif
+
+	for (int i = 0; i < contact_count; i++) {
+
+		const Contact &c = contacts[i];
+		if (!c.active)
+			continue;
+
+		Vector3 global_A = c.rA + A->get_center_of_mass();
+		Vector3 global_B = c.rB + B->get_center_of_mass() + offset_B;
+
+#ifdef DEBUG_ENABLED
+
+		if (space->is_debugging_contacts()) {
+			space->add_debug_contact(global_A + offset_A);
+			space->add_debug_contact(global_B + offset_A);
+		}
+#endif
+
+		if (report_A) {
+			Vector3 crA = A->get_angular_velocity().cross(c.rA) + A->get_linear_velocity();
+			A->add_contact(global_A, -c.normal, c.depth, shape_A, global_B, shape_B, B->get_instance_id(), B->get_self(), crA);
+		}
+
+		if (report_B) {
+			Vector3 crB = B->get_angular_velocity().cross(c.rB) + B->get_linear_velocity();
+			B->add_contact(global_B, c.normal, c.depth, shape_B, global_A, shape_A, A->get_instance_id(), A->get_self(), crB);
+		}
+	}
+}
+
 void BodyPairSW::solve(real_t p_step) {
 
 	if (!collided)
@@ -486,6 +530,7 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	deferred_reports = false;
 }
 
 BodyPairSW::~BodyPairSW() {
@@ -221,19 +221,31 @@ public:
 		linear_velocity += p_j * _inv_mass;
 	}
 
+	// Static and kinematic bodies are never moved by impulses. They can be shared by
+	// islands that are solved in parallel, so they must not be written to either.
+
 	_FORCE_INLINE_ void apply_impulse(const Vector3 &p_pos, const Vector3 &p_j) {
 
+		if (mode <= PhysicsServer::BODY_MODE_KINEMATIC)
+			return;
+
 		linear_velocity += p_j * _inv_mass;
 		angular_velocity += _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(const Vector3 &p_j) {
 
+		if (mode <= PhysicsServer::BODY_MODE_KINEMATIC)
+			return;
+
 		angular_velocity += _inv_inertia_tensor.xform(p_j);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3 &p_pos, const Vector3 &p_j, real_t p_max_delta_av = -1.0) {
 
+		if (mode <= PhysicsServer::BODY_MODE_KINEMATIC)
+			return;
+
 		biased_linear_velocity += p_j * _inv_mass;
 		if (p_max_delta_av != 0.0) {
 			Vector3 delta_av = _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
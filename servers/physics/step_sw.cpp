@@ -32,6 +32,8 @@
 #include "joints_sw.h"
 
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
 
@@ -107,7 +109,7 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_de
 	}
 }
 
-void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
+bool StepSW::_island_can_sleep(BodySW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
 
@@ -125,9 +127,14 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 		b = b->get_island_next();
 	}
 
+	return can_sleep;
+}
+
+void StepSW::_check_suspend(BodySW *p_island, bool p_can_sleep) {
+
 	//put all to sleep or wake up everyoen
 
-	b = p_island;
+	BodySW *b = p_island;
 	while (b) {
 
 		if (b->get_mode() == PhysicsServer::BODY_MODE_STATIC || b->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC) {
@@ -137,19 +144,37 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep)
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep)
+			b->set_active(!p_can_sleep);
 
 		b = b->get_island_next();
 	}
 }
 
+void StepSW::_setup_island_job(uint32_t p_index, ConstraintSW **p_islands) {
+
+	_setup_island(p_islands[p_index], step_delta);
+}
+
+void StepSW::_solve_island_job(uint32_t p_index, ConstraintSW **p_islands) {
+
+	_solve_island(p_islands[p_index], step_iterations, step_delta);
+}
+
+void StepSW::_island_can_sleep_job(uint32_t p_index, bool *p_can_sleep) {
+
+	p_can_sleep[p_index] = _island_can_sleep(body_islands[p_index], step_delta);
+}
+
 void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
 
+	step_delta = p_delta;
+	step_iterations = p_iterations;
+
 	const SelfList<BodySW>::List *body_list = &p_space->get_active_body_list();
 
 	/* INTEGRATE FORCES */
@@ -222,6 +247,38 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 		p_space->area_remove_from_moved_list((SelfList<AreaSW> *)aml.first()); //faster to remove here
 	}
 
+	/* FLATTEN ISLANDS */
+
+	// Islands only share static and kinematic bodies, which impulses never write to.
+	// Anything else that is shared (areas, contact reports, debug contacts) is left to
+	// post_setup(), which runs in island order, so results don't depend on the amount
+	// of threads.
+
+	{
+		int count = 0;
+		for (ConstraintSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			count++;
+		}
+		constraint_islands.resize(count);
+		ConstraintSW **ptr = constraint_islands.ptrw();
+		for (ConstraintSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			*ptr++ = ci;
+		}
+
+		count = 0;
+		for (BodySW *bi = island_list; bi; bi = bi->get_island_list_next()) {
+			count++;
+		}
+		body_islands.resize(count);
+		body_island_can_sleep.resize(count);
+		BodySW **bptr = body_islands.ptrw();
+		for (BodySW *bi = island_list; bi; bi = bi->get_island_list_next()) {
+			*bptr++ = bi;
+		}
+	}
+
+	bool threaded = parallel_islands && constraint_islands.size() >= PARALLEL_ISLANDS_MIN_COUNT;
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(SpaceSW::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -230,12 +287,20 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
+	if (threaded) {
+		thread_process_array(constraint_islands.size(), this, &StepSW::_setup_island_job, constraint_islands.ptrw());
+	} else {
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			_setup_island(constraint_islands[i], p_delta);
+		}
+	}
 
-			_setup_island(ci, p_delta);
-			ci = ci->get_island_list_next();
+	for (int i = 0; i < constraint_islands.size(); i++) {
+
+		ConstraintSW *ci = constraint_islands[i];
+		while (ci) {
+			ci->post_setup(p_delta);
+			ci = ci->get_island_next();
 		}
 	}
 
@@ -247,12 +312,12 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+	//iterating each island separatedly improves cache efficiency
+	if (threaded) {
+		thread_process_array(constraint_islands.size(), this, &StepSW::_solve_island_job, constraint_islands.ptrw());
+	} else {
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			_solve_island(constraint_islands[i], p_iterations, p_delta);
 		}
 	}
 
@@ -273,15 +338,20 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		BodySW *bi = island_list;
-		while (bi) {
-
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
+	if (parallel_islands && body_islands.size() >= PARALLEL_ISLANDS_MIN_COUNT) {
+		thread_process_array(body_islands.size(), this, &StepSW::_island_can_sleep_job, body_island_can_sleep.ptrw());
+	} else {
+		for (int i = 0; i < body_islands.size(); i++) {
+			body_island_can_sleep.write[i] = _island_can_sleep(body_islands[i], p_delta);
 		}
 	}
 
+	// activating or suspending a body changes the space active list, so it stays serial
+	for (int i = 0; i < body_islands.size(); i++) {
+
+		_check_suspend(body_islands[i], body_island_can_sleep[i]);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(SpaceSW::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
@@ -296,4 +366,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 StepSW::StepSW() {
 
 	_step = 1;
+	step_delta = 0;
+	step_iterations = 0;
+	parallel_islands = GLOBAL_DEF("physics/3d/parallel_islands", false);
 }
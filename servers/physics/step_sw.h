@@ -35,12 +35,30 @@
 
 class StepSW {
 
+	enum {
+		PARALLEL_ISLANDS_MIN_COUNT = 8
+	};
+
 	uint64_t _step;
 
+	bool parallel_islands;
+	real_t step_delta;
+	int step_iterations;
+
+	// islands are flattened every step so they can be processed by index
+	Vector<ConstraintSW *> constraint_islands;
+	Vector<BodySW *> body_islands;
+	Vector<bool> body_island_can_sleep;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
-	void _check_suspend(BodySW *p_island, real_t p_delta);
+	bool _island_can_sleep(BodySW *p_island, real_t p_delta);
+	void _check_suspend(BodySW *p_island, bool p_can_sleep);
+
+	void _setup_island_job(uint32_t p_index, ConstraintSW **p_islands);
+	void _solve_island_job(uint32_t p_index, ConstraintSW **p_islands);
+	void _island_can_sleep_job(uint32_t p_index, bool *p_can_sleep);
 
 public:
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
@@ -229,6 +229,8 @@ real_t combine_friction(Body2DSW *A, Body2DSW *B) {
 
 bool BodyPair2DSW::setup(real_t p_step) {
 
+	deferred_reports = false;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
@@ -360,6 +362,15 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 	bool do_process = false;
 
+	// static and kinematic bodies can take part in several islands being set up at
+	// the same time, so contacts reported to them are added from post_setup()
+	int gather_A = A->can_report_contacts() && A->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
+	int gather_B = B->can_report_contacts() && B->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
+	deferred_reports = gather_A != A->can_report_contacts() || gather_B != B->can_report_contacts();
+#ifdef DEBUG_ENABLED
+	deferred_reports = deferred_reports || space->is_debugging_contacts();
+#endif
+
 	for (int i = 0; i < contact_count; i++) {
 
 		Contact &c = contacts[i];
@@ -375,14 +386,6 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		}
 
 		c.active = true;
-#ifdef DEBUG_ENABLED
-		if (space->is_debugging_contacts()) {
-			space->add_debug_contact(global_A + offset_A);
-			space->add_debug_contact(global_B + offset_A);
-		}
-#endif
-		int gather_A = A->can_report_contacts();
-		int gather_B = B->can_report_contacts();
 
 		c.rA = global_A;
 		c.rB = global_B - offset_B;
@@ -455,6 +458,53 @@ bool BodyPair2DSW::setup(real_t p_step) {
 	return do_process;
 }
 
+void BodyPair2DSW::post_setup(real_t p_step) {
+
+	if (!deferred_reports)
+		return;
+
+	bool gather_A = A->can_report_contacts() && A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC;
+	bool gather_B = B->can_report_contacts() && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC;
+
+	Vector2 offset_A = A->get_transform().get_origin();
+	Transform2D xform_Au = A->get_transform().untranslated();
+	Transform2D xform_Bu = B->get_transform();
+	xform_Bu.elements[2] -= offset_A;
+
+	for (int i = 0; i < contact_count; i++) {
+
+		const Contact &c = contacts[i];
+
+		Vector2 global_A = xform_Au.xform(c.local_A);
+		Vector2 global_B = xform_Bu.xform(c.local_B);
+
+		real_t depth = c.normal.dot(global_A - global_B);
+
+		if (depth <= 0 || !c.reused)
+			continue;
+
+		global_A += offset_A;
+		global_B += offset_A;
+
+#ifdef DEBUG_ENABLED
+		if (space->is_debugging_contacts()) {
+			space->add_debug_contact(global_A);
+			space->add_debug_contact(global_B);
+		}
+#endif
+
+		if (gather_A) {
+			Vector2 crB(-B->get_angular_velocity() * c.rB.y, B->get_angular_velocity() * c.rB.x);
+			A->add_contact(global_A, -c.normal, depth, shape_A, global_B, shape_B, B->get_instance_id(), B->get_self(), crB + B->get_linear_velocity());
+		}
+		if (gather_B) {
+
+			Vector2 crA(-A->get_angular_velocity() * c.rA.y, A->get_angular_velocity() * c.rA.x);
+			B->add_contact(global_B, c.normal, depth, shape_B, global_A, shape_A, A->get_instance_id(), A->get_self(), crA + A->get_linear_velocity());
+		}
+	}
+}
+
 void BodyPair2DSW::solve(real_t p_step) {
 
 	if (!collided)
@@ -523,6 +573,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	contact_count = 0;
 	collided = false;
 	oneway_disabled = false;
+	deferred_reports = false;
 }
 
 BodyPair2DSW::~BodyPair2DSW() {
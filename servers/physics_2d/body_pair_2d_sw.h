@@ -78,6 +78,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	int contact_count;
 	bool collided;
 	bool oneway_disabled;
+	bool deferred_reports;
 	int cc;
 
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
@@ -87,6 +88,7 @@ class BodyPair2DSW : public Constraint2DSW {
 
 public:
 	bool setup(real_t p_step);
+	void post_setup(real_t p_step);
 	void solve(real_t p_step);
 
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
@@ -72,6 +72,9 @@ public:
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
 	virtual bool setup(real_t p_step) = 0;
+	// setup() may run on several threads at once, one island per thread; work that
+	// touches state shared between islands goes here, always called from one thread.
+	virtual void post_setup(real_t p_step) {}
 	virtual void solve(real_t p_step) = 0;
 
 	virtual ~Constraint2DSW() {}
@@ -30,6 +30,8 @@
 
 #include "step_2d_sw.h"
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 
@@ -94,7 +96,7 @@ void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t
 	}
 }
 
-void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
+bool Step2DSW::_island_can_sleep(Body2DSW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
 
@@ -112,9 +114,14 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 		b = b->get_island_next();
 	}
 
+	return can_sleep;
+}
+
+void Step2DSW::_check_suspend(Body2DSW *p_island, bool p_can_sleep) {
+
 	//put all to sleep or wake up everyoen
 
-	b = p_island;
+	Body2DSW *b = p_island;
 	while (b) {
 
 		if (b->get_mode() == Physics2DServer::BODY_MODE_STATIC || b->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) {
@@ -124,19 +131,37 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep)
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep)
+			b->set_active(!p_can_sleep);
 
 		b = b->get_island_next();
 	}
 }
 
+void Step2DSW::_setup_island_job(uint32_t p_index, bool *p_removed_root) {
+
+	p_removed_root[p_index] = _setup_island(constraint_islands[p_index], step_delta);
+}
+
+void Step2DSW::_solve_island_job(uint32_t p_index, Constraint2DSW **p_islands) {
+
+	_solve_island(p_islands[p_index], step_iterations, step_delta);
+}
+
+void Step2DSW::_island_can_sleep_job(uint32_t p_index, bool *p_can_sleep) {
+
+	p_can_sleep[p_index] = _island_can_sleep(body_islands[p_index], step_delta);
+}
+
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
 
+	step_delta = p_delta;
+	step_iterations = p_iterations;
+
 	const SelfList<Body2DSW>::List *body_list = &p_space->get_active_body_list();
 
 	/* INTEGRATE FORCES */
@@ -209,6 +234,49 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 		p_space->area_remove_from_moved_list((SelfList<Area2DSW> *)aml.first()); //faster to remove here
 	}
 
+	/* FLATTEN ISLANDS */
+
+	// Islands only share static and kinematic bodies, which impulses never write to.
+	// Anything else that is shared (areas, contact reports, debug contacts) is left to
+	// post_setup(), which runs in island order, so results don't depend on the amount
+	// of threads.
+
+	{
+		int count = 0;
+		int total = 0;
+		for (Constraint2DSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			count++;
+			for (Constraint2DSW *c = ci; c; c = c->get_island_next()) {
+				total++;
+			}
+		}
+		constraint_islands.resize(count);
+		constraint_island_removed_root.resize(count);
+		constraints.resize(total);
+		Constraint2DSW **ptr = constraint_islands.ptrw();
+		Constraint2DSW **cptr = constraints.ptrw();
+		for (Constraint2DSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			*ptr++ = ci;
+			// setup unlinks the constraints it won't process, they still need post_setup()
+			for (Constraint2DSW *c = ci; c; c = c->get_island_next()) {
+				*cptr++ = c;
+			}
+		}
+
+		count = 0;
+		for (Body2DSW *bi = island_list; bi; bi = bi->get_island_list_next()) {
+			count++;
+		}
+		body_islands.resize(count);
+		body_island_can_sleep.resize(count);
+		Body2DSW **bptr = body_islands.ptrw();
+		for (Body2DSW *bi = island_list; bi; bi = bi->get_island_list_next()) {
+			*bptr++ = bi;
+		}
+	}
+
+	bool threaded = parallel_islands && constraint_islands.size() >= PARALLEL_ISLANDS_MIN_COUNT;
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -217,42 +285,32 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = NULL;
-		while (ci) {
-
-			if (_setup_island(ci, p_delta)) {
-
-				//removed the root from the island graph because it is not to be processed
-
-				Constraint2DSW *next = ci->get_island_next();
+	if (threaded) {
+		thread_process_array(constraint_islands.size(), this, &Step2DSW::_setup_island_job, constraint_island_removed_root.ptrw());
+	} else {
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			constraint_island_removed_root.write[i] = _setup_island(constraint_islands[i], p_delta);
+		}
+	}
 
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
+	for (int i = 0; i < constraints.size(); i++) {
+		constraints[i]->post_setup(p_delta);
+	}
 
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
+	{
+		//islands whose root was removed from the graph continue from the next constraint, or are skipped when empty
+		int count = 0;
+		for (int i = 0; i < constraint_islands.size(); i++) {
 
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
-			} else {
-				prev_ci = ci;
+			Constraint2DSW *ci = constraint_islands[i];
+			if (constraint_island_removed_root[i]) {
+				ci = ci->get_island_next();
+			}
+			if (ci) {
+				constraint_islands.write[count++] = ci;
 			}
-
-			ci = ci->get_island_list_next();
 		}
+		constraint_islands.resize(count);
 	}
 
 	{ //profile
@@ -263,12 +321,12 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+	//iterating each island separatedly improves cache efficiency
+	if (threaded) {
+		thread_process_array(constraint_islands.size(), this, &Step2DSW::_solve_island_job, constraint_islands.ptrw());
+	} else {
+		for (int i = 0; i < constraint_islands.size(); i++) {
+			_solve_island(constraint_islands[i], p_iterations, p_delta);
 		}
 	}
 
@@ -290,15 +348,20 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		Body2DSW *bi = island_list;
-		while (bi) {
-
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
+	if (parallel_islands && body_islands.size() >= PARALLEL_ISLANDS_MIN_COUNT) {
+		thread_process_array(body_islands.size(), this, &Step2DSW::_island_can_sleep_job, body_island_can_sleep.ptrw());
+	} else {
+		for (int i = 0; i < body_islands.size(); i++) {
+			body_island_can_sleep.write[i] = _island_can_sleep(body_islands[i], p_delta);
 		}
 	}
 
+	// activating or suspending a body changes the space active list, so it stays serial
+	for (int i = 0; i < body_islands.size(); i++) {
+
+		_check_suspend(body_islands[i], body_island_can_sleep[i]);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
@@ -313,4 +376,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 Step2DSW::Step2DSW() {
 
 	_step = 1;
+	step_delta = 0;
+	step_iterations = 0;
+	parallel_islands = GLOBAL_DEF("physics/2d/parallel_islands", false);
 }
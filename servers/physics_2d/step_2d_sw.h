@@ -35,12 +35,32 @@
 
 class Step2DSW {
 
+	enum {
+		PARALLEL_ISLANDS_MIN_COUNT = 8
+	};
+
 	uint64_t _step;
 
+	bool parallel_islands;
+	real_t step_delta;
+	int step_iterations;
+
+	// islands are flattened every step so they can be processed by index
+	Vector<Constraint2DSW *> constraint_islands;
+	Vector<Constraint2DSW *> constraints;
+	Vector<bool> constraint_island_removed_root;
+	Vector<Body2DSW *> body_islands;
+	Vector<bool> body_island_can_sleep;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
 	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
-	void _check_suspend(Body2DSW *p_island, real_t p_delta);
+	bool _island_can_sleep(Body2DSW *p_island, real_t p_delta);
+	void _check_suspend(Body2DSW *p_island, bool p_can_sleep);
+
+	void _setup_island_job(uint32_t p_index, bool *p_removed_root);
+	void _solve_island_job(uint32_t p_index, Constraint2DSW **p_islands);
+	void _island_can_sleep_job(uint32_t p_index, bool *p_can_sleep);
 
 public:
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
@@ -0,0 +1,530 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rasterizer_canvas_batcher.h"
+
+static const uint16_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+#define _NPIDX(y, x) (y * 4 + x)
+static const uint16_t ninepatch_indices[54] = {
+
+	_NPIDX(0, 0), _NPIDX(0, 1), _NPIDX(1, 1), _NPIDX(0, 0), _NPIDX(1, 1), _NPIDX(1, 0),
+	_NPIDX(0, 1), _NPIDX(0, 2), _NPIDX(1, 2), _NPIDX(0, 1), _NPIDX(1, 2), _NPIDX(1, 1),
+	_NPIDX(0, 2), _NPIDX(0, 3), _NPIDX(1, 3), _NPIDX(0, 2), _NPIDX(1, 3), _NPIDX(1, 2),
+
+	_NPIDX(1, 0), _NPIDX(1, 1), _NPIDX(2, 1), _NPIDX(1, 0), _NPIDX(2, 1), _NPIDX(2, 0),
+	_NPIDX(1, 2), _NPIDX(1, 3), _NPIDX(2, 3), _NPIDX(1, 2), _NPIDX(2, 3), _NPIDX(2, 2),
+
+	_NPIDX(2, 0), _NPIDX(2, 1), _NPIDX(3, 1), _NPIDX(2, 0), _NPIDX(3, 1), _NPIDX(3, 0),
+	_NPIDX(2, 1), _NPIDX(2, 2), _NPIDX(3, 2), _NPIDX(2, 1), _NPIDX(3, 2), _NPIDX(3, 1),
+	_NPIDX(2, 2), _NPIDX(2, 3), _NPIDX(3, 3), _NPIDX(2, 2), _NPIDX(3, 3), _NPIDX(3, 2),
+
+	// center last, so it can be left out
+	_NPIDX(1, 1), _NPIDX(1, 2), _NPIDX(2, 2), _NPIDX(1, 1), _NPIDX(2, 2), _NPIDX(2, 1)
+};
+#undef _NPIDX
+
+bool RasterizerCanvasBatcher::_get_texture_info_cached(const RID &p_texture, Size2 &r_size, uint32_t &r_flags) {
+
+	if (p_texture != last_texture) {
+		last_texture = p_texture;
+		last_texture_valid = _get_texture_info(p_texture, last_texture_size, last_texture_flags);
+	}
+
+	r_size = last_texture_size;
+	r_flags = last_texture_flags;
+	return last_texture_valid;
+}
+
+void RasterizerCanvasBatcher::_get_item_size(const Item *p_item, int &r_vertices, int &r_indices) const {
+
+	r_vertices = 0;
+	r_indices = 0;
+
+	int command_count = p_item->commands.size();
+	const Item::Command *const *commands = p_item->commands.ptr();
+
+	for (int i = 0; i < command_count; i++) {
+
+		switch (commands[i]->type) {
+			case Item::Command::TYPE_RECT:
+			case Item::Command::TYPE_PRIMITIVE: {
+				r_vertices += 4;
+				r_indices += 6;
+			} break;
+			case Item::Command::TYPE_NINEPATCH: {
+				r_vertices += 16;
+				r_indices += 54;
+			} break;
+			default: {
+			}
+		}
+	}
+}
+
+RasterizerCanvasBatcher::Batch &RasterizerCanvasBatcher::_push_batch() {
+
+	if (batch_count == batches.size()) {
+		batches.resize(MAX(16, batch_count * 2));
+	}
+
+	return batches.ptrw()[batch_count++];
+}
+
+void RasterizerCanvasBatcher::_add_segment(const RID &p_texture, const Vertex *p_vertices, int p_vertex_count, const uint16_t *p_indices, int p_index_count) {
+
+	if (segment_count == segments.size()) {
+		segments.resize(MAX(64, segment_count * 2));
+	}
+
+	Segment &s = segments.ptrw()[segment_count++];
+	s.texture = p_texture;
+	s.rect = Rect2(p_vertices[0].pos, Size2());
+	s.first_index = segment_index_count;
+	s.index_count = p_index_count;
+	s.placed = false;
+
+	Vertex *v = vertices.ptrw() + vertex_count;
+	for (int i = 0; i < p_vertex_count; i++) {
+		v[i] = p_vertices[i];
+		s.rect.expand_to(p_vertices[i].pos);
+	}
+
+	uint16_t *idx = segment_indices.ptrw() + segment_index_count;
+	for (int i = 0; i < p_index_count; i++) {
+		idx[i] = vertex_count + p_indices[i];
+	}
+
+	vertex_count += p_vertex_count;
+	segment_index_count += p_index_count;
+}
+
+void RasterizerCanvasBatcher::_place_segment(const Segment &p_segment) {
+
+	const uint16_t *src = segment_indices.ptr() + p_segment.first_index;
+	uint16_t *dst = indices.ptrw() + index_count;
+	for (int i = 0; i < p_segment.index_count; i++) {
+		dst[i] = src[i];
+	}
+
+	if (batch_count) {
+		Batch &last = batches.ptrw()[batch_count - 1];
+		if (last.type == Batch::TYPE_TRIANGLES && last.texture == p_segment.texture && last.first_index + last.index_count == index_count) {
+			last.index_count += p_segment.index_count;
+			index_count += p_segment.index_count;
+			return;
+		}
+	}
+
+	Batch &b = _push_batch();
+	b.type = Batch::TYPE_TRIANGLES;
+	b.texture = p_segment.texture;
+	b.first_index = index_count;
+	b.index_count = p_segment.index_count;
+	b.item = NULL;
+	b.first_command = 0;
+	b.command_count = 0;
+	b.extra_matrix = Transform2D();
+
+	index_count += p_segment.index_count;
+}
+
+void RasterizerCanvasBatcher::_flush_segments() {
+
+	// Segments are emitted in submission order, except that a segment may be pulled up to join
+	// an earlier one using the same texture when it doesn't overlap anything it would skip over.
+
+	Segment *segs = segments.ptrw();
+
+	for (int i = 0; i < segment_count; i++) {
+
+		if (segs[i].placed)
+			continue;
+
+		_place_segment(segs[i]);
+		segs[i].placed = true;
+
+		int scanned = 0;
+
+		for (int j = i + 1; j < segment_count && scanned < reorder_lookahead; j++) {
+
+			if (segs[j].placed)
+				continue;
+
+			scanned++;
+
+			if (segs[j].texture != segs[i].texture)
+				continue;
+
+			bool overlaps = false;
+
+			for (int k = i + 1; k < j; k++) {
+				if (!segs[k].placed && segs[k].rect.intersects(segs[j].rect)) {
+					overlaps = true;
+					break;
+				}
+			}
+
+			if (!overlaps) {
+				_place_segment(segs[j]);
+				segs[j].placed = true;
+			}
+		}
+	}
+
+	segment_count = 0;
+}
+
+bool RasterizerCanvasBatcher::_add_rect(const Item::CommandRect *p_rect, const Transform2D &p_xform, const Color &p_modulate) {
+
+	static const Vector2 corners[4] = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1) };
+
+	RID texture;
+	Size2 texture_size;
+	uint32_t texture_flags = 0;
+
+	if (p_rect->texture.is_valid() && _get_texture_info_cached(p_rect->texture, texture_size, texture_flags)) {
+
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_CLIP_UV)
+			return false;
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_TILE && !(texture_flags & VS::TEXTURE_FLAG_REPEAT))
+			return false; // the renderer toggles the wrap mode for these
+		if (texture_size.width <= 0 || texture_size.height <= 0)
+			return false;
+
+		texture = p_rect->texture;
+	}
+
+	Rect2 dst_rect = p_rect->rect;
+
+	if (dst_rect.size.width < 0) {
+		dst_rect.position.x += dst_rect.size.width;
+		dst_rect.size.width *= -1;
+	}
+	if (dst_rect.size.height < 0) {
+		dst_rect.position.y += dst_rect.size.height;
+		dst_rect.size.height *= -1;
+	}
+
+	Color color = p_rect->modulate * p_modulate;
+	Vertex v[4];
+
+	if (texture.is_valid()) {
+
+		// same mapping as the texture rect shader
+		Size2 texpixel_size(1.0 / texture_size.width, 1.0 / texture_size.height);
+		Rect2 src_rect = (p_rect->flags & RasterizerCanvas::CANVAS_RECT_REGION) ? Rect2(p_rect->source.position * texpixel_size, p_rect->source.size * texpixel_size) : Rect2(0, 0, 1, 1);
+
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_H) {
+			src_rect.size.x *= -1;
+		}
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_V) {
+			src_rect.size.y *= -1;
+		}
+
+		bool transpose = p_rect->flags & RasterizerCanvas::CANVAS_RECT_TRANSPOSE;
+		Size2 src_size = src_rect.size.abs();
+
+		for (int i = 0; i < 4; i++) {
+
+			const Vector2 &c = corners[i];
+			Vector2 p(src_rect.size.x < 0 ? 1.0 - c.x : c.x, src_rect.size.y < 0 ? 1.0 - c.y : c.y);
+			v[i].pos = p_xform.xform(dst_rect.position + dst_rect.size * p);
+			v[i].uv = src_rect.position + src_size * (transpose ? Vector2(c.y, c.x) : c);
+			v[i].color = color;
+		}
+
+	} else {
+
+		for (int i = 0; i < 4; i++) {
+			v[i].pos = p_xform.xform(dst_rect.position + dst_rect.size * corners[i]);
+			v[i].uv = corners[i];
+			v[i].color = color;
+		}
+	}
+
+	_add_segment(texture, v, 4, quad_indices, 6);
+	return true;
+}
+
+bool RasterizerCanvasBatcher::_add_ninepatch(const Item::CommandNinePatch *p_ninepatch, const Transform2D &p_xform, const Color &p_modulate) {
+
+	Size2 texture_size;
+	uint32_t texture_flags = 0;
+
+	if (!p_ninepatch->texture.is_valid() || !_get_texture_info_cached(p_ninepatch->texture, texture_size, texture_flags))
+		return false;
+	if (texture_size.width <= 0 || texture_size.height <= 0)
+		return false;
+	if (p_ninepatch->axis_x != VS::NINE_PATCH_STRETCH || p_ninepatch->axis_y != VS::NINE_PATCH_STRETCH)
+		return false; // tiling is done per pixel by the renderer
+
+	const Rect2 &rect = p_ninepatch->rect;
+	const float *margin = p_ninepatch->margin;
+
+	if (rect.size.x < margin[MARGIN_LEFT] + margin[MARGIN_RIGHT] || rect.size.y < margin[MARGIN_TOP] + margin[MARGIN_BOTTOM])
+		return false;
+
+	Rect2 source = p_ninepatch->source;
+	if (source.size.x == 0 && source.size.y == 0) {
+		source.size = texture_size;
+	}
+
+	const real_t x[4] = { rect.position.x, rect.position.x + margin[MARGIN_LEFT], rect.position.x + rect.size.x - margin[MARGIN_RIGHT], rect.position.x + rect.size.x };
+	const real_t y[4] = { rect.position.y, rect.position.y + margin[MARGIN_TOP], rect.position.y + rect.size.y - margin[MARGIN_BOTTOM], rect.position.y + rect.size.y };
+	const real_t u[4] = { source.position.x, source.position.x + margin[MARGIN_LEFT], source.position.x + source.size.x - margin[MARGIN_RIGHT], source.position.x + source.size.x };
+	const real_t w[4] = { source.position.y, source.position.y + margin[MARGIN_TOP], source.position.y + source.size.y - margin[MARGIN_BOTTOM], source.position.y + source.size.y };
+
+	Color color = p_ninepatch->color * p_modulate;
+	Vertex v[16];
+
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			Vertex &vtx = v[i * 4 + j];
+			vtx.pos = p_xform.xform(Vector2(x[j], y[i]));
+			vtx.uv = Vector2(u[j] / texture_size.width, w[i] / texture_size.height);
+			vtx.color = color;
+		}
+	}
+
+	_add_segment(p_ninepatch->texture, v, 16, ninepatch_indices, p_ninepatch->draw_center ? 54 : 48);
+	return true;
+}
+
+bool RasterizerCanvasBatcher::_add_primitive(const Item::CommandPrimitive *p_primitive, const Transform2D &p_xform, const Color &p_modulate) {
+
+	int point_count = p_primitive->points.size();
+	int color_count = p_primitive->colors.size();
+	int uv_count = p_primitive->uvs.size();
+
+	if (point_count != 3 && point_count != 4)
+		return false; // points and lines are not triangles
+	if (color_count > 1 && color_count != point_count)
+		return false;
+	if (uv_count && uv_count != point_count)
+		return false;
+
+	RID texture;
+	Size2 texture_size;
+	uint32_t texture_flags = 0;
+
+	if (p_primitive->texture.is_valid() && _get_texture_info_cached(p_primitive->texture, texture_size, texture_flags)) {
+		texture = p_primitive->texture;
+	}
+
+	const Point2 *points = p_primitive->points.ptr();
+	const Point2 *uvs = p_primitive->uvs.ptr();
+	const Color *colors = p_primitive->colors.ptr();
+
+	Vertex v[4];
+
+	for (int i = 0; i < point_count; i++) {
+		v[i].pos = p_xform.xform(points[i]);
+		v[i].uv = uv_count ? uvs[i] : Vector2();
+		v[i].color = (color_count == 0 ? Color(1, 1, 1, 1) : colors[color_count == 1 ? 0 : i]) * p_modulate;
+	}
+
+	_add_segment(texture, v, point_count, quad_indices, point_count == 4 ? 6 : 3);
+	return true;
+}
+
+bool RasterizerCanvasBatcher::_is_command_range_open(const Item *p_item, int p_command) const {
+
+	if (!batch_count)
+		return false;
+
+	const Batch &last = batches[batch_count - 1];
+	return last.type == Batch::TYPE_COMMANDS && last.item == p_item && last.first_command + last.command_count == p_command;
+}
+
+void RasterizerCanvasBatcher::_add_commands(Item *p_item, int p_command, const Transform2D &p_extra_matrix) {
+
+	if (_is_command_range_open(p_item, p_command)) {
+		batches.ptrw()[batch_count - 1].command_count++;
+		return;
+	}
+
+	// commands are drawn in place, so everything submitted before them has to be emitted first
+	_flush_segments();
+
+	Batch &b = _push_batch();
+	b.type = Batch::TYPE_COMMANDS;
+	b.texture = RID();
+	b.first_index = 0;
+	b.index_count = 0;
+	b.item = p_item;
+	b.first_command = p_command;
+	b.command_count = 1;
+	b.extra_matrix = p_extra_matrix;
+}
+
+void RasterizerCanvasBatcher::_add_item(Item *p_item, const Color &p_modulate) {
+
+	const Color &modulate = p_item->final_modulate;
+
+	if (modulate.a * p_modulate.a <= 0.001)
+		return; // not drawn by the renderer either
+
+	int command_count = p_item->commands.size();
+	Item::Command *const *commands = p_item->commands.ptr();
+
+	Transform2D extra_matrix;
+	Transform2D xform = p_item->final_transform;
+
+	for (int i = 0; i < command_count; i++) {
+
+		Item::Command *c = commands[i];
+		bool added = false;
+
+		switch (c->type) {
+
+			case Item::Command::TYPE_RECT: {
+
+				added = _add_rect(static_cast<Item::CommandRect *>(c), xform, modulate);
+			} break;
+			case Item::Command::TYPE_NINEPATCH: {
+
+				added = _add_ninepatch(static_cast<Item::CommandNinePatch *>(c), xform, modulate);
+			} break;
+			case Item::Command::TYPE_PRIMITIVE: {
+
+				added = _add_primitive(static_cast<Item::CommandPrimitive *>(c), xform, modulate);
+			} break;
+			case Item::Command::TYPE_TRANSFORM: {
+
+				extra_matrix = static_cast<Item::CommandTransform *>(c)->xform;
+				xform = p_item->final_transform * extra_matrix;
+
+				// the renderer applies it itself inside a command range
+				added = !_is_command_range_open(p_item, i);
+			} break;
+			default: {
+			}
+		}
+
+		if (!added) {
+			_add_commands(p_item, i, extra_matrix);
+		}
+	}
+}
+
+void RasterizerCanvasBatcher::set_max_vertices(int p_max) {
+
+	max_vertices = CLAMP(p_max, 16, int(MAX_VERTICES));
+	max_indices = max_vertices * 4; // ninepatches use 54 indices for 16 vertices
+
+	vertices.resize(max_vertices);
+	indices.resize(max_indices);
+	segment_indices.resize(max_indices);
+}
+
+void RasterizerCanvasBatcher::set_reorder_lookahead(int p_lookahead) {
+
+	reorder_lookahead = MAX(p_lookahead, 0);
+}
+
+bool RasterizerCanvasBatcher::can_join(const Item *p_item, const Light *p_lights, int p_z) const {
+
+	const Item *material_owner = p_item->material_owner ? p_item->material_owner : p_item;
+
+	if (material_owner->material.is_valid() || p_item->skeleton.is_valid() || p_item->copy_back_buffer || p_item->light_masked)
+		return false;
+
+	for (const Light *light = p_lights; light; light = light->next_ptr) {
+
+		if (p_item->light_mask & light->item_mask && p_z >= light->z_min && p_z <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache))
+			return false;
+	}
+
+	int command_count = p_item->commands.size();
+	const Item::Command *const *commands = p_item->commands.ptr();
+
+	for (int i = 0; i < command_count; i++) {
+		if (commands[i]->type == Item::Command::TYPE_CLIP_IGNORE)
+			return false;
+	}
+
+	return true;
+}
+
+RasterizerCanvasBatcher::Item *RasterizerCanvasBatcher::build(Item *p_items, const Light *p_lights, int p_z, const Color &p_modulate) {
+
+	vertex_count = 0;
+	index_count = 0;
+	segment_index_count = 0;
+	segment_count = 0;
+	batch_count = 0;
+	item_count = 0;
+
+	last_texture = RID(); // textures may have changed since the last build
+
+	Item *ci = p_items;
+
+	while (ci) {
+
+		if (ci != p_items && (ci->final_clip_owner != p_items->final_clip_owner || ci->distance_field != p_items->distance_field || !can_join(ci, p_lights, p_z)))
+			break;
+
+		int item_vertices;
+		int item_indices;
+		_get_item_size(ci, item_vertices, item_indices);
+
+		if (vertex_count + item_vertices > max_vertices || segment_index_count + item_indices > max_indices)
+			break;
+
+		_add_item(ci, p_modulate);
+		item_count++;
+
+		ci = ci->next;
+	}
+
+	_flush_segments();
+
+	return ci;
+}
+
+RasterizerCanvasBatcher::RasterizerCanvasBatcher() {
+
+	max_vertices = 0;
+	max_indices = 0;
+	reorder_lookahead = 0;
+
+	vertex_count = 0;
+	index_count = 0;
+	segment_index_count = 0;
+	segment_count = 0;
+	batch_count = 0;
+	item_count = 0;
+
+	last_texture_valid = false;
+	last_texture_flags = 0;
+
+	set_max_vertices(DEFAULT_MAX_VERTICES);
+}
@@ -0,0 +1,154 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RASTERIZER_CANVAS_BATCHER_H
+#define RASTERIZER_CANVAS_BATCHER_H
+
+#include "servers/visual/rasterizer.h"
+
+/**
+	Joins the commands of consecutive canvas items that don't need per item render
+	state (no material, no skeleton, not lit) into large triangle batches. Vertices are
+	transformed to canvas space and carry the item modulate, so the renderer draws
+	every batch with identity model and extra matrices, one draw call per texture.
+	Commands that can't be expressed as triangles are handed back to the renderer as
+	command ranges, drawn in place with the owning item state.
+*/
+class RasterizerCanvasBatcher {
+public:
+	typedef RasterizerCanvas::Item Item;
+	typedef RasterizerCanvas::Light Light;
+
+	enum {
+		DEFAULT_MAX_VERTICES = 16384,
+		MAX_VERTICES = 65536, // indices are 16 bits
+	};
+
+	struct Vertex {
+		Vector2 pos;
+		Vector2 uv;
+		Color color;
+	};
+
+	struct Batch {
+
+		enum Type {
+			TYPE_TRIANGLES,
+			TYPE_COMMANDS,
+		};
+
+		Type type;
+
+		// TYPE_TRIANGLES
+		RID texture;
+		int first_index;
+		int index_count;
+
+		// TYPE_COMMANDS
+		Item *item;
+		int first_command;
+		int command_count;
+		Transform2D extra_matrix;
+	};
+
+private:
+	struct Segment {
+		RID texture;
+		Rect2 rect;
+		int first_index;
+		int index_count;
+		bool placed;
+	};
+
+	int max_vertices;
+	int max_indices;
+	int reorder_lookahead;
+
+	Vector<Vertex> vertices;
+	Vector<uint16_t> indices;
+	Vector<uint16_t> segment_indices;
+	Vector<Batch> batches;
+	Vector<Segment> segments;
+
+	int vertex_count;
+	int index_count;
+	int segment_index_count;
+	int segment_count;
+	int batch_count;
+	int item_count;
+
+	RID last_texture;
+	bool last_texture_valid;
+	Size2 last_texture_size;
+	uint32_t last_texture_flags;
+
+	bool _get_texture_info_cached(const RID &p_texture, Size2 &r_size, uint32_t &r_flags);
+	void _get_item_size(const Item *p_item, int &r_vertices, int &r_indices) const;
+
+	Batch &_push_batch();
+	void _add_segment(const RID &p_texture, const Vertex *p_vertices, int p_vertex_count, const uint16_t *p_indices, int p_index_count);
+	void _place_segment(const Segment &p_segment);
+	bool _add_rect(const Item::CommandRect *p_rect, const Transform2D &p_xform, const Color &p_modulate);
+	bool _add_ninepatch(const Item::CommandNinePatch *p_ninepatch, const Transform2D &p_xform, const Color &p_modulate);
+	bool _add_primitive(const Item::CommandPrimitive *p_primitive, const Transform2D &p_xform, const Color &p_modulate);
+	void _add_item(Item *p_item, const Color &p_modulate);
+	bool _is_command_range_open(const Item *p_item, int p_command) const;
+	void _add_commands(Item *p_item, int p_command, const Transform2D &p_extra_matrix);
+	void _flush_segments();
+
+protected:
+	// Size and flags of the texture as the renderer binds it, false if it doesn't exist (drawn untextured).
+	virtual bool _get_texture_info(const RID &p_texture, Size2 &r_size, uint32_t &r_flags) = 0;
+
+public:
+	void set_max_vertices(int p_max);
+	int get_max_vertices() const { return max_vertices; }
+	int get_max_indices() const { return max_indices; }
+
+	void set_reorder_lookahead(int p_lookahead);
+	int get_reorder_lookahead() const { return reorder_lookahead; }
+
+	bool can_join(const Item *p_item, const Light *p_lights, int p_z) const;
+	// p_items must be joinable, returns the first item that was left out (p_items if none fit).
+	Item *build(Item *p_items, const Light *p_lights, int p_z, const Color &p_modulate);
+
+	const Vertex *get_vertices() const { return vertices.ptr(); }
+	int get_vertex_count() const { return vertex_count; }
+	const uint16_t *get_indices() const { return indices.ptr(); }
+	int get_index_count() const { return index_count; }
+	const Batch *get_batches() const { return batches.ptr(); }
+	int get_batch_count() const { return batch_count; }
+	int get_item_count() const { return item_count; }
+
+	RasterizerCanvasBatcher();
+	virtual ~RasterizerCanvasBatcher() {}
+};
+
+#endif // RASTERIZER_CANVAS_BATCHER_H
@@ -29,6 +29,8 @@
 /*************************************************************************/
 
 #include "visual_server_canvas.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
 #include "visual_server_global.h"
 #include "visual_server_raster.h"
 #include "visual_server_viewport.h"
@@ -57,9 +59,9 @@ void _collect_ysort_children(VisualServerCanvas::Item *p_canvas_item, Transform2
 	for (int i = 0; i < child_item_count; i++) {
 		if (r_items) {
 			r_items[r_index] = child_items[i];
-			child_items[i]->ysort_xform = p_transform;
-			child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.elements[2]);
 		}
+		child_items[i]->ysort_xform = p_transform;
+		child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.elements[2]);
 
 		r_index++;
 
@@ -75,6 +77,36 @@ void _mark_ysort_dirty(VisualServerCanvas::Item *ysort_owner, RID_Owner<VisualSe
 	}
 }
 
+void _mark_ysort_xform_dirty(VisualServerCanvas::Item *ysort_owner) {
+	while (ysort_owner && ysort_owner->sort_y) {
+		ysort_owner->ysort_xform_dirty = true;
+		ysort_owner = ysort_owner->parent_item;
+	}
+}
+
+// Insertion sort for a list that was sorted last frame, gives up (leaving the list unsorted) after p_max_moves shifts.
+bool _ysort_insertion_sort(VisualServerCanvas::Item **p_items, int p_count, int p_max_moves) {
+
+	VisualServerCanvas::ItemPtrSort compare;
+
+	for (int i = 1; i < p_count; i++) {
+
+		VisualServerCanvas::Item *item = p_items[i];
+		int j = i;
+		while (j > 0 && compare(item, p_items[j - 1])) {
+			p_items[j] = p_items[j - 1];
+			j--;
+		}
+		p_items[j] = item;
+
+		p_max_moves -= i - j;
+		if (p_max_moves < 0)
+			return false;
+	}
+
+	return true;
+}
+
 void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 
 	Item *ci = p_canvas_item;
@@ -125,16 +157,30 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		if (ci->ysort_children_count == -1) {
 			ci->ysort_children_count = 0;
 			_collect_ysort_children(ci, Transform2D(), NULL, ci->ysort_children_count);
-		}
 
-		child_item_count = ci->ysort_children_count;
-		child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+			ci->ysort_children.resize(ci->ysort_children_count);
+
+			int i = 0;
+			_collect_ysort_children(ci, Transform2D(), ci->ysort_children.ptrw(), i);
+
+			SortArray<Item *, ItemPtrSort> sorter;
+			sorter.sort(ci->ysort_children.ptrw(), ci->ysort_children_count);
+
+		} else if (ci->ysort_xform_dirty) {
+			//only transforms changed, the order from last time is usually close
+			int i = 0;
+			_collect_ysort_children(ci, Transform2D(), NULL, i);
+
+			if (!_ysort_insertion_sort(ci->ysort_children.ptrw(), ci->ysort_children_count, ci->ysort_children_count * YSORT_RESORT_MAX_MOVES)) {
+				SortArray<Item *, ItemPtrSort> sorter;
+				sorter.sort(ci->ysort_children.ptrw(), ci->ysort_children_count);
+			}
+		}
 
-		int i = 0;
-		_collect_ysort_children(ci, Transform2D(), child_items, i);
+		ci->ysort_xform_dirty = false;
 
-		SortArray<Item *, ItemPtrSort> sorter;
-		sorter.sort(child_items, child_item_count);
+		child_item_count = ci->ysort_children_count;
+		child_items = ci->ysort_children.ptrw();
 	}
 
 	if (ci->z_relative)
@@ -142,16 +188,7 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 	else
 		p_z = ci->z_index;
 
-	for (int i = 0; i < child_item_count; i++) {
-
-		if (!child_items[i]->behind || (ci->sort_y && child_items[i]->sort_y))
-			continue;
-		if (ci->sort_y) {
-			_render_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
-		} else {
-			_render_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
-		}
-	}
+	_render_canvas_item_children(ci, child_items, 0, child_item_count, true, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, p_material_owner);
 
 	if (ci->copy_back_buffer) {
 
@@ -184,18 +221,130 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		ci->next = NULL;
 	}
 
-	for (int i = 0; i < child_item_count; i++) {
+	int job_count = 0;
+
+	if (parallel_culling && child_item_count >= PARALLEL_CULL_MIN_CHILDREN * 2) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool) {
+			job_count = MIN(pool->get_thread_count() + 1, child_item_count / PARALLEL_CULL_MIN_CHILDREN);
+		}
+	}
 
-		if (child_items[i]->behind || (ci->sort_y && child_items[i]->sort_y))
+	//children drawn behind the parent are rare, only the ones in front are worth splitting up
+	if (job_count > 1) {
+		_render_canvas_item_children_parallel(ci, child_items, child_item_count, job_count, false, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, p_material_owner);
+	} else {
+		_render_canvas_item_children(ci, child_items, 0, child_item_count, false, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, p_material_owner);
+	}
+}
+
+void VisualServerCanvas::_render_canvas_item_children(Item *p_canvas_item, Item **p_child_items, int p_from, int p_to, bool p_behind, const Transform2D &p_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_material_owner) {
+
+	Item *ci = p_canvas_item;
+
+	for (int i = p_from; i < p_to; i++) {
+
+		if (p_child_items[i]->behind != p_behind || (ci->sort_y && p_child_items[i]->sort_y))
 			continue;
 		if (ci->sort_y) {
-			_render_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
+			_render_canvas_item(p_child_items[i], p_xform * p_child_items[i]->ysort_xform, p_clip_rect, p_modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
 		} else {
-			_render_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
+			_render_canvas_item(p_child_items[i], p_xform, p_clip_rect, p_modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
+		}
+	}
+}
+
+void VisualServerCanvas::_render_canvas_item_children_parallel(Item *p_canvas_item, Item **p_child_items, int p_child_count, int p_job_count, bool p_behind, const Transform2D &p_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_material_owner) {
+
+	static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
+
+	//jobs may start more jobs for large subtrees of their own, so nothing here is shared
+	Vector<RasterizerCanvas::Item *> job_z_lists;
+	job_z_lists.resize(p_job_count * z_range * 2);
+
+	Vector<ChildCullJob> jobs;
+	jobs.resize(p_job_count);
+	ChildCullJob *jobs_ptr = jobs.ptrw();
+
+	for (int i = 0; i < p_job_count; i++) {
+
+		ChildCullJob &job = jobs_ptr[i];
+		job.parent = p_canvas_item;
+		job.child_items = p_child_items;
+		job.from = p_child_count * i / p_job_count;
+		job.to = p_child_count * (i + 1) / p_job_count;
+		job.behind = p_behind;
+		job.xform = p_xform;
+		job.clip_rect = p_clip_rect;
+		job.modulate = p_modulate;
+		job.z = p_z;
+		job.material_owner = p_material_owner;
+		job.z_list = job_z_lists.ptrw() + i * z_range * 2;
+		job.z_last_list = job.z_list + z_range;
+	}
+
+	thread_process_array(p_job_count, this, &VisualServerCanvas::_child_cull_job, jobs_ptr);
+
+	//append the lists of each job in order, the result is the same as culling serially
+	for (int i = 0; i < p_job_count; i++) {
+
+		const ChildCullJob &job = jobs_ptr[i];
+
+		for (int j = 0; j < z_range; j++) {
+
+			if (!job.z_list[j])
+				continue;
+
+			if (z_last_list[j]) {
+				z_last_list[j]->next = job.z_list[j];
+			} else {
+				z_list[j] = job.z_list[j];
+			}
+			z_last_list[j] = job.z_last_list[j];
 		}
 	}
 }
 
+void VisualServerCanvas::_child_cull_job(uint32_t p_index, ChildCullJob *p_jobs) {
+
+	static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
+
+	ChildCullJob &job = p_jobs[p_index];
+
+	memset(job.z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+	memset(job.z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+
+	_render_canvas_item_children(job.parent, job.child_items, job.from, job.to, job.behind, job.xform, job.clip_rect, job.modulate, job.z, job.z_list, job.z_last_list, job.material_owner);
+}
+
+void VisualServerCanvas::_cull_canvas(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list) {
+
+	static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
+
+	memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+	memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+
+	int l = p_canvas->child_items.size();
+	Canvas::ChildItem *ci = p_canvas->child_items.ptrw();
+
+	for (int i = 0; i < l; i++) {
+		_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+	}
+}
+
+void VisualServerCanvas::_canvas_cull_job(uint32_t p_index, CanvasCullJob *p_jobs) {
+
+	CanvasCullJob &job = p_jobs[p_index];
+
+	if (job.canvas->children_order_dirty) {
+
+		job.canvas->child_items.sort();
+		job.canvas->children_order_dirty = false;
+	}
+
+	_cull_canvas(job.canvas, job.transform, job.clip_rect, job.z_list, job.z_last_list);
+}
+
 void VisualServerCanvas::_light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights) {
 
 	if (!p_masked_lights)
@@ -219,6 +368,48 @@ void VisualServerCanvas::_light_mask_canvas_items(int p_z, RasterizerCanvas::Ite
 	}
 }
 
+void VisualServerCanvas::cull_canvases(Canvas *const *p_canvases, const Transform2D *p_transforms, int p_count, const Rect2 &p_clip_rect) {
+
+	if (!parallel_culling || p_count < 2)
+		return;
+
+	canvas_cull_jobs.clear();
+
+	for (int i = 0; i < p_count; i++) {
+
+		Canvas *canvas = p_canvases[i];
+
+		//mirrored canvases are culled once per copy while rendering
+		if (canvas->child_items.empty() || canvas->has_mirror())
+			continue;
+
+		CanvasCullJob job;
+		job.canvas = canvas;
+		job.transform = p_transforms[i];
+		job.clip_rect = p_clip_rect;
+		canvas_cull_jobs.push_back(job);
+	}
+
+	if (canvas_cull_jobs.size() < 2) {
+		canvas_cull_jobs.clear();
+		return;
+	}
+
+	static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
+
+	canvas_cull_z_lists.resize(canvas_cull_jobs.size() * z_range * 2);
+	CanvasCullJob *jobs = canvas_cull_jobs.ptrw();
+
+	for (int i = 0; i < canvas_cull_jobs.size(); i++) {
+
+		jobs[i].z_list = canvas_cull_z_lists.ptrw() + i * z_range * 2;
+		jobs[i].z_last_list = jobs[i].z_list + z_range;
+		jobs[i].canvas->cull_job = i;
+	}
+
+	thread_process_array(canvas_cull_jobs.size(), this, &VisualServerCanvas::_canvas_cull_job, jobs);
+}
+
 void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect) {
 
 	VSG::canvas_render->canvas_begin();
@@ -230,27 +421,25 @@ void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_tr
 	}
 
 	int l = p_canvas->child_items.size();
-	Canvas::ChildItem *ci = p_canvas->child_items.ptrw();
 
-	bool has_mirror = false;
-	for (int i = 0; i < l; i++) {
-		if (ci[i].mirror.x || ci[i].mirror.y) {
-			has_mirror = true;
-			break;
-		}
-	}
+	int cull_job = p_canvas->cull_job;
+	p_canvas->cull_job = -1;
 
-	if (!has_mirror) {
+	if (!p_canvas->has_mirror()) {
 
 		static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
-		RasterizerCanvas::Item *z_list[z_range];
-		RasterizerCanvas::Item *z_last_list[z_range];
+		RasterizerCanvas::Item **z_list;
+		RasterizerCanvas::Item **z_last_list;
 
-		memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
-		memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+		if (cull_job >= 0 && cull_job < canvas_cull_jobs.size() && canvas_cull_jobs[cull_job].canvas == p_canvas && canvas_cull_jobs[cull_job].transform == p_transform && canvas_cull_jobs[cull_job].clip_rect == p_clip_rect) {
+			//already culled by cull_canvases()
+			z_list = canvas_cull_jobs[cull_job].z_list;
+			z_last_list = canvas_cull_jobs[cull_job].z_last_list;
+		} else {
+			z_list = (RasterizerCanvas::Item **)alloca(z_range * sizeof(RasterizerCanvas::Item *));
+			z_last_list = (RasterizerCanvas::Item **)alloca(z_range * sizeof(RasterizerCanvas::Item *));
 
-		for (int i = 0; i < l; i++) {
-			_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, NULL, NULL);
+			_cull_canvas(p_canvas, p_transform, p_clip_rect, z_list, z_last_list);
 		}
 
 		for (int i = 0; i < z_range; i++) {
@@ -347,6 +536,7 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 		}
 
 		canvas_item->parent = RID();
+		canvas_item->parent_item = NULL;
 	}
 
 	if (p_parent.is_valid()) {
@@ -362,6 +552,7 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 			Item *item_owner = canvas_item_owner.get(p_parent);
 			item_owner->child_items.push_back(canvas_item);
 			item_owner->children_order_dirty = true;
+			canvas_item->parent_item = item_owner;
 
 			_mark_ysort_dirty(item_owner, canvas_item_owner);
 
@@ -395,6 +586,8 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->xform = p_transform;
+
+	_mark_ysort_xform_dirty(canvas_item->parent_item);
 }
 void VisualServerCanvas::canvas_item_set_clip(RID p_item, bool p_clip) {
 
@@ -872,8 +1065,13 @@ void VisualServerCanvas::canvas_item_set_sort_children_by_y(RID p_item, bool p_e
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->sort_y = p_enable;
+	canvas_item->ysort_children_count = -1;
+	if (!p_enable) {
+		canvas_item->ysort_children.clear();
+	}
 
-	_mark_ysort_dirty(canvas_item, canvas_item_owner);
+	//a Y-sorted parent only collects the children of items that sort too
+	_mark_ysort_dirty(canvas_item->parent_item, canvas_item_owner);
 }
 void VisualServerCanvas::canvas_item_set_z_index(RID p_item, int p_z) {
 
@@ -1359,6 +1557,7 @@ bool VisualServerCanvas::free(RID p_rid) {
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 
 			canvas_item->child_items[i]->parent = RID();
+			canvas_item->child_items[i]->parent_item = NULL;
 		}
 
 		/*
@@ -1434,4 +1633,6 @@ bool VisualServerCanvas::free(RID p_rid) {
 }
 
 VisualServerCanvas::VisualServerCanvas() {
+
+	parallel_culling = GLOBAL_GET("rendering/threads/parallel_culling");
 }
@@ -39,6 +39,7 @@ public:
 	struct Item : public RasterizerCanvas::Item {
 
 		RID parent; // canvas it belongs to
+		Item *parent_item; // same as parent when it is a canvas item, NULL otherwise
 		List<Item *>::Element *E;
 		int z_index;
 		bool z_relative;
@@ -49,14 +50,17 @@ public:
 		int index;
 		bool children_order_dirty;
 		int ysort_children_count;
+		bool ysort_xform_dirty;
 		Transform2D ysort_xform;
 		Vector2 ysort_pos;
 
 		Vector<Item *> child_items;
+		Vector<Item *> ysort_children; // kept sorted between frames, rebuilt when ysort_children_count is -1
 
 		Item() {
 			children_order_dirty = true;
 			E = NULL;
+			parent_item = NULL;
 			z_index = 0;
 			modulate = Color(1, 1, 1, 1);
 			self_modulate = Color(1, 1, 1, 1);
@@ -65,6 +69,7 @@ public:
 			z_relative = true;
 			index = 0;
 			ysort_children_count = -1;
+			ysort_xform_dirty = false;
 			ysort_xform = Transform2D();
 			ysort_pos = Vector2();
 		}
@@ -127,6 +132,8 @@ public:
 		Vector<ChildItem> child_items;
 		Color modulate;
 
+		int cull_job; // set by cull_canvases() until the canvas is rendered, -1 otherwise
+
 		int find_item(Item *p_item) {
 			for (int i = 0; i < child_items.size(); i++) {
 				if (child_items[i].item == p_item)
@@ -139,10 +146,18 @@ public:
 			if (idx >= 0)
 				child_items.remove(idx);
 		}
+		bool has_mirror() const {
+			for (int i = 0; i < child_items.size(); i++) {
+				if (child_items[i].mirror.x || child_items[i].mirror.y)
+					return true;
+			}
+			return false;
+		}
 
 		Canvas() {
 			modulate = Color(1, 1, 1, 1);
 			children_order_dirty = true;
+			cull_job = -1;
 		}
 	};
 
@@ -151,11 +166,50 @@ public:
 	RID_Owner<RasterizerCanvas::Light> canvas_light_owner;
 
 private:
+	enum {
+		PARALLEL_CULL_MIN_CHILDREN = 512, // per job, smaller lists are culled on the calling thread
+		YSORT_RESORT_MAX_MOVES = 4 // per child, beyond that a moved Y-sort list is sorted from scratch
+	};
+
+	struct ChildCullJob {
+		Item *parent;
+		Item **child_items;
+		int from;
+		int to;
+		bool behind;
+		Transform2D xform;
+		Rect2 clip_rect;
+		Color modulate;
+		int z;
+		Item *material_owner;
+		RasterizerCanvas::Item **z_list;
+		RasterizerCanvas::Item **z_last_list;
+	};
+
+	struct CanvasCullJob {
+		Canvas *canvas;
+		Transform2D transform;
+		Rect2 clip_rect;
+		RasterizerCanvas::Item **z_list;
+		RasterizerCanvas::Item **z_last_list;
+	};
+
+	bool parallel_culling;
+
+	Vector<CanvasCullJob> canvas_cull_jobs;
+	Vector<RasterizerCanvas::Item *> canvas_cull_z_lists;
+
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
+	void _render_canvas_item_children(Item *p_canvas_item, Item **p_child_items, int p_from, int p_to, bool p_behind, const Transform2D &p_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_material_owner);
+	void _render_canvas_item_children_parallel(Item *p_canvas_item, Item **p_child_items, int p_child_count, int p_job_count, bool p_behind, const Transform2D &p_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_material_owner);
+	void _child_cull_job(uint32_t p_index, ChildCullJob *p_jobs);
+	void _cull_canvas(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list);
+	void _canvas_cull_job(uint32_t p_index, CanvasCullJob *p_jobs);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
 
 public:
+	void cull_canvases(Canvas *const *p_canvases, const Transform2D *p_transforms, int p_count, const Rect2 &p_clip_rect);
 	void render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect);
 
 	RID canvas_create();
@@ -30,6 +30,8 @@
 
 #include "visual_server_scene.h"
 #include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
 #include "visual_server_global.h"
 #include "visual_server_raster.h"
 /* CAMERA API */
@@ -246,8 +248,14 @@ RID VisualServerScene::scenario_create() {
 	RID scenario_rid = scenario_owner.make_rid(scenario);
 	scenario->self = scenario_rid;
 
-	scenario->octree.set_pair_callback(_instance_pair, this);
-	scenario->octree.set_unpair_callback(_instance_unpair, this);
+	if (use_bvh) {
+		scenario->sps = memnew(SpatialPartitioningSceneBVH);
+	} else {
+		scenario->sps = memnew(SpatialPartitioningSceneOctree);
+	}
+
+	scenario->sps->set_pair_callback(_instance_pair, this);
+	scenario->sps->set_unpair_callback(_instance_unpair, this);
 	scenario->reflection_probe_shadow_atlas = VSG::scene_render->shadow_atlas_create();
 	VSG::scene_render->shadow_atlas_set_size(scenario->reflection_probe_shadow_atlas, 1024); //make enough shadows for close distance, don't bother with rest
 	VSG::scene_render->shadow_atlas_set_quadrant_subdivision(scenario->reflection_probe_shadow_atlas, 0, 4);
@@ -345,7 +353,7 @@ void VisualServerScene::instance_set_base(RID p_instance, RID p_base) {
 		}
 
 		if (scenario && instance->octree_id) {
-			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
+			scenario->sps->erase(instance->octree_id); //make dependencies generated by the octree go away
 			instance->octree_id = 0;
 		}
 
@@ -493,7 +501,7 @@ void VisualServerScene::instance_set_scenario(RID p_instance, RID p_scenario) {
 		instance->scenario->instances.remove(&instance->scenario_item);
 
 		if (instance->octree_id) {
-			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
+			instance->scenario->sps->erase(instance->octree_id); //make dependencies generated by the octree go away
 			instance->octree_id = 0;
 		}
 
@@ -632,25 +640,25 @@ void VisualServerScene::instance_set_visible(RID p_instance, bool p_visible) {
 	switch (instance->base_type) {
 		case VS::INSTANCE_LIGHT: {
 			if (VSG::storage->light_get_type(instance->base) != VS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				instance->scenario->sps->set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHT, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_REFLECTION_PROBE: {
 			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				instance->scenario->sps->set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_REFLECTION_PROBE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_LIGHTMAP_CAPTURE: {
 			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
+				instance->scenario->sps->set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_LIGHTMAP_CAPTURE, p_visible ? VS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case VS::INSTANCE_GI_PROBE: {
 			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
+				instance->scenario->sps->set_pairable(instance->octree_id, p_visible, 1 << VS::INSTANCE_GI_PROBE, p_visible ? (VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT)) : 0);
 			}
 
 		} break;
@@ -753,7 +761,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_aabb(const AABB &p_aabb, RID
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_aabb(p_aabb, cull, 1024);
+	culled = scenario->sps->cull_aabb(p_aabb, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -776,7 +784,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_ray(const Vector3 &p_from, co
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
+	culled = scenario->sps->cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -799,7 +807,7 @@ Vector<ObjectID> VisualServerScene::instances_cull_convex(const Vector<Plane> &p
 	int culled = 0;
 	Instance *cull[1024];
 
-	culled = scenario->octree.cull_convex(p_convex, cull, 1024);
+	culled = scenario->sps->cull_convex(p_convex, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 
@@ -946,7 +954,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		}
 
 		// not inside octree
-		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		p_instance->octree_id = p_instance->scenario->sps->create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
 
 	} else {
 
@@ -955,7 +963,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 			return;
 		*/
 
-		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		p_instance->scenario->sps->move(p_instance->octree_id, new_aabb);
 	}
 }
 
@@ -1264,19 +1272,81 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	}
 }
 
-bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+int VisualServerScene::_light_instance_get_shadow_pass_count(Instance *p_instance) const {
+
+	switch (VSG::storage->light_get_type(p_instance->base)) {
+
+		case VS::LIGHT_DIRECTIONAL: {
+
+			switch (VSG::storage->light_directional_get_shadow_mode(p_instance->base)) {
+				case VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL: return 1;
+				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_2_SPLITS: return 2;
+				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS: return 4;
+			}
+		} break;
+		case VS::LIGHT_OMNI: {
+
+			return VSG::storage->light_omni_get_shadow_mode(p_instance->base) == VS::LIGHT_OMNI_SHADOW_CUBE ? 6 : 2;
+		} break;
+		case VS::LIGHT_SPOT: {
+
+			return 1;
+		} break;
+	}
+
+	return 0;
+}
+
+int VisualServerScene::_cull_shadow_casters(Scenario *p_scenario, const Vector<Plane> &p_planes, Instance **r_cull_buffer, bool p_threaded) {
+
+	if (p_threaded) {
+		return p_scenario->sps->cull_convex_mt(p_planes, r_cull_buffer, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+	}
+	return p_scenario->sps->cull_convex(p_planes, r_cull_buffer, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+}
+
+// Removes instances that can't cast shadows and stores the rest in the shadow pass.
+static void _store_shadow_pass_casters(VisualServerScene::InstanceLightData::ShadowPass &r_pass, VisualServerScene::Instance **p_cull_buffer, int p_cull_count) {
+
+	r_pass.animated_material_found = false;
+	r_pass.valid = true;
+
+	for (int j = 0; j < p_cull_count; j++) {
+
+		VisualServerScene::Instance *instance = p_cull_buffer[j];
+		if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<VisualServerScene::InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+			p_cull_count--;
+			SWAP(p_cull_buffer[j], p_cull_buffer[p_cull_count]);
+			j--;
+		} else if (static_cast<VisualServerScene::InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+			r_pass.animated_material_found = true;
+		}
+	}
+
+	r_pass.instances.resize(p_cull_count);
+	if (p_cull_count) {
+		copymem(r_pass.instances.ptrw(), p_cull_buffer, sizeof(VisualServerScene::Instance *) * p_cull_count);
+	}
+}
+
+void VisualServerScene::_light_instance_cull_shadow(Instance *p_instance, int p_pass, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario, Instance **p_cull_buffer, bool p_threaded) {
 
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
+	if (p_pass < 0) {
+		light->shadow_pass_count = _light_instance_get_shadow_pass_count(p_instance);
+	}
+
 	Transform light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
-
 	switch (VSG::storage->light_get_type(p_instance->base)) {
 
 		case VS::LIGHT_DIRECTIONAL: {
 
+			//splits depend on each other, so they are always culled together
+			bool animated_material_found = false;
+
 			float max_distance = p_cam_projection.get_z_far();
 			float shadow_max = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_SHADOW_MAX_DISTANCE);
 			if (shadow_max > 0 && !p_cam_orthogonal) { //its impractical (and leads to unwanted behaviors) to set max distance in orthogonal camera
@@ -1290,7 +1360,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
 				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = _cull_shadow_casters(p_scenario, planes, p_cull_buffer, p_threaded);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1300,7 +1370,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 				for (int i = 0; i < cull_count; i++) {
 
-					Instance *instance = instance_shadow_cull_result[i];
+					Instance *instance = p_cull_buffer[i];
 					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						continue;
 					}
@@ -1331,12 +1401,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			float range = max_distance - min_distance;
 
-			int splits = 0;
-			switch (VSG::storage->light_directional_get_shadow_mode(p_instance->base)) {
-				case VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL: splits = 1; break;
-				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_2_SPLITS: splits = 2; break;
-				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS: splits = 4; break;
-			}
+			int splits = light->shadow_pass_count;
 
 			float distances[5];
 
@@ -1355,6 +1420,11 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			for (int i = 0; i < splits; i++) {
 
+				InstanceLightData::ShadowPass &shadow_pass = light->shadow_passes[i];
+				shadow_pass.instances.clear();
+				shadow_pass.animated_material_found = false;
+				shadow_pass.valid = false;
+
 				// setup a camera matrix for that range!
 				CameraMatrix camera_matrix;
 
@@ -1488,26 +1558,17 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = _cull_shadow_casters(p_scenario, light_frustum_planes, p_cull_buffer, p_threaded);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
-				Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
+				_store_shadow_pass_casters(shadow_pass, p_cull_buffer, cull_count);
+				shadow_pass.animated_material_found = false; //only the depth range pre pass reports animated materials
 
-				for (int j = 0; j < cull_count; j++) {
+				for (int j = 0; j < shadow_pass.instances.size(); j++) {
 
 					float min, max;
-					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-						j--;
-						continue;
-					}
-
-					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
+					shadow_pass.instances[j]->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
 					if (max > z_max)
 						z_max = max;
 				}
@@ -1524,25 +1585,33 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					ortho_transform.basis = transform.basis;
 					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
 
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
+					shadow_pass.projection = ortho_camera;
+					shadow_pass.transform = ortho_transform;
+					shadow_pass.far = 0;
+					shadow_pass.split = distances[i + 1];
+					shadow_pass.bias_scale = bias_scale;
+					shadow_pass.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
+					shadow_pass.valid = true;
 				}
-
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 			}
 
+			light->shadow_passes[0].animated_material_found = animated_material_found;
+
 		} break;
 		case VS::LIGHT_OMNI: {
 
 			VS::LightOmniShadowMode shadow_mode = VSG::storage->light_omni_get_shadow_mode(p_instance->base);
+			float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
 
 			switch (shadow_mode) {
 				case VS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID: {
 
 					for (int i = 0; i < 2; i++) {
 
-						//using this one ensures that raster deferred will have it
+						if (p_pass >= 0 && p_pass != i)
+							continue;
 
-						float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
+						//using this one ensures that raster deferred will have it
 
 						float z = i == 0 ? -1 : 1;
 						Vector<Plane> planes;
@@ -1553,38 +1622,28 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 						planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
 						planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-						Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
-
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-									animated_material_found = true;
-								}
-
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
+						int cull_count = _cull_shadow_casters(p_scenario, planes, p_cull_buffer, p_threaded);
 
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						InstanceLightData::ShadowPass &shadow_pass = light->shadow_passes[i];
+						_store_shadow_pass_casters(shadow_pass, p_cull_buffer, cull_count);
+						shadow_pass.projection = CameraMatrix();
+						shadow_pass.transform = light_transform;
+						shadow_pass.far = radius;
+						shadow_pass.split = 0;
+						shadow_pass.bias_scale = 1.0;
+						shadow_pass.near_plane = Plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 					}
 				} break;
 				case VS::LIGHT_OMNI_SHADOW_CUBE: {
 
-					float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
 					CameraMatrix cm;
 					cm.set_perspective(90, 1, 0.01, radius);
 
 					for (int i = 0; i < 6; i++) {
 
+						if (p_pass >= 0 && p_pass != i)
+							continue;
+
 						//using this one ensures that raster deferred will have it
 
 						static const Vector3 view_normals[6] = {
@@ -1608,32 +1667,18 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 						Vector<Plane> planes = cm.get_projection_planes(xform);
 
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
-						Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-									animated_material_found = true;
-								}
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
+						int cull_count = _cull_shadow_casters(p_scenario, planes, p_cull_buffer, p_threaded);
 
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						InstanceLightData::ShadowPass &shadow_pass = light->shadow_passes[i];
+						_store_shadow_pass_casters(shadow_pass, p_cull_buffer, cull_count);
+						shadow_pass.projection = cm;
+						shadow_pass.transform = xform;
+						shadow_pass.far = radius;
+						shadow_pass.split = 0;
+						shadow_pass.bias_scale = 1.0;
+						shadow_pass.near_plane = Plane(xform.origin, -xform.basis.get_axis(2));
 					}
 
-					//restore the regular DP matrix
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0);
-
 				} break;
 			}
 
@@ -1647,34 +1692,68 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+			int cull_count = _cull_shadow_casters(p_scenario, planes, p_cull_buffer, p_threaded);
 
-			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
+			InstanceLightData::ShadowPass &shadow_pass = light->shadow_passes[0];
+			_store_shadow_pass_casters(shadow_pass, p_cull_buffer, cull_count);
+			shadow_pass.projection = cm;
+			shadow_pass.transform = light_transform;
+			shadow_pass.far = radius;
+			shadow_pass.split = 0;
+			shadow_pass.bias_scale = 1.0;
+			shadow_pass.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
 
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
-			}
+		} break;
+	}
+}
 
-			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+bool VisualServerScene::_light_instance_render_shadow(Instance *p_instance, RID p_shadow_atlas) {
 
-		} break;
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+
+	bool animated_material_found = false;
+
+	for (int i = 0; i < light->shadow_pass_count; i++) {
+
+		InstanceLightData::ShadowPass &shadow_pass = light->shadow_passes[i];
+
+		if (shadow_pass.animated_material_found) {
+			animated_material_found = true;
+		}
+
+		if (!shadow_pass.valid) {
+			continue;
+		}
+
+		int cull_count = shadow_pass.instances.size();
+		Instance **cull_result = shadow_pass.instances.ptrw();
+
+		for (int j = 0; j < cull_count; j++) {
+			cull_result[j]->depth = shadow_pass.near_plane.distance_to(cull_result[j]->transform.origin);
+			cull_result[j]->depth_layer = 0;
+		}
+
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, shadow_pass.projection, shadow_pass.transform, shadow_pass.far, shadow_pass.split, i, shadow_pass.bias_scale);
+		VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)cull_result, cull_count);
+	}
+
+	if (VSG::storage->light_get_type(p_instance->base) == VS::LIGHT_OMNI && VSG::storage->light_omni_get_shadow_mode(p_instance->base) == VS::LIGHT_OMNI_SHADOW_CUBE) {
+		//restore the regular DP matrix
+		Transform light_transform = p_instance->transform;
+		light_transform.orthonormalize();
+		float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0);
 	}
 
 	return animated_material_found;
 }
 
+bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+
+	_light_instance_cull_shadow(p_instance, -1, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_scenario, instance_shadow_cull_result, false);
+	return _light_instance_render_shadow(p_instance, p_shadow_atlas);
+}
+
 void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
 // render to mono camera
 #ifndef _3D_DISABLED
@@ -1819,7 +1898,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	instance_cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+	instance_cull_count = scenario->sps->cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -1988,12 +2067,12 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	RID *directional_light_ptr = &light_instance_cull_result[light_cull_count];
 	directional_light_count = 0;
 
+	Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
+	int directional_shadow_count = 0;
+
 	// directional lights
 	{
 
-		Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
-		int directional_shadow_count = 0;
-
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 
 			if (light_cull_count + directional_light_count >= MAX_LIGHTS_CULLED) {
@@ -2018,12 +2097,18 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 		VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
 
-		for (int i = 0; i < directional_shadow_count; i++) {
+		if (!parallel_culling) {
+			for (int i = 0; i < directional_shadow_count; i++) {
 
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			}
 		}
 	}
 
+	//with parallel culling, shadows are culled all at once and rendered afterwards
+	Instance **lights_to_redraw = (Instance **)alloca(sizeof(Instance *) * MAX(1, light_cull_count));
+	int redraw_count = 0;
+
 	{ //setup shadow maps
 
 		//SortArray<Instance*,_InstanceLightsort> sorter;
@@ -2119,10 +2204,95 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 			if (redraw) {
 				//must redraw!
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				if (parallel_culling) {
+					lights_to_redraw[redraw_count++] = ins;
+				} else {
+					light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				}
 			}
 		}
 	}
+
+	if (parallel_culling && (directional_shadow_count || redraw_count)) {
+
+		_update_shadows_parallel(lights_with_shadow, directional_shadow_count, lights_to_redraw, redraw_count, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+	}
+}
+
+void VisualServerScene::_update_shadows_parallel(Instance **p_directional_lights, int p_directional_count, Instance **p_lights, int p_light_count, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+
+	shadow_cull_jobs.clear();
+
+	for (int i = 0; i < p_directional_count + p_light_count; i++) {
+
+		Instance *ins = i < p_directional_count ? p_directional_lights[i] : p_lights[i - p_directional_count];
+		InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+
+		light->shadow_pass_count = _light_instance_get_shadow_pass_count(ins);
+
+		ShadowCullJob job;
+		job.light = ins;
+		job.cam_transform = p_cam_transform;
+		job.cam_projection = p_cam_projection;
+		job.cam_orthogonal = p_cam_orthogonal;
+		job.scenario = p_scenario;
+
+		if (VSG::storage->light_get_type(ins->base) == VS::LIGHT_DIRECTIONAL) {
+			//splits share the depth range, cull them together
+			job.pass = -1;
+			shadow_cull_jobs.push_back(job);
+		} else {
+			for (int j = 0; j < light->shadow_pass_count; j++) {
+				job.pass = j;
+				shadow_cull_jobs.push_back(job);
+			}
+		}
+	}
+
+	thread_process_array(shadow_cull_jobs.size(), this, &VisualServerScene::_shadow_cull_job, shadow_cull_jobs.ptrw());
+
+	//rendering is not thread safe, do it in the same order as the serial path
+	for (int i = 0; i < p_directional_count; i++) {
+
+		_light_instance_render_shadow(p_directional_lights[i], p_shadow_atlas);
+	}
+
+	for (int i = 0; i < p_light_count; i++) {
+
+		InstanceLightData *light = static_cast<InstanceLightData *>(p_lights[i]->base_data);
+		light->shadow_dirty = _light_instance_render_shadow(p_lights[i], p_shadow_atlas);
+	}
+}
+
+VisualServerScene::Instance **VisualServerScene::_shadow_cull_buffer_acquire() {
+
+	shadow_cull_buffer_mutex->lock();
+	Instance **buffer;
+	if (shadow_cull_buffers.size()) {
+		buffer = shadow_cull_buffers[shadow_cull_buffers.size() - 1];
+		shadow_cull_buffers.resize(shadow_cull_buffers.size() - 1);
+	} else {
+		buffer = memnew_arr(Instance *, MAX_INSTANCE_CULL);
+	}
+	shadow_cull_buffer_mutex->unlock();
+
+	return buffer;
+}
+
+void VisualServerScene::_shadow_cull_buffer_release(Instance **p_buffer) {
+
+	shadow_cull_buffer_mutex->lock();
+	shadow_cull_buffers.push_back(p_buffer);
+	shadow_cull_buffer_mutex->unlock();
+}
+
+void VisualServerScene::_shadow_cull_job(uint32_t p_index, ShadowCullJob *p_jobs) {
+
+	ShadowCullJob &job = p_jobs[p_index];
+
+	Instance **buffer = _shadow_cull_buffer_acquire();
+	_light_instance_cull_shadow(job.light, job.pass, job.cam_transform, job.cam_projection, job.cam_orthogonal, job.scenario, buffer, true);
+	_shadow_cull_buffer_release(buffer);
 }
 
 void VisualServerScene::_render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass) {
@@ -3407,10 +3577,37 @@ void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
 	p_instance->update_materials = false;
 }
 
+void VisualServerScene::_update_dirty_instance_aabb_job(uint32_t p_index, Instance **p_instances) {
+
+	_update_instance_aabb(p_instances[p_index]);
+}
+
 void VisualServerScene::update_dirty_instances() {
 
 	VSG::storage->update_dirty_resources();
 
+	if (parallel_culling) {
+		//mesh AABBs (skinned ones especially) can be computed in parallel, storage only reads from them
+		dirty_aabb_instances.clear();
+
+		for (SelfList<Instance> *E = _instance_update_list.first(); E; E = E->next()) {
+
+			Instance *ins = E->self();
+			if (ins->update_aabb && ins->base_type == VS::INSTANCE_MESH) {
+				dirty_aabb_instances.push_back(ins);
+			}
+		}
+
+		if (dirty_aabb_instances.size() >= PARALLEL_AABB_UPDATE_MIN_INSTANCES) {
+
+			thread_process_array(dirty_aabb_instances.size(), this, &VisualServerScene::_update_dirty_instance_aabb_job, dirty_aabb_instances.ptrw());
+
+			for (int i = 0; i < dirty_aabb_instances.size(); i++) {
+				dirty_aabb_instances[i]->update_aabb = false;
+			}
+		}
+	}
+
 	while (_instance_update_list.first()) {
 
 		_update_dirty_instance(_instance_update_list.first()->self());
@@ -3475,6 +3672,10 @@ VisualServerScene::VisualServerScene() {
 
 	render_pass = 1;
 	singleton = this;
+
+	parallel_culling = GLOBAL_GET("rendering/threads/parallel_culling");
+	use_bvh = GLOBAL_GET("rendering/quality/spatial_partitioning/use_bvh");
+	shadow_cull_buffer_mutex = Mutex::create();
 }
 
 VisualServerScene::~VisualServerScene() {
@@ -3488,4 +3689,11 @@ VisualServerScene::~VisualServerScene() {
 	memdelete(probe_bake_mutex);
 
 #endif
+
+	for (int i = 0; i < shadow_cull_buffers.size(); i++) {
+		memdelete_arr(shadow_cull_buffers[i]);
+	}
+	if (shadow_cull_buffer_mutex) {
+		memdelete(shadow_cull_buffer_mutex);
+	}
 }
@@ -34,8 +34,10 @@
 #include "servers/visual/rasterizer.h"
 
 #include "core/allocators.h"
+#include "core/math/bvh.h"
 #include "core/math/geometry.h"
 #include "core/math/octree.h"
+#include "core/os/mutex.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/self_list.h"
@@ -116,13 +118,59 @@ public:
 
 	struct Instance;
 
+	// Holds the instances of a scenario, for pairing and culling. Either the octree
+	// or the BVH is used, depending on rendering/quality/spatial_partitioning/use_bvh.
+	class SpatialPartitioningScene {
+	public:
+		typedef void *(*PairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int);
+		typedef void (*UnpairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int, void *);
+
+		virtual uint32_t create(Instance *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) = 0;
+		virtual void move(uint32_t p_id, const AABB &p_aabb) = 0;
+		virtual void erase(uint32_t p_id) = 0;
+		virtual void set_pairable(uint32_t p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) = 0;
+
+		virtual int cull_convex(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) = 0;
+		virtual int cull_convex_mt(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const = 0;
+		virtual int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) = 0;
+		virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) = 0;
+
+		virtual void set_pair_callback(PairCallback p_callback, void *p_userdata) = 0;
+		virtual void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) = 0;
+
+		virtual ~SpatialPartitioningScene() {}
+	};
+
+	template <class TREE>
+	class SpatialPartitioningSceneTree : public SpatialPartitioningScene {
+
+		TREE tree;
+
+	public:
+		virtual uint32_t create(Instance *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) { return tree.create(p_userdata, p_aabb, p_subindex, p_pairable, p_pairable_type, p_pairable_mask); }
+		virtual void move(uint32_t p_id, const AABB &p_aabb) { tree.move(p_id, p_aabb); }
+		virtual void erase(uint32_t p_id) { tree.erase(p_id); }
+		virtual void set_pairable(uint32_t p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) { tree.set_pairable(p_id, p_pairable, p_pairable_type, p_pairable_mask); }
+
+		virtual int cull_convex(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) { return tree.cull_convex(p_convex, p_result_array, p_result_max, p_mask); }
+		virtual int cull_convex_mt(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const { return tree.cull_convex_mt(p_convex, p_result_array, p_result_max, p_mask); }
+		virtual int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) { return tree.cull_aabb(p_aabb, p_result_array, p_result_max, p_subindex_array, p_mask); }
+		virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF) { return tree.cull_segment(p_from, p_to, p_result_array, p_result_max, p_subindex_array, p_mask); }
+
+		virtual void set_pair_callback(PairCallback p_callback, void *p_userdata) { tree.set_pair_callback(p_callback, p_userdata); }
+		virtual void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) { tree.set_unpair_callback(p_callback, p_userdata); }
+	};
+
+	typedef SpatialPartitioningSceneTree<Octree<Instance, true> > SpatialPartitioningSceneOctree;
+	typedef SpatialPartitioningSceneTree<BVH<Instance, true> > SpatialPartitioningSceneBVH;
+
 	struct Scenario : RID_Data {
 
 		VS::ScenarioDebugMode debug;
 		RID self;
 		// well wtf, balloon allocator is slower?
 
-		Octree<Instance, true> octree;
+		SpatialPartitioningScene *sps;
 
 		List<Instance *> directional_lights;
 		RID environment;
@@ -132,10 +180,20 @@ public:
 
 		SelfList<Instance>::List instances;
 
-		Scenario() { debug = VS::SCENARIO_DEBUG_DISABLED; }
+		Scenario() {
+			debug = VS::SCENARIO_DEBUG_DISABLED;
+			sps = NULL;
+		}
+
+		~Scenario() {
+			if (sps) {
+				memdelete(sps);
+			}
+		}
 	};
 
 	mutable RID_Owner<Scenario> scenario_owner;
+	bool use_bvh;
 
 	static void *_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
 	static void _instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
@@ -172,7 +230,7 @@ public:
 		AABB transformed_aabb;
 		AABB *custom_aabb; // <Zylann> would using aabb directly with a bool be better?
 		float extra_margin;
-		uint32_t object_ID;
+		ObjectID object_ID;
 
 		float lod_begin;
 		float lod_end;
@@ -305,12 +363,38 @@ public:
 
 		Instance *baked_light;
 
+		// One per directional split, paraboloid or cubemap face. Filled when culling
+		// the shadow, consumed when rendering it.
+		struct ShadowPass {
+			CameraMatrix projection;
+			Transform transform;
+			float far;
+			float split;
+			float bias_scale;
+			Plane near_plane;
+			bool animated_material_found;
+			bool valid;
+			Vector<Instance *> instances;
+
+			ShadowPass() {
+				valid = false;
+				far = 0;
+				split = 0;
+				bias_scale = 1.0;
+				animated_material_found = false;
+			}
+		};
+
+		ShadowPass shadow_passes[6];
+		int shadow_pass_count;
+
 		InstanceLightData() {
 
 			shadow_dirty = true;
 			D = NULL;
 			last_version = 0;
 			baked_light = NULL;
+			shadow_pass_count = 0;
 		}
 	};
 
@@ -439,6 +523,34 @@ public:
 	int instance_cull_count;
 	Instance *instance_cull_result[MAX_INSTANCE_CULL];
 	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
+
+	// Parallel culling: shadow passes and dirty instance AABBs are processed on the WorkerThreadPool.
+	bool parallel_culling;
+
+	struct ShadowCullJob {
+		Instance *light;
+		int pass; // -1 culls every pass of the light
+		Transform cam_transform;
+		CameraMatrix cam_projection;
+		bool cam_orthogonal;
+		Scenario *scenario;
+	};
+
+	Vector<ShadowCullJob> shadow_cull_jobs;
+	Mutex *shadow_cull_buffer_mutex;
+	Vector<Instance **> shadow_cull_buffers; // scratch results, one per job running at the same time
+
+	Instance **_shadow_cull_buffer_acquire();
+	void _shadow_cull_buffer_release(Instance **p_buffer);
+	void _shadow_cull_job(uint32_t p_index, ShadowCullJob *p_jobs);
+	void _update_dirty_instance_aabb_job(uint32_t p_index, Instance **p_instances);
+
+	enum {
+		PARALLEL_AABB_UPDATE_MIN_INSTANCES = 64
+	};
+
+	Vector<Instance *> dirty_aabb_instances;
+
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
@@ -485,6 +597,11 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
+	int _light_instance_get_shadow_pass_count(Instance *p_instance) const;
+	int _cull_shadow_casters(Scenario *p_scenario, const Vector<Plane> &p_planes, Instance **r_cull_buffer, bool p_threaded);
+	void _light_instance_cull_shadow(Instance *p_instance, int p_pass, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario, Instance **p_cull_buffer, bool p_threaded);
+	bool _light_instance_render_shadow(Instance *p_instance, RID p_shadow_atlas);
+	void _update_shadows_parallel(Instance **p_directional_lights, int p_directional_count, Instance **p_lights, int p_light_count, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
 	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
 
 	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe);
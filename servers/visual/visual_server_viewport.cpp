@@ -174,6 +174,22 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 			//VSG::canvas_render->reset_canvas();
 		}
 
+		if (canvas_map.size() > 1) {
+			//layers don't share items, so they can all be culled at once before drawing them in order
+			VisualServerCanvas::Canvas **canvases = (VisualServerCanvas::Canvas **)alloca(sizeof(VisualServerCanvas::Canvas *) * canvas_map.size());
+			Transform2D *canvas_transforms = (Transform2D *)alloca(sizeof(Transform2D) * canvas_map.size());
+
+			int canvas_count = 0;
+			for (Map<Viewport::CanvasKey, Viewport::CanvasData *>::Element *E = canvas_map.front(); E; E = E->next()) {
+
+				canvases[canvas_count] = static_cast<VisualServerCanvas::Canvas *>(E->get()->canvas);
+				canvas_transforms[canvas_count] = p_viewport->global_transform * E->get()->transform;
+				canvas_count++;
+			}
+
+			VSG::canvas->cull_canvases(canvases, canvas_transforms, canvas_count, clip_rect);
+		}
+
 		VSG::rasterizer->restore_render_target();
 
 		if (scenario_draw_canvas_bg && canvas_map.front() && canvas_map.front()->key().get_layer() > scenario_canvas_max_layer) {
@@ -2251,6 +2251,9 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_VIDEO_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_VERTEX_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_2D_ITEMS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_2D_DRAW_CALLS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_2D_BATCHES_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2373,6 +2376,7 @@ VisualServer::VisualServer() {
 	GLOBAL_DEF("rendering/vram_compression/import_etc", false);
 	GLOBAL_DEF("rendering/vram_compression/import_etc2", true);
 	GLOBAL_DEF("rendering/vram_compression/import_pvrtc", false);
+	GLOBAL_DEF("rendering/vram_compression/import_cache", true);
 
 	GLOBAL_DEF("rendering/quality/directional_shadow/size", 4096);
 	GLOBAL_DEF("rendering/quality/directional_shadow/size.mobile", 2048);
@@ -2409,6 +2413,14 @@ VisualServer::VisualServer() {
 	GLOBAL_DEF("rendering/quality/depth_prepass/disable_for_vendors", "PowerVR,Mali,Adreno");
 
 	GLOBAL_DEF("rendering/quality/filters/use_nearest_mipmap_filter", false);
+
+	GLOBAL_DEF("rendering/quality/spatial_partitioning/use_bvh", false);
+
+	GLOBAL_DEF("rendering/threads/parallel_culling", false);
+
+	GLOBAL_DEF("rendering/batching/use_batching", true);
+	GLOBAL_DEF("rendering/batching/item_reordering_lookahead", 4);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/batching/item_reordering_lookahead", PropertyInfo(Variant::INT, "rendering/batching/item_reordering_lookahead", PROPERTY_HINT_RANGE, "0,64,1"));
 }
 
 VisualServer::~VisualServer() {
@@ -193,10 +193,27 @@ int enet_socket_receive(ENetSocket socket, ENetAddress *address, ENetBuffer *buf
 	return read;
 }
 
-// Not implemented
 int enet_socket_wait(ENetSocket socket, enet_uint32 *condition, enet_uint32 timeout) {
 
-	return 0; // do we need this function?
+	// Only used when servicing with a timeout, e.g. from a network thread. Sends on UDP sockets don't block.
+	NetSocket *sock = (NetSocket *)socket;
+
+	if (!(*condition & ENET_SOCKET_WAIT_RECEIVE)) {
+		*condition = ENET_SOCKET_WAIT_NONE;
+		return 0;
+	}
+
+	Error err = sock->poll(NetSocket::POLL_TYPE_IN, timeout);
+
+	*condition = ENET_SOCKET_WAIT_NONE;
+
+	if (err == OK) {
+		*condition = ENET_SOCKET_WAIT_RECEIVE;
+	} else if (err != ERR_BUSY) {
+		return -1;
+	}
+
+	return 0;
 }
 
 int enet_socket_get_address(ENetSocket socket, ENetAddress *address) {